@@ -5,7 +5,7 @@
             "sources": [ "src/native-lib/tuxedo_io_napi.cc" ],
             "include_dirs": [ "<!@(node -p \"require('node-addon-api').include\")", "./src/native-lib/tuxedo_io_lib" ],
             "dependencies": [ "<!(node -p \"require('node-addon-api').gyp\")" ],
-            "libraries": [ "-ludev" ],
+            "libraries": [ "-ludev", "-lrt" ],
             "defines": [ "NAPI_CPP_EXCEPTIONS" ],
             "cflags_cc": ['-fexceptions']
         }
@@ -23,11 +23,16 @@ export class TccPaths {
         '/opt/tuxedo-control-center/resources/dist/tuxedo-control-center/data/service/tccd';
     static readonly TCCD_PYTHON_CAMERACTRL_FILE: string =
         '/opt/tuxedo-control-center/resources/dist/tuxedo-control-center/data/camera/cameractrls.py';
+    static readonly TCCD_NATIVE_LIB_FILE: string =
+        '/opt/tuxedo-control-center/resources/dist/tuxedo-control-center/data/service/TuxedoIOAPI.node';
     static readonly SETTINGS_FILE: string = '/etc/tcc/settings';
     static readonly PROFILES_FILE: string = '/etc/tcc/profiles';
     static readonly WEBCAM_FILE: string = '/etc/tcc/webcam';
     static readonly V4L2_NAMES_FILE: string =
         '/opt/tuxedo-control-center/resources/dist/tuxedo-control-center/data/camera/v4l2_kernel_names.json';
     static readonly FANTABLES_FILE: string = '/etc/tcc/fantables';
+    static readonly FAN_ACTUATORS_FILE: string = '/etc/tcc/fanactuators';
     static readonly TCCD_LOG_FILE: string = '/var/log/tccd/log';
+    static readonly TCCD_METRICS_SOCKET: string = '/run/tccd-metrics.sock';
+    static readonly TELEMETRY_JOURNAL_FILE: string = '/var/lib/tcc/telemetry.journal';
 }
@@ -22,6 +22,7 @@ import { ConfigHandler } from '../../common/classes/ConfigHandler';
 import { TccPaths } from '../../common/classes/TccPaths';
 import { WebcamAPIFunctions } from '../../common/models/IWebcamAPI';
 import type { WebcamConstraints, WebcamPreset } from '../../common/models/TccWebcamSettings';
+import type { ITuxedoIOAPI, V4l2ApplyResult } from '../../native-lib/TuxedoIOAPI';
 import { clearWebcamWindow, createWebcamPreview, tccWindow, webcamWindow } from './browserWindowsAPI';
 import { userConfig } from './initMain';
 import { cwd, environmentIsProduction, execCmd, execFile } from './utilsAPI';
@@ -44,6 +45,63 @@ function getWebcamCtrlPythonPath(): string {
     return webcamCtrolsPath;
 }
 
+// undefined until first use, null if the addon can not be loaded
+let nativeLib: ITuxedoIOAPI | null | undefined;
+
+function getNativeLib(): ITuxedoIOAPI | null {
+    if (nativeLib === undefined) {
+        const addonPaths: string[] = environmentIsProduction
+            ? [TccPaths.TCCD_NATIVE_LIB_FILE]
+            : [`${cwd}/build/Release/TuxedoIOAPI.node`, `${cwd}/build/Debug/TuxedoIOAPI.node`];
+        nativeLib = null;
+        for (const addonPath of addonPaths) {
+            try {
+                nativeLib = require(addonPath);
+                break;
+            } catch (err: unknown) {
+                console.error(`webcamAPI: loading ${addonPath} failed => ${err}`);
+            }
+        }
+    }
+    return nativeLib;
+}
+
+function parseControls(controls: string): Record<string, string> {
+    const controlsMap: Record<string, string> = {};
+    for (const control of controls.split(',')) {
+        const separator: number = control.indexOf('=');
+        if (separator > 0) {
+            controlsMap[control.slice(0, separator)] = control.slice(separator + 1);
+        }
+    }
+    return controlsMap;
+}
+
+/**
+ * Set the plain V4L2 controls natively in one batch, only format and vendor
+ * specific controls are left to cameractrls.py
+ */
+async function setWebcamControls(devicePath: string, controls: Record<string, string>): Promise<string> {
+    const ioAPI: ITuxedoIOAPI | null = getNativeLib();
+    let remaining: string[] = Object.keys(controls);
+    if (ioAPI !== null) {
+        const result: V4l2ApplyResult = { applied: [], unknown: [], failed: [] };
+        ioAPI.setV4l2Controls(devicePath, controls, result);
+        // Nothing applied at all, e.g. device not opened: cameractrls.py reports the error
+        if (result.applied.length > 0 || result.unknown.length > 0) {
+            for (const name of result.failed) {
+                console.warn(`webcamAPI: setting ${name} to ${controls[name]} failed`);
+            }
+            remaining = result.unknown;
+        }
+    }
+    if (remaining.length === 0) {
+        return '';
+    }
+    const remainingControls: string = remaining.map((name: string): string => `${name}=${controls[name]}`).join(',');
+    return execCmd(`python3 ${getWebcamCtrlPythonPath()} -d ${devicePath} -c ${remainingControls}`);
+}
+
 export const webcamHandlers: Map<string, (...args: any[]) => any> = new Map<string, (...args: any[]) => any>()
     .set(WebcamAPIFunctions.settingWebcamWithLoading, async (arg: any): Promise<void> => {
         if (webcamWindow !== null) {
@@ -124,18 +182,23 @@ export const webcamHandlers: Map<string, (...args: any[]) => any> = new Map<stri
     .set(
         WebcamAPIFunctions.executeWebcamCtrls,
         (devicePath: string, parameter: string, value: string): Promise<string> => {
-            return execCmd(`python3 ${getWebcamCtrlPythonPath()} -d ${devicePath} -c ${parameter}=${value}`);
+            return setWebcamControls(devicePath, { [parameter]: value });
         },
     )
 
     .set(
         WebcamAPIFunctions.executeFilteredWebcamCtrls,
         async (devicePath: string, filteredControls: string): Promise<string> => {
-            return execCmd(`python3 ${getWebcamCtrlPythonPath()} -d ${devicePath} -c ${filteredControls}`);
+            return setWebcamControls(devicePath, parseControls(filteredControls));
         },
     )
 
     .set(WebcamAPIFunctions.getWebcamPaths, async (): Promise<string> => {
+        const ioAPI: ITuxedoIOAPI | null = getNativeLib();
+        if (ioAPI !== null) {
+            return JSON.stringify(ioAPI.getWebcamDevices());
+        }
+
         const result: { data: string; error: unknown } = await execFile(`python3 ${getWebcamCtrlPythonPath()} -i`);
 
         if (result.error) {
@@ -17,7 +17,7 @@
  * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-interface ITuxedoIOAPI {
+export interface ITuxedoIOAPI {
     /**
      * Gets information about the tuxedo-cc-wmi module
      *
@@ -39,6 +39,48 @@ interface ITuxedoIOAPI {
      */
     setEnableModeSet(enabled: boolean): boolean;
 
+    /**
+     * Get the errno of the last failed call, 0 if it succeeded.
+     * EOPNOTSUPP for operations the active interface does not implement
+     */
+    getLastError(): number;
+
+    /**
+     * Get the ioctl requests currently short-circuited, either permanently
+     * (not supported by the driver) or in backoff after transient errors
+     */
+    getIoctlBreakerState(): IoctlBreakerEntry[];
+
+    /**
+     * Forget all remembered ioctl failures, e.g. after a driver reload
+     */
+    resetIoctlBreaker(): void;
+
+    /**
+     * Get depth, coalescing and per priority wait time statistics of the
+     * ioctl submission queue shared by all callers
+     */
+    getIoctlQueueStats(): IoctlQueueStats;
+
+    /**
+     * Get statistics of the device session shared by the addon instances of
+     * all threads, users counts the instances (main thread and workers)
+     * currently holding it
+     */
+    getDeviceSessionStats(): DeviceSessionStats;
+    /**
+     * Watch for the device file appearing and disappearing, e.g. when the
+     * module loads after the daemon started. An appeared device is
+     * identified once right away, the callback is called when presence or
+     * identification changed. While the file is missing, calls no longer
+     * try to reopen it.
+     * @param devicePath Defaults to /dev/tuxedo_io
+     * @returns True if the watch was started, false if already running or not possible
+     */
+    startDeviceWatch(onChange: (event: DevicePresenceEvent) => void, devicePath?: string): boolean;
+    stopDeviceWatch(): void;
+    getDeviceWatchState(): DeviceWatchState;
+
     /**
      * Get the minimum speed the fan must be running for not making noises
      * because it is stuttering
@@ -76,6 +118,78 @@ interface ITuxedoIOAPI {
      * @returns True if call succeeded, false otherwise
      */
     getFanTemperature(fanNumber: number, fanTemperatureCelcius: ObjWrapper<number>): boolean;
+    /**
+     * Read speed and temperature of all fans and min, max and current of all
+     * TDPs at once, with a single batched ioctl if the module supports it.
+     * Values not available are -1.
+     * @returns True if call succeeded, false otherwise
+     */
+    getDeviceStatus(status: DeviceStatus): boolean;
+    /**
+     * Start sampling the fan temperatures on a native thread. The interval per
+     * sensor adapts to the temperature slope and the distance to the next
+     * fan table breakpoint
+     * @param minIntervalMs Fastest sampling interval, defaults to 100 ms
+     * @param maxIntervalMs Slowest sampling interval, defaults to 5000 ms
+     * @returns True if sampling was started, false otherwise
+     */
+    startSensorSampler(minIntervalMs?: number, maxIntervalMs?: number): boolean;
+    /**
+     * Stop the temperature sampler
+     */
+    stopSensorSampler(): void;
+    /**
+     * Set the fan table whose breakpoints the sampler of the fan watches
+     */
+    setSamplerFanTable(fanNumber: number, table: { temp: number; speed: number }[]): void;
+    /**
+     * Get the latest sampled temperature without accessing the hardware
+     * @returns True if a sample is available, false otherwise
+     */
+    getSampledFanTemperature(fanNumber: number, fanTemperatureCelcius: ObjWrapper<number>): boolean;
+    /**
+     * Get the current sampling intervals and wakeups of the last minute
+     */
+    getSamplerStats(): SamplerStats;
+    /**
+     * Step each fan across its range, follow the speed the EC reports and
+     * measure dead time, settling rate, minimum speed and quantization. Takes
+     * minutes on real fans, nothing else may drive the fans meanwhile. Stops
+     * once a fan sensor reaches maxTemperature, the fans are set to auto
+     * afterwards, also if the calibration failed.
+     */
+    calibrateFans(options?: FanCalibrationOptions): Promise<FanCalibrationResult>;
+    /**
+     * Start one long-lived nvidia-smi --loop-ms child whose CSV output is
+     * parsed on a native thread. The child is restarted when it exits.
+     * @param fields nvidia-smi --query-gpu field names, e.g. power.draw
+     * @param executable Defaults to nvidia-smi from PATH
+     * @returns True if the child was started, false if already running or not startable
+     */
+    startGpuQuery(fields: string[], loopMs: number, executable?: string): boolean;
+    /**
+     * Stop the GPU query and its child
+     */
+    stopGpuQuery(): void;
+    /**
+     * Get the latest values per GPU without starting a process. Values not
+     * available are -1.
+     * @returns True if the query is running, false otherwise
+     */
+    getGpuQuerySnapshot(snapshot: GpuQuerySnapshot): boolean;
+    /**
+     * Wait on the thread pool for a sample newer than afterSequence, keep
+     * timeouts short
+     * @returns Resolves true on a new sample, false on timeout or if the query is not running
+     */
+    waitGpuQuerySample(afterSequence: number, timeoutMs: number): Promise<boolean>;
+    /**
+     * Run nvidia-smi once on the thread pool, independent of startGpuQuery,
+     * for values needed once like the power limits
+     * @param executable Defaults to nvidia-smi from PATH
+     * @returns Resolves the values, null if nvidia-smi failed or timed out
+     */
+    queryGpuOnce(fields: string[], timeoutMs: number, executable?: string): Promise<GpuQuerySnapshot | null>;
     /**
      * Set webcam switch
      * @returns True if call succeeded, false otherwise
@@ -86,6 +200,97 @@ interface ITuxedoIOAPI {
      * @returns True if call succeeded, false otherwise
      */
     getWebcamStatus(status: ObjWrapper<boolean>): boolean;
+    /**
+     * Get the video capture devices with their "vendor_id:product_id", one
+     * device node per camera
+     * @param ignoreGrey Leave out cameras only delivering grey frames (IR), default true
+     */
+    getWebcamDevices(ignoreGrey?: boolean): Record<string, string>;
+    /**
+     * Get the V4L2 controls of a video device with their current values.
+     * Controls and menus are queried once per device and cached.
+     * @returns True if call succeeded, false otherwise
+     */
+    getV4l2Controls(devicePath: string, controls: V4l2Control[]): boolean;
+    /**
+     * Set V4L2 controls by text id (e.g. brightness=128, auto_exposure=manual_mode)
+     * in one batch
+     * @returns True if every control was applied, false otherwise
+     */
+    setV4l2Controls(devicePath: string, controls: Record<string, string | number | boolean>, result?: V4l2ApplyResult): boolean;
+    /**
+     * Answer getV4l2Controls and setV4l2Controls for devicePath from a
+     * simulated camera instead of the device file, for tests. Replaces the
+     * camera simulated there before like a replug.
+     */
+    simulateV4l2Camera(devicePath: string, camera?: V4l2SimulatedCamera): void;
+    /**
+     * Remove all simulated cameras and forget their cached controls
+     */
+    stopV4l2Simulation(): void;
+    /**
+     * Get how often the controls of the simulated camera were enumerated,
+     * -1 if none is simulated at devicePath
+     */
+    getV4l2SimulationEnumerations(devicePath: string): number;
+    /**
+     * Keep the multi_intensity and brightness files of the keyboard LEDs open
+     * for frame writes, replaces previously opened LEDs
+     * @param ledPaths LED class directories (rgb:kbd_backlight*) in frame order
+     * @returns True if all LEDs were opened, false otherwise
+     */
+    openKeyboardLeds(ledPaths: string[]): boolean;
+    /**
+     * Stop a running animation and close the keyboard LEDs
+     */
+    closeKeyboardLeds(): void;
+    /**
+     * Write one frame, only LEDs that changed since the previous frame are
+     * written. Stops a running animation.
+     * @param rgb Three bytes per LED, zone or key
+     * @param brightness Also set the LED brightness, unless negative
+     * @returns Number of LEDs written, -1 if no LEDs are open
+     */
+    writeKeyboardFrame(rgb: Uint8Array, brightness?: number): number;
+    /**
+     * Write every LED with the next frame, after the LEDs were changed
+     * through sysfs by someone else
+     */
+    invalidateKeyboardFrame(): void;
+    /**
+     * Run an effect on a native timer, replaces a running one
+     * @returns True if started, false if no LEDs are open or the options are invalid
+     */
+    startKeyboardAnimation(options: KeyboardAnimationOptions): boolean;
+    stopKeyboardAnimation(): void;
+    getKeyboardLedStats(): KeyboardLedStats;
+    /**
+     * Logged in users from utmp and the systemd-logind session files, read
+     * without spawning w or loginctl. Both sources are watched with inotify
+     * and only reread after a change.
+     * @param sources Defaults to the system utmp and /run/systemd/sessions
+     * @returns True if at least one source could be read, false otherwise
+     */
+    getLoginSessions(snapshot: LoginSessions, sources?: LoginSessionSources): boolean;
+    /**
+     * Cached cpufreq and hotplug state. Limits and available values are read
+     * once, the scaling values per cpufreq policy and the online list on
+     * every call.
+     * @param sysfsRoot Defaults to /sys/devices/system/cpu
+     * @returns True if cpufreq policies were found, false otherwise
+     */
+    getCpuPolicyState(state: CpuPolicyState, sysfsRoot?: string): boolean;
+    /**
+     * Apply per core values, only attributes that differ from the cached
+     * state are written, the policies in parallel. Cores go online first
+     * and offline last.
+     */
+    applyCpuPolicy(target: CpuPolicyTarget, sysfsRoot?: string): Promise<CpuPolicyApplyResult>;
+    /**
+     * Compare the applied values with the current ones, drift are values
+     * changed outside of applyCpuPolicy
+     */
+    checkCpuPolicy(sysfsRoot?: string): CpuPolicyCheckResult;
     /**
      * Get names of output ports
      * @returns Array of output port names
@@ -117,6 +322,228 @@ interface ITuxedoIOAPI {
      *  @returns True if call succeeded, false otherwise
      */
     setTDPValues(tdpValues: number[]): boolean;
+    /**
+     *  Apply ODM profile, TDP values, fan mode and fan speeds in one
+     *  ordered sequence off the main thread. Steps whose target is already
+     *  active are skipped.
+     *  @returns Promise resolving to the per step results and timings
+     */
+    applyProfile(profile: ProfileApplyRequest): Promise<ProfileApplyResult>;
+    /**
+     *  Start watching for system resume. On resume the last applied state of
+     *  all setters is written back to the hardware before the callback is run.
+     *  @returns True if the watch was started, false otherwise
+     */
+    startResumeWatch(onResume?: (stats: ResumeStats) => void): boolean;
+    /**
+     *  Stop watching for system resume
+     */
+    stopResumeWatch(): void;
+    /**
+     *  Get statistics of the last state restore on resume
+     */
+    getResumeStats(): ResumeStats;
+    /**
+     *  Write the last applied state of all setters back to the hardware
+     *  @returns True if all writes succeeded, false otherwise
+     */
+    restoreDeviceState(): boolean;
+    /**
+     *  Serve the latest sampled hardware values and IO statistics in
+     *  Prometheus/OpenMetrics text format from a native thread
+     *  @param address Unix socket path or port number on localhost
+     *  @returns True if the server was started, false otherwise
+     */
+    startMetricsServer(address: string): boolean;
+    /**
+     *  Stop the metrics server
+     */
+    stopMetricsServer(): void;
+    /**
+     *  Mirror the telemetry snapshot into a shared memory segment under
+     *  /dev/shm on every update (daemon side)
+     *  @param name Segment name, defaults to /tcc-telemetry
+     *  @returns True if the segment was created, false otherwise
+     */
+    publishTelemetry(name?: string): boolean;
+    /**
+     *  Stop mirroring and remove the shared memory segment
+     */
+    unpublishTelemetry(): void;
+    /**
+     *  Map the shared memory telemetry segment read only (GUI side)
+     *  @param name Segment name, defaults to /tcc-telemetry
+     *  @returns True if a compatible segment was mapped, false otherwise
+     */
+    openTelemetry(name?: string): boolean;
+    /**
+     *  Copy the latest published telemetry without any IPC round trip
+     *  @returns True if a consistent snapshot was read, false otherwise
+     */
+    readTelemetry(snapshot: TelemetrySnapshot): boolean;
+    /**
+     *  Unmap the shared memory telemetry segment
+     */
+    closeTelemetry(): void;
+    /**
+     *  Copy the latest telemetry of this process (sampled values and scheduler reads)
+     */
+    getTelemetry(snapshot: TelemetrySnapshot): void;
+    /**
+     *  Record fan, temperature, TDP and ODM profile history to a preallocated
+     *  ring file, the oldest records are overwritten once it is full
+     *  @param intervalMs Sampling interval, default 5000
+     *  @param maxBytes File size cap, default 8 MiB (about a week at 5 s)
+     *  @returns True if recording started, false otherwise
+     */
+    startTelemetryJournal(path: string, intervalMs?: number, maxBytes?: number): boolean;
+    /**
+     *  Stop recording and close the journal file
+     */
+    stopTelemetryJournal(): void;
+    /**
+     *  Map a journal recorded by another process (tccd) read only for queries
+     */
+    openTelemetryJournal(path: string): boolean;
+    /**
+     *  Unmap the journal opened for queries
+     */
+    closeTelemetryJournal(): void;
+    /**
+     *  Aggregate a journal channel over equally sized buckets of [fromMs, toMs)
+     *  (wall clock ms)
+     *  @param index Fan number for 'temperature' and 'fanSpeed', TDP index for 'tdp'
+     *  @returns min, max and average per bucket (3 * buckets values), NaN for
+     *  buckets without samples
+     */
+    queryTelemetryJournal(
+        channel: 'temperature' | 'fanSpeed' | 'tdp',
+        index: number,
+        fromMs: number,
+        toMs: number,
+        buckets: number,
+    ): Float64Array;
+    /**
+     *  ODM profile changes in [fromMs, toMs), the first entry is the profile
+     *  active at fromMs if known
+     */
+    getTelemetryJournalProfiles(fromMs: number, toMs: number): Array<{ timeMs: number; profile: string }>;
+    /**
+     *  Add a periodic job to the native scheduler. Deadlines are aligned to
+     *  multiples of the period and may be delayed by up to slackMs to share
+     *  a wakeup with other jobs
+     *  @param hardwareReads Reads done natively in the wakeup batch before
+     *  dispatch, results end up in the telemetry ('webcam', 'temperatures',
+     *  'fanSpeeds', 'tdp')
+     *  @returns Job id, -1 if the parameters are invalid
+     */
+    addScheduledJob(name: string, periodMs: number, slackMs: number, hardwareReads?: string[]): number;
+    /**
+     *  Replace the hardware reads of a job, e.g. once tuxedo-io appeared
+     *  @returns False if the job does not exist
+     */
+    setScheduledJobReads(jobId: number, hardwareReads: string[]): boolean;
+    /**
+     *  Remove a job from the native scheduler
+     */
+    removeScheduledJob(jobId: number): boolean;
+    /**
+     *  Report the dispatched work of a job as finished, the job is not
+     *  dispatched again before
+     */
+    completeScheduledJob(jobId: number): void;
+    /**
+     *  Start the scheduler thread. The callback gets the ids of all jobs
+     *  due in one wakeup
+     *  @returns True if the scheduler was started, false otherwise
+     */
+    startScheduler(onJobsDue: (jobIds: number[]) => void): boolean;
+    /**
+     *  Stop the scheduler thread
+     */
+    stopScheduler(): void;
+    /**
+     *  Get wakeup count and per job runtime and lateness statistics
+     */
+    getSchedulerStats(): SchedulerStats;
+    /**
+     *  Ping the event loop from a native thread every intervalMs and record
+     *  how late it answers. Runs of scheduled jobs and the fan calls made
+     *  during them are recorded against their deadlines while it runs.
+     *  @returns True if started, false if already running
+     */
+    startLoopMonitor(intervalMs: number): boolean;
+    stopLoopMonitor(): void;
+    /**
+     *  Record a GC pause, e.g. from a perf_hooks 'gc' entry
+     *  @param kind PerformanceEntry.detail.kind flags
+     */
+    recordGcPause(kind: number, durationMs: number): void;
+    /**
+     *  Record the start of a worker run not dispatched by the native
+     *  scheduler, runs later than slackMs count as missed
+     */
+    beginWorkerRun(name: string, latenessMs: number, slackMs: number): void;
+    endWorkerRun(name: string): void;
+    /**
+     *  Get loop lag, GC pause, fan call and per worker deadline histograms
+     */
+    getLoopMonitorStats(): LoopMonitorStats;
+    resetLoopMonitor(): void;
+    /**
+     *  Record every ioctl (request, argument in and out, errno, timestamp)
+     *  to a binary trace file
+     *  @returns True if recording started, false otherwise
+     */
+    startIoctlTrace(path: string): boolean;
+    /**
+     *  Stop recording and flush the trace file
+     *  @returns Number of recorded ioctls
+     */
+    stopIoctlTrace(): number;
+    /**
+     *  Serve all devices opened afterwards from a recorded trace instead of
+     *  /dev/tuxedo_io
+     *  @param realtime Answer at the recorded timing instead of as fast as possible
+     *  @returns True if the trace was loaded, false otherwise
+     */
+    startIoctlReplay(path: string, realtime?: boolean): boolean;
+    /**
+     *  Open devices from /dev/tuxedo_io again
+     */
+    stopIoctlReplay(): void;
+    /**
+     *  Get statistics of the active replay, null if none is active
+     */
+    getIoctlReplayStats(): IoctlReplayStats;
+    /**
+     *  Serve all devices opened afterwards from a simulated tuxedo_io module
+     *  instead of /dev/tuxedo_io, for tests and benchmarks
+     */
+    startIoctlSimulation(options?: IoctlSimulationOptions): boolean;
+    /**
+     *  Open devices from /dev/tuxedo_io again
+     */
+    stopIoctlSimulation(): void;
+    /**
+     *  Set the temperature the simulated module reports for a fan
+     */
+    setSimulatedTemperature(fanNumber: number, temperatureCelcius: number): void;
+    /**
+     *  Get call counters of the active simulation, null if none is active
+     */
+    getIoctlSimulationStats(): IoctlSimulationStats;
+    /**
+     *  Take the temperature and fan speed changes of the active simulation
+     *  since the last call, null if none is active
+     */
+    takeSimulationEvents(): SimulationEvents;
+    /**
+     *  Issue fan calls from one native thread each, started startMs after
+     *  the call, to exercise the ioctl queue with concurrent callers
+     *  @returns Result, value and completion time of every call in order
+     */
+    runConcurrentDeviceCalls(calls: ConcurrentDeviceCall[]): Promise<ConcurrentDeviceCallResult[]>;
 }
 
 export class ModuleInfo {
@@ -132,6 +559,443 @@ export class TDPInfo {
     descriptor: string;
 }
 
+export class V4l2Control {
+    id: number;
+    name: string;
+    textId: string;
+    type: 'integer' | 'boolean' | 'menu' | 'button';
+    minimum: number;
+    maximum: number;
+    step: number;
+    default: number;
+    // Missing for write only controls and buttons
+    value?: number;
+    inactive: boolean;
+    menu: { index: number; textId: string; name: string }[];
+}
+
+export class V4l2ApplyResult {
+    applied: string[];
+    unknown: string[];
+    failed: string[];
+}
+
+export class V4l2SimulatedCamera {
+    card?: string;
+    busInfo?: string;
+    // Text ids of the offered controls (brightness, white_balance_automatic,
+    // white_balance_temperature, power_line_frequency), all by default
+    controls?: string[];
+}
+
+export class ProfileApplyRequest {
+    odmProfile?: string;
+    tdpValues?: number[];
+    fanMode?: 'auto' | 'manual';
+    // Per fan in percent as decided by the fan control logic, -1 leaves the fan alone
+    fanSpeeds?: number[];
+}
+
+export class ProfileApplyStep {
+    name: string;
+    skipped: boolean;
+    success: boolean;
+    durationUs: number;
+}
+
+export class ProfileApplyResult {
+    success: boolean;
+    durationUs: number;
+    steps: ProfileApplyStep[];
+}
+
+export class ResumeStats {
+    resumeCount: number;
+    suspendedMs: number;
+    restoreSuccess: boolean;
+    restoreDurationUs: number;
+    fanStateUs: number;
+}
+
+export class IoctlBreakerEntry {
+    request: number;
+    permanent: boolean;
+    errno: number;
+    failures: number;
+    retryInMs: number;
+}
+
+export class SamplerStats {
+    running: boolean;
+    wakeupsPerMinute: number;
+    sensors: {
+        fanNumber: number;
+        temperature: number;
+        slope: number;
+        intervalMs: number;
+        breakpointDistance: number;
+    }[];
+}
+
+export class FanCalibrationOptions {
+    // All fans by default
+    fans?: number[];
+    // Commanded speeds of the sweeps are this far apart, defaults to 10
+    stepPercent?: number;
+    // Read-back poll period, defaults to 50
+    pollIntervalMs?: number;
+    // Unchanged read-back time that counts as settled, longer than the EC dead time, defaults to 1000
+    stableMs?: number;
+    // Per commanded speed, defaults to 15000
+    timeoutMs?: number;
+    // Range of the 1 percent sweep for the quantization, defaults to 20
+    quantizationWindowPercent?: number;
+    // Calibration stops once the hottest fan sensor reaches this, defaults to 90
+    maxTemperature?: number;
+}
+
+export class FanActuatorCharacteristics {
+    fan: number;
+    offAvailable: boolean;
+    // Lowest commanded speed that starts the fan from standstill, -1 if it never turned
+    minimumPercent: number;
+    // Commanded change it takes to move the read-back
+    quantizationPercent: number;
+    // Time until the read-back follows a write
+    latencyMs: number;
+    // Time per percent of read-back change after the latency
+    settlingMsPerPercent: number;
+    // Sweep up from standstill, then down again
+    steps: {
+        commanded: number;
+        readBack: number;
+        // -1 if the read-back did not change
+        latencyMs: number;
+        settlingMs: number;
+        settled: boolean;
+    }[];
+}
+
+export class FanCalibrationResult {
+    interfaceId: string;
+    // Empty on devices without model id
+    modelId: string;
+    durationMs: number;
+    fans: FanActuatorCharacteristics[];
+}
+
+export class KeyboardAnimationOptions {
+    effect: 'breathe' | 'wave' | 'temperature';
+    // 1 to 60, defaults to 30
+    fps?: number;
+    // Breathe cycle or wave travel time, defaults to 4000
+    periodMs?: number;
+    // Breathe: flat RGB per LED, repeated. Temperature: cold RGB followed by hot RGB.
+    colors?: number[];
+    // Temperature effect sensor and range, defaults to fan 0 and 40 to 90 °C
+    fanNumber?: number;
+    minTemperature?: number;
+    maxTemperature?: number;
+}
+
+export class KeyboardLedStats {
+    leds: number;
+    animating: boolean;
+    animationFrames: number;
+    frames: number;
+    ledWrites: number;
+    ledsSkipped: number;
+    errors: number;
+}
+
+export class LoginSessionSources {
+    utmpPath?: string;
+    sessionsDir?: string;
+}
+
+export class LoginSessions {
+    // Without watches the sources are reread on every call
+    watching: boolean;
+    reloads: number;
+    lastReloadUs: number;
+    // logind sessions ordered by id
+    sessions: {
+        id: string;
+        user: string;
+        uid: number;
+        seat: string;
+        tty: string;
+        display: string;
+        // x11, wayland, tty, mir or unspecified
+        type: string;
+        // user, greeter, lock-screen or background
+        class: string;
+        // online, active or closing
+        state: string;
+        service: string;
+        desktop: string;
+        remoteHost: string;
+        active: boolean;
+        remote: boolean;
+        vtnr: number;
+        leader: number;
+    }[];
+    // utmp USER_PROCESS entries in file order
+    logins: {
+        user: string;
+        line: string;
+        host: string;
+        pid: number;
+        loginTimeMs: number;
+    }[];
+}
+
+export class CpuPolicyState {
+    present: number[];
+    online: number[];
+    // null if not available
+    boost: boolean | null;
+    noTurbo: boolean | null;
+    policies: {
+        id: number;
+        cpus: number[];
+        driver: string;
+        availableGovernors: string[];
+        availableEnergyPerformancePreferences: string[];
+        availableFrequencies: number[];
+        cpuinfoMinFrequency: number;
+        cpuinfoMaxFrequency: number;
+        // At least one cpu online, the scaling values are empty or -1 otherwise
+        active: boolean;
+        governor: string;
+        energyPerformancePreference: string;
+        scalingMinFrequency: number;
+        scalingMaxFrequency: number;
+    }[];
+}
+
+/**
+ * Cores of one policy share the scaling values, the first core setting a
+ * value wins. Missing values are left alone.
+ */
+export class CpuPolicyTarget {
+    cores: {
+        cpu: number;
+        online?: boolean;
+        governor?: string;
+        energyPerformancePreference?: string;
+        scalingMinFrequency?: number;
+        scalingMaxFrequency?: number;
+    }[];
+    boost?: boolean;
+    noTurbo?: boolean;
+}
+
+export class CpuPolicyDeviation {
+    // Relative to the sysfs root, e.g. cpufreq/policy3/scaling_governor
+    path: string;
+    expected: string;
+    actual: string;
+    // errno of a failed write, 0 for drift
+    error: number;
+}
+
+export class CpuPolicyApplyResult {
+    writes: number;
+    unchanged: number;
+    reads: number;
+    failed: CpuPolicyDeviation[];
+    durationUs: number;
+}
+
+export class CpuPolicyCheckResult {
+    drift: CpuPolicyDeviation[];
+    reads: number;
+    durationUs: number;
+}
+
+export class GpuQuerySnapshot {
+    sequence: number;
+    restarts: number;
+    childRunning: boolean;
+    gpus: {
+        index: number;
+        ageMs: number;
+        values: { [field: string]: number };
+    }[];
+}
+
+export class LatencyHistogram {
+    count: number;
+    avgMs: number;
+    // Upper bounds of the buckets holding the quantiles
+    p50Ms: number;
+    p99Ms: number;
+    maxMs: number;
+    // Counts per bucket of LoopMonitorStats.bucketBoundsMs, the last one is unbounded
+    buckets: number[];
+}
+
+export class LoopMonitorStats {
+    running: boolean;
+    intervalMs: number;
+    bucketBoundsMs: number[];
+    // Pings not sent while the previous one was unanswered
+    skippedPings: number;
+    loopLag: LatencyHistogram;
+    gcPause: LatencyHistogram;
+    gcPauses: { minor: number; major: number; incremental: number; weakCallbacks: number };
+    fanCalls: LatencyHistogram;
+    workers: {
+        name: string;
+        runs: number;
+        // Runs started later than their slack
+        missed: number;
+        inProgress: boolean;
+        lateness: LatencyHistogram;
+        runtime: LatencyHistogram;
+        // Fan calls during the runs relative to their deadline
+        fanCallLateness: LatencyHistogram;
+    }[];
+}
+
+export class SchedulerStats {
+    running: boolean;
+    wakeups: number;
+    jobs: {
+        id: number;
+        name: string;
+        periodMs: number;
+        slackMs: number;
+        runs: number;
+        overruns: number;
+        lastRuntimeMs: number;
+        maxRuntimeMs: number;
+        avgRuntimeMs: number;
+        lastLatenessMs: number;
+        maxLatenessMs: number;
+        avgLatenessMs: number;
+    }[];
+}
+
+export class TelemetrySnapshot {
+    sequence: number;
+    updatedNs: number;
+    interface: string;
+    model: string;
+    odmProfile: string;
+    fansMinSpeed: number;
+    fansOffAvailable: boolean;
+    webcamStatus: number;
+    fans: { temperature: number; speedPercent: number; temperatureUpdatedNs: number; speedUpdatedNs: number }[];
+    tdps: { descriptor: string; min: number; max: number; current: number }[];
+    ioctlCalls: number;
+    ioctlErrors: number;
+}
+
+export class IoctlQueueStats {
+    depth: number;
+    maxDepth: number;
+    executed: number;
+    coalesced: number;
+    superseded: number;
+    priorities: Record<'high' | 'normal' | 'low', { submitted: number; avgWaitUs: number; maxWaitUs: number }>;
+}
+
+export class DeviceSessionStats {
+    users: number;
+    opens: number;
+    acquisitions: number;
+    contended: number;
+}
+
+export class DevicePresenceEvent {
+    present: boolean;
+    // Device opened and an interface identified
+    available: boolean;
+    interface: string;
+    model: string;
+    identifyUs: number;
+}
+
+export class DeviceWatchState {
+    running: boolean;
+    present: boolean;
+    available: boolean;
+    appearances: number;
+    disappearances: number;
+}
+
+export class IoctlReplayStats {
+    records: number;
+    served: number;
+    missing: number;
+    diverged: number;
+    repeated: number;
+}
+
+export class DeviceStatus {
+    fans: Array<{ speedPercent: number; temperature: number }>;
+    tdps: Array<{ min: number; max: number; current: number }>;
+}
+
+export class IoctlSimulationOptions {
+    interface?: 'clevo' | 'uniwill';
+    batchSupport?: boolean;
+    // errno the advertised batch ioctl fails with as a whole
+    batchError?: number;
+    moduleVersion?: string;
+    transitionLatencyUs?: number;
+    registerLatencyUs?: number;
+    // Fan actuator, fans follow writes at once by default
+    fanDeadTimeMs?: number;
+    fanSlewPercentPerSecond?: number;
+    // Lower non-zero speeds stop the fan
+    fanMinimumPercent?: number;
+    // The EC drives the fan in steps of this size
+    fanStepPercent?: number;
+}
+
+export class IoctlSimulationStats {
+    transitions: number;
+    batchCalls: number;
+    registerAccesses: number;
+    // Fans driven by the EC, not by speed writes
+    fansAuto: boolean;
+}
+
+export class SimulationEvent {
+    // Since simulation start
+    timeMs: number;
+    type: 'temperature' | 'speed';
+    fan: number;
+    // Celsius or percent
+    value: number;
+}
+
+export class SimulationEvents {
+    events: SimulationEvent[];
+    // Changes lost because the simulation log was full
+    dropped: number;
+}
+
+export class ConcurrentDeviceCall {
+    call: 'getFanSpeed' | 'getFanTemperature' | 'setFanSpeed';
+    fan: number;
+    // Percent written by setFanSpeed
+    value?: number;
+    startMs?: number;
+    // Queue priority class, picked from the kind of call by default
+    priority?: 'high' | 'normal' | 'low';
+}
+
+export class ConcurrentDeviceCallResult {
+    result: boolean;
+    value: number;
+    // Since the calls were started
+    finishedMs: number;
+}
+
 export class ObjWrapper<T> {
     value: T;
 }
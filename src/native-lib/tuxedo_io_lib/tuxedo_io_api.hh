@@ -25,57 +25,302 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <algorithm>
 #include <cmath>
+#include <errno.h>
+#include <time.h>
+#include <atomic>
+#include <sys/stat.h>
 #include "tuxedo_io_ioctl.h"
+#include "tuxedo_io_backend.hh"
+#include "tuxedo_io_breaker.hh"
+#include "tuxedo_io_probes.hh"
+#include "tuxedo_io_queue.hh"
+#include "tuxedo_io_trace.hh"
+
+/**
+ * Process wide ioctl counters, updated lock free by every IO instance
+ */
+struct IOStatistics {
+    std::atomic<uint64_t> calls { 0 };
+    std::atomic<uint64_t> errors { 0 };
+    std::atomic<uint64_t> shortCircuited { 0 };
+    std::atomic<uint64_t> durationNs { 0 };
+
+    static IOStatistics &Default() {
+        static IOStatistics statistics;
+        return statistics;
+    }
+};
+
+/**
+ * One register of a batched access, error is the errno of the register
+ */
+struct IoctlRegister {
+    unsigned long request;
+    int value;
+    int error;
+};
 
 class IO {
 public:
-    IO(const char *file) {
+    IO(const char *file, IoctlBreaker &breaker = IoctlBreaker::Default(), IoctlQueue &queue = IoctlQueue::Default())
+        : breaker(breaker), queue(queue) {
         OpenDevice(file);
     }
 
+    /**
+     * Serve all calls from a backend (recorded trace, simulation) instead of a device file
+     */
+    IO(std::shared_ptr<IoctlBackend> backend) : breaker(backend->Breaker()), queue(IoctlQueue::Default()), backend(backend) { }
+
     ~IO() {
         CloseDevice();
     }
 
     bool IOAvailable() {
-        return _fileHandle >= 0;
+        return _fileHandle >= 0 || backend != nullptr;
+    }
+
+    /**
+     * errno of the last call on this thread, 0 if it succeeded
+     */
+    static int LastError() {
+        return lastError;
+    }
+
+    static bool SetLastError(int error) {
+        lastError = error;
+        return error == 0;
     }
 
     bool IoctlCall(unsigned long request) {
-        if (!IOAvailable()) return false;
-        int result = ioctl(_fileHandle, request);
-        return result >= 0;
+        if (!CallAllowed(request)) return false;
+        IoctlQueue::Result result = Submit(request, nullptr, 0);
+        Trace(request, nullptr, 0, nullptr, 0, result);
+        return CallDone(request, result);
     }
 
     bool IoctlCall(unsigned long request, int &argument) {
-        if (!IOAvailable()) return false;
-        int result = ioctl(_fileHandle, request, &argument);
-        return result >= 0;
+        if (!CallAllowed(request, argument)) return false;
+        int in = argument;
+        IoctlQueue::Result result = Submit(request, &argument, sizeof(argument));
+        // Reads ignore the input, writes do not change the argument
+        size_t inSize = _IOC_DIR(request) == _IOC_READ ? 0 : sizeof(in);
+        size_t outSize = KindOf(request) == IoctlKind::Write ? 0 : sizeof(argument);
+        Trace(request, &in, inSize, &argument, outSize, result);
+        return CallDone(request, result, argument);
     }
 
     bool IoctlCall(unsigned long request, std::string &argument, size_t buffer_length) {
-        if (!IOAvailable()) return false;
-        char *buffer = new char[buffer_length];
-        int result = ioctl(_fileHandle, request, buffer);
+        if (!CallAllowed(request)) return false;
+        std::vector<char> buffer(buffer_length, '\0');
+        IoctlQueue::Result result = Submit(request, buffer.data(), buffer_length);
+        buffer[buffer_length - 1] = '\0';
         argument.clear();
-        argument.append(buffer);
-        delete[] buffer;
-        return result >= 0;
+        argument.append(buffer.data());
+        Trace(request, nullptr, 0, argument.c_str(), argument.size() + 1, result);
+        return CallDone(request, result);
+    }
+
+    /**
+     * Access several registers of one interface with as few transitions as
+     * possible. Uses the batch ioctl if the module supports it, else one
+     * call per register.
+     * @param batchRequest Batch ioctl of the interface the registers belong to
+     * @returns True if every register succeeded, LastError() is the first error
+     */
+    bool IoctlBatch(unsigned long batchRequest, std::vector<IoctlRegister> &registers) {
+        if (!BatchSupported()) {
+            return IoctlEach(registers);
+        }
+
+        // Registers with an open breaker are answered without the driver, like single calls
+        std::vector<IoctlRegister *> pending;
+        for (IoctlRegister &reg : registers) {
+            reg.error = 0;
+            if (!breaker.Allow(reg.request, reg.error)) {
+                IOStatistics::Default().shortCircuited.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                pending.push_back(&reg);
+            }
+        }
+
+        for (size_t offset = 0; offset < pending.size(); offset += TUXEDO_IO_BATCH_MAX) {
+            size_t count = std::min<size_t>(TUXEDO_IO_BATCH_MAX, pending.size() - offset);
+            struct tuxedo_io_batch batch = {};
+            batch.count = count;
+            for (size_t i = 0; i < count; ++i) {
+                batch.entries[i].request = (uint32_t) pending[offset + i]->request;
+                batch.entries[i].value = pending[offset + i]->value;
+            }
+
+            int error = 0;
+            bool allowed = CallAllowed(batchRequest, count);
+            if (allowed) {
+                struct tuxedo_io_batch in = batch;
+                IoctlQueue::Result result = Submit(batchRequest, &batch, sizeof(batch));
+                Trace(batchRequest, &in, sizeof(in), &batch, sizeof(batch), result);
+                CallDone(batchRequest, result, count);
+                error = result.error;
+            } else {
+                error = LastError();
+            }
+            if (!allowed || error == EINVAL || IoctlBreaker::IsPermanent(batchRequest, error)) {
+                // Advertised but not implemented or rejected for this interface, fall back for good
+                batchSupport = 0;
+                std::vector<IoctlRegister> rest;
+                for (size_t i = offset; i < pending.size(); ++i) { rest.push_back(*pending[i]); }
+                IoctlEach(rest);
+                for (size_t i = offset; i < pending.size(); ++i) { *pending[i] = rest[i - offset]; }
+                break;
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                IoctlRegister &reg = *pending[offset + i];
+                if (error != 0) {
+                    reg.error = error;
+                    continue;
+                }
+                reg.error = batch.entries[i].error;
+                if (reg.error == 0) {
+                    reg.value = batch.entries[i].value;
+                }
+                breaker.Report(reg.request, reg.error);
+            }
+        }
+
+        for (const IoctlRegister &reg : registers) {
+            if (reg.error != 0) { return SetLastError(reg.error); }
+        }
+        return SetLastError(0);
     }
 
 private:
     int _fileHandle = -1;
+    uint64_t _device = 0;
+    IoctlBreaker &breaker;
+    IoctlQueue &queue;
+    std::shared_ptr<IoctlBackend> backend;
+    // -1 until the module was asked, holders of a shared session may ask at once
+    std::atomic<int> batchSupport { -1 };
+    static thread_local int lastError;
+
+    bool BatchSupported() {
+        if (batchSupport < 0) {
+            // Modules before 0.3.0 answer ENOTTY, remembered by the breaker from then on
+            int capabilities = 0;
+            batchSupport = IoctlCall(R_MOD_CAPABILITIES, capabilities) && (capabilities & MOD_CAP_BATCH) ? 1 : 0;
+        }
+        return batchSupport == 1;
+    }
+
+    bool IoctlEach(std::vector<IoctlRegister> &registers) {
+        int firstError = 0;
+        for (IoctlRegister &reg : registers) {
+            reg.error = IoctlCall(reg.request, reg.value) ? 0 : LastError();
+            if (firstError == 0) { firstError = reg.error; }
+        }
+        return SetLastError(firstError);
+    }
+
+    static IoctlKind KindOf(unsigned long request) {
+        if (_IOC_DIR(request) == _IOC_READ) {
+            return IoctlKind::Read;
+        }
+        // Only the write groups address registers, R_TF_BC is a read with input
+        bool writeGroup = _IOC_TYPE(request) == (MAGIC_WRITE_CL) || _IOC_TYPE(request) == (MAGIC_WRITE_UW);
+        if (writeGroup && (_IOC_DIR(request) == _IOC_WRITE || _IOC_DIR(request) == _IOC_NONE)) {
+            return IoctlKind::Write;
+        }
+        return IoctlKind::Other;
+    }
+
+    IoctlQueue::Result Submit(unsigned long request, void *argument, size_t argumentSize) {
+        if (backend != nullptr) {
+            // The backend instance stands in for the device identity
+            return queue.Submit(-1, (uint64_t) (uintptr_t) backend.get(), request, KindOf(request), argument, argumentSize, IoctlPriority::Auto, backend.get());
+        }
+        return queue.Submit(_fileHandle, _device, request, KindOf(request), argument, argumentSize, IoctlPriority::Auto);
+    }
+
+    /**
+     * @param value Argument for the probes, register count for batches
+     */
+    bool CallAllowed(unsigned long request, long value = 0) {
+        TUXEDO_IO_PROBE2(ioctl__entry, request, value);
+        int error = 0;
+        if (!IOAvailable()) {
+            error = ENODEV;
+        } else if (!breaker.Allow(request, error)) {
+            IOStatistics::Default().shortCircuited.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            return true;
+        }
+        // Answered without reaching the driver
+        TUXEDO_IO_PROBE5(ioctl__return, request, value, -1, error, 0);
+        return SetLastError(error);
+    }
+
+    void Trace(unsigned long request, const void *in, size_t inSize, const void *out, size_t outSize, const IoctlQueue::Result &result) {
+        IoctlTraceRecorder &recorder = IoctlTraceRecorder::Default();
+        if (backend == nullptr && recorder.IsRecording()) {
+            recorder.Record(request, in, inSize, out, outSize, result.result, result.error);
+        }
+    }
+
+    bool CallDone(unsigned long request, const IoctlQueue::Result &result, long value = 0) {
+        TUXEDO_IO_PROBE5(ioctl__return, request, value, result.result, result.error, result.durationNs);
+        // Coalesced and superseded calls did not reach the driver themselves,
+        // backend calls only feed the breaker of the backend
+        if (result.executed && backend != nullptr) {
+            breaker.Report(request, result.error);
+        } else if (result.executed) {
+            IOStatistics &statistics = IOStatistics::Default();
+            statistics.calls.fetch_add(1, std::memory_order_relaxed);
+            statistics.durationNs.fetch_add(result.durationNs, std::memory_order_relaxed);
+            if (result.error != 0) {
+                statistics.errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            breaker.Report(request, result.error);
+        }
+        return SetLastError(result.error);
+    }
 
     void OpenDevice(const char *file) {
+        if (file == nullptr) { return; }
         _fileHandle = open(file, O_RDWR);
+        struct stat info;
+        if (_fileHandle >= 0 && fstat(_fileHandle, &info) == 0) {
+            _device = info.st_rdev != 0 ? info.st_rdev : info.st_ino;
+        }
     }
 
     void CloseDevice() {
-        close(_fileHandle);
+        if (_fileHandle >= 0) {
+            close(_fileHandle);
+        }
     }
 };
 
+inline thread_local int IO::lastError = 0;
+
+#define DEVICE_STATUS_MAX_FANS 3
+#define DEVICE_STATUS_MAX_TDPS 3
+
+/**
+ * Fan and TDP state read in one go, -1 for values not available
+ */
+struct DeviceStatus {
+    int nrFans = 0;
+    int fanSpeedPercent[DEVICE_STATUS_MAX_FANS] = { -1, -1, -1 };
+    int fanTemperature[DEVICE_STATUS_MAX_FANS] = { -1, -1, -1 };
+    int nrTDPs = 0;
+    int tdpMin[DEVICE_STATUS_MAX_TDPS] = { -1, -1, -1 };
+    int tdpMax[DEVICE_STATUS_MAX_TDPS] = { -1, -1, -1 };
+    int tdp[DEVICE_STATUS_MAX_TDPS] = { -1, -1, -1 };
+};
+
 class DeviceInterface {
 public:
     DeviceInterface(IO &io) { this->io = &io; }
@@ -104,8 +349,43 @@ public:
     virtual bool SetTDP(const int tdpIndex, const int tdpValue) = 0;
     virtual bool GetTDP(const int tdpIndex, int &tdpValue) = 0;
 
+    /**
+     * Read all fan and TDP values. Interfaces override this to read the
+     * registers with one batched ioctl instead of one call per value.
+     */
+    virtual bool GetStatus(DeviceStatus &status) {
+        status = DeviceStatus();
+        if (!GetNumberFans(status.nrFans)) { return false; }
+        status.nrFans = std::min(status.nrFans, DEVICE_STATUS_MAX_FANS);
+        for (int i = 0; i < status.nrFans; ++i) {
+            if (!GetFanSpeedPercent(i, status.fanSpeedPercent[i])) { status.fanSpeedPercent[i] = -1; }
+            if (!GetFanTemperature(i, status.fanTemperature[i])) { status.fanTemperature[i] = -1; }
+        }
+        if (GetNumberTDPs(status.nrTDPs)) {
+            status.nrTDPs = std::min(status.nrTDPs, DEVICE_STATUS_MAX_TDPS);
+            for (int i = 0; i < status.nrTDPs; ++i) {
+                if (!GetTDPMin(i, status.tdpMin[i])) { status.tdpMin[i] = -1; }
+                if (!GetTDPMax(i, status.tdpMax[i])) { status.tdpMax[i] = -1; }
+                if (!GetTDP(i, status.tdp[i])) { status.tdp[i] = -1; }
+            }
+        } else {
+            status.nrTDPs = 0;
+        }
+        return true;
+    }
+
+    /**
+     * errno of the last failed operation, EOPNOTSUPP for operations the
+     * interface does not implement
+     */
+    virtual int LastError() { return IO::LastError(); }
+
 protected:
     IO *io;
+
+    bool Unsupported() { return IO::SetLastError(EOPNOTSUPP); }
+    bool InvalidArgument() { return IO::SetLastError(EINVAL); }
+    bool NoDevice() { return IO::SetLastError(ENODEV); }
 };
 
 class ClevoDevice : public DeviceInterface {
@@ -124,7 +404,7 @@ public:
     }
 
     virtual bool DeviceModelIdStr(std::string &modelIdStr) {
-        return false;
+        return Unsupported();
     }
 
     virtual bool SetEnableModeSet(bool enabled) {
@@ -161,8 +441,8 @@ public:
         int fanSpeedRaw[3];
         int ret;
 
-        if (fanNr < 0 || fanNr >= 3) { return false; }
-        if (fanSpeedPercent < 0 || fanSpeedPercent > 100) { return false; }
+        if (fanNr < 0 || fanNr >= 3) { return InvalidArgument(); }
+        if (fanSpeedPercent < 0 || fanSpeedPercent > 100) { return InvalidArgument(); }
 
         for (int i = 0; i < 3; ++i) {
             if (i == fanNr) {
@@ -226,6 +506,8 @@ public:
         if (perfProfileExists) {
             int perfProfileArgument = clevoPerformanceProfilesToArgument.at(performanceProfile);
             result = io->IoctlCall(W_CL_PERF_PROFILE, perfProfileArgument);
+        } else {
+            result = InvalidArgument();
         }
         return result;
     }
@@ -235,12 +517,31 @@ public:
         return true;
     }
 
-    virtual bool GetNumberTDPs(int &nrTDPs) { return false; }
-    virtual bool GetTDPDescriptors(std::vector<std::string> &tdpDescriptors) { return false; }
-    virtual bool GetTDPMin(const int tdpIndex, int &minValue) { return false; }
-    virtual bool GetTDPMax(const int tdpIndex, int &maxValue) { return false; }
-    virtual bool SetTDP(const int tdpIndex, int tdpValue) { return false; }
-    virtual bool GetTDP(const int tdpIndex, int &tdpValue) { return false; }
+    virtual bool GetStatus(DeviceStatus &status) {
+        std::vector<IoctlRegister> registers = {
+            { R_CL_FANINFO1, 0, 0 },
+            { R_CL_FANINFO2, 0, 0 },
+            { R_CL_FANINFO3, 0, 0 }
+        };
+        bool result = io->IoctlBatch(RW_CL_BATCH, registers);
+        status = DeviceStatus();
+        status.nrFans = 3;
+        for (int i = 0; i < 3; ++i) {
+            if (registers[i].error != 0) { continue; }
+            int fanInfo = registers[i].value;
+            status.fanSpeedPercent[i] = std::round(((fanInfo & 0xff) / (float) MAX_FAN_SPEED) * 100);
+            int fanTemp2 = (int8_t) ((fanInfo >> 0x10) & 0xff);
+            status.fanTemperature[i] = fanTemp2 <= 1 ? -1 : fanTemp2;
+        }
+        return result;
+    }
+
+    virtual bool GetNumberTDPs(int &nrTDPs) { return Unsupported(); }
+    virtual bool GetTDPDescriptors(std::vector<std::string> &tdpDescriptors) { return Unsupported(); }
+    virtual bool GetTDPMin(const int tdpIndex, int &minValue) { return Unsupported(); }
+    virtual bool GetTDPMax(const int tdpIndex, int &maxValue) { return Unsupported(); }
+    virtual bool SetTDP(const int tdpIndex, int tdpValue) { return Unsupported(); }
+    virtual bool GetTDP(const int tdpIndex, int &tdpValue) { return Unsupported(); }
 
 private:
     const int MAX_FAN_SPEED = 0xff;
@@ -257,7 +558,7 @@ private:
     };
 
     bool GetFanInfo(int fanNr, int &fanInfo) {
-        if (fanNr < 0 || fanNr >= 3) return false;
+        if (fanNr < 0 || fanNr >= 3) return InvalidArgument();
         bool result = false;
         int argument = 0;
         if (fanNr == 0) {
@@ -345,8 +646,7 @@ public:
                 result = io->IoctlCall(W_UW_FANSPEED2, fanSpeedRaw);
                 break;
             default:
-                result = false;
-                break;
+                return InvalidArgument();
         }
 
         return result;
@@ -364,8 +664,7 @@ public:
                 result = io->IoctlCall(R_UW_FANSPEED2, fanSpeedRaw);
                 break;
             default:
-                result = false;
-                break;
+                return InvalidArgument();
         }
 
         fanSpeedPercent = (int) std::round(fanSpeedRaw * 100.0 / MAX_FAN_SPEED);
@@ -385,8 +684,7 @@ public:
                 result = io->IoctlCall(R_UW_FAN_TEMP2, temp);
                 break;
             default:
-                result = false;
-                break;
+                return InvalidArgument();
         }
 
         temperatureCelcius = temp;
@@ -399,12 +697,12 @@ public:
 
     virtual bool SetWebcam(const bool status) {
         // Not implemented
-        return false;
+        return Unsupported();
     }
 
     virtual bool GetWebcam(bool &status) {
         // Not implemented
-        return false;
+        return Unsupported();
     }
 
     virtual bool GetAvailableODMPerformanceProfiles(std::vector<std::string> &profiles) {
@@ -430,6 +728,8 @@ public:
         if (perfProfileExists) {
             int32_t perfProfileArgument = uniwillPerformanceProfilesToArgument.at(performanceProfile);
             result = io->IoctlCall(W_UW_PERF_PROF, perfProfileArgument);
+        } else {
+            result = InvalidArgument();
         }
         return result;
     }
@@ -490,7 +790,7 @@ public:
     virtual bool GetTDPMin(const int tdpIndex, int &minValue) {
         const unsigned long ioctl_tdp_min[] = { R_UW_TDP0_MIN, R_UW_TDP1_MIN, R_UW_TDP2_MIN };
         if (tdpIndex < 0 || tdpIndex > 2) {
-            return -EINVAL;
+            return InvalidArgument();
         }
         return io->IoctlCall(ioctl_tdp_min[tdpIndex], minValue);
     }
@@ -498,7 +798,7 @@ public:
     virtual bool GetTDPMax(const int tdpIndex, int &maxValue) {
         const unsigned long ioctl_tdp_max[] = { R_UW_TDP0_MAX, R_UW_TDP1_MAX, R_UW_TDP2_MAX };
         if (tdpIndex < 0 || tdpIndex > 2) {
-            return -EINVAL;
+            return InvalidArgument();
         }
         return io->IoctlCall(ioctl_tdp_max[tdpIndex], maxValue);
     }
@@ -506,7 +806,7 @@ public:
     virtual bool SetTDP(const int tdpIndex, int tdpValue) {
         const unsigned long ioctl_tdp_set[] = { W_UW_TDP0, W_UW_TDP1, W_UW_TDP2 };
         if (tdpIndex < 0 || tdpIndex > 2) {
-            return -EINVAL;
+            return InvalidArgument();
         }
         return io->IoctlCall(ioctl_tdp_set[tdpIndex], tdpValue);
     }
@@ -514,11 +814,51 @@ public:
     virtual bool GetTDP(const int tdpIndex, int &tdpValue) {
         const unsigned long ioctl_tdp_get[] = { R_UW_TDP0, R_UW_TDP1, R_UW_TDP2 };
         if (tdpIndex < 0 || tdpIndex > 2) {
-            return -EINVAL;
+            return InvalidArgument();
         }
         return io->IoctlCall(ioctl_tdp_get[tdpIndex], tdpValue);
     }
 
+    virtual bool GetStatus(DeviceStatus &status) {
+        // 13 registers, one transition with batch support
+        std::vector<IoctlRegister> registers = {
+            { R_UW_FANSPEED, 0, 0 }, { R_UW_FANSPEED2, 0, 0 },
+            { R_UW_FAN_TEMP, 0, 0 }, { R_UW_FAN_TEMP2, 0, 0 },
+            { R_UW_TDP0_MIN, 0, 0 }, { R_UW_TDP1_MIN, 0, 0 }, { R_UW_TDP2_MIN, 0, 0 },
+            { R_UW_TDP0_MAX, 0, 0 }, { R_UW_TDP1_MAX, 0, 0 }, { R_UW_TDP2_MAX, 0, 0 },
+            { R_UW_TDP0, 0, 0 }, { R_UW_TDP1, 0, 0 }, { R_UW_TDP2, 0, 0 }
+        };
+        io->IoctlBatch(RW_UW_BATCH, registers);
+        status = DeviceStatus();
+        status.nrFans = 2;
+        for (int i = 0; i < 2; ++i) {
+            const IoctlRegister &speed = registers[i];
+            const IoctlRegister &temperature = registers[2 + i];
+            if (speed.error == 0) {
+                status.fanSpeedPercent[i] = (int) std::round(speed.value * 100.0 / MAX_FAN_SPEED);
+            }
+            // Same as GetFanTemperature, 0x00 means no temp/fan
+            if (temperature.error == 0 && temperature.value != 0) {
+                status.fanTemperature[i] = temperature.value;
+            }
+        }
+        for (int i = 2; i >= 0; --i) {
+            // Same rule as GetNumberTDPs
+            const IoctlRegister &minimum = registers[4 + i];
+            if (minimum.error == 0 && minimum.value >= 0) {
+                status.nrTDPs = i + 1;
+                break;
+            }
+        }
+        for (int i = 0; i < status.nrTDPs; ++i) {
+            status.tdpMin[i] = registers[4 + i].error == 0 ? registers[4 + i].value : -1;
+            status.tdpMax[i] = registers[7 + i].error == 0 ? registers[7 + i].value : -1;
+            status.tdp[i] = registers[10 + i].error == 0 ? registers[10 + i].value : -1;
+        }
+        // Single values may fail like the single getters do, the status itself is still valid
+        return IO::SetLastError(0);
+    }
+
 private:
     const int MAX_FAN_SPEED = 0xc8;
     const std::string PERF_PROF_STR_BALANCED = "power_save";
@@ -532,7 +872,7 @@ private:
     };
 
     bool GetFanInfo(int fanNr, int &fanInfo) {
-        if (fanNr < 0 || fanNr >= 3) return false;
+        if (fanNr < 0 || fanNr >= 3) return InvalidArgument();
         bool result = false;
         int argument = 0;
         if (fanNr == 0) {
@@ -554,20 +894,35 @@ private:
 
 class TuxedoIOAPI : public DeviceInterface {
 public:
-    IO io = IO(TUXEDO_IO_DEVICE_FILE);
-
-    TuxedoIOAPI() : DeviceInterface(io) {
+    IO io;
+
+    /**
+     * Opens the device file, or the active backend if one is set
+     */
+    TuxedoIOAPI() : TuxedoIOAPI(IoctlBackend::Active()) { }
+
+    /**
+     * @param file Device file used without backend, nullptr for a device
+     * that is not opened and fails every call with ENODEV
+     */
+    TuxedoIOAPI(std::shared_ptr<IoctlBackend> backend, const char *file = TUXEDO_IO_DEVICE_FILE)
+        : DeviceInterface(io), io(backend != nullptr ? IO(backend) : IO(file)) {
         devices.push_back(new ClevoDevice(io));
         devices.push_back(new UniwillDevice(io));
 
+        TUXEDO_IO_PROBE0(identify__entry);
+        int interfaceIndex = -1;
         for (std::size_t i = 0; i < devices.size(); ++i) {
             bool status, identified;
             status = devices[i]->Identify(identified);
             if (status && identified) {
                 activeInterface = devices[i];
+                interfaceIndex = i;
                 break;
             }
         }
+        TUXEDO_IO_PROBE1(identify__return, interfaceIndex);
+        (void) interfaceIndex;
     }
 
     ~TuxedoIOAPI() {
@@ -593,7 +948,7 @@ public:
         if (activeInterface) {
             return activeInterface->Identify(identified);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -601,7 +956,7 @@ public:
         if (activeInterface) {
             return activeInterface->DeviceInterfaceIdStr(interfaceIdStr);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -609,7 +964,7 @@ public:
         if (activeInterface) {
             return activeInterface->DeviceModelIdStr(modelIdStr);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -617,7 +972,7 @@ public:
         if (activeInterface) {
             return activeInterface->SetEnableModeSet(enabled);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -625,7 +980,7 @@ public:
         if (activeInterface) {
             return activeInterface->GetFansMinSpeed(minSpeed);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -633,7 +988,7 @@ public:
         if (activeInterface) {
             return activeInterface->GetFansOffAvailable(offAvailable);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -641,52 +996,58 @@ public:
         if (activeInterface) {
             return activeInterface->GetNumberFans(nrFans);
         } else {
-            return false;
+            return NoDevice();
         }
     }
     virtual bool SetFansAuto() {
         if (activeInterface) {
             return activeInterface->SetFansAuto();
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
     virtual bool SetFanSpeedPercent(const int fanNr, const int fanSpeedPercent) {
         if (activeInterface) {
-            return activeInterface->SetFanSpeedPercent(fanNr, fanSpeedPercent);
+            bool result = activeInterface->SetFanSpeedPercent(fanNr, fanSpeedPercent);
+            TUXEDO_IO_PROBE3(fan__set, fanNr, fanSpeedPercent, result);
+            return result;
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
     virtual bool GetFanSpeedPercent(const int fanNr, int &fanSpeedPercent) {
         if (activeInterface) {
-            return activeInterface->GetFanSpeedPercent(fanNr, fanSpeedPercent);
+            bool result = activeInterface->GetFanSpeedPercent(fanNr, fanSpeedPercent);
+            TUXEDO_IO_PROBE4(fan__get, fanNr, fanSpeedPercent, -1, result);
+            return result;
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
     virtual bool GetFanTemperature(const int fanNr, int &temperatureCelcius) {
         if (activeInterface) {
-            return activeInterface->GetFanTemperature(fanNr, temperatureCelcius);
+            bool result = activeInterface->GetFanTemperature(fanNr, temperatureCelcius);
+            TUXEDO_IO_PROBE4(fan__get, fanNr, -1, temperatureCelcius, result);
+            return result;
         } else {
-            return false;
+            return NoDevice();
         }
     }
     virtual bool SetWebcam(const bool status) {
         if (activeInterface) {
             return activeInterface->SetWebcam(status);
         } else {
-            return false;
+            return NoDevice();
         }
     }
     virtual bool GetWebcam(bool &status) {
         if (activeInterface) {
             return activeInterface->GetWebcam(status);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -694,7 +1055,7 @@ public:
         if (activeInterface) {
             return activeInterface->GetAvailableODMPerformanceProfiles(profiles);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -702,7 +1063,7 @@ public:
         if (activeInterface) {
             return activeInterface->SetODMPerformanceProfile(performanceProfile);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -710,7 +1071,7 @@ public:
         if (activeInterface) {
             return activeInterface->GetDefaultODMPerformanceProfile(profileName);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -718,7 +1079,7 @@ public:
         if (activeInterface) {
             return activeInterface->GetNumberTDPs(nrTDPs);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -726,7 +1087,7 @@ public:
         if (activeInterface) {
             return activeInterface->GetTDPDescriptors(tdpDescriptors);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -734,7 +1095,7 @@ public:
         if (activeInterface) {
             return activeInterface->GetTDPMin(tdpIndex, minValue);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -742,7 +1103,7 @@ public:
         if (activeInterface) {
             return activeInterface->GetTDPMax(tdpIndex, maxValue);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -750,7 +1111,7 @@ public:
         if (activeInterface) {
             return activeInterface->SetTDP(tdpIndex, tdpValue);
         } else {
-            return false;
+            return NoDevice();
         }
     }
 
@@ -758,7 +1119,19 @@ public:
         if (activeInterface) {
             return activeInterface->GetTDP(tdpIndex, tdpValue);
         } else {
-            return false;
+            return NoDevice();
+        }
+    }
+
+    virtual bool GetStatus(DeviceStatus &status) {
+        if (activeInterface) {
+            bool result = activeInterface->GetStatus(status);
+            for (int i = 0; i < status.nrFans && i < DEVICE_STATUS_MAX_FANS; ++i) {
+                TUXEDO_IO_PROBE4(fan__get, i, status.fanSpeedPercent[i], status.fanTemperature[i], result);
+            }
+            return result;
+        } else {
+            return NoDevice();
         }
     }
 
@@ -0,0 +1,72 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <memory>
+#include <mutex>
+#include "tuxedo_io_breaker.hh"
+
+/**
+ * Answers ioctls in place of /dev/tuxedo_io, e.g. a recorded trace or a
+ * simulated device
+ */
+class IoctlBackend {
+public:
+    virtual ~IoctlBackend() { }
+
+    /**
+     * Answer a call like ioctl() would, argument is updated in place
+     */
+    virtual int Call(unsigned long request, void *argument, size_t argumentSize, int &error) = 0;
+
+    /**
+     * Separate breaker so backend errors never short-circuit the real device
+     */
+    IoctlBreaker &Breaker() {
+        return breaker;
+    }
+
+    /**
+     * Backend used by default constructed TuxedoIOAPI instances instead of
+     * the device file, nullptr for the real device
+     */
+    static std::shared_ptr<IoctlBackend> Active() {
+        std::lock_guard<std::mutex> lock(ActiveMutex());
+        return ActiveBackend();
+    }
+
+    static void SetActive(std::shared_ptr<IoctlBackend> backend) {
+        std::lock_guard<std::mutex> lock(ActiveMutex());
+        ActiveBackend() = backend;
+    }
+
+private:
+    IoctlBreaker breaker;
+
+    static std::mutex &ActiveMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::shared_ptr<IoctlBackend> &ActiveBackend() {
+        static std::shared_ptr<IoctlBackend> backend;
+        return backend;
+    }
+};
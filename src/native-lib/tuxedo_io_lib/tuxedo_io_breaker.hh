@@ -0,0 +1,135 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * Circuit breaker per ioctl request code. Requests the driver does not
+ * support are remembered and answered without a syscall, transient
+ * failures of reads are retried with bounded exponential backoff.
+ */
+class IoctlBreaker {
+public:
+    struct Entry {
+        unsigned long request;
+        bool permanent;
+        int error;
+        int failures;
+        // Remaining backoff, 0 if the next call passes through
+        int64_t retryInMs;
+    };
+
+    static IoctlBreaker &Default() {
+        static IoctlBreaker breaker;
+        return breaker;
+    }
+
+    /**
+     * Check if a call may pass. If not, error is set to the errno
+     * the request failed with.
+     */
+    bool Allow(unsigned long request, int &error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = states.find(request);
+        if (it == states.end()) { return true; }
+        const State &state = it->second;
+        if (state.permanent || Clock::now() < state.retryAt) {
+            error = state.error;
+            return false;
+        }
+        return true;
+    }
+
+    void Report(unsigned long request, int error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error == 0) {
+            states.erase(request);
+            return;
+        }
+        State &state = states[request];
+        state.error = error;
+        state.failures += 1;
+        state.permanent = IsPermanent(request, error);
+        // Writes carry what the fan control or a profile wants now and are
+        // repeated by their caller, a backoff would only hold back the next one
+        if (!state.permanent && _IOC_DIR(request) != _IOC_READ) {
+            state.retryAt = Clock::now();
+        } else if (!state.permanent) {
+            int64_t backoffMs = BACKOFF_INITIAL_MS << std::min(state.failures - 1, 16);
+            state.retryAt = Clock::now() + std::chrono::milliseconds(std::min(backoffMs, BACKOFF_MAX_MS));
+        }
+    }
+
+    std::vector<Entry> GetEntries() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Entry> entries;
+        auto now = Clock::now();
+        for (const auto &it : states) {
+            int64_t retryInMs = 0;
+            if (!it.second.permanent && it.second.retryAt > now) {
+                retryInMs = std::chrono::duration_cast<std::chrono::milliseconds>(it.second.retryAt - now).count();
+            }
+            entries.push_back({ it.first, it.second.permanent, it.second.error, it.second.failures, retryInMs });
+        }
+        return entries;
+    }
+
+    void Reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        states.clear();
+    }
+
+    /**
+     * Errors that do not change with retrying, the driver does not implement the request
+     */
+    static bool IsPermanent(unsigned long request, int error) {
+        if (error == ENOTTY || error == EOPNOTSUPP || error == ENOSYS) {
+            return true;
+        }
+        // For writes EINVAL can depend on the value, only reads are argument independent
+        if (error == EINVAL) {
+            return _IOC_DIR(request) == _IOC_READ;
+        }
+        return false;
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    const int64_t BACKOFF_INITIAL_MS = 250;
+    const int64_t BACKOFF_MAX_MS = 30000;
+
+    struct State {
+        bool permanent = false;
+        int error = 0;
+        int failures = 0;
+        Clock::time_point retryAt;
+    };
+
+    std::mutex mutex;
+    std::map<unsigned long, State> states;
+};
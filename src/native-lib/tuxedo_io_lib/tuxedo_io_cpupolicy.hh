@@ -0,0 +1,483 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CPU_SYSFS_ROOT "/sys/devices/system/cpu"
+
+/**
+ * Parse a kernel cpu list like "0-3,8,10-11"
+ */
+inline std::vector<int> ParseCpuList(const std::string &text) {
+    std::vector<int> cpus;
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        char *end;
+        long first = strtol(range.c_str(), &end, 10);
+        if (end == range.c_str()) { continue; }
+        long last = *end == '-' ? strtol(end + 1, nullptr, 10) : first;
+        for (long cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back((int) cpu);
+        }
+    }
+    return cpus;
+}
+
+/**
+ * One cpufreq policy, all its cpus share the scaling attributes. Dynamic
+ * values are empty or -1 while the policy has no online cpu.
+ */
+struct CpuPolicyState {
+    int id;
+    std::vector<int> cpus;
+    std::string driver;
+    std::vector<std::string> availableGovernors;
+    std::vector<std::string> availablePreferences;
+    std::vector<int64_t> availableFrequencies;
+    int64_t cpuinfoMinFreq = -1;
+    int64_t cpuinfoMaxFreq = -1;
+    bool active = false;
+    std::string governor;
+    std::string preference;
+    int64_t minFreq = -1;
+    int64_t maxFreq = -1;
+};
+
+struct CpuSystemState {
+    std::vector<int> present;
+    std::vector<int> online;
+    std::vector<CpuPolicyState> policies;
+    // -1 if not available
+    int boost = -1;
+    int noTurbo = -1;
+};
+
+/**
+ * Desired values of one cpu, empty strings and negative numbers are left
+ * alone. Cpus of one policy share the scaling values, the first core target
+ * of a policy setting a value wins.
+ */
+struct CpuCoreTarget {
+    int cpu = -1;
+    int online = -1;
+    std::string governor;
+    std::string preference;
+    int64_t minFreq = -1;
+    int64_t maxFreq = -1;
+};
+
+struct CpuPolicyTarget {
+    std::vector<CpuCoreTarget> cores;
+    int boost = -1;
+    int noTurbo = -1;
+};
+
+/**
+ * Attribute that does not hold the applied value, path relative to the
+ * sysfs root
+ */
+struct CpuPolicyDeviation {
+    std::string path;
+    std::string expected;
+    std::string actual;
+    // errno of a failed write, 0 for an external change
+    int error;
+};
+
+struct CpuPolicyApplyResult {
+    int writes = 0;
+    // Attributes that already had the desired value
+    int unchanged = 0;
+    uint64_t reads = 0;
+    std::vector<CpuPolicyDeviation> failed;
+    int64_t durationUs = 0;
+};
+
+struct CpuPolicyCheckResult {
+    std::vector<CpuPolicyDeviation> drift;
+    uint64_t reads = 0;
+    int64_t durationUs = 0;
+};
+
+/**
+ * Cached model of the cpufreq and hotplug state under a sysfs root. Static
+ * attributes (drivers, limits, available values) are read once, a refresh
+ * only reads the scaling values per policy and the global online list
+ * instead of the files of every cpu. Apply writes only attributes that
+ * differ from the model, the policies in parallel, and remembers what the
+ * kernel accepted so Check can report values changed by someone else.
+ */
+class CpuPolicyEngine {
+public:
+    CpuPolicyEngine(const std::string &root = CPU_SYSFS_ROOT) : root(root) { }
+
+    /**
+     * @returns False if there are no cpufreq policies under the root
+     */
+    bool GetState(CpuSystemState &state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!Load()) { return false; }
+        Refresh();
+        state = model;
+        return true;
+    }
+
+    CpuPolicyApplyResult Apply(const CpuPolicyTarget &target) {
+        auto start = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex);
+        CpuPolicyApplyResult result;
+        uint64_t readsBefore = reads.load();
+        if (!Load()) {
+            result.failed.push_back({ "cpufreq", "", "", ENOENT });
+            return result;
+        }
+        Refresh();
+
+        // Cores come online first so their policies get the new values, go offline last
+        bool onlineChanged = false;
+        for (const CpuCoreTarget &core : target.cores) {
+            if (core.online == 1 && hotpluggable.count(core.cpu)) {
+                onlineChanged |= Set("cpu" + std::to_string(core.cpu) + "/online", "1", result);
+            }
+        }
+        if (onlineChanged) {
+            Refresh();
+        }
+
+        std::vector<std::pair<size_t, CpuCoreTarget>> policyTargets;
+        for (size_t i = 0; i < model.policies.size(); ++i) {
+            if (model.policies[i].active) {
+                policyTargets.push_back({ i, MergeTargets(model.policies[i], target) });
+            }
+        }
+        ApplyPolicies(policyTargets, result);
+
+        if (target.boost >= 0 && model.boost >= 0) {
+            Set("cpufreq/boost", std::to_string(target.boost), result);
+        }
+        if (target.noTurbo >= 0 && model.noTurbo >= 0) {
+            Set("intel_pstate/no_turbo", std::to_string(target.noTurbo), result);
+        }
+        onlineChanged = false;
+        for (const CpuCoreTarget &core : target.cores) {
+            if (core.online == 0 && hotpluggable.count(core.cpu)) {
+                onlineChanged |= Set("cpu" + std::to_string(core.cpu) + "/online", "0", result);
+            }
+        }
+        if (onlineChanged) {
+            Refresh();
+        }
+        result.reads = reads.load() - readsBefore;
+        result.durationUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    /**
+     * Compare the applied values with a fresh read
+     */
+    CpuPolicyCheckResult Check() {
+        auto start = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex);
+        CpuPolicyCheckResult result;
+        uint64_t readsBefore = reads.load();
+        if (Load()) {
+            Refresh();
+            for (const auto &entry : expected) {
+                auto current = values.find(entry.first);
+                // Attributes of policies without online cpu are not readable, not a drift
+                if (current == values.end() || current->second == entry.second) { continue; }
+                result.drift.push_back({ entry.first, entry.second, current->second, 0 });
+            }
+        }
+        result.reads = reads.load() - readsBefore;
+        result.durationUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+private:
+    static constexpr size_t MAX_WRITE_THREADS = 8;
+
+    std::mutex mutex;
+    std::string root;
+    bool loaded = false;
+    CpuSystemState model;
+    // Cpus with an online file, cpu0 usually has none
+    std::set<int> hotpluggable;
+    // Current and applied values by path relative to the root
+    std::map<std::string, std::string> values;
+    std::map<std::string, std::string> expected;
+    std::atomic<uint64_t> reads { 0 };
+
+    bool Read(const std::string &path, std::string &value) {
+        reads.fetch_add(1, std::memory_order_relaxed);
+        int fd = open((root + "/" + path).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { return false; }
+        char buffer[4096];
+        ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (length < 0) { return false; }
+        value.assign(buffer, length);
+        while (!value.empty() && isspace((unsigned char) value.back())) { value.pop_back(); }
+        return true;
+    }
+
+    /**
+     * @returns errno, 0 on success
+     */
+    int Write(const std::string &path, const std::string &value) {
+        int fd = open((root + "/" + path).c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+        if (fd < 0) { return errno; }
+        ssize_t length = write(fd, value.c_str(), value.size());
+        int error = length < 0 ? errno : ((size_t) length != value.size() ? EIO : 0);
+        close(fd);
+        return error;
+    }
+
+    static int64_t ToInt(const std::string &text) {
+        return text.empty() ? -1 : strtoll(text.c_str(), nullptr, 10);
+    }
+
+    static std::vector<std::string> Split(const std::string &text) {
+        std::vector<std::string> words;
+        std::stringstream stream(text);
+        std::string word;
+        while (stream >> word) { words.push_back(word); }
+        return words;
+    }
+
+    /**
+     * Static part of the model, the lock is held
+     */
+    bool Load() {
+        if (loaded) { return true; }
+        std::string text;
+        if (Read("present", text)) { model.present = ParseCpuList(text); }
+        for (int cpu : model.present) {
+            if (access((root + "/cpu" + std::to_string(cpu) + "/online").c_str(), F_OK) == 0) {
+                hotpluggable.insert(cpu);
+            }
+        }
+
+        DIR *directory = opendir((root + "/cpufreq").c_str());
+        if (directory == nullptr) { return false; }
+        struct dirent *entry;
+        while ((entry = readdir(directory)) != nullptr) {
+            if (strncmp(entry->d_name, "policy", 6) != 0 || !isdigit((unsigned char) entry->d_name[6])) { continue; }
+            CpuPolicyState policy;
+            policy.id = atoi(entry->d_name + 6);
+            std::string path = PolicyPath(policy.id);
+            if (Read(path + "/related_cpus", text)) { policy.cpus = ParseCpuList(text); }
+            Read(path + "/scaling_driver", policy.driver);
+            if (Read(path + "/scaling_available_governors", text)) { policy.availableGovernors = Split(text); }
+            if (Read(path + "/energy_performance_available_preferences", text)) { policy.availablePreferences = Split(text); }
+            if (Read(path + "/scaling_available_frequencies", text)) {
+                for (const std::string &frequency : Split(text)) { policy.availableFrequencies.push_back(ToInt(frequency)); }
+            }
+            if (Read(path + "/cpuinfo_min_freq", text)) { policy.cpuinfoMinFreq = ToInt(text); }
+            if (Read(path + "/cpuinfo_max_freq", text)) { policy.cpuinfoMaxFreq = ToInt(text); }
+            model.policies.push_back(policy);
+        }
+        closedir(directory);
+        std::sort(model.policies.begin(), model.policies.end(),
+                  [](const CpuPolicyState &a, const CpuPolicyState &b) { return a.id < b.id; });
+        model.boost = access((root + "/cpufreq/boost").c_str(), F_OK) == 0 ? 0 : -1;
+        model.noTurbo = access((root + "/intel_pstate/no_turbo").c_str(), F_OK) == 0 ? 0 : -1;
+        loaded = !model.policies.empty();
+        return loaded;
+    }
+
+    static std::string PolicyPath(int id) {
+        return "cpufreq/policy" + std::to_string(id);
+    }
+
+    /**
+     * Read the dynamic values, one online list and four files per active
+     * policy, the lock is held
+     */
+    void Refresh() {
+        std::string text;
+        if (Read("online", text)) {
+            model.online = ParseCpuList(text);
+        } else {
+            model.online = model.present;
+        }
+        std::set<int> online(model.online.begin(), model.online.end());
+        for (int cpu : hotpluggable) {
+            values["cpu" + std::to_string(cpu) + "/online"] = online.count(cpu) ? "1" : "0";
+        }
+
+        for (CpuPolicyState &policy : model.policies) {
+            std::string path = PolicyPath(policy.id);
+            policy.active = std::any_of(policy.cpus.begin(), policy.cpus.end(), [&](int cpu) { return online.count(cpu) > 0; });
+            policy.governor.clear();
+            policy.preference.clear();
+            policy.minFreq = policy.maxFreq = -1;
+            for (const char *name : { "scaling_governor", "energy_performance_preference", "scaling_min_freq", "scaling_max_freq" }) {
+                values.erase(path + "/" + name);
+            }
+            if (!policy.active) { continue; }
+
+            if (ReadValue(path + "/scaling_governor", text)) { policy.governor = text; }
+            if (!policy.availablePreferences.empty() && ReadValue(path + "/energy_performance_preference", text)) {
+                policy.preference = text;
+            }
+            if (ReadValue(path + "/scaling_min_freq", text)) { policy.minFreq = ToInt(text); }
+            if (ReadValue(path + "/scaling_max_freq", text)) { policy.maxFreq = ToInt(text); }
+        }
+
+        if (model.boost >= 0 && ReadValue("cpufreq/boost", text)) { model.boost = ToInt(text) > 0 ? 1 : 0; }
+        if (model.noTurbo >= 0 && ReadValue("intel_pstate/no_turbo", text)) { model.noTurbo = ToInt(text) > 0 ? 1 : 0; }
+    }
+
+    /**
+     * Read into the model, the lock is held
+     */
+    bool ReadValue(const std::string &path, std::string &value) {
+        if (!Read(path, value)) { return false; }
+        values[path] = value;
+        return true;
+    }
+
+    /**
+     * Values of the first core targets of the policy's cpus
+     */
+    static CpuCoreTarget MergeTargets(const CpuPolicyState &policy, const CpuPolicyTarget &target) {
+        CpuCoreTarget merged;
+        for (const CpuCoreTarget &core : target.cores) {
+            if (std::find(policy.cpus.begin(), policy.cpus.end(), core.cpu) == policy.cpus.end()) { continue; }
+            if (merged.governor.empty()) { merged.governor = core.governor; }
+            if (merged.preference.empty()) { merged.preference = core.preference; }
+            if (merged.minFreq < 0) { merged.minFreq = core.minFreq; }
+            if (merged.maxFreq < 0) { merged.maxFreq = core.maxFreq; }
+        }
+        return merged;
+    }
+
+    /**
+     * Write the scaling values of the active policies, split across up to
+     * MAX_WRITE_THREADS threads. Each thread only touches its policies'
+     * entries of the model, the lock is held.
+     */
+    void ApplyPolicies(const std::vector<std::pair<size_t, CpuCoreTarget>> &policyTargets, CpuPolicyApplyResult &result) {
+        size_t nrThreads = std::min(MAX_WRITE_THREADS, policyTargets.size());
+        if (nrThreads <= 1) {
+            for (const auto &policyTarget : policyTargets) {
+                ApplyPolicy(model.policies[policyTarget.first], policyTarget.second, result);
+            }
+            return;
+        }
+
+        // Writes collect into per thread results and local value maps, merged afterwards
+        std::vector<CpuPolicyApplyResult> results(nrThreads);
+        std::vector<std::map<std::string, std::string>> written(nrThreads), accepted(nrThreads);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < nrThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                for (size_t i = t; i < policyTargets.size(); i += nrThreads) {
+                    ApplyPolicy(model.policies[policyTargets[i].first], policyTargets[i].second, results[t], &written[t], &accepted[t]);
+                }
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        for (size_t t = 0; t < nrThreads; ++t) {
+            result.writes += results[t].writes;
+            result.unchanged += results[t].unchanged;
+            result.failed.insert(result.failed.end(), results[t].failed.begin(), results[t].failed.end());
+            for (const auto &entry : written[t]) { values[entry.first] = entry.second; }
+            for (const auto &entry : accepted[t]) { expected[entry.first] = entry.second; }
+        }
+    }
+
+    /**
+     * Governor before the preference (some drivers refuse preferences under
+     * the performance governor), frequencies in the order that keeps
+     * min <= max at every step
+     */
+    void ApplyPolicy(CpuPolicyState &policy, const CpuCoreTarget &target, CpuPolicyApplyResult &result,
+                     std::map<std::string, std::string> *written = nullptr, std::map<std::string, std::string> *accepted = nullptr) {
+        std::string path = PolicyPath(policy.id);
+        if (!target.governor.empty()) {
+            Set(path + "/scaling_governor", target.governor, result, written, accepted);
+        }
+        if (!target.preference.empty() && !policy.availablePreferences.empty()) {
+            Set(path + "/energy_performance_preference", target.preference, result, written, accepted);
+        }
+        bool maxFirst = target.minFreq >= 0 && policy.maxFreq >= 0 && target.minFreq > policy.maxFreq;
+        if (maxFirst && target.maxFreq >= 0) {
+            Set(path + "/scaling_max_freq", std::to_string(target.maxFreq), result, written, accepted);
+        }
+        if (target.minFreq >= 0) {
+            Set(path + "/scaling_min_freq", std::to_string(target.minFreq), result, written, accepted);
+        }
+        if (!maxFirst && target.maxFreq >= 0) {
+            Set(path + "/scaling_max_freq", std::to_string(target.maxFreq), result, written, accepted);
+        }
+    }
+
+    /**
+     * Write an attribute unless the model already holds the value. What the
+     * kernel reports afterwards becomes the expected value, so adjusted
+     * writes (rounded frequencies, "default" preference) are no drift.
+     * Without the map arguments the model is updated directly.
+     *
+     * @returns True if the attribute was written
+     */
+    bool Set(const std::string &path, const std::string &value, CpuPolicyApplyResult &result,
+             std::map<std::string, std::string> *written = nullptr, std::map<std::string, std::string> *accepted = nullptr) {
+        auto current = values.find(path);
+        if (current != values.end() && current->second == value) {
+            result.unchanged += 1;
+            (accepted ? *accepted : expected)[path] = value;
+            return false;
+        }
+
+        int error = Write(path, value);
+        if (error != 0) {
+            result.failed.push_back({ path, value, current != values.end() ? current->second : "", error });
+            return false;
+        }
+        result.writes += 1;
+        std::string readBack;
+        if (!Read(path, readBack)) { readBack = value; }
+        (written ? *written : values)[path] = readBack;
+        (accepted ? *accepted : expected)[path] = readBack;
+        return true;
+    }
+};
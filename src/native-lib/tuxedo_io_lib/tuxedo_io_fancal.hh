@@ -0,0 +1,265 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+struct FanCalibrationOptions {
+    // Commanded speeds of the sweeps are this far apart
+    int stepPercent = 10;
+    // Read-back poll period. A read-back unchanged for stableMs counts as
+    // settled, it has to be longer than the dead time of the EC.
+    int64_t pollIntervalMs = 50;
+    int64_t stableMs = 1000;
+    // A step that has not settled by then is recorded as unsettled
+    int64_t timeoutMs = 15000;
+    // Range of the 1 percent sweep for the quantization
+    int quantizationWindowPercent = 20;
+    // Calibration stops once the hottest fan sensor reaches this
+    int maxTemperature = 90;
+};
+
+/**
+ * One commanded speed of a sweep, times since the write
+ */
+struct FanCalibrationStep {
+    int commanded;
+    int readBack;
+    // Until the first read-back change, -1 if it never changed
+    int64_t latencyMs;
+    // Until the last read-back change before it was stable
+    int64_t settlingMs;
+    bool settled;
+};
+
+struct FanActuatorCharacteristics {
+    int fanNr;
+    // Fan stands still when commanded 0
+    bool offAvailable;
+    // Lowest commanded speed that starts the fan from standstill, -1 if it never turned
+    int minimumPercent;
+    // Commanded change it takes to move the read-back, smaller changes are lost
+    int quantizationPercent;
+    // Medians of the sweep steps: dead time, and time per percent of read-back change after it
+    int64_t latencyMs;
+    double settlingMsPerPercent;
+    // Sweep up from standstill, then down again
+    std::vector<FanCalibrationStep> steps;
+};
+
+/**
+ * Characterizes the fan actuators by commanding speeds through write and
+ * following the speed the EC reports through read. Takes several seconds per
+ * commanded speed on real fans, nothing else may drive the fans meanwhile.
+ * The temperature is watched while the fans run slow, the fans are handed
+ * back to the EC through restore whenever a calibration ends.
+ */
+class FanCalibration {
+public:
+    typedef std::function<bool(int fanNr, int percent)> FanWrite;
+    typedef std::function<bool(int fanNr, int &percent)> FanRead;
+    // Hottest fan sensor, false if none could be read
+    typedef std::function<bool(int &temperature)> TemperatureRead;
+    typedef std::function<void()> FanRestore;
+
+    FanCalibration(FanWrite write, FanRead read, TemperatureRead readTemperature, FanRestore restore,
+                   const FanCalibrationOptions &options = FanCalibrationOptions())
+        : write(write), read(read), readTemperature(readTemperature), restore(restore), options(options) {
+        this->options.stepPercent = std::max(1, std::min(100, options.stepPercent));
+        this->options.pollIntervalMs = std::max<int64_t>(1, options.pollIntervalMs);
+        this->options.quantizationWindowPercent = std::max(1, std::min(100, options.quantizationWindowPercent));
+    }
+
+    /**
+     * @returns False if the fan could not be written or read, or the
+     * temperature limit was reached
+     */
+    bool Calibrate(int fanNr, FanActuatorCharacteristics &result) {
+        RestoreScope restoreScope(restore);
+        temperatureExceeded = false;
+        result = FanActuatorCharacteristics();
+        result.fanNr = fanNr;
+        FanCalibrationStep step;
+        if (!read(fanNr, readBack)) { return false; }
+
+        if (!Step(fanNr, 0, step)) { return false; }
+        result.offAvailable = step.readBack == 0;
+        std::vector<int> sweep;
+        for (int percent = options.stepPercent; percent < 100; percent += options.stepPercent) {
+            sweep.push_back(percent);
+        }
+        sweep.push_back(100);
+        for (int i = (int) sweep.size() - 2; i >= 0; --i) {
+            sweep.push_back(sweep[i]);
+        }
+        sweep.push_back(0);
+        for (int percent : sweep) {
+            if (!Step(fanNr, percent, step)) { return false; }
+            result.steps.push_back(step);
+        }
+
+        if (!FindMinimum(fanNr, result)) { return false; }
+        if (!FindQuantization(fanNr, result)) { return false; }
+
+        std::vector<int64_t> latencies;
+        std::vector<double> settlingRates;
+        int previous = result.offAvailable ? 0 : -1;
+        for (const FanCalibrationStep &sweepStep : result.steps) {
+            if (sweepStep.latencyMs >= 0) {
+                latencies.push_back(sweepStep.latencyMs);
+                if (previous >= 0 && sweepStep.readBack != previous) {
+                    int64_t movingMs = sweepStep.settlingMs - sweepStep.latencyMs;
+                    settlingRates.push_back(movingMs / (double) abs(sweepStep.readBack - previous));
+                }
+            }
+            previous = sweepStep.readBack;
+        }
+        result.latencyMs = latencies.empty() ? 0 : Median(latencies);
+        result.settlingMsPerPercent = settlingRates.empty() ? 0 : Median(settlingRates);
+        return true;
+    }
+
+    /**
+     * True if the last calibration stopped at the temperature limit
+     */
+    bool TemperatureExceeded() const {
+        return temperatureExceeded;
+    }
+
+private:
+    FanWrite write;
+    FanRead read;
+    TemperatureRead readTemperature;
+    FanRestore restore;
+    FanCalibrationOptions options;
+    // Last read-back of the fan being calibrated
+    int readBack = 0;
+    bool temperatureExceeded = false;
+
+    class RestoreScope {
+    public:
+        RestoreScope(FanRestore &restore) : restore(restore) { }
+        ~RestoreScope() { restore(); }
+    private:
+        FanRestore &restore;
+    };
+
+    /**
+     * Command a speed and follow the read-back until it is stable, checking
+     * the temperature at every poll
+     */
+    bool Step(int fanNr, int percent, FanCalibrationStep &step) {
+        auto start = std::chrono::steady_clock::now();
+        step = { percent, readBack, -1, 0, false };
+        if (!write(fanNr, percent)) { return false; }
+
+        int64_t lastChangeMs = 0;
+        while (true) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.pollIntervalMs));
+            int value;
+            if (!read(fanNr, value)) { return false; }
+            int temperature;
+            if (!readTemperature(temperature)) { return false; }
+            if (temperature >= options.maxTemperature) {
+                temperatureExceeded = true;
+                return false;
+            }
+            int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            if (value != readBack) {
+                readBack = value;
+                lastChangeMs = elapsedMs;
+                if (step.latencyMs < 0) { step.latencyMs = elapsedMs; }
+            }
+            if (elapsedMs - lastChangeMs >= options.stableMs) {
+                step.settled = true;
+                break;
+            }
+            if (elapsedMs >= options.timeoutMs) { break; }
+        }
+        step.readBack = readBack;
+        step.settlingMs = step.latencyMs >= 0 ? lastChangeMs : 0;
+        return true;
+    }
+
+    /**
+     * Bisect between the highest standing and the lowest turning speed of
+     * the upward sweep, each try starting from standstill
+     */
+    bool FindMinimum(int fanNr, FanActuatorCharacteristics &result) {
+        if (!result.offAvailable) {
+            result.minimumPercent = 0;
+            return true;
+        }
+        int standing = 0;
+        int turning = -1;
+        for (const FanCalibrationStep &step : result.steps) {
+            if (step.readBack > 0) {
+                turning = step.commanded;
+                break;
+            }
+            standing = step.commanded;
+        }
+        result.minimumPercent = turning;
+        if (turning < 0) { return true; }
+
+        FanCalibrationStep step;
+        while (turning - standing > 1) {
+            int percent = (standing + turning) / 2;
+            if (!Step(fanNr, 0, step) || !Step(fanNr, percent, step)) { return false; }
+            if (step.readBack > 0) {
+                turning = percent;
+            } else {
+                standing = percent;
+            }
+        }
+        result.minimumPercent = turning;
+        return true;
+    }
+
+    /**
+     * 1 percent steps over a window above the minimum, the window divided
+     * by the number of read-back changes is the commanded change per step
+     */
+    bool FindQuantization(int fanNr, FanActuatorCharacteristics &result) {
+        int window = options.quantizationWindowPercent;
+        int first = std::min(std::max(result.minimumPercent, 40), 100 - window);
+        FanCalibrationStep step;
+        if (!Step(fanNr, first, step)) { return false; }
+        int changes = 0;
+        for (int percent = first + 1; percent <= first + window; ++percent) {
+            int previous = readBack;
+            if (!Step(fanNr, percent, step)) { return false; }
+            if (step.readBack != previous) { changes += 1; }
+        }
+        result.quantizationPercent = changes > 0 ? (window + changes - 1) / changes : window;
+        return true;
+    }
+
+    template <typename T>
+    static T Median(std::vector<T> values) {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+};
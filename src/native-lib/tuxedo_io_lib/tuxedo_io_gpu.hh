@@ -0,0 +1,363 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <locale.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char **environ;
+
+struct GpuQueryOptions {
+    std::string executable = "nvidia-smi";
+    // nvidia-smi --query-gpu field names, the GPU index is queried in addition
+    std::vector<std::string> fields;
+    // 0 queries once, the session ends with its child
+    int loopMs = 2000;
+    // Wait before restarting an exited child, doubled while it keeps exiting
+    // without output
+    int64_t restartDelayMs = 1000;
+    int64_t maxRestartDelayMs = 60000;
+};
+
+struct GpuQueryDevice {
+    int index;
+    // One per field, -1 for values reported as not available
+    std::vector<double> values;
+    uint64_t updatedNs;
+};
+
+struct GpuQuerySnapshot {
+    std::vector<std::string> fields;
+    // Number of sample lines parsed since start
+    uint64_t sequence;
+    uint64_t restarts;
+    // A child is currently streaming
+    bool childRunning;
+    std::vector<GpuQueryDevice> gpus;
+};
+
+inline uint64_t GpuQueryNowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+/**
+ * Keeps one nvidia-smi --loop-ms child streaming CSV lines instead of
+ * starting a process per sample. A background thread parses the stream into
+ * the latest values per GPU and restarts the child when it exits. Should
+ * the daemon die without stopping the session, the child gets SIGPIPE on
+ * its next write.
+ */
+class GpuQuerySession {
+public:
+    ~GpuQuerySession() {
+        Stop();
+    }
+
+    /**
+     * @returns False if already running or the executable cannot be started
+     */
+    bool Start(const GpuQueryOptions &options) {
+        std::lock_guard<std::mutex> controlLock(controlMutex);
+        if (running || options.fields.empty() || options.loopMs < 0) { return false; }
+
+        stopFd = eventfd(0, EFD_CLOEXEC);
+        if (stopFd < 0) { return false; }
+        this->options = options;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            snapshot = {};
+            snapshot.fields = options.fields;
+            gpus.clear();
+        }
+        if (!Spawn()) {
+            close(stopFd);
+            stopFd = -1;
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = true;
+        }
+        queryThread = std::thread(&GpuQuerySession::Run, this);
+        return true;
+    }
+
+    void Stop() {
+        std::lock_guard<std::mutex> controlLock(controlMutex);
+        if (!running) { return; }
+        uint64_t value = 1;
+        ssize_t written = write(stopFd, &value, sizeof(value));
+        (void) written;
+        queryThread.join();
+        close(stopFd);
+        stopFd = -1;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        sampled.notify_all();
+    }
+
+    bool IsRunning() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return running;
+    }
+
+    GpuQuerySnapshot GetSnapshot() {
+        std::lock_guard<std::mutex> lock(mutex);
+        GpuQuerySnapshot result = snapshot;
+        for (const auto &gpu : gpus) {
+            result.gpus.push_back(gpu.second);
+        }
+        return result;
+    }
+
+    /**
+     * Block until a sample newer than afterSequence was parsed
+     * @returns False on timeout, when the session is not running or a single
+     * query exited without it
+     */
+    bool WaitForSample(uint64_t afterSequence, int64_t timeoutMs) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return sampled.wait_for(lock, std::chrono::milliseconds(std::max<int64_t>(timeoutMs, 0)), [&]() {
+            return !running || snapshot.sequence > afterSequence || (options.loopMs == 0 && !snapshot.childRunning);
+        }) && running && snapshot.sequence > afterSequence;
+    }
+
+private:
+    // Bound for a line without newline, protects against a runaway child
+    static constexpr size_t MAX_LINE_LENGTH = 4096;
+
+    std::mutex controlMutex;
+    std::mutex mutex;
+    std::condition_variable sampled;
+    GpuQueryOptions options;
+    bool running = false;
+    GpuQuerySnapshot snapshot = {};
+    std::map<int, GpuQueryDevice> gpus;
+    std::thread queryThread;
+    int stopFd = -1;
+    pid_t childPid = -1;
+    int childFd = -1;
+
+    bool Spawn() {
+        int pipeFds[2];
+        if (pipe2(pipeFds, O_CLOEXEC) != 0) { return false; }
+
+        std::string query = "--query-gpu=index";
+        for (const std::string &field : options.fields) {
+            query += "," + field;
+        }
+        std::vector<std::string> arguments = { options.executable, query, "--format=csv,noheader,nounits" };
+        if (options.loopMs > 0) {
+            arguments.push_back("--loop-ms=" + std::to_string(options.loopMs));
+        }
+        std::vector<char *> argv;
+        for (std::string &argument : arguments) {
+            argv.push_back(&argument[0]);
+        }
+        argv.push_back(nullptr);
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+        // Node ignores SIGPIPE, the child needs it to exit with the daemon
+        posix_spawnattr_t attributes;
+        posix_spawnattr_init(&attributes);
+        sigset_t signals;
+        sigemptyset(&signals);
+        posix_spawnattr_setsigmask(&attributes, &signals);
+        sigfillset(&signals);
+        posix_spawnattr_setsigdefault(&attributes, &signals);
+        posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+        pid_t pid;
+        int result = posix_spawnp(&pid, options.executable.c_str(), &actions, &attributes, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attributes);
+        close(pipeFds[1]);
+        if (result != 0) {
+            close(pipeFds[0]);
+            return false;
+        }
+        childPid = pid;
+        childFd = pipeFds[0];
+        SetChildRunning(true);
+        return true;
+    }
+
+    void Reap() {
+        if (childFd >= 0) {
+            close(childFd);
+            childFd = -1;
+        }
+        if (childPid > 0) {
+            kill(childPid, SIGTERM);
+            while (waitpid(childPid, nullptr, 0) < 0 && errno == EINTR) { }
+            childPid = -1;
+        }
+        SetChildRunning(false);
+    }
+
+    void SetChildRunning(bool childRunning) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            snapshot.childRunning = childRunning;
+        }
+        sampled.notify_all();
+    }
+
+    /**
+     * @returns False if stop was requested while waiting
+     */
+    bool WaitForRestart(int64_t delayMs) {
+        struct pollfd fd = { stopFd, POLLIN, 0 };
+        int result;
+        while ((result = poll(&fd, 1, (int) delayMs)) < 0 && errno == EINTR) { }
+        return result == 0;
+    }
+
+    void Run() {
+        int64_t restartDelayMs = options.restartDelayMs;
+        while (true) {
+            bool stopped = false;
+            bool sampledAny = Stream(stopped);
+            Reap();
+            if (stopped || options.loopMs == 0) { break; }
+
+            restartDelayMs = sampledAny ? options.restartDelayMs : std::min(restartDelayMs * 2, options.maxRestartDelayMs);
+            bool spawned = false;
+            while (!spawned) {
+                if (!WaitForRestart(restartDelayMs)) { return; }
+                spawned = Spawn();
+                if (!spawned) {
+                    restartDelayMs = std::min(restartDelayMs * 2, options.maxRestartDelayMs);
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            snapshot.restarts += 1;
+        }
+    }
+
+    /**
+     * Read the child's output until it closes or stop is requested
+     * @returns True if at least one sample was parsed
+     */
+    bool Stream(bool &stopped) {
+        struct pollfd fds[2] = { { childFd, POLLIN, 0 }, { stopFd, POLLIN, 0 } };
+        std::string line;
+        bool sampledAny = false;
+        char chunk[4096];
+        while (true) {
+            int result = poll(fds, 2, -1);
+            if (result < 0 && errno == EINTR) { continue; }
+            if (result < 0 || (fds[1].revents & POLLIN)) {
+                stopped = true;
+                return sampledAny;
+            }
+            if (fds[0].revents == 0) { continue; }
+
+            ssize_t length = read(childFd, chunk, sizeof(chunk));
+            if (length < 0 && (errno == EINTR || errno == EAGAIN)) { continue; }
+            if (length <= 0) { return sampledAny; }
+            for (ssize_t i = 0; i < length; ++i) {
+                if (chunk[i] != '\n') {
+                    if (line.size() < MAX_LINE_LENGTH) { line += chunk[i]; }
+                    continue;
+                }
+                sampledAny = ParseLine(line) || sampledAny;
+                line.clear();
+            }
+        }
+    }
+
+    /**
+     * Parse "index, value, ..." with values as printed with nounits, e.g.
+     * "12.34" or "[N/A]". Lines with an unexpected field count, like the
+     * error messages nvidia-smi prints to stdout, are ignored.
+     */
+    bool ParseLine(const std::string &line) {
+        std::vector<std::string> columns;
+        size_t start = 0;
+        while (true) {
+            size_t end = line.find(',', start);
+            columns.push_back(Trim(line.substr(start, end == std::string::npos ? std::string::npos : end - start)));
+            if (end == std::string::npos) { break; }
+            start = end + 1;
+        }
+        if (columns.size() != options.fields.size() + 1) { return false; }
+
+        double index;
+        if (!ParseNumber(columns[0], index) || index < 0) { return false; }
+        GpuQueryDevice device;
+        device.index = (int) index;
+        for (size_t i = 1; i < columns.size(); ++i) {
+            double value;
+            device.values.push_back(ParseNumber(columns[i], value) ? value : -1);
+        }
+        device.updatedNs = GpuQueryNowNs();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            gpus[device.index] = device;
+            snapshot.sequence += 1;
+        }
+        sampled.notify_all();
+        return true;
+    }
+
+    static std::string Trim(const std::string &value) {
+        size_t start = value.find_first_not_of(" \t\r");
+        if (start == std::string::npos) { return ""; }
+        size_t end = value.find_last_not_of(" \t\r");
+        return value.substr(start, end - start + 1);
+    }
+
+    static bool ParseNumber(const std::string &value, double &result) {
+        if (value.empty()) { return false; }
+        // Independent of the process locale's decimal separator
+        static locale_t numericLocale = newlocale(LC_NUMERIC_MASK, "C", (locale_t) 0);
+        char *end;
+        errno = 0;
+        result = strtod_l(value.c_str(), &end, numericLocale);
+        return errno == 0 && *end == '\0';
+    }
+};
@@ -0,0 +1,151 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+/**
+ * Reports a device node appearing and disappearing, e.g. /dev/tuxedo_io
+ * when the module is loaded after the daemon started. The directory of the
+ * node is watched with inotify, which devtmpfs reports as soon as the
+ * driver registers the device, without depending on udevd.
+ */
+class DeviceNodeWatcher {
+public:
+    /**
+     * Called on the watch thread when the node appeared or disappeared, and
+     * again when udev changes the attributes of a present node. A node
+     * removed and created again within one read is reported as both.
+     */
+    typedef std::function<void(bool present)> PresenceCallback;
+
+    ~DeviceNodeWatcher() {
+        Stop();
+    }
+
+    bool Start(const std::string &path, PresenceCallback callback) {
+        if (running) { return false; }
+        size_t slash = path.rfind('/');
+        if (slash == std::string::npos || slash + 1 >= path.size()) { return false; }
+        std::string directory = slash == 0 ? "/" : path.substr(0, slash);
+        name = path.substr(slash + 1);
+
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        stopFd = eventfd(0, EFD_CLOEXEC);
+        if (inotifyFd < 0 || stopFd < 0
+            || inotify_add_watch(inotifyFd, directory.c_str(), IN_CREATE | IN_DELETE | IN_ATTRIB | IN_MOVED_TO | IN_MOVED_FROM) < 0) {
+            CloseFds();
+            return false;
+        }
+
+        this->path = path;
+        this->callback = callback;
+        // Checked after the watch is in place, a node created in between is not missed
+        present.store(access(path.c_str(), F_OK) == 0);
+        running = true;
+        watchThread = std::thread(&DeviceNodeWatcher::Run, this);
+        return true;
+    }
+
+    void Stop() {
+        if (!running) { return; }
+        uint64_t value = 1;
+        ssize_t written = write(stopFd, &value, sizeof(value));
+        (void) written;
+        watchThread.join();
+        running = false;
+        CloseFds();
+    }
+
+    bool IsRunning() {
+        return running;
+    }
+
+    bool IsPresent() {
+        return present.load();
+    }
+
+private:
+    std::string path;
+    std::string name;
+    PresenceCallback callback;
+    std::atomic<bool> present { false };
+    bool running = false;
+    int inotifyFd = -1;
+    int stopFd = -1;
+    std::thread watchThread;
+
+    void CloseFds() {
+        if (inotifyFd >= 0) { close(inotifyFd); }
+        if (stopFd >= 0) { close(stopFd); }
+        inotifyFd = -1;
+        stopFd = -1;
+    }
+
+    void Run() {
+        struct pollfd fds[2] = { { inotifyFd, POLLIN, 0 }, { stopFd, POLLIN, 0 } };
+        alignas(struct inotify_event) char buffer[4096];
+        while (true) {
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) { continue; }
+                break;
+            }
+            if (fds[1].revents & POLLIN) { break; }
+
+            bool relevant = false;
+            bool attributes = false;
+            bool removed = false;
+            ssize_t length;
+            while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+                for (char *position = buffer; position < buffer + length;) {
+                    struct inotify_event *event = (struct inotify_event *) position;
+                    position += sizeof(struct inotify_event) + event->len;
+                    if (event->mask & IN_Q_OVERFLOW) {
+                        relevant = true;
+                    } else if (event->len > 0 && name == event->name) {
+                        relevant = true;
+                        attributes = attributes || (event->mask & IN_ATTRIB);
+                        removed = removed || (event->mask & (IN_DELETE | IN_MOVED_FROM));
+                    }
+                }
+            }
+            if (!relevant) { continue; }
+
+            bool nowPresent = access(path.c_str(), F_OK) == 0;
+            bool wasPresent = present.exchange(nowPresent);
+            if (wasPresent && nowPresent && removed) {
+                // Module reloaded, the open device belongs to the old node
+                callback(false);
+                callback(true);
+            } else if (wasPresent != nowPresent || (nowPresent && attributes)) {
+                callback(nowPresent);
+            }
+        }
+    }
+};
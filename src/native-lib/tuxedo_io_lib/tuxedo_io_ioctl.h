@@ -35,6 +35,35 @@
 #define R_HWCHECK_CL		_IOR(IOCTL_MAGIC, 0x05, int32_t*)
 #define R_HWCHECK_UW		_IOR(IOCTL_MAGIC, 0x06, int32_t*)
 
+// Bit mask of optional features, not available before 0.3.0. Optional
+// features do not raise MOD_API_MIN_VERSION, they are probed at runtime
+#define R_MOD_CAPABILITIES	_IOR(IOCTL_MAGIC, 0x07, int32_t*)
+#define MOD_CAP_BATCH		0x01
+
+/**
+ * Batched register access (MOD_CAP_BATCH)
+ *
+ * Every entry names the scalar ioctl of one register of the interface, e.g.
+ * R_UW_TDP0 or W_UW_TDP0. Entries are processed in order as if issued one
+ * by one, value is input for writes and output for reads. The batch ioctl
+ * only fails as a whole for malformed batches, errors of single registers
+ * are reported per entry as positive errno.
+ */
+#define TUXEDO_IO_BATCH_MAX	16
+
+struct tuxedo_io_batch_entry {
+	uint32_t request;
+	int32_t value;
+	int32_t error;
+	uint32_t reserved;
+};
+
+struct tuxedo_io_batch {
+	uint32_t count;
+	uint32_t reserved;
+	struct tuxedo_io_batch_entry entries[TUXEDO_IO_BATCH_MAX];
+};
+
 /**
  * Clevo interface
  */
@@ -50,6 +79,8 @@
 #define R_CL_FLIGHTMODE_SW	_IOR(MAGIC_READ_CL, 0x14, int32_t*)
 #define R_CL_TOUCHPAD_SW	_IOR(MAGIC_READ_CL, 0x15, int32_t*)
 
+#define RW_CL_BATCH		_IOWR(MAGIC_READ_CL, 0x20, struct tuxedo_io_batch*)
+
 #ifdef DEBUG
 #define R_TF_BC			_IOW(MAGIC_READ_CL, 0x91, uint32_t*)
 #endif
@@ -96,6 +127,8 @@
 
 #define R_UW_PROFS_AVAILABLE	_IOR(MAGIC_READ_UW, 0x21, int32_t*)
 
+#define RW_UW_BATCH		_IOWR(MAGIC_READ_UW, 0x30, struct tuxedo_io_batch*)
+
 // Write
 #define W_UW_FANSPEED		_IOW(MAGIC_WRITE_UW, 0x10, int32_t*)
 #define W_UW_FANSPEED2		_IOW(MAGIC_WRITE_UW, 0x11, int32_t*)
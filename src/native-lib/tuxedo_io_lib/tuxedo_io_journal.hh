@@ -0,0 +1,482 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tuxedo_io_api.hh"
+#include "tuxedo_io_queue.hh"
+#include "tuxedo_io_telemetry.hh"
+
+#define TELEMETRY_JOURNAL_MAGIC 0x4a434354 // "TCCJ"
+#define TELEMETRY_JOURNAL_VERSION 1
+#define TELEMETRY_JOURNAL_HEADER_SIZE 4096
+#define TELEMETRY_JOURNAL_FANS 3
+#define TELEMETRY_JOURNAL_TDPS 3
+
+/**
+ * One sample, 64 bytes. A record is valid if its checksum matches, so a
+ * record torn by a crash or a concurrent reader is skipped instead of read.
+ */
+struct TelemetryJournalRecord {
+    // Starts at 1, the slot of a record is (sequence - 1) % capacity
+    uint64_t sequence;
+    // Wall clock, the journal spans reboots
+    int64_t timestampMs;
+    // -1 for unknown values
+    int16_t temperature[TELEMETRY_JOURNAL_FANS];
+    int16_t fanSpeed[TELEMETRY_JOURNAL_FANS];
+    int32_t tdp[TELEMETRY_JOURNAL_TDPS];
+    char odmProfile[20];
+    uint32_t checksum;
+};
+
+static_assert(sizeof(TelemetryJournalRecord) == 64, "journal record layout must stay fixed");
+
+struct TelemetryJournalHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t headerSize;
+    uint64_t capacity;
+    // Sequence of the next record, updated after the record is complete
+    std::atomic<uint64_t> nextSequence;
+};
+
+static_assert(sizeof(TelemetryJournalHeader) <= TELEMETRY_JOURNAL_HEADER_SIZE, "journal header must fit its page");
+
+enum class TelemetryJournalChannel {
+    Temperature,
+    FanSpeed,
+    TDP
+};
+
+/**
+ * Fixed size ring of telemetry records in a preallocated, memory mapped
+ * file. The writer (daemon) opens it read write, other processes can map
+ * the same file read only and query it concurrently.
+ */
+class TelemetryJournal {
+public:
+    ~TelemetryJournal() {
+        Close();
+    }
+
+    /**
+     * Open or create the journal for writing. An existing journal with a
+     * different capacity or layout is started over.
+     * @param maxBytes Upper bound of the file size including header
+     */
+    bool Create(const std::string &path, uint64_t maxBytes) {
+        Close();
+        if (maxBytes < TELEMETRY_JOURNAL_HEADER_SIZE + sizeof(TelemetryJournalRecord)) { return false; }
+        uint64_t capacity = (maxBytes - TELEMETRY_JOURNAL_HEADER_SIZE) / sizeof(TelemetryJournalRecord);
+        size_t size = TELEMETRY_JOURNAL_HEADER_SIZE + capacity * sizeof(TelemetryJournalRecord);
+
+        size_t separator = path.rfind('/');
+        if (separator != std::string::npos && separator > 0) {
+            mkdir(path.substr(0, separator).c_str(), 0755);
+        }
+        int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) { return false; }
+        fchmod(fd, 0644);
+
+        struct stat info;
+        bool reuse = fstat(fd, &info) == 0 && (size_t) info.st_size == size;
+        if (!reuse && (ftruncate(fd, 0) < 0 || posix_fallocate(fd, 0, size) != 0)) {
+            close(fd);
+            return false;
+        }
+        void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) { return false; }
+
+        this->mapping = (char *) mapping;
+        mappingSize = size;
+        writable = true;
+
+        TelemetryJournalHeader *header = Header();
+        if (!reuse || !HeaderValid() || header->capacity != capacity) {
+            memset(this->mapping, 0, TELEMETRY_JOURNAL_HEADER_SIZE);
+            header->magic = TELEMETRY_JOURNAL_MAGIC;
+            header->version = TELEMETRY_JOURNAL_VERSION;
+            header->recordSize = sizeof(TelemetryJournalRecord);
+            header->headerSize = TELEMETRY_JOURNAL_HEADER_SIZE;
+            header->capacity = capacity;
+            header->nextSequence.store(1, std::memory_order_relaxed);
+            msync(this->mapping, TELEMETRY_JOURNAL_HEADER_SIZE, MS_SYNC);
+        } else {
+            Recover();
+        }
+        return true;
+    }
+
+    /**
+     * Map an existing journal read only for queries
+     */
+    bool Open(const std::string &path) {
+        Close();
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { return false; }
+        struct stat info;
+        if (fstat(fd, &info) < 0 || (size_t) info.st_size < TELEMETRY_JOURNAL_HEADER_SIZE) {
+            close(fd);
+            return false;
+        }
+        void *mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) { return false; }
+
+        this->mapping = (char *) mapping;
+        mappingSize = info.st_size;
+        writable = false;
+        if (!HeaderValid()
+            || TELEMETRY_JOURNAL_HEADER_SIZE + Header()->capacity * sizeof(TelemetryJournalRecord) > mappingSize) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Close() {
+        if (mapping == nullptr) { return; }
+        if (writable) {
+            msync(mapping, mappingSize, MS_SYNC);
+        }
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+        mappingSize = 0;
+    }
+
+    bool IsOpen() {
+        return mapping != nullptr;
+    }
+
+    void Append(TelemetryJournalRecord record) {
+        if (mapping == nullptr || !writable) { return; }
+        TelemetryJournalHeader *header = Header();
+        uint64_t sequence = header->nextSequence.load(std::memory_order_relaxed);
+        record.sequence = sequence;
+        record.checksum = Checksum(record);
+        memcpy(Slot(sequence), &record, sizeof(record));
+        header->nextSequence.store(sequence + 1, std::memory_order_release);
+
+        // Bound what a power loss can take, dirty pages only
+        if (sequence % SYNC_INTERVAL_RECORDS == 0) {
+            msync(mapping, mappingSize, MS_ASYNC);
+        }
+    }
+
+    /**
+     * Number of records currently in the journal
+     */
+    uint64_t Size() {
+        uint64_t first, end;
+        Range(first, end);
+        return end - first;
+    }
+
+    uint64_t Capacity() {
+        return mapping != nullptr ? Header()->capacity : 0;
+    }
+
+    /**
+     * Aggregate a value over equally sized buckets of [fromMs, toMs). Writes
+     * min, max and average per bucket to result (3 * buckets values), NaN for
+     * buckets without samples.
+     * @returns Number of records aggregated
+     */
+    uint64_t Query(TelemetryJournalChannel channel, int index, int64_t fromMs, int64_t toMs, size_t buckets, double *result) {
+        for (size_t i = 0; i < buckets * 3; ++i) {
+            result[i] = NAN;
+        }
+        if (mapping == nullptr || buckets == 0 || toMs <= fromMs || index < 0) { return 0; }
+        if ((channel == TelemetryJournalChannel::TDP && index >= TELEMETRY_JOURNAL_TDPS)
+            || (channel != TelemetryJournalChannel::TDP && index >= TELEMETRY_JOURNAL_FANS)) {
+            return 0;
+        }
+
+        std::vector<uint64_t> counts(buckets, 0);
+        uint64_t aggregated = 0;
+        uint64_t first, end;
+        Range(first, end);
+        TelemetryJournalRecord record;
+        for (uint64_t sequence = LowerBound(first, end, fromMs); sequence < end; ++sequence) {
+            if (!Read(sequence, record)) { continue; }
+            // Clock steps backwards can leave single earlier records in between
+            if (record.timestampMs < fromMs) { continue; }
+            if (record.timestampMs >= toMs) { break; }
+            int value = Value(record, channel, index);
+            if (value < 0) { continue; }
+
+            size_t bucket = (size_t) ((record.timestampMs - fromMs) * (int64_t) buckets / (toMs - fromMs));
+            double *target = result + bucket * 3;
+            if (counts[bucket] == 0) {
+                target[0] = value;
+                target[1] = value;
+                target[2] = 0;
+            }
+            target[0] = std::min(target[0], (double) value);
+            target[1] = std::max(target[1], (double) value);
+            target[2] += value;
+            counts[bucket] += 1;
+            aggregated += 1;
+        }
+        for (size_t i = 0; i < buckets; ++i) {
+            if (counts[i] > 0) {
+                result[i * 3 + 2] /= counts[i];
+            }
+        }
+        return aggregated;
+    }
+
+    /**
+     * ODM profile changes in [fromMs, toMs), including the profile active at fromMs
+     */
+    std::vector<std::pair<int64_t, std::string>> ProfileChanges(int64_t fromMs, int64_t toMs) {
+        std::vector<std::pair<int64_t, std::string>> changes;
+        if (mapping == nullptr || toMs <= fromMs) { return changes; }
+        uint64_t first, end;
+        Range(first, end);
+        uint64_t start = LowerBound(first, end, fromMs);
+        TelemetryJournalRecord record;
+        if (start > first && Read(start - 1, record)) {
+            changes.push_back({ fromMs, std::string(record.odmProfile, strnlen(record.odmProfile, sizeof(record.odmProfile))) });
+        }
+        for (uint64_t sequence = start; sequence < end; ++sequence) {
+            if (!Read(sequence, record) || record.timestampMs < fromMs) { continue; }
+            if (record.timestampMs >= toMs) { break; }
+            std::string profile(record.odmProfile, strnlen(record.odmProfile, sizeof(record.odmProfile)));
+            if (changes.empty() || changes.back().second != profile) {
+                changes.push_back({ record.timestampMs, profile });
+            }
+        }
+        return changes;
+    }
+
+    static int64_t NowMs() {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        return (int64_t) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+    }
+
+private:
+    static constexpr uint64_t SYNC_INTERVAL_RECORDS = 60;
+
+    char *mapping = nullptr;
+    size_t mappingSize = 0;
+    bool writable = false;
+
+    TelemetryJournalHeader *Header() {
+        return (TelemetryJournalHeader *) mapping;
+    }
+
+    bool HeaderValid() {
+        TelemetryJournalHeader *header = Header();
+        return header->magic == TELEMETRY_JOURNAL_MAGIC && header->version == TELEMETRY_JOURNAL_VERSION
+            && header->recordSize == sizeof(TelemetryJournalRecord) && header->headerSize == TELEMETRY_JOURNAL_HEADER_SIZE
+            && header->capacity > 0;
+    }
+
+    char *Slot(uint64_t sequence) {
+        return mapping + TELEMETRY_JOURNAL_HEADER_SIZE + ((sequence - 1) % Header()->capacity) * sizeof(TelemetryJournalRecord);
+    }
+
+    static uint32_t Checksum(const TelemetryJournalRecord &record) {
+        // FNV-1a over everything but the checksum itself
+        uint32_t hash = 2166136261u;
+        const unsigned char *data = (const unsigned char *) &record;
+        for (size_t i = 0; i < offsetof(TelemetryJournalRecord, checksum); ++i) {
+            hash = (hash ^ data[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    bool Read(uint64_t sequence, TelemetryJournalRecord &record) {
+        memcpy(&record, Slot(sequence), sizeof(record));
+        return record.sequence == sequence && record.checksum == Checksum(record);
+    }
+
+    /**
+     * Sequences [first, end) currently readable. The oldest slot is left out,
+     * it is the one the writer overwrites next.
+     */
+    void Range(uint64_t &first, uint64_t &end) {
+        first = end = 1;
+        if (mapping == nullptr) { return; }
+        TelemetryJournalHeader *header = Header();
+        end = header->nextSequence.load(std::memory_order_acquire);
+        first = end > header->capacity ? end - header->capacity + 1 : 1;
+    }
+
+    /**
+     * First sequence with a timestamp of at least timeMs, records are in
+     * append order and thereby in time order apart from clock steps
+     */
+    uint64_t LowerBound(uint64_t first, uint64_t end, int64_t timeMs) {
+        TelemetryJournalRecord record;
+        while (first < end) {
+            uint64_t middle = first + (end - first) / 2;
+            if (!Read(middle, record) || record.timestampMs < timeMs) {
+                first = middle + 1;
+            } else {
+                end = middle;
+            }
+        }
+        return first;
+    }
+
+    /**
+     * Continue after the newest valid record, the header may lag behind the
+     * records after a crash
+     */
+    void Recover() {
+        TelemetryJournalHeader *header = Header();
+        uint64_t newest = 0;
+        for (uint64_t slot = 0; slot < header->capacity; ++slot) {
+            TelemetryJournalRecord record;
+            memcpy(&record, mapping + TELEMETRY_JOURNAL_HEADER_SIZE + slot * sizeof(record), sizeof(record));
+            if (record.sequence != 0 && (record.sequence - 1) % header->capacity == slot
+                && record.checksum == Checksum(record)) {
+                newest = std::max(newest, record.sequence);
+            }
+        }
+        header->nextSequence.store(newest + 1, std::memory_order_release);
+    }
+
+    static int Value(const TelemetryJournalRecord &record, TelemetryJournalChannel channel, int index) {
+        switch (channel) {
+            case TelemetryJournalChannel::Temperature: return record.temperature[index];
+            case TelemetryJournalChannel::FanSpeed: return record.fanSpeed[index];
+            case TelemetryJournalChannel::TDP: return record.tdp[index];
+        }
+        return -1;
+    }
+};
+
+/**
+ * Appends a record sampled from the device getters to a journal in a fixed
+ * interval on a native thread
+ */
+class TelemetryJournalRecorder {
+public:
+    typedef std::function<bool(DeviceStatus &status)> StatusRead;
+
+    ~TelemetryJournalRecorder() {
+        Stop();
+    }
+
+    /**
+     * @param readStatus Reads the device status, run on the recorder thread
+     */
+    bool Start(TelemetryJournal &journal, StatusRead readStatus, int64_t intervalMs) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running || intervalMs <= 0 || !journal.IsOpen()) { return false; }
+        this->journal = &journal;
+        this->readStatus = readStatus;
+        this->intervalMs = intervalMs;
+        stopRequested = false;
+        running = true;
+        recorderThread = std::thread(&TelemetryJournalRecorder::Run, this);
+        return true;
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) { return; }
+            stopRequested = true;
+        }
+        wakeup.notify_all();
+        recorderThread.join();
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        journal = nullptr;
+        readStatus = nullptr;
+    }
+
+    bool IsRunning() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return running;
+    }
+
+    static void Sample(const StatusRead &readStatus, TelemetryJournalRecord &record) {
+        memset(&record, 0, sizeof(record));
+        record.timestampMs = TelemetryJournal::NowMs();
+        DeviceStatus status;
+        if (!readStatus(status)) { status = DeviceStatus(); }
+        for (int i = 0; i < TELEMETRY_JOURNAL_FANS; ++i) {
+            bool available = i < status.nrFans && i < DEVICE_STATUS_MAX_FANS;
+            record.temperature[i] = (int16_t) (available ? status.fanTemperature[i] : -1);
+            record.fanSpeed[i] = (int16_t) (available ? status.fanSpeedPercent[i] : -1);
+        }
+        for (int i = 0; i < TELEMETRY_JOURNAL_TDPS; ++i) {
+            record.tdp[i] = i < status.nrTDPs && i < DEVICE_STATUS_MAX_TDPS ? status.tdp[i] : -1;
+        }
+        // There is no profile getter, the last set profile is kept in the telemetry
+        TelemetrySnapshot snapshot;
+        TelemetryStore::Default().Read(snapshot);
+        strncpy(record.odmProfile, snapshot.odmProfile, sizeof(record.odmProfile));
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::thread recorderThread;
+    bool running = false;
+    bool stopRequested = false;
+
+    TelemetryJournal *journal = nullptr;
+    StatusRead readStatus;
+    int64_t intervalMs = 0;
+
+    void Run() {
+        // History is informational, never ahead of fan control
+        IoctlPriorityScope priority(IoctlPriority::Low);
+        std::unique_lock<std::mutex> lock(mutex);
+        auto nextSample = std::chrono::steady_clock::now();
+        while (!stopRequested) {
+            if (wakeup.wait_until(lock, nextSample, [this] { return stopRequested; })) { break; }
+            lock.unlock();
+            TelemetryJournalRecord record;
+            Sample(readStatus, record);
+            journal->Append(record);
+            lock.lock();
+            // After a stall continue from now instead of catching up
+            nextSample = std::max(nextSample + std::chrono::milliseconds(intervalMs), std::chrono::steady_clock::now());
+        }
+    }
+};
@@ -0,0 +1,308 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr int LATENCY_BUCKETS = 15;
+// Upper bounds of all but the last bucket, which is unbounded
+static constexpr double LATENCY_BUCKET_BOUNDS_MS[LATENCY_BUCKETS - 1] = {
+    0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100, 250, 500, 1000, 2500
+};
+
+inline uint64_t LatencyNowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+struct LatencyHistogram {
+    uint64_t counts[LATENCY_BUCKETS];
+    uint64_t count;
+    double sumMs;
+    double maxMs;
+
+    void Record(double ms) {
+        // Buckets include their upper bound, as Prometheus' le does
+        int bucket = std::lower_bound(LATENCY_BUCKET_BOUNDS_MS, LATENCY_BUCKET_BOUNDS_MS + LATENCY_BUCKETS - 1, ms)
+                     - LATENCY_BUCKET_BOUNDS_MS;
+        counts[bucket] += 1;
+        count += 1;
+        sumMs += ms;
+        maxMs = std::max(maxMs, ms);
+    }
+
+    /**
+     * Upper bound of the bucket holding the quantile, the maximum for the
+     * unbounded bucket
+     */
+    double Quantile(double q) const {
+        if (count == 0) { return 0; }
+        uint64_t rank = (uint64_t) (q * count + 0.5);
+        uint64_t seen = 0;
+        for (int i = 0; i < LATENCY_BUCKETS - 1; ++i) {
+            seen += counts[i];
+            if (seen >= std::max<uint64_t>(rank, 1)) { return std::min(LATENCY_BUCKET_BOUNDS_MS[i], maxMs); }
+        }
+        return maxMs;
+    }
+};
+
+enum class GcKind {
+    Minor,
+    Major,
+    Incremental,
+    WeakCallbacks,
+    COUNT
+};
+
+struct WorkDeadlineStats {
+    std::string name;
+    uint64_t runs;
+    // Runs started later than their slack allows
+    uint64_t missed;
+    bool inProgress;
+    // Start of the run on the event loop relative to its deadline
+    LatencyHistogram lateness;
+    LatencyHistogram runtime;
+    // Fan export calls made during the run, relative to its deadline
+    LatencyHistogram fanCallLateness;
+};
+
+struct LoopMonitorStats {
+    bool running;
+    int64_t intervalMs;
+    // Pings not sent because the previous one was still unanswered
+    uint64_t skippedPings;
+    LatencyHistogram loopLag;
+    LatencyHistogram gcPause;
+    uint64_t gcPauses[(int) GcKind::COUNT];
+    // Duration of the fan export calls
+    LatencyHistogram fanCalls;
+    std::vector<WorkDeadlineStats> workers;
+};
+
+/**
+ * Measures where control loop latency comes from. A monitor thread pings
+ * the event loop through an async handle and records how long the loop
+ * takes to answer. GC pauses, runs of the daemon workers against their
+ * deadlines and the fan export calls made during a run are recorded by
+ * the loop thread itself.
+ */
+class LoopMonitor {
+public:
+    // Queues a call of Pong on the event loop, false if that failed
+    typedef std::function<bool()> Ping;
+
+    static LoopMonitor &Default() {
+        static LoopMonitor monitor;
+        return monitor;
+    }
+
+    ~LoopMonitor() {
+        Stop();
+    }
+
+    bool Start(int64_t intervalMs, Ping ping) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running || intervalMs <= 0) { return false; }
+        this->intervalMs = intervalMs;
+        this->ping = ping;
+        pingPending = false;
+        stopRequested = false;
+        running = true;
+        enabled.store(true, std::memory_order_relaxed);
+        monitorThread = std::thread(&LoopMonitor::Run, this);
+        return true;
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) { return; }
+            stopRequested = true;
+        }
+        wakeup.notify_all();
+        monitorThread.join();
+        std::lock_guard<std::mutex> lock(mutex);
+        enabled.store(false, std::memory_order_relaxed);
+        running = false;
+        ping = nullptr;
+    }
+
+    bool IsRunning() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Answer to a ping, called on the event loop
+     */
+    void Pong() {
+        uint64_t now = LatencyNowNs();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!pingPending) { return; }
+        pingPending = false;
+        stats.loopLag.Record((now - pingSentNs) / 1e6);
+    }
+
+    void RecordGcPause(GcKind kind, double durationMs) {
+        if (!IsRunning()) { return; }
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.gcPause.Record(durationMs);
+        stats.gcPauses[(int) kind] += 1;
+    }
+
+    /**
+     * A worker run starts on the event loop
+     * @param deadlineNs Monotonic time the run was due
+     * @param slackMs Lateness up to which the run is not counted as missed
+     */
+    void BeginWork(const std::string &name, uint64_t deadlineNs, double slackMs) {
+        if (!IsRunning()) { return; }
+        uint64_t now = LatencyNowNs();
+        std::lock_guard<std::mutex> lock(mutex);
+        Work &work = works[name];
+        double latenessMs = now > deadlineNs ? (now - deadlineNs) / 1e6 : 0;
+        work.stats.runs += 1;
+        if (latenessMs > slackMs) { work.stats.missed += 1; }
+        work.stats.lateness.Record(latenessMs);
+        work.deadlineNs = deadlineNs;
+        work.startedNs = now;
+        work.startSequence = ++startSequence;
+        work.stats.inProgress = true;
+    }
+
+    void EndWork(const std::string &name) {
+        uint64_t now = LatencyNowNs();
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = works.find(name);
+        if (it == works.end() || !it->second.stats.inProgress) { return; }
+        it->second.stats.inProgress = false;
+        it->second.stats.runtime.Record((now - it->second.startedNs) / 1e6);
+    }
+
+    /**
+     * Fan export call, attributed to the most recently started worker run
+     * still in progress
+     */
+    void RecordFanCall(uint64_t startNs, uint64_t endNs) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.fanCalls.Record((endNs - startNs) / 1e6);
+        Work *current = nullptr;
+        for (auto &it : works) {
+            if (it.second.stats.inProgress && (current == nullptr || it.second.startSequence > current->startSequence)) {
+                current = &it.second;
+            }
+        }
+        if (current != nullptr) {
+            current->stats.fanCallLateness.Record(startNs > current->deadlineNs ? (startNs - current->deadlineNs) / 1e6 : 0);
+        }
+    }
+
+    LoopMonitorStats GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        LoopMonitorStats result = stats;
+        result.running = running;
+        result.intervalMs = intervalMs;
+        for (const auto &it : works) {
+            result.workers.push_back(it.second.stats);
+            result.workers.back().name = it.first;
+        }
+        return result;
+    }
+
+    void Reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats = {};
+        for (auto &it : works) {
+            bool inProgress = it.second.stats.inProgress;
+            it.second.stats = {};
+            it.second.stats.inProgress = inProgress;
+        }
+    }
+
+    /**
+     * Times one fan export call while the monitor runs
+     */
+    class CallTimer {
+    public:
+        CallTimer(LoopMonitor &monitor = Default()) : monitor(monitor), startNs(monitor.IsRunning() ? LatencyNowNs() : 0) { }
+
+        ~CallTimer() {
+            if (startNs != 0) { monitor.RecordFanCall(startNs, LatencyNowNs()); }
+        }
+
+    private:
+        LoopMonitor &monitor;
+        uint64_t startNs;
+    };
+
+private:
+    struct Work {
+        uint64_t deadlineNs = 0;
+        uint64_t startedNs = 0;
+        uint64_t startSequence = 0;
+        WorkDeadlineStats stats = {};
+    };
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::thread monitorThread;
+    std::atomic<bool> enabled { false };
+    bool running = false;
+    bool stopRequested = false;
+    int64_t intervalMs = 0;
+    Ping ping;
+    bool pingPending = false;
+    uint64_t pingSentNs = 0;
+    uint64_t startSequence = 0;
+    LoopMonitorStats stats = {};
+    std::map<std::string, Work> works;
+
+    void Run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopRequested) {
+            wakeup.wait_for(lock, std::chrono::milliseconds(intervalMs), [this]() { return stopRequested; });
+            if (stopRequested) { break; }
+            if (pingPending) {
+                // A blocked loop shows up as one long lag once it answers
+                stats.skippedPings += 1;
+                continue;
+            }
+            pingPending = true;
+            pingSentNs = LatencyNowNs();
+            Ping pingCopy = ping;
+            lock.unlock();
+            bool sent = pingCopy();
+            lock.lock();
+            if (!sent) { pingPending = false; }
+        }
+    }
+};
@@ -0,0 +1,355 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct LedWriterStats {
+    uint64_t frames;
+    // LEDs written and LEDs left alone because they did not change
+    uint64_t ledWrites;
+    uint64_t ledsSkipped;
+    uint64_t errors;
+};
+
+/**
+ * Writes RGB frames to sysfs multicolor LEDs (rgb:kbd_backlight*), one LED
+ * per zone or per key. The multi_intensity and brightness files stay open
+ * and only LEDs that changed since the previous frame are written. Per-key
+ * ITE keyboards get all writes of a frame between buffer_input 1 and 0, so
+ * the controller is updated in one transfer.
+ */
+class LedFrameWriter {
+public:
+    ~LedFrameWriter() {
+        Close();
+    }
+
+    /**
+     * @param ledPaths LED class directories in frame order
+     * @returns False if one multi_intensity file cannot be opened
+     */
+    bool Open(const std::vector<std::string> &ledPaths) {
+        std::lock_guard<std::mutex> lock(mutex);
+        CloseFds();
+        for (const std::string &path : ledPaths) {
+            Led led;
+            led.multiIntensityFd = open((path + "/multi_intensity").c_str(), O_WRONLY | O_CLOEXEC);
+            if (led.multiIntensityFd < 0) {
+                CloseFds();
+                return false;
+            }
+            led.brightnessFd = open((path + "/brightness").c_str(), O_WRONLY | O_CLOEXEC);
+            leds.push_back(led);
+        }
+        if (!ledPaths.empty()) {
+            bufferInputFd = open((ledPaths[0] + "/device/controls/buffer_input").c_str(), O_WRONLY | O_CLOEXEC);
+        }
+        stats = {};
+        return !leds.empty();
+    }
+
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        CloseFds();
+    }
+
+    bool IsOpen() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !leds.empty();
+    }
+
+    size_t Size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return leds.size();
+    }
+
+    /**
+     * @param rgb Three bytes per LED, LEDs beyond the frame keep their color
+     * @param brightness Written to the LEDs whose brightness differs, unless negative
+     * @returns Number of LEDs written, -1 if not open
+     */
+    int Write(const uint8_t *rgb, size_t length, int brightness = -1) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (leds.empty()) { return -1; }
+
+        std::vector<size_t> changed;
+        size_t count = std::min(leds.size(), length / 3);
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t *color = rgb + i * 3;
+            Led &led = leds[i];
+            if (!led.colorKnown || led.color[0] != color[0] || led.color[1] != color[1] || led.color[2] != color[2]
+                || (brightness >= 0 && led.brightnessFd >= 0 && led.brightness != brightness)) {
+                changed.push_back(i);
+            }
+        }
+        stats.frames += 1;
+        stats.ledsSkipped += count - changed.size();
+        if (changed.empty()) { return 0; }
+
+        bool buffered = bufferInputFd >= 0 && changed.size() > 1 && WriteAttribute(bufferInputFd, "1", 1);
+        for (size_t i : changed) {
+            const uint8_t *color = rgb + i * 3;
+            Led &led = leds[i];
+            if (brightness >= 0 && led.brightnessFd >= 0 && led.brightness != brightness) {
+                char value[16];
+                int valueLength = snprintf(value, sizeof(value), "%d\n", brightness);
+                led.brightness = WriteAttribute(led.brightnessFd, value, valueLength) ? brightness : -1;
+            }
+            char value[16];
+            int valueLength = snprintf(value, sizeof(value), "%d %d %d\n", color[0], color[1], color[2]);
+            if (WriteAttribute(led.multiIntensityFd, value, valueLength)) {
+                std::copy(color, color + 3, led.color);
+                led.colorKnown = true;
+                stats.ledWrites += 1;
+            } else {
+                led.colorKnown = false;
+                stats.errors += 1;
+            }
+        }
+        if (buffered) {
+            WriteAttribute(bufferInputFd, "0", 1);
+        }
+        return (int) changed.size();
+    }
+
+    /**
+     * Write every LED with the next frame, for when something else changed
+     * the LEDs through sysfs
+     */
+    void Invalidate() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Led &led : leds) {
+            led.colorKnown = false;
+            led.brightness = -1;
+        }
+    }
+
+    LedWriterStats GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+private:
+    struct Led {
+        int multiIntensityFd = -1;
+        int brightnessFd = -1;
+        uint8_t color[3] = { 0, 0, 0 };
+        bool colorKnown = false;
+        int brightness = -1;
+    };
+
+    std::mutex mutex;
+    std::vector<Led> leds;
+    int bufferInputFd = -1;
+    LedWriterStats stats = {};
+
+    /**
+     * sysfs attributes take one value per write, always from offset 0. A
+     * trailing newline is accepted like from echo and delimits the value in
+     * regular files standing in for sysfs.
+     */
+    static bool WriteAttribute(int fd, const char *value, size_t length) {
+        ssize_t result;
+        while ((result = pwrite(fd, value, length, 0)) < 0 && errno == EINTR) { }
+        return result == (ssize_t) length;
+    }
+
+    void CloseFds() {
+        for (Led &led : leds) {
+            close(led.multiIntensityFd);
+            if (led.brightnessFd >= 0) { close(led.brightnessFd); }
+        }
+        leds.clear();
+        if (bufferInputFd >= 0) { close(bufferInputFd); }
+        bufferInputFd = -1;
+    }
+};
+
+enum class LedEffect {
+    // Colors fade in and out
+    Breathe,
+    // Rainbow moving across the LEDs
+    Wave,
+    // Color between a cold and a hot color by fan sensor temperature
+    Temperature
+};
+
+struct LedAnimationOptions {
+    LedEffect effect = LedEffect::Breathe;
+    int fps = 30;
+    // Breathe cycle, time the wave takes to travel over all LEDs
+    int64_t periodMs = 4000;
+    // Breathe: colors per LED, repeated if shorter than the frame.
+    // Temperature: cold color followed by hot color.
+    std::vector<uint8_t> colors;
+    int minTemperature = 40;
+    int maxTemperature = 90;
+};
+
+/**
+ * Renders an effect on a native thread and hands the frames to a
+ * LedFrameWriter, which drops LEDs that did not change
+ */
+class LedAnimator {
+public:
+    static constexpr int MIN_FPS = 1;
+    static constexpr int MAX_FPS = 60;
+
+    typedef std::function<int()> TemperatureSource;
+
+    ~LedAnimator() {
+        Stop();
+    }
+
+    /**
+     * @param writer Must outlive the animation
+     * @param temperature Sensor temperature for the temperature effect, negative if unknown
+     */
+    bool Start(LedFrameWriter &writer, const LedAnimationOptions &options, TemperatureSource temperature = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running || options.fps < MIN_FPS || options.fps > MAX_FPS || options.periodMs <= 0
+            || options.colors.size() % 3 != 0
+            || (options.effect == LedEffect::Breathe && options.colors.empty())
+            || (options.effect == LedEffect::Temperature && (options.colors.size() != 6 || !temperature
+                || options.maxTemperature <= options.minTemperature))) {
+            return false;
+        }
+        this->writer = &writer;
+        this->options = options;
+        this->temperature = temperature;
+        frames = 0;
+        stopRequested = false;
+        running = true;
+        animationThread = std::thread(&LedAnimator::Run, this);
+        return true;
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) { return; }
+            stopRequested = true;
+        }
+        wakeup.notify_all();
+        animationThread.join();
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        writer = nullptr;
+    }
+
+    bool IsRunning() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return running;
+    }
+
+    uint64_t Frames() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return frames;
+    }
+
+    /**
+     * Frame of the effect at a point in time, three bytes per LED
+     */
+    static void Render(const LedAnimationOptions &options, size_t nrLeds, int64_t elapsedMs, int temperature, std::vector<uint8_t> &frame) {
+        frame.assign(nrLeds * 3, 0);
+        double phase = fmod((double) elapsedMs / options.periodMs, 1.0);
+        if (options.effect == LedEffect::Breathe) {
+            double level = 0.5 - 0.5 * cos(2 * M_PI * phase);
+            for (size_t i = 0; i < frame.size(); ++i) {
+                frame[i] = (uint8_t) lround(options.colors[i % options.colors.size()] * level);
+            }
+        } else if (options.effect == LedEffect::Wave) {
+            for (size_t i = 0; i < nrLeds; ++i) {
+                Hue(fmod((double) i / nrLeds + phase, 1.0), &frame[i * 3]);
+            }
+        } else {
+            double heat = temperature < 0 ? 0
+                : std::min(1.0, std::max(0.0, (double) (temperature - options.minTemperature) / (options.maxTemperature - options.minTemperature)));
+            for (size_t i = 0; i < frame.size(); ++i) {
+                int channel = i % 3;
+                frame[i] = (uint8_t) lround(options.colors[channel] + (options.colors[3 + channel] - options.colors[channel]) * heat);
+            }
+        }
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool running = false;
+    bool stopRequested = false;
+    uint64_t frames = 0;
+    LedFrameWriter *writer = nullptr;
+    LedAnimationOptions options;
+    TemperatureSource temperature;
+    std::thread animationThread;
+
+    /**
+     * Fully saturated color of a hue between 0 and 1
+     */
+    static void Hue(double hue, uint8_t *rgb) {
+        double sector = hue * 6;
+        double fraction = sector - floor(sector);
+        uint8_t rising = (uint8_t) lround(fraction * 255);
+        uint8_t falling = 255 - rising;
+        const uint8_t colors[6][3] = {
+            { 255, rising, 0 }, { falling, 255, 0 }, { 0, 255, rising },
+            { 0, falling, 255 }, { rising, 0, 255 }, { 255, 0, falling }
+        };
+        std::copy(colors[(int) sector % 6], colors[(int) sector % 6] + 3, rgb);
+    }
+
+    void Run() {
+        Clock::time_point start = Clock::now();
+        Clock::duration interval = std::chrono::microseconds(1000000 / options.fps);
+        Clock::time_point next = start;
+        std::vector<uint8_t> frame;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopRequested) {
+            lock.unlock();
+            int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+            int currentTemperature = options.effect == LedEffect::Temperature ? temperature() : -1;
+            Render(options, writer->Size(), elapsedMs, currentTemperature, frame);
+            writer->Write(frame.data(), frame.size());
+            lock.lock();
+            frames += 1;
+
+            // Frames missed by a slow write are dropped, not caught up
+            next += interval;
+            Clock::time_point now = Clock::now();
+            if (next < now) { next = now; }
+            wakeup.wait_until(lock, next, [this]() { return stopRequested; });
+        }
+    }
+};
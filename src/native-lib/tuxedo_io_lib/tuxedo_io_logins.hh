@@ -0,0 +1,295 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <paths.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <utmpx.h>
+#include <sys/inotify.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * One systemd-logind session as written to /run/systemd/sessions/<id>
+ */
+struct LoginSession {
+    std::string id;
+    std::string user;
+    int64_t uid = -1;
+    std::string seat;
+    std::string tty;
+    std::string display;
+    // x11, wayland, tty, mir or unspecified
+    std::string type;
+    // user, greeter, lock-screen or background
+    std::string sessionClass;
+    // online, active or closing
+    std::string state;
+    std::string service;
+    std::string desktop;
+    std::string remoteHost;
+    bool active = false;
+    bool remote = false;
+    int vtnr = 0;
+    int64_t leader = 0;
+};
+
+/**
+ * One USER_PROCESS utmp entry, what w lists
+ */
+struct LoginRecord {
+    std::string user;
+    std::string line;
+    std::string host;
+    int64_t pid;
+    int64_t loginTimeMs;
+};
+
+struct LoginSnapshot {
+    std::vector<LoginSession> sessions;
+    std::vector<LoginRecord> logins;
+    // At least one of the sources could be read
+    bool available;
+    // Both sources are watched, without a watch they are reread on every get
+    bool watching;
+    uint64_t reloads;
+    int64_t lastReloadUs;
+};
+
+/**
+ * Logged in users and their sessions from utmp and the logind session
+ * files. Both are watched with inotify, a get only rereads them after a
+ * change and otherwise costs one non-blocking read of the inotify fd.
+ */
+class LoginSessionCache {
+public:
+    static constexpr const char *DEFAULT_SESSIONS_DIR = "/run/systemd/sessions";
+
+    LoginSessionCache(const std::string &utmpPath = _PATH_UTMP, const std::string &sessionsDir = DEFAULT_SESSIONS_DIR)
+        : utmpPath(utmpPath), sessionsDir(sessionsDir) {
+        size_t slash = utmpPath.rfind('/');
+        utmpDir = slash == std::string::npos ? "." : (slash == 0 ? "/" : utmpPath.substr(0, slash));
+        utmpName = slash == std::string::npos ? utmpPath : utmpPath.substr(slash + 1);
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+
+    ~LoginSessionCache() {
+        if (inotifyFd >= 0) { close(inotifyFd); }
+    }
+
+    LoginSessionCache(const LoginSessionCache &) = delete;
+    LoginSessionCache &operator=(const LoginSessionCache &) = delete;
+
+    void Get(LoginSnapshot &result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (Changed()) {
+            Reload();
+        }
+        result = snapshot;
+        result.watching = utmpWatch >= 0 && sessionsWatch >= 0;
+    }
+
+    /**
+     * Force a reread on the next get
+     */
+    void Invalidate() {
+        std::lock_guard<std::mutex> lock(mutex);
+        dirty = true;
+    }
+
+    /**
+     * Parse one logind session file
+     */
+    static bool ParseSessionFile(const std::string &path, LoginSession &session) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { return false; }
+        std::string content;
+        char chunk[4096];
+        ssize_t length;
+        while ((length = read(fd, chunk, sizeof(chunk))) > 0) {
+            content.append(chunk, length);
+        }
+        close(fd);
+        if (length < 0) { return false; }
+
+        size_t start = 0;
+        while (start < content.size()) {
+            size_t end = content.find('\n', start);
+            if (end == std::string::npos) { end = content.size(); }
+            size_t separator = content.find('=', start);
+            if (content[start] != '#' && separator != std::string::npos && separator < end) {
+                SetSessionValue(session, content.substr(start, separator - start), content.substr(separator + 1, end - separator - 1));
+            }
+            start = end + 1;
+        }
+        return true;
+    }
+
+private:
+    static constexpr uint32_t UTMP_DIR_EVENTS = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM;
+    static constexpr uint32_t SESSIONS_DIR_EVENTS = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM
+                                                    | IN_DELETE_SELF | IN_MOVE_SELF;
+
+    std::mutex mutex;
+    std::string utmpPath;
+    std::string utmpDir;
+    std::string utmpName;
+    std::string sessionsDir;
+    int inotifyFd = -1;
+    int utmpWatch = -1;
+    int sessionsWatch = -1;
+    bool dirty = true;
+    LoginSnapshot snapshot = {};
+
+    static std::mutex &UtmpMutex() {
+        // getutxent and utmpxname work on process wide state
+        static std::mutex utmpMutex;
+        return utmpMutex;
+    }
+
+    static int64_t NowUs() {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (int64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+    }
+
+    static void SetSessionValue(LoginSession &session, const std::string &key, const std::string &value) {
+        if (key == "USER") { session.user = value; }
+        else if (key == "UID") { session.uid = strtoll(value.c_str(), nullptr, 10); }
+        else if (key == "SEAT") { session.seat = value; }
+        else if (key == "TTY") { session.tty = value; }
+        else if (key == "DISPLAY") { session.display = value; }
+        else if (key == "TYPE") { session.type = value; }
+        else if (key == "CLASS") { session.sessionClass = value; }
+        else if (key == "STATE") { session.state = value; }
+        else if (key == "SERVICE") { session.service = value; }
+        else if (key == "DESKTOP") { session.desktop = value; }
+        else if (key == "REMOTE_HOST") { session.remoteHost = value; }
+        else if (key == "ACTIVE") { session.active = value == "1"; }
+        else if (key == "REMOTE") { session.remote = value == "1"; }
+        else if (key == "VTNR") { session.vtnr = (int) strtol(value.c_str(), nullptr, 10); }
+        else if (key == "LEADER") { session.leader = strtoll(value.c_str(), nullptr, 10); }
+    }
+
+    static bool SessionIdLess(const LoginSession &a, const LoginSession &b) {
+        // Numeric ids in numeric order, "c1" style ids after them
+        if (a.id.size() != b.id.size()) { return a.id.size() < b.id.size(); }
+        return a.id < b.id;
+    }
+
+    /**
+     * Add missing watches and drain pending events, the lock is held
+     * @returns True if a source may have changed since the last reload
+     */
+    bool Changed() {
+        if (inotifyFd < 0) { return true; }
+        if (utmpWatch < 0) {
+            utmpWatch = inotify_add_watch(inotifyFd, utmpDir.c_str(), UTMP_DIR_EVENTS);
+            dirty = true;
+        }
+        if (sessionsWatch < 0) {
+            // A missing sessions directory is retried on every get, it appears with logind
+            sessionsWatch = inotify_add_watch(inotifyFd, sessionsDir.c_str(), SESSIONS_DIR_EVENTS);
+            if (sessionsWatch >= 0) { dirty = true; }
+        }
+
+        alignas(struct inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char *position = buffer; position < buffer + length;) {
+                struct inotify_event *event = (struct inotify_event *) position;
+                position += sizeof(struct inotify_event) + event->len;
+                if (event->mask & IN_Q_OVERFLOW) {
+                    dirty = true;
+                } else if (event->mask & IN_IGNORED) {
+                    if (event->wd == utmpWatch) { utmpWatch = -1; }
+                    if (event->wd == sessionsWatch) { sessionsWatch = -1; }
+                    dirty = true;
+                } else if (event->wd == utmpWatch) {
+                    if (event->len > 0 && utmpName == event->name) { dirty = true; }
+                } else if (event->wd == sessionsWatch) {
+                    // Skip the .ref fifos and logind's temporary files
+                    if (event->len == 0 || strchr(event->name, '.') == nullptr) { dirty = true; }
+                }
+            }
+        }
+        // Unwatched sources can change unnoticed
+        return dirty || utmpWatch < 0;
+    }
+
+    void Reload() {
+        int64_t startUs = NowUs();
+        bool utmpRead = ReadUtmp(snapshot.logins);
+        bool sessionsRead = ReadSessions(snapshot.sessions);
+        snapshot.available = utmpRead || sessionsRead;
+        snapshot.reloads += 1;
+        snapshot.lastReloadUs = NowUs() - startUs;
+        dirty = false;
+    }
+
+    bool ReadUtmp(std::vector<LoginRecord> &logins) {
+        logins.clear();
+        if (access(utmpPath.c_str(), R_OK) != 0) { return false; }
+
+        std::lock_guard<std::mutex> lock(UtmpMutex());
+        if (utmpxname(utmpPath.c_str()) != 0) { return false; }
+        setutxent();
+        struct utmpx *entry;
+        while ((entry = getutxent()) != nullptr) {
+            if (entry->ut_type != USER_PROCESS) { continue; }
+            LoginRecord record;
+            record.user.assign(entry->ut_user, strnlen(entry->ut_user, sizeof(entry->ut_user)));
+            record.line.assign(entry->ut_line, strnlen(entry->ut_line, sizeof(entry->ut_line)));
+            record.host.assign(entry->ut_host, strnlen(entry->ut_host, sizeof(entry->ut_host)));
+            record.pid = entry->ut_pid;
+            record.loginTimeMs = (int64_t) entry->ut_tv.tv_sec * 1000 + entry->ut_tv.tv_usec / 1000;
+            logins.push_back(record);
+        }
+        endutxent();
+        utmpxname(_PATH_UTMP);
+        return true;
+    }
+
+    bool ReadSessions(std::vector<LoginSession> &sessions) {
+        sessions.clear();
+        DIR *directory = opendir(sessionsDir.c_str());
+        if (directory == nullptr) { return false; }
+        struct dirent *entry;
+        while ((entry = readdir(directory)) != nullptr) {
+            if (strchr(entry->d_name, '.') != nullptr) { continue; }
+            LoginSession session;
+            session.id = entry->d_name;
+            if (ParseSessionFile(sessionsDir + "/" + entry->d_name, session)) {
+                sessions.push_back(session);
+            }
+        }
+        closedir(directory);
+        std::sort(sessions.begin(), sessions.end(), SessionIdLess);
+        return true;
+    }
+};
@@ -0,0 +1,328 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "tuxedo_io_api.hh"
+#include "tuxedo_io_latency.hh"
+#include "tuxedo_io_telemetry.hh"
+
+/**
+ * Minimal HTTP responder serving the telemetry snapshot in Prometheus text
+ * format (OpenMetrics if requested by the Accept header). Listens either on
+ * a unix domain socket or on a localhost TCP port. Scrapes only read the
+ * snapshot and the IO counters, they never touch the device.
+ */
+class MetricsServer {
+public:
+    MetricsServer(TelemetryStore &store = TelemetryStore::Default()) : store(store) { }
+
+    ~MetricsServer() {
+        Stop();
+    }
+
+    /**
+     * @param address Socket path, or a port number to listen on 127.0.0.1
+     * @returns False if it could not listen, or for a port out of range
+     */
+    bool Start(const std::string &address) {
+        if (running) { return false; }
+
+        bool isPort = !address.empty() && address.find_first_not_of("0123456789") == std::string::npos;
+        long port = 0;
+        if (isPort) {
+            errno = 0;
+            port = strtol(address.c_str(), nullptr, 10);
+            if (errno != 0 || port < 1 || port > 65535) { return false; }
+        }
+        listenFd = isPort ? ListenTcp((int) port) : ListenUnix(address);
+        stopFd = eventfd(0, EFD_CLOEXEC);
+        if (listenFd < 0 || stopFd < 0) {
+            CloseFds();
+            return false;
+        }
+
+        socketPath = isPort ? "" : address;
+        running = true;
+        serverThread = std::thread(&MetricsServer::Run, this);
+        return true;
+    }
+
+    void Stop() {
+        if (!running) { return; }
+        uint64_t value = 1;
+        ssize_t written = write(stopFd, &value, sizeof(value));
+        (void) written;
+        serverThread.join();
+        running = false;
+        CloseFds();
+        if (!socketPath.empty()) {
+            unlink(socketPath.c_str());
+        }
+    }
+
+    bool IsRunning() {
+        return running;
+    }
+
+    static std::string Format(const TelemetrySnapshot &snapshot, bool openMetrics) {
+        std::ostringstream out;
+        double ageSeconds = (TelemetryNowNs() - snapshot.updatedNs) / 1e9;
+
+        // OpenMetrics has an info type for the family without the _info suffix
+        if (openMetrics) {
+            Header(out, "tuxedo_io", "info", "Active tuxedo-io interface and model");
+        } else {
+            Header(out, "tuxedo_io_info", "gauge", "Active tuxedo-io interface and model");
+        }
+        out << "tuxedo_io_info{interface=\"" << Escape(snapshot.interfaceId) << "\",model=\"" << Escape(snapshot.modelId) << "\"} 1\n";
+
+        Header(out, "tuxedo_io_snapshot_age_seconds", "gauge", "Time since the last hardware value was sampled");
+        out << "tuxedo_io_snapshot_age_seconds " << (snapshot.updatedNs == 0 ? -1 : ageSeconds) << "\n";
+
+        Header(out, "tuxedo_io_fan_temperature_celsius", "gauge", "Temperature of the sensor assigned to the fan");
+        for (int i = 0; i < snapshot.nrFans && i < TELEMETRY_MAX_FANS; ++i) {
+            out << "tuxedo_io_fan_temperature_celsius{fan=\"" << i << "\"} " << snapshot.fans[i].temperature << "\n";
+        }
+
+        Header(out, "tuxedo_io_fan_speed_percent", "gauge", "Fan speed in percent");
+        for (int i = 0; i < snapshot.nrFans && i < TELEMETRY_MAX_FANS; ++i) {
+            out << "tuxedo_io_fan_speed_percent{fan=\"" << i << "\"} " << snapshot.fans[i].speedPercent << "\n";
+        }
+
+        Header(out, "tuxedo_io_fans_min_speed_percent", "gauge", "Minimum fan speed supported by the firmware");
+        out << "tuxedo_io_fans_min_speed_percent " << snapshot.fansMinSpeed << "\n";
+        Header(out, "tuxedo_io_fans_off_available", "gauge", "Whether the fans can be turned off completely");
+        out << "tuxedo_io_fans_off_available " << snapshot.fansOffAvailable << "\n";
+
+        Header(out, "tuxedo_io_tdp_watts", "gauge", "Configured TDP values");
+        for (int i = 0; i < snapshot.nrTDPs && i < TELEMETRY_MAX_TDPS; ++i) {
+            std::string descriptor = Escape(snapshot.tdps[i].descriptor);
+            out << "tuxedo_io_tdp_watts{descriptor=\"" << descriptor << "\",kind=\"current\"} " << snapshot.tdps[i].current << "\n";
+            out << "tuxedo_io_tdp_watts{descriptor=\"" << descriptor << "\",kind=\"min\"} " << snapshot.tdps[i].min << "\n";
+            out << "tuxedo_io_tdp_watts{descriptor=\"" << descriptor << "\",kind=\"max\"} " << snapshot.tdps[i].max << "\n";
+        }
+
+        Header(out, "tuxedo_io_odm_profile", "gauge", "Active ODM performance profile");
+        if (snapshot.odmProfile[0] != '\0') {
+            out << "tuxedo_io_odm_profile{profile=\"" << Escape(snapshot.odmProfile) << "\"} 1\n";
+        }
+
+        Header(out, "tuxedo_io_webcam_status", "gauge", "Webcam switch status, -1 if unknown");
+        out << "tuxedo_io_webcam_status " << snapshot.webcamStatus << "\n";
+
+        IOStatistics &statistics = IOStatistics::Default();
+        Counter(out, openMetrics, "tuxedo_io_ioctl_calls", "Issued ioctl calls", statistics.calls.load(std::memory_order_relaxed));
+        Counter(out, openMetrics, "tuxedo_io_ioctl_errors", "Failed ioctl calls", statistics.errors.load(std::memory_order_relaxed));
+        Counter(out, openMetrics, "tuxedo_io_ioctl_short_circuited", "ioctl calls answered by the circuit breaker", statistics.shortCircuited.load(std::memory_order_relaxed));
+        Header(out, openMetrics ? "tuxedo_io_ioctl_duration_seconds" : "tuxedo_io_ioctl_duration_seconds_total", "counter", "Time spent in ioctl calls");
+        out << "tuxedo_io_ioctl_duration_seconds_total " << statistics.durationNs.load(std::memory_order_relaxed) / 1e9 << "\n";
+
+        IoctlQueueStats queue = IoctlQueue::Default().GetStats();
+        Header(out, "tuxedo_io_ioctl_queue_depth", "gauge", "ioctl calls waiting in the submission queue");
+        out << "tuxedo_io_ioctl_queue_depth " << queue.depth << "\n";
+        Counter(out, openMetrics, "tuxedo_io_ioctl_coalesced", "Reads answered by an identical call in flight", queue.coalesced);
+        Counter(out, openMetrics, "tuxedo_io_ioctl_superseded", "Queued writes replaced by a newer value", queue.superseded);
+        const char *classNames[IOCTL_PRIORITY_CLASSES] = { "high", "normal", "low" };
+        Header(out, openMetrics ? "tuxedo_io_ioctl_queue_wait_seconds" : "tuxedo_io_ioctl_queue_wait_seconds_total", "counter", "Time calls spent waiting for the device per priority class");
+        for (int i = 0; i < IOCTL_PRIORITY_CLASSES; ++i) {
+            out << "tuxedo_io_ioctl_queue_wait_seconds_total{priority=\"" << classNames[i] << "\"} " << queue.totalWaitNs[i] / 1e9 << "\n";
+        }
+
+        if (LoopMonitor::Default().IsRunning()) {
+            LoopMonitorStats loop = LoopMonitor::Default().GetStats();
+            Header(out, "tuxedo_io_event_loop_lag_seconds", "histogram", "Time the event loop took to answer a ping");
+            Histogram(out, "tuxedo_io_event_loop_lag_seconds", "", loop.loopLag);
+            Header(out, "tuxedo_io_gc_pause_seconds", "histogram", "Garbage collection pauses of the event loop thread");
+            Histogram(out, "tuxedo_io_gc_pause_seconds", "", loop.gcPause);
+            Header(out, "tuxedo_io_fan_call_seconds", "histogram", "Duration of the fan export calls");
+            Histogram(out, "tuxedo_io_fan_call_seconds", "", loop.fanCalls);
+            Header(out, "tuxedo_io_worker_lateness_seconds", "histogram", "Start of worker runs relative to their deadline");
+            for (const WorkDeadlineStats &worker : loop.workers) {
+                Histogram(out, "tuxedo_io_worker_lateness_seconds", "worker=\"" + Escape(worker.name) + "\"", worker.lateness);
+            }
+            Header(out, openMetrics ? "tuxedo_io_worker_missed_deadlines" : "tuxedo_io_worker_missed_deadlines_total", "counter", "Worker runs started later than their slack allows");
+            for (const WorkDeadlineStats &worker : loop.workers) {
+                out << "tuxedo_io_worker_missed_deadlines_total{worker=\"" << Escape(worker.name) << "\"} " << worker.missed << "\n";
+            }
+        }
+
+        if (openMetrics) {
+            out << "# EOF\n";
+        }
+        return out.str();
+    }
+
+private:
+    TelemetryStore &store;
+    int listenFd = -1;
+    int stopFd = -1;
+    bool running = false;
+    std::string socketPath;
+    std::thread serverThread;
+
+    static void Header(std::ostringstream &out, const std::string &name, const std::string &type, const std::string &help) {
+        out << "# HELP " << name << " " << help << "\n";
+        out << "# TYPE " << name << " " << type << "\n";
+    }
+
+    /**
+     * Escapes a label value as required by both exposition formats
+     */
+    static std::string Escape(const std::string &value) {
+        std::string escaped;
+        escaped.reserve(value.size());
+        for (char c : value) {
+            switch (c) {
+                case '\\': escaped += "\\\\"; break;
+                case '"': escaped += "\\\""; break;
+                case '\n': escaped += "\\n"; break;
+                default: escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    static void Counter(std::ostringstream &out, bool openMetrics, const std::string &name, const std::string &help, uint64_t value) {
+        // OpenMetrics names the family without the _total suffix
+        Header(out, openMetrics ? name : name + "_total", "counter", help);
+        out << name << "_total " << value << "\n";
+    }
+
+    static void Histogram(std::ostringstream &out, const std::string &name, const std::string &labels, const LatencyHistogram &histogram) {
+        std::string separator = labels.empty() ? "" : ",";
+        uint64_t cumulative = 0;
+        for (int i = 0; i < LATENCY_BUCKETS; ++i) {
+            cumulative += histogram.counts[i];
+            out << name << "_bucket{" << labels << separator << "le=\"";
+            if (i < LATENCY_BUCKETS - 1) {
+                out << LATENCY_BUCKET_BOUNDS_MS[i] / 1000;
+            } else {
+                out << "+Inf";
+            }
+            out << "\"} " << cumulative << "\n";
+        }
+        std::string labelSet = labels.empty() ? "" : "{" + labels + "}";
+        out << name << "_sum" << labelSet << " " << histogram.sumMs / 1000 << "\n";
+        out << name << "_count" << labelSet << " " << histogram.count << "\n";
+    }
+
+    static int ListenUnix(const std::string &path) {
+        struct sockaddr_un address = {};
+        if (path.size() >= sizeof(address.sun_path)) { return -1; }
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) { return -1; }
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        unlink(path.c_str());
+        if (bind(fd, (struct sockaddr *) &address, sizeof(address)) < 0 || listen(fd, 8) < 0) {
+            close(fd);
+            return -1;
+        }
+        // Telemetry is not sensitive, allow unprivileged scrapers
+        chmod(path.c_str(), 0666);
+        return fd;
+    }
+
+    static int ListenTcp(int port) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) { return -1; }
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(fd, (struct sockaddr *) &address, sizeof(address)) < 0 || listen(fd, 8) < 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    void Run() {
+        struct pollfd fds[2] = { { listenFd, POLLIN, 0 }, { stopFd, POLLIN, 0 } };
+        while (true) {
+            int result = poll(fds, 2, -1);
+            if (result < 0 && errno == EINTR) { continue; }
+            if (result < 0 || (fds[1].revents & POLLIN)) { break; }
+            if (fds[0].revents & POLLIN) {
+                int clientFd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (clientFd >= 0) {
+                    HandleClient(clientFd);
+                    close(clientFd);
+                }
+            }
+        }
+    }
+
+    void HandleClient(int clientFd) {
+        // Request is small, a single read with a short timeout is enough
+        struct pollfd clientPoll = { clientFd, POLLIN, 0 };
+        char request[2048];
+        ssize_t length = 0;
+        if (poll(&clientPoll, 1, 1000) > 0) {
+            length = read(clientFd, request, sizeof(request) - 1);
+        }
+        if (length <= 0) { return; }
+        request[length] = '\0';
+
+        std::string response;
+        if (strncmp(request, "GET ", 4) != 0) {
+            response = "HTTP/1.1 405 Method Not Allowed\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        } else {
+            bool openMetrics = strstr(request, "application/openmetrics-text") != nullptr;
+            TelemetrySnapshot snapshot;
+            store.Read(snapshot);
+            std::string body = Format(snapshot, openMetrics);
+            response = std::string("HTTP/1.1 200 OK\r\nContent-Type: ")
+                + (openMetrics ? "application/openmetrics-text; version=1.0.0; charset=utf-8" : "text/plain; version=0.0.4; charset=utf-8")
+                + "\r\nContent-Length: " + std::to_string(body.size())
+                + "\r\nConnection: close\r\n\r\n" + body;
+        }
+
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t written = send(clientFd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) { break; }
+            sent += written;
+        }
+    }
+
+    void CloseFds() {
+        if (listenFd >= 0) { close(listenFd); }
+        if (stopFd >= 0) { close(stopFd); }
+        listenFd = -1;
+        stopFd = -1;
+    }
+};
@@ -0,0 +1,61 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/**
+ * Static user space tracepoints (USDT) of the tuxedo_io provider. Each probe
+ * site is a single nop with its arguments described in an ELF note, so a
+ * probe costs nothing until a tracer like bpftrace attaches to it. Without
+ * <sys/sdt.h> (systemtap-sdt-dev) at build time, or with
+ * TUXEDO_IO_DISABLE_PROBES defined, the probes compile to nothing.
+ *
+ * Probes and arguments:
+ *   ioctl__entry(request, value)
+ *   ioctl__return(request, value, result, errno, durationNs)
+ *   identify__entry()
+ *   identify__return(interfaceIndex)   -1 if no interface answered
+ *   fan__set(fanNr, speedPercent, success)
+ *   fan__get(fanNr, speedPercent, temperature, success)
+ *   napi__entry(name)
+ *   napi__return(name, threw)
+ *   udev__enumerate__entry(subsystem)
+ *   udev__enumerate__return(subsystem, devices)
+ */
+#if !defined(TUXEDO_IO_DISABLE_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define TUXEDO_IO_PROBES_ENABLED 1
+#endif
+#endif
+
+#ifdef TUXEDO_IO_PROBES_ENABLED
+#define TUXEDO_IO_PROBE0(name) DTRACE_PROBE(tuxedo_io, name)
+#define TUXEDO_IO_PROBE1(name, a1) DTRACE_PROBE1(tuxedo_io, name, a1)
+#define TUXEDO_IO_PROBE2(name, a1, a2) DTRACE_PROBE2(tuxedo_io, name, a1, a2)
+#define TUXEDO_IO_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(tuxedo_io, name, a1, a2, a3)
+#define TUXEDO_IO_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(tuxedo_io, name, a1, a2, a3, a4)
+#define TUXEDO_IO_PROBE5(name, a1, a2, a3, a4, a5) DTRACE_PROBE5(tuxedo_io, name, a1, a2, a3, a4, a5)
+#else
+#define TUXEDO_IO_PROBE0(name) do { } while (0)
+#define TUXEDO_IO_PROBE1(name, a1) do { } while (0)
+#define TUXEDO_IO_PROBE2(name, a1, a2) do { } while (0)
+#define TUXEDO_IO_PROBE3(name, a1, a2, a3) do { } while (0)
+#define TUXEDO_IO_PROBE4(name, a1, a2, a3, a4) do { } while (0)
+#define TUXEDO_IO_PROBE5(name, a1, a2, a3, a4, a5) do { } while (0)
+#endif
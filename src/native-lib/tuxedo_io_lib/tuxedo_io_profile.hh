@@ -0,0 +1,137 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "tuxedo_io_api.hh"
+#include "tuxedo_io_state.hh"
+
+struct FanTableEntry {
+    int temp;
+    int speed;
+};
+
+/**
+ * Complete hardware part of a TCC profile. Fields left empty (or fan mode
+ * unchanged) are not touched by the apply sequence.
+ */
+struct ProfileApplyRequest {
+    std::string odmProfile;
+    std::vector<int> tdpValues;
+    ProfileFanMode fanMode = ProfileFanMode::Unchanged;
+    // Per fan as decided by the fan control logic, -1 leaves the fan alone
+    std::vector<int> fanSpeeds;
+};
+
+struct ProfileApplyStep {
+    std::string name;
+    bool skipped = false;
+    bool success = false;
+    int64_t durationUs = 0;
+};
+
+class ProfileApplier {
+public:
+    /**
+     * The state record holds the last applied values and is used to skip
+     * steps without hardware getter (ODM profile, fan mode)
+     */
+    ProfileApplier(DeviceInterface &device, const DeviceStateRecord &state) : device(device), state(state) { }
+
+    /**
+     * Runs the whole profile switch as one ordered sequence: ODM profile
+     * first (firmware may reset limits on profile change), then TDPs,
+     * fan mode and finally the fan speeds
+     */
+    bool Apply(const ProfileApplyRequest &request, std::vector<ProfileApplyStep> &steps) {
+        bool success = true;
+        steps.clear();
+
+        if (!request.odmProfile.empty()) {
+            success &= RunStep(steps, "odmProfile", state.odmProfile == request.odmProfile, [&]() {
+                return device.SetODMPerformanceProfile(request.odmProfile);
+            });
+        }
+
+        int nrTDPs = 0;
+        if (request.tdpValues.size() > 0 && device.GetNumberTDPs(nrTDPs)) {
+            for (int i = 0; i < nrTDPs && i < (int) request.tdpValues.size(); ++i) {
+                int currentValue;
+                bool active = device.GetTDP(i, currentValue) && currentValue == request.tdpValues[i];
+                success &= RunStep(steps, "tdp" + std::to_string(i), active, [&]() {
+                    return device.SetTDP(i, request.tdpValues[i]);
+                });
+            }
+        }
+
+        if (request.fanMode != ProfileFanMode::Unchanged) {
+            success &= RunStep(steps, "fanMode", state.fanMode == request.fanMode, [&]() {
+                bool result;
+                if (request.fanMode == ProfileFanMode::Auto) {
+                    result = device.SetFansAuto();
+                    result &= device.SetEnableModeSet(false);
+                } else {
+                    result = device.SetEnableModeSet(true);
+                }
+                return result;
+            });
+        }
+
+        if (request.fanMode != ProfileFanMode::Auto) {
+            int nrFans = 0;
+            device.GetNumberFans(nrFans);
+            for (int i = 0; i < nrFans && i < (int) request.fanSpeeds.size(); ++i) {
+                int targetSpeed = request.fanSpeeds[i];
+                int currentSpeed;
+                if (targetSpeed < 0 || targetSpeed > 100) {
+                    continue;
+                }
+                bool active = device.GetFanSpeedPercent(i, currentSpeed) && currentSpeed == targetSpeed;
+                success &= RunStep(steps, "fan" + std::to_string(i), active, [&]() {
+                    return device.SetFanSpeedPercent(i, targetSpeed);
+                });
+            }
+        }
+
+        return success;
+    }
+
+private:
+    DeviceInterface &device;
+    const DeviceStateRecord &state;
+
+    template<typename Action>
+    bool RunStep(std::vector<ProfileApplyStep> &steps, const std::string &name, bool alreadyActive, Action action) {
+        ProfileApplyStep step;
+        step.name = name;
+        auto start = std::chrono::steady_clock::now();
+        if (alreadyActive) {
+            step.skipped = true;
+            step.success = true;
+        } else {
+            step.success = action();
+        }
+        step.durationUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        steps.push_back(step);
+        return step.success;
+    }
+};
@@ -0,0 +1,290 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "tuxedo_io_backend.hh"
+
+enum class IoctlPriority {
+    // Fan writes, profile applies, state restore
+    High = 0,
+    // Sensor reads feeding the fan control loop
+    Normal = 1,
+    // Informational reads
+    Low = 2,
+    // Pick from the kind of call: writes high, reads low
+    Auto = 3
+};
+
+#define IOCTL_PRIORITY_CLASSES 3
+
+enum class IoctlKind {
+    // Reads without input, identical pending calls share one ioctl
+    Read,
+    // Register writes, a pending write is replaced by a newer value
+    Write,
+    // Anything else, always executed as submitted
+    Other
+};
+
+struct IoctlQueueStats {
+    uint64_t depth;
+    uint64_t maxDepth;
+    uint64_t executed;
+    uint64_t coalesced;
+    uint64_t superseded;
+    uint64_t submitted[IOCTL_PRIORITY_CLASSES];
+    uint64_t totalWaitNs[IOCTL_PRIORITY_CLASSES];
+    uint64_t maxWaitNs[IOCTL_PRIORITY_CLASSES];
+};
+
+/**
+ * Submission queue in front of the ioctl syscall for callers on different
+ * threads. There is no dispatcher thread: a caller finding the queue idle
+ * executes pending calls in priority order until its own call is done, the
+ * others block until their call is done or take over executing.
+ */
+class IoctlQueue {
+public:
+    struct Result {
+        int result;
+        int error;
+        // False if the call was answered by an ioctl submitted by another caller
+        bool executed;
+        uint64_t durationNs;
+    };
+
+    static IoctlQueue &Default() {
+        static IoctlQueue queue;
+        return queue;
+    }
+
+    /**
+     * @param device Identifies the device behind fd, calls are only
+     * combined for the same device
+     * @param argument Pointer passed to ioctl, nullptr for calls without
+     * argument. Updated in place with the result.
+     * @param backend Answers the call instead of ioctl on fd if set
+     */
+    Result Submit(int fd, uint64_t device, unsigned long request, IoctlKind kind, void *argument, size_t argumentSize, IoctlPriority priority,
+                  IoctlBackend *backend = nullptr) {
+        if (priority == IoctlPriority::Auto) {
+            priority = ThreadPriority();
+        }
+        if (priority == IoctlPriority::Auto) {
+            priority = kind == IoctlKind::Read ? IoctlPriority::Low : IoctlPriority::High;
+        }
+        int priorityClass = (int) priority;
+        Key key = { device, request };
+        uint64_t enqueuedNs = NowNs();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        stats.submitted[priorityClass] += 1;
+
+        std::shared_ptr<Entry> entry;
+        bool owner = false;
+        if (kind == IoctlKind::Read && reads.count(key) > 0) {
+            entry = reads[key];
+            Promote(entry, priorityClass);
+            stats.coalesced += 1;
+        } else if (kind == IoctlKind::Write && writes.count(key) > 0) {
+            entry = writes[key];
+            if (argument != nullptr) {
+                memcpy(entry->argument.data(), argument, std::min(argumentSize, entry->argument.size()));
+            }
+            Promote(entry, priorityClass);
+            stats.superseded += 1;
+        } else {
+            entry = std::make_shared<Entry>();
+            entry->fd = fd;
+            entry->backend = backend;
+            entry->request = request;
+            entry->kind = kind;
+            entry->key = key;
+            entry->priorityClass = priorityClass;
+            if (argument != nullptr) {
+                entry->argument.assign((char *) argument, (char *) argument + argumentSize);
+                entry->hasArgument = true;
+            }
+            owner = true;
+            pending[priorityClass].push_back(entry);
+            if (kind == IoctlKind::Read) { reads[key] = entry; }
+            if (kind == IoctlKind::Write) { writes[key] = entry; }
+            depth += 1;
+            stats.maxDepth = std::max(stats.maxDepth, depth);
+        }
+
+        while (!entry->done) {
+            if (!executorActive) {
+                executorActive = true;
+                Drain(lock, *entry);
+                executorActive = false;
+                // Hand the executor role over to a caller still waiting
+                idle.notify_all();
+            } else {
+                idle.wait(lock);
+            }
+        }
+
+        uint64_t waitNs = NowNs() - enqueuedNs;
+        stats.totalWaitNs[priorityClass] += waitNs;
+        stats.maxWaitNs[priorityClass] = std::max(stats.maxWaitNs[priorityClass], waitNs);
+
+        if (argument != nullptr && !entry->argument.empty()) {
+            memcpy(argument, entry->argument.data(), std::min(argumentSize, entry->argument.size()));
+        }
+        return { entry->result, entry->error, owner, entry->durationNs };
+    }
+
+    IoctlQueueStats GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        IoctlQueueStats result = stats;
+        result.depth = depth;
+        return result;
+    }
+
+    /**
+     * Priority used for calls of the current thread submitted with Auto
+     */
+    static IoctlPriority &ThreadPriority() {
+        static thread_local IoctlPriority priority = IoctlPriority::Auto;
+        return priority;
+    }
+
+private:
+    typedef std::pair<uint64_t, unsigned long> Key;
+
+    struct Entry {
+        int fd;
+        IoctlBackend *backend = nullptr;
+        unsigned long request;
+        IoctlKind kind;
+        Key key;
+        int priorityClass;
+        bool started = false;
+        std::vector<char> argument;
+        bool hasArgument = false;
+        bool done = false;
+        int result = 0;
+        int error = 0;
+        uint64_t durationNs = 0;
+    };
+
+    std::mutex mutex;
+    std::condition_variable idle;
+    bool executorActive = false;
+    std::deque<std::shared_ptr<Entry>> pending[IOCTL_PRIORITY_CLASSES];
+    std::map<Key, std::shared_ptr<Entry>> reads;
+    std::map<Key, std::shared_ptr<Entry>> writes;
+    uint64_t depth = 0;
+    IoctlQueueStats stats = {};
+
+    static uint64_t NowNs() {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint64_t) now.tv_sec * 1000000000ull + now.tv_nsec;
+    }
+
+    /**
+     * Move a pending call up if a caller with higher priority waits for it
+     */
+    void Promote(const std::shared_ptr<Entry> &entry, int priorityClass) {
+        if (entry->started || priorityClass >= entry->priorityClass) { return; }
+        auto &queue = pending[entry->priorityClass];
+        queue.erase(std::remove(queue.begin(), queue.end(), entry), queue.end());
+        entry->priorityClass = priorityClass;
+        pending[priorityClass].push_back(entry);
+    }
+
+    std::shared_ptr<Entry> Next() {
+        for (auto &queue : pending) {
+            if (!queue.empty()) {
+                std::shared_ptr<Entry> entry = queue.front();
+                queue.pop_front();
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Execute pending calls in priority order until the call of the
+     * executing caller is done
+     */
+    void Drain(std::unique_lock<std::mutex> &lock, const Entry &own) {
+        std::shared_ptr<Entry> entry;
+        while (!own.done && (entry = Next()) != nullptr) {
+            depth -= 1;
+            entry->started = true;
+            // From here on the written value is fixed, later writes queue up anew
+            if (entry->kind == IoctlKind::Write) { writes.erase(entry->key); }
+            lock.unlock();
+
+            uint64_t start = NowNs();
+            int result;
+            int error = 0;
+            if (entry->backend != nullptr) {
+                result = entry->backend->Call(entry->request, entry->hasArgument ? entry->argument.data() : nullptr, entry->argument.size(), error);
+            } else {
+                result = entry->hasArgument ? ioctl(entry->fd, entry->request, entry->argument.data()) : ioctl(entry->fd, entry->request);
+                error = result < 0 ? errno : 0;
+            }
+            uint64_t durationNs = NowNs() - start;
+
+            lock.lock();
+            // Reads issued while this one was in flight may share its result
+            if (entry->kind == IoctlKind::Read) { reads.erase(entry->key); }
+            entry->result = result;
+            entry->error = error;
+            entry->durationNs = durationNs;
+            entry->done = true;
+            stats.executed += 1;
+            idle.notify_all();
+        }
+    }
+};
+
+/**
+ * Sets the queue priority for all calls of the current thread in scope
+ */
+class IoctlPriorityScope {
+public:
+    IoctlPriorityScope(IoctlPriority priority) : previous(IoctlQueue::ThreadPriority()) {
+        IoctlQueue::ThreadPriority() = priority;
+    }
+
+    ~IoctlPriorityScope() {
+        IoctlQueue::ThreadPriority() = previous;
+    }
+
+private:
+    IoctlPriority previous;
+};
@@ -0,0 +1,133 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <functional>
+#include <thread>
+
+/**
+ * Detects system resume without periodic wakeups. A CLOCK_REALTIME timerfd
+ * armed with TFD_TIMER_CANCEL_ON_SET is cancelled by the kernel whenever
+ * the realtime clock jumps, which includes resume from suspend. A growing
+ * difference between CLOCK_BOOTTIME and CLOCK_MONOTONIC (the latter does
+ * not advance while suspended) separates a resume from a manual clock set.
+ */
+class ResumeWatcher {
+public:
+    typedef std::function<void(int64_t suspendedMs)> ResumeCallback;
+
+    ~ResumeWatcher() {
+        Stop();
+    }
+
+    bool Start(ResumeCallback callback) {
+        if (running) { return false; }
+
+        timerFd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC);
+        stopFd = eventfd(0, EFD_CLOEXEC);
+        if (timerFd < 0 || stopFd < 0 || !ArmTimer()) {
+            CloseFds();
+            return false;
+        }
+
+        this->callback = callback;
+        lastSuspendOffsetMs = SuspendOffsetMs();
+        running = true;
+        watchThread = std::thread(&ResumeWatcher::Run, this);
+        return true;
+    }
+
+    void Stop() {
+        if (!running) { return; }
+        uint64_t value = 1;
+        ssize_t written = write(stopFd, &value, sizeof(value));
+        (void) written;
+        watchThread.join();
+        running = false;
+        CloseFds();
+    }
+
+    bool IsRunning() {
+        return running;
+    }
+
+    /**
+     * Total time spent in suspend since boot
+     */
+    static int64_t SuspendOffsetMs() {
+        struct timespec boottime, monotonic;
+        clock_gettime(CLOCK_BOOTTIME, &boottime);
+        clock_gettime(CLOCK_MONOTONIC, &monotonic);
+        return (boottime.tv_sec - monotonic.tv_sec) * 1000 + (boottime.tv_nsec - monotonic.tv_nsec) / 1000000;
+    }
+
+private:
+    // Offset growth below this is treated as clock jitter, not a suspend
+    const int64_t SUSPEND_THRESHOLD_MS = 500;
+
+    int timerFd = -1;
+    int stopFd = -1;
+    bool running = false;
+    int64_t lastSuspendOffsetMs = 0;
+    ResumeCallback callback;
+    std::thread watchThread;
+
+    bool ArmTimer() {
+        // Expiry far in the future, only the cancellation is of interest
+        struct itimerspec spec = {};
+        spec.it_value.tv_sec = INT32_MAX;
+        return timerfd_settime(timerFd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &spec, nullptr) == 0;
+    }
+
+    void Run() {
+        struct pollfd fds[2] = { { timerFd, POLLIN, 0 }, { stopFd, POLLIN, 0 } };
+        while (true) {
+            int result = poll(fds, 2, -1);
+            if (result < 0 && errno == EINTR) { continue; }
+            if (result < 0 || (fds[1].revents & POLLIN)) { break; }
+
+            if (fds[0].revents & POLLIN) {
+                uint64_t expirations;
+                if (read(timerFd, &expirations, sizeof(expirations)) < 0 && errno == ECANCELED) {
+                    int64_t suspendOffsetMs = SuspendOffsetMs();
+                    int64_t suspendedMs = suspendOffsetMs - lastSuspendOffsetMs;
+                    lastSuspendOffsetMs = suspendOffsetMs;
+                    if (suspendedMs >= SUSPEND_THRESHOLD_MS) {
+                        callback(suspendedMs);
+                    }
+                }
+                ArmTimer();
+            }
+        }
+    }
+
+    void CloseFds() {
+        if (timerFd >= 0) { close(timerFd); }
+        if (stopFd >= 0) { close(stopFd); }
+        timerFd = -1;
+        stopFd = -1;
+    }
+};
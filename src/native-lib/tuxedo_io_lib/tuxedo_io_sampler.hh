@@ -0,0 +1,310 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "tuxedo_io_profile.hh"
+
+#define SAMPLER_MAX_SENSORS 3
+
+struct SamplerSensorStats {
+    int fanNr;
+    int temperature;
+    // Smoothed temperature change in °C per second
+    double slope;
+    int64_t intervalMs;
+    // Distance to the closest temperature where the fan table changes speed, -1 if unknown
+    int breakpointDistance;
+};
+
+struct SamplerStats {
+    bool running;
+    int wakeupsPerMinute;
+    std::vector<SamplerSensorStats> sensors;
+};
+
+/**
+ * Samples the fan temperature sensors on a native thread with a per sensor
+ * interval. Steady temperatures far away from the next fan table breakpoint
+ * are sampled rarely, rising or falling temperatures close to a breakpoint
+ * at up to the minimum interval.
+ */
+class AdaptiveSampler {
+public:
+    typedef std::function<bool(int fanNr, int &temperature)> TemperatureRead;
+    typedef std::function<void(int fanNr, int temperature)> SampleCallback;
+
+    ~AdaptiveSampler() {
+        Stop();
+    }
+
+    /**
+     * @param readTemperature Reads one sensor, run on the sampler thread
+     * @param onSample Run on the sampler thread for every successful read
+     */
+    bool Start(TemperatureRead readTemperature, int nrSensors, int64_t minIntervalMs, int64_t maxIntervalMs, SampleCallback onSample) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (running || nrSensors <= 0 || minIntervalMs <= 0 || maxIntervalMs < minIntervalMs) { return false; }
+
+        this->readTemperature = readTemperature;
+        this->onSample = onSample;
+        this->minIntervalMs = minIntervalMs;
+        this->maxIntervalMs = maxIntervalMs;
+        auto now = Clock::now();
+        this->nrSensors = std::min(nrSensors, SAMPLER_MAX_SENSORS);
+        for (int i = 0; i < SAMPLER_MAX_SENSORS; ++i) {
+            Sensor &sensor = sensors[i];
+            sensor.temperature = -1;
+            sensor.slope = 0;
+            sensor.intervalMs = minIntervalMs;
+            sensor.nextSample = now;
+        }
+        for (auto &bucket : wakeupBuckets) { bucket = { 0, 0 }; }
+        stopRequested = false;
+        running = true;
+        samplerThread = std::thread(&AdaptiveSampler::Run, this);
+        return true;
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) { return; }
+            stopRequested = true;
+        }
+        wakeup.notify_all();
+        samplerThread.join();
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        readTemperature = nullptr;
+    }
+
+    bool IsRunning() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return running;
+    }
+
+    /**
+     * Fan table the sensor drives. Only temperatures where the speed
+     * changes are kept as breakpoints. Resamples the sensor right away.
+     */
+    void SetFanTable(int fanNr, const std::vector<FanTableEntry> &table) {
+        if (fanNr < 0 || fanNr >= SAMPLER_MAX_SENSORS) { return; }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Sensor &sensor = sensors[fanNr];
+            sensor.breakpoints.clear();
+            for (size_t i = 1; i < table.size(); ++i) {
+                if (table[i].speed != table[i - 1].speed) {
+                    sensor.breakpoints.push_back(table[i].temp);
+                }
+            }
+            sensor.nextSample = Clock::now();
+        }
+        wakeup.notify_all();
+    }
+
+    /**
+     * Latest sampled temperature, false if the sensor was not read yet, the
+     * last read failed or the next sample is overdue, e.g. behind a hanging read
+     */
+    bool GetTemperature(int fanNr, int &temperature) {
+        if (fanNr < 0 || fanNr >= SAMPLER_MAX_SENSORS) { return false; }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running || fanNr >= nrSensors || sensors[fanNr].temperature < 0) { return false; }
+        if (Clock::now() - sensors[fanNr].lastSample > std::chrono::milliseconds(2 * maxIntervalMs)) { return false; }
+        temperature = sensors[fanNr].temperature;
+        return true;
+    }
+
+    SamplerStats GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        SamplerStats stats;
+        stats.running = running;
+        stats.wakeupsPerMinute = 0;
+        int64_t currentSecond = SecondsSinceEpoch(Clock::now());
+        for (const auto &bucket : wakeupBuckets) {
+            if (currentSecond - bucket.second < WAKEUP_WINDOW_S) {
+                stats.wakeupsPerMinute += bucket.count;
+            }
+        }
+        for (int i = 0; running && i < nrSensors; ++i) {
+            const Sensor &sensor = sensors[i];
+            stats.sensors.push_back({ i, sensor.temperature, sensor.slope, sensor.intervalMs, BreakpointDistance(sensor) });
+        }
+        return stats;
+    }
+
+    /**
+     * Interval for a sensor: half the estimated time until the temperature
+     * reaches the next breakpoint, bounded by min and max interval
+     */
+    static int64_t ComputeIntervalMs(double slope, int breakpointDistance, int64_t minIntervalMs, int64_t maxIntervalMs) {
+        double absoluteSlope = fabs(slope);
+        if (breakpointDistance < 0) {
+            // Without fan table only the slope is known, 1 °C change per sample at most
+            breakpointDistance = 1;
+        }
+        if (absoluteSlope < SLOPE_EPSILON) {
+            return maxIntervalMs;
+        }
+        double timeToBreakpointMs = (std::max(breakpointDistance, 1) / absoluteSlope) * 1000.0;
+        int64_t interval = (int64_t) (timeToBreakpointMs / 2);
+        return std::max(minIntervalMs, std::min(maxIntervalMs, interval));
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    static constexpr double SLOPE_EPSILON = 0.05;
+    // Weight of the newest slope measurement
+    static constexpr double SLOPE_SMOOTHING = 0.5;
+    static constexpr int WAKEUP_WINDOW_S = 60;
+    static constexpr int64_t INITIAL_INTERVAL_MS = 1000;
+
+    struct Sensor {
+        int temperature = -1;
+        double slope = 0;
+        int64_t intervalMs = 0;
+        Clock::time_point lastSample;
+        Clock::time_point nextSample;
+        std::vector<int> breakpoints;
+    };
+
+    struct WakeupBucket {
+        int count;
+        int64_t second;
+    };
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::thread samplerThread;
+    bool running = false;
+    bool stopRequested = false;
+
+    TemperatureRead readTemperature;
+    SampleCallback onSample;
+    int nrSensors = 0;
+    int64_t minIntervalMs = 0;
+    int64_t maxIntervalMs = 0;
+    Sensor sensors[SAMPLER_MAX_SENSORS];
+    WakeupBucket wakeupBuckets[WAKEUP_WINDOW_S];
+
+    static int64_t SecondsSinceEpoch(Clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+    }
+
+    static int BreakpointDistance(const Sensor &sensor) {
+        if (sensor.breakpoints.empty() || sensor.temperature < 0) { return -1; }
+        int distance = -1;
+        for (int breakpoint : sensor.breakpoints) {
+            int current = abs(breakpoint - sensor.temperature);
+            if (distance < 0 || current < distance) {
+                distance = current;
+            }
+        }
+        return distance;
+    }
+
+    void CountWakeup(Clock::time_point now) {
+        int64_t second = SecondsSinceEpoch(now);
+        WakeupBucket &bucket = wakeupBuckets[second % WAKEUP_WINDOW_S];
+        if (bucket.second != second) {
+            bucket = { 0, second };
+        }
+        bucket.count += 1;
+    }
+
+    void Run() {
+        // Temperatures feed the fan control, ahead of informational reads
+        IoctlPriorityScope priority(IoctlPriority::Normal);
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopRequested) {
+            auto now = Clock::now();
+            Clock::time_point nextWakeup = now + std::chrono::milliseconds(maxIntervalMs);
+            std::vector<int> due;
+            for (int i = 0; i < nrSensors; ++i) {
+                if (sensors[i].nextSample <= now) {
+                    due.push_back(i);
+                } else {
+                    nextWakeup = std::min(nextWakeup, sensors[i].nextSample);
+                }
+            }
+
+            if (due.empty()) {
+                wakeup.wait_until(lock, nextWakeup);
+                continue;
+            }
+
+            CountWakeup(now);
+            // Device reads happen without the lock so stats and cached reads never block on IO
+            lock.unlock();
+            std::vector<std::pair<int, int>> results;
+            for (int fanNr : due) {
+                int temperature = -1;
+                bool success = readTemperature(fanNr, temperature) && temperature >= 0;
+                results.push_back({ fanNr, success ? temperature : -1 });
+                if (success && onSample) {
+                    onSample(fanNr, temperature);
+                }
+            }
+            lock.lock();
+
+            auto sampleTime = Clock::now();
+            for (const auto &result : results) {
+                UpdateSensor(sensors[result.first], result.second, sampleTime);
+            }
+        }
+    }
+
+    void UpdateSensor(Sensor &sensor, int temperature, Clock::time_point sampleTime) {
+        if (temperature < 0) {
+            // Callers fall back to reading the sensor themselves, retry failed reads at the slowest rate
+            sensor.temperature = -1;
+            sensor.slope = 0;
+            sensor.intervalMs = maxIntervalMs;
+            sensor.nextSample = sampleTime + std::chrono::milliseconds(sensor.intervalMs);
+            return;
+        }
+        bool firstSample = sensor.temperature < 0;
+        if (!firstSample) {
+            double elapsedS = std::chrono::duration<double>(sampleTime - sensor.lastSample).count();
+            if (elapsedS > 0) {
+                double slope = (temperature - sensor.temperature) / elapsedS;
+                sensor.slope = SLOPE_SMOOTHING * slope + (1 - SLOPE_SMOOTHING) * sensor.slope;
+            }
+        }
+        sensor.temperature = temperature;
+        sensor.lastSample = sampleTime;
+        sensor.intervalMs = ComputeIntervalMs(sensor.slope, BreakpointDistance(sensor), minIntervalMs, maxIntervalMs);
+        if (firstSample) {
+            // No slope yet, take a second sample soon
+            sensor.intervalMs = std::max(minIntervalMs, std::min(maxIntervalMs, INITIAL_INTERVAL_MS));
+        }
+        sensor.nextSample = sampleTime + std::chrono::milliseconds(sensor.intervalMs);
+    }
+};
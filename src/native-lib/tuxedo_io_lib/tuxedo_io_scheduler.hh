@@ -0,0 +1,372 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ScheduledJobStats {
+    int id;
+    std::string name;
+    int64_t periodMs;
+    int64_t slackMs;
+    uint64_t runs;
+    // Deadlines passed while the previous run was still in progress
+    uint64_t overruns;
+    double lastRuntimeMs;
+    double maxRuntimeMs;
+    double totalRuntimeMs;
+    double lastLatenessMs;
+    double maxLatenessMs;
+    double totalLatenessMs;
+};
+
+/**
+ * Periodic job scheduler on a single timerfd/epoll thread. Deadlines are
+ * aligned to multiples of the job period since the scheduler start, so jobs
+ * with related periods share tick boundaries. A wakeup is delayed to later
+ * deadlines as long as the slack of every pending job allows, and all jobs
+ * due at that point run as one batch: first their native work on the
+ * scheduler thread, then one dispatch with all job ids (e.g. to JS).
+ */
+class JobScheduler {
+public:
+    typedef std::function<void(const std::vector<int> &jobIds)> DispatchCallback;
+
+    ~JobScheduler() {
+        Stop();
+    }
+
+    /**
+     * @param nativeWork Optional work run on the scheduler thread before dispatch
+     * @returns Job id, -1 for invalid parameters
+     */
+    int AddJob(const std::string &name, int64_t periodMs, int64_t slackMs, std::function<void()> nativeWork = nullptr) {
+        if (periodMs <= 0 || slackMs < 0) { return -1; }
+        int id;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            id = nextJobId++;
+            Job &job = jobs[id];
+            job.name = name;
+            job.periodMs = periodMs;
+            job.slackMs = std::min(slackMs, periodMs);
+            job.nativeWork = nativeWork;
+            job.deadlineNs = AlignedDeadline(NowNs(), periodMs);
+        }
+        Rearm();
+        return id;
+    }
+
+    /**
+     * Replace the native work of a job, e.g. once the device it reads appeared
+     */
+    bool SetJobWork(int id, std::function<void()> nativeWork) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto job = jobs.find(id);
+        if (job == jobs.end()) { return false; }
+        job->second.nativeWork = nativeWork;
+        return true;
+    }
+
+    bool RemoveJob(int id) {
+        bool removed;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            removed = jobs.erase(id) > 0;
+        }
+        if (removed) { Rearm(); }
+        return removed;
+    }
+
+    bool Start(DispatchCallback dispatch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) { return false; }
+        timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (timerFd < 0 || wakeFd < 0 || epollFd < 0 || !AddToEpoll(timerFd) || !AddToEpoll(wakeFd)) {
+            CloseFds();
+            return false;
+        }
+
+        this->dispatch = dispatch;
+        epochNs = NowNs();
+        for (auto &it : jobs) {
+            it.second.deadlineNs = AlignedDeadline(epochNs, it.second.periodMs);
+            it.second.inProgress = false;
+        }
+        wakeups = 0;
+        stopRequested = false;
+        running = true;
+        schedulerThread = std::thread(&JobScheduler::Run, this);
+        return true;
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) { return; }
+            stopRequested = true;
+        }
+        Signal();
+        schedulerThread.join();
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        CloseFds();
+    }
+
+    bool IsRunning() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return running;
+    }
+
+    /**
+     * Marks the dispatched part of a job as finished. Until then further
+     * deadlines of the job are counted as overruns instead of dispatched.
+     */
+    void CompleteJob(int id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = jobs.find(id);
+        if (it == jobs.end() || !it->second.inProgress) { return; }
+        Job &job = it->second;
+        job.inProgress = false;
+        double runtimeMs = (NowNs() - job.startedNs) / 1e6;
+        job.stats.lastRuntimeMs = runtimeMs;
+        job.stats.maxRuntimeMs = std::max(job.stats.maxRuntimeMs, runtimeMs);
+        job.stats.totalRuntimeMs += runtimeMs;
+    }
+
+    /**
+     * Name, slack and deadline of the job's run in progress
+     * @returns False if the job is not in progress
+     */
+    bool GetRunInProgress(int id, std::string &name, int64_t &slackMs, uint64_t &deadlineNs) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = jobs.find(id);
+        if (it == jobs.end() || !it->second.inProgress) { return false; }
+        name = it->second.name;
+        slackMs = it->second.slackMs;
+        deadlineNs = it->second.runDeadlineNs;
+        return true;
+    }
+
+    std::vector<ScheduledJobStats> GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<ScheduledJobStats> result;
+        for (const auto &it : jobs) {
+            ScheduledJobStats stats = it.second.stats;
+            stats.id = it.first;
+            stats.name = it.second.name;
+            stats.periodMs = it.second.periodMs;
+            stats.slackMs = it.second.slackMs;
+            result.push_back(stats);
+        }
+        return result;
+    }
+
+    uint64_t Wakeups() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return wakeups;
+    }
+
+private:
+    struct Job {
+        std::string name;
+        int64_t periodMs = 0;
+        int64_t slackMs = 0;
+        std::function<void()> nativeWork;
+        uint64_t deadlineNs = 0;
+        uint64_t startedNs = 0;
+        // Deadline of the run in progress
+        uint64_t runDeadlineNs = 0;
+        bool inProgress = false;
+        ScheduledJobStats stats = {};
+    };
+
+    std::mutex mutex;
+    std::map<int, Job> jobs;
+    int nextJobId = 1;
+    DispatchCallback dispatch;
+    uint64_t epochNs = 0;
+    uint64_t wakeups = 0;
+
+    std::thread schedulerThread;
+    bool running = false;
+    bool stopRequested = false;
+    int timerFd = -1;
+    int wakeFd = -1;
+    int epollFd = -1;
+
+    static uint64_t NowNs() {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint64_t) now.tv_sec * 1000000000ull + now.tv_nsec;
+    }
+
+    /**
+     * Next multiple of the period after the given time, counted from the
+     * scheduler epoch
+     */
+    uint64_t AlignedDeadline(uint64_t afterNs, int64_t periodMs) {
+        uint64_t periodNs = (uint64_t) periodMs * 1000000ull;
+        uint64_t base = afterNs < epochNs ? 0 : afterNs - epochNs;
+        return epochNs + (base / periodNs + 1) * periodNs;
+    }
+
+    bool AddToEpoll(int fd) {
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+
+    void Signal() {
+        uint64_t value = 1;
+        ssize_t written = write(wakeFd, &value, sizeof(value));
+        (void) written;
+    }
+
+    void Rearm() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) { Signal(); }
+    }
+
+    /**
+     * Earliest deadline, pushed back to later deadlines as long as the
+     * slack of every job already included allows it. Must be called with
+     * the lock held.
+     */
+    uint64_t NextWakeupNs() {
+        std::vector<std::pair<uint64_t, uint64_t>> deadlines;
+        for (const auto &it : jobs) {
+            deadlines.push_back({ it.second.deadlineNs, it.second.deadlineNs + (uint64_t) it.second.slackMs * 1000000ull });
+        }
+        if (deadlines.empty()) { return UINT64_MAX; }
+        std::sort(deadlines.begin(), deadlines.end());
+
+        uint64_t wakeupNs = deadlines[0].first;
+        uint64_t limitNs = deadlines[0].second;
+        for (const auto &deadline : deadlines) {
+            if (deadline.first > limitNs) { break; }
+            wakeupNs = deadline.first;
+            limitNs = std::min(limitNs, deadline.second);
+        }
+        return wakeupNs;
+    }
+
+    void ArmTimer(uint64_t wakeupNs) {
+        struct itimerspec spec = {};
+        if (wakeupNs != UINT64_MAX) {
+            spec.it_value.tv_sec = wakeupNs / 1000000000ull;
+            spec.it_value.tv_nsec = wakeupNs % 1000000000ull;
+        }
+        // All zero disarms the timer when there are no jobs
+        timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+    }
+
+    void Run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopRequested) {
+            ArmTimer(NextWakeupNs());
+            lock.unlock();
+
+            struct epoll_event events[2];
+            int count = epoll_wait(epollFd, events, 2, -1);
+            uint64_t value;
+            for (int i = 0; i < count; ++i) {
+                ssize_t result = read(events[i].data.fd, &value, sizeof(value));
+                (void) result;
+            }
+
+            lock.lock();
+            if (count < 0 && errno != EINTR) { break; }
+            if (stopRequested) { break; }
+            RunDueJobs(lock);
+        }
+    }
+
+    void RunDueJobs(std::unique_lock<std::mutex> &lock) {
+        uint64_t now = NowNs();
+        std::vector<int> due;
+        std::vector<std::function<void()>> nativeWork;
+        for (auto &it : jobs) {
+            Job &job = it.second;
+            if (job.deadlineNs > now) { continue; }
+            if (job.inProgress) {
+                job.stats.overruns += 1;
+            } else {
+                double latenessMs = (now - job.deadlineNs) / 1e6;
+                job.stats.runs += 1;
+                job.stats.lastLatenessMs = latenessMs;
+                job.stats.maxLatenessMs = std::max(job.stats.maxLatenessMs, latenessMs);
+                job.stats.totalLatenessMs += latenessMs;
+                job.startedNs = now;
+                job.runDeadlineNs = job.deadlineNs;
+                job.inProgress = true;
+                due.push_back(it.first);
+                if (job.nativeWork) { nativeWork.push_back(job.nativeWork); }
+            }
+            // Skip deadlines missed entirely instead of running them back to back
+            job.deadlineNs = AlignedDeadline(std::max(now, job.deadlineNs), job.periodMs);
+        }
+        if (due.empty()) { return; }
+        wakeups += 1;
+
+        DispatchCallback dispatchCopy = dispatch;
+        lock.unlock();
+        for (auto &work : nativeWork) {
+            work();
+        }
+        if (dispatchCopy) {
+            dispatchCopy(due);
+        }
+        lock.lock();
+
+        if (!dispatchCopy) {
+            // Without dispatch target the job is done after its native work
+            for (int id : due) {
+                lock.unlock();
+                CompleteJob(id);
+                lock.lock();
+            }
+        }
+    }
+
+    void CloseFds() {
+        if (timerFd >= 0) { close(timerFd); }
+        if (wakeFd >= 0) { close(wakeFd); }
+        if (epollFd >= 0) { close(epollFd); }
+        timerFd = -1;
+        wakeFd = -1;
+        epollFd = -1;
+    }
+};
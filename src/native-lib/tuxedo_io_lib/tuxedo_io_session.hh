@@ -0,0 +1,250 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include "tuxedo_io_api.hh"
+#include "tuxedo_io_backend.hh"
+#include "tuxedo_io_state.hh"
+
+struct DeviceSessionStats {
+    // Holders of the session, one per addon instance plus pending async work
+    long users;
+    uint64_t opens;
+    uint64_t acquisitions;
+    uint64_t contended;
+};
+
+/**
+ * Interface found when the device (re)appeared
+ */
+struct DeviceIdentification {
+    bool available;
+    std::string interfaceId;
+    std::string modelId;
+    int64_t durationUs;
+};
+
+/**
+ * Process wide device shared by every addon instance (main thread and
+ * worker_threads). Kept open while referenced, setters are recorded into one
+ * state record. Single calls share the session and meet in the IoctlQueue,
+ * which orders them by priority and combines identical ones. Sequences that
+ * must not interleave with other calls lock it exclusively.
+ */
+class DeviceSession {
+public:
+    /**
+     * Access to the device, holds the session lock shared or exclusive while alive
+     */
+    class Access {
+    public:
+        Access(DeviceSession &session, bool exclusive) : session(&session) {
+            if (exclusive) {
+                exclusiveLock = std::unique_lock<std::shared_mutex>(session.mutex, std::try_to_lock);
+                if (!exclusiveLock.owns_lock()) {
+                    session.contended.fetch_add(1, std::memory_order_relaxed);
+                    exclusiveLock.lock();
+                }
+                session.Reopen();
+            } else {
+                sharedLock = std::shared_lock<std::shared_mutex>(session.mutex, std::try_to_lock);
+                if (!sharedLock.owns_lock()) {
+                    session.contended.fetch_add(1, std::memory_order_relaxed);
+                    sharedLock.lock();
+                }
+                if (session.NeedsReopen()) {
+                    // Replacing the device waits for the other holders to be done with it
+                    sharedLock.unlock();
+                    {
+                        std::unique_lock<std::shared_mutex> reopenLock(session.mutex);
+                        session.Reopen();
+                    }
+                    sharedLock.lock();
+                }
+            }
+            session.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        TuxedoIOAPI &Device() {
+            return *session->device;
+        }
+
+        /**
+         * Recorded state, only stable while locked exclusively
+         */
+        DeviceStateRecord &State() {
+            return session->state;
+        }
+
+        /**
+         * Device recording every successful setter into the session state
+         */
+        StateRecordingDevice Recording() {
+            return StateRecordingDevice(*session->device, session->state, session->stateMutex);
+        }
+
+    private:
+        std::unique_lock<std::shared_mutex> exclusiveLock;
+        std::shared_lock<std::shared_mutex> sharedLock;
+        DeviceSession *session;
+    };
+
+    /**
+     * The session of this process, created for the first holder and closed
+     * with the last one
+     */
+    static std::shared_ptr<DeviceSession> Acquire() {
+        std::lock_guard<std::mutex> lock(CurrentMutex());
+        std::shared_ptr<DeviceSession> session = Current().lock();
+        if (!session) {
+            session.reset(new DeviceSession());
+            Current() = session;
+        }
+        return session;
+    }
+
+    /**
+     * Exclusive access for call sequences, e.g. a profile switch or restore
+     */
+    Access Lock() {
+        return Access(*this, true);
+    }
+
+    /**
+     * Shared access for single calls
+     */
+    Access Share() {
+        return Access(*this, false);
+    }
+
+    /**
+     * The device file appeared or disappeared. An appeared device is opened
+     * and identified once right away, a disappeared one is closed. While a
+     * watcher reports the file missing, accesses no longer try to reopen it.
+     */
+    DeviceIdentification DevicePresenceChanged(bool present) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        DevicePresence previous = devicePresence.exchange(present ? DevicePresence::Present : DevicePresence::Absent, std::memory_order_relaxed);
+        if (present && previous != DevicePresence::Present) {
+            // Requests the previous module rejected may be supported by the new one
+            IoctlBreaker::Default().Reset();
+        }
+        device.reset();
+        Reopen();
+
+        DeviceIdentification identification = {};
+        identification.available = device->WmiAvailable();
+        if (identification.available) {
+            device->DeviceInterfaceIdStr(identification.interfaceId);
+            device->DeviceModelIdStr(identification.modelId);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        identification.durationUs = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+        return identification;
+    }
+
+    /**
+     * No watcher anymore, a missing device is retried on every access again
+     */
+    void ForgetDevicePresence() {
+        devicePresence.store(DevicePresence::Unknown, std::memory_order_relaxed);
+    }
+
+    DeviceSessionStats GetStats() {
+        DeviceSessionStats stats;
+        {
+            std::lock_guard<std::mutex> lock(CurrentMutex());
+            stats.users = Current().use_count();
+        }
+        stats.opens = opens.load(std::memory_order_relaxed);
+        stats.acquisitions = acquisitions.load(std::memory_order_relaxed);
+        stats.contended = contended.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    enum class DevicePresence {
+        Unknown,
+        Present,
+        Absent
+    };
+
+    std::shared_mutex mutex;
+    std::unique_ptr<TuxedoIOAPI> device;
+    std::shared_ptr<IoctlBackend> deviceBackend;
+    DeviceStateRecord state;
+    std::mutex stateMutex;
+    std::atomic<uint64_t> opens { 0 };
+    std::atomic<uint64_t> acquisitions { 0 };
+    std::atomic<uint64_t> contended { 0 };
+    std::atomic<DevicePresence> devicePresence { DevicePresence::Unknown };
+
+    DeviceSession() { }
+
+    static std::mutex &CurrentMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::weak_ptr<DeviceSession> &Current() {
+        static std::weak_ptr<DeviceSession> session;
+        return session;
+    }
+
+    /**
+     * A watcher reports the device file missing and no backend replaces it
+     */
+    bool KeepClosed(const std::shared_ptr<IoctlBackend> &backend) {
+        return backend == nullptr && devicePresence.load(std::memory_order_relaxed) == DevicePresence::Absent;
+    }
+
+    bool NeedsReopen() {
+        std::shared_ptr<IoctlBackend> backend = IoctlBackend::Active();
+        if (!device || backend != deviceBackend) { return true; }
+        // An open device is closed once the file is gone, a missing one retried until it is
+        return KeepClosed(backend) ? device->WmiAvailable() : !device->WmiAvailable();
+    }
+
+    /**
+     * Open on first use, after the active backend changed and while the
+     * device file is missing unless a watcher reports it missing, the lock
+     * is held
+     */
+    void Reopen() {
+        if (!NeedsReopen()) { return; }
+        std::shared_ptr<IoctlBackend> backend = IoctlBackend::Active();
+        device.reset();
+        if (KeepClosed(backend)) {
+            device.reset(new TuxedoIOAPI(nullptr, nullptr));
+        } else {
+            device.reset(new TuxedoIOAPI(backend));
+            opens.fetch_add(1, std::memory_order_relaxed);
+        }
+        deviceBackend = backend;
+    }
+};
@@ -0,0 +1,419 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tuxedo_io_backend.hh"
+#include "tuxedo_io_ioctl.h"
+
+enum class SimulatedInterface {
+    Clevo,
+    Uniwill
+};
+
+struct IoctlSimulationOptions {
+    SimulatedInterface interface = SimulatedInterface::Uniwill;
+    // Module advertises and implements the batch ioctls
+    bool batchSupport = true;
+    // The batch ioctl is advertised but fails as a whole with this errno, 0 if it works
+    int batchError = 0;
+    std::string moduleVersion = MOD_API_MIN_VERSION;
+    // Cost of one user/kernel transition and of one EC register access
+    int64_t transitionLatencyUs = 0;
+    int64_t registerLatencyUs = 0;
+    // Fan actuator as the EC drives it, all 0 for fans that follow writes at once.
+    // Time until the EC reacts to a write and the rate the fan speed changes at
+    int64_t fanDeadTimeMs = 0;
+    double fanSlewPercentPerSecond = 0;
+    // Lower non-zero speeds stop the fan
+    int fanMinimumPercent = 0;
+    // The EC drives the fan in steps of this size
+    int fanStepPercent = 0;
+};
+
+struct IoctlSimulationStats {
+    // Every ioctl, scalar or batch
+    uint64_t transitions;
+    uint64_t batchCalls;
+    uint64_t registerAccesses;
+    // Fans driven by the EC, not by speed writes
+    bool fansAuto;
+};
+
+enum class SimulationEventType {
+    Temperature,
+    FanSpeed
+};
+
+/**
+ * Change of a simulated sensor or actuator, time since simulation start
+ */
+struct SimulationEvent {
+    uint64_t timeNs;
+    SimulationEventType type;
+    int fanNr;
+    int value;
+};
+
+/**
+ * Simulated tuxedo_io module with the register set of a Clevo or Uniwill
+ * device. Writes are reflected by the matching reads, fan speeds through the
+ * actuator model of the options. Temperatures are set from outside.
+ */
+class IoctlSimulation : public IoctlBackend {
+public:
+    IoctlSimulation(const IoctlSimulationOptions &options = IoctlSimulationOptions()) : options(options) {
+        if (options.interface == SimulatedInterface::Clevo) {
+            fanRaw[0] = fanRaw[1] = fanRaw[2] = 0x80;
+        } else {
+            fanRaw[0] = fanRaw[1] = 0x64;
+        }
+        startTime = std::chrono::steady_clock::now();
+        int nrFans = options.interface == SimulatedInterface::Clevo ? 3 : 2;
+        for (int i = 0; i < nrFans; ++i) {
+            fanActualRaw[i] = fanRaw[i];
+            fanWrittenTime[i] = startTime;
+            fanPercent[i] = RawToPercent(fanRaw[i]);
+            AddEvent(SimulationEventType::Temperature, i, temperatures[i]);
+            AddEvent(SimulationEventType::FanSpeed, i, fanPercent[i]);
+        }
+    }
+
+    int Call(unsigned long request, void *argument, size_t argumentSize, int &error) override {
+        Delay(options.transitionLatencyUs);
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.transitions += 1;
+        error = 0;
+        AdvanceFans();
+
+        if (request == R_MOD_VERSION) {
+            if (argument == nullptr || argumentSize == 0) { error = EFAULT; return -1; }
+            strncpy((char *) argument, options.moduleVersion.c_str(), argumentSize - 1);
+            ((char *) argument)[argumentSize - 1] = '\0';
+            return 0;
+        }
+        if (request == R_CL_HW_IF_STR && options.interface == SimulatedInterface::Clevo) {
+            if (argument == nullptr || argumentSize == 0) { error = EFAULT; return -1; }
+            strncpy((char *) argument, "clevo_acpi", argumentSize - 1);
+            ((char *) argument)[argumentSize - 1] = '\0';
+            return 0;
+        }
+        if ((request == RW_CL_BATCH && options.interface == SimulatedInterface::Clevo)
+            || (request == RW_UW_BATCH && options.interface == SimulatedInterface::Uniwill)) {
+            if (!options.batchSupport) { error = ENOTTY; return -1; }
+            if (options.batchError != 0) { error = options.batchError; return -1; }
+            return Batch((struct tuxedo_io_batch *) argument, argumentSize, error);
+        }
+
+        int32_t value = 0;
+        if (argument != nullptr && argumentSize >= sizeof(value)) {
+            memcpy(&value, argument, sizeof(value));
+        }
+        error = Register(request, value);
+        if (error != 0) { return -1; }
+        if (argument != nullptr && argumentSize >= sizeof(value) && _IOC_DIR(request) == _IOC_READ) {
+            memcpy(argument, &value, sizeof(value));
+        }
+        return 0;
+    }
+
+    void SetTemperature(int fanNr, int temperature) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fanNr < 0 || fanNr >= 3 || temperatures[fanNr] == temperature) { return; }
+        temperatures[fanNr] = temperature;
+        AddEvent(SimulationEventType::Temperature, fanNr, temperature);
+    }
+
+    /**
+     * Current fan speed in percent as the EC would drive it
+     */
+    int GetFanSpeedPercent(int fanNr) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fanNr < 0 || fanNr >= 3) { return -1; }
+        AdvanceFans();
+        return RawToPercent(ActualRaw(fanNr));
+    }
+
+    /**
+     * Temperature and fan speed changes since the last call, in order. The
+     * log is bounded, changes beyond the bound are counted as dropped.
+     */
+    std::vector<SimulationEvent> TakeEvents(uint64_t &dropped) {
+        std::lock_guard<std::mutex> lock(mutex);
+        AdvanceFans();
+        std::vector<SimulationEvent> taken;
+        taken.swap(events);
+        dropped = droppedEvents;
+        droppedEvents = 0;
+        return taken;
+    }
+
+    IoctlSimulationStats GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        IoctlSimulationStats result = stats;
+        result.fansAuto = fansAuto;
+        return result;
+    }
+
+    void ResetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats = {};
+    }
+
+private:
+    static constexpr int CLEVO_MAX_FAN_RAW = 0xff;
+    static constexpr int UNIWILL_MAX_FAN_RAW = 0xc8;
+    static constexpr size_t MAX_EVENTS = 64 * 1024;
+
+    std::mutex mutex;
+    IoctlSimulationOptions options;
+    IoctlSimulationStats stats = {};
+
+    int temperatures[3] = { 45, 50, 0 };
+    // Last written and currently driven speed
+    int fanRaw[3] = { 0, 0, 0 };
+    double fanActualRaw[3] = { 0, 0, 0 };
+    int fanPercent[3] = { 0, 0, 0 };
+    std::chrono::steady_clock::time_point fanWrittenTime[3];
+    std::chrono::steady_clock::time_point fansAdvancedTime;
+    std::chrono::steady_clock::time_point startTime;
+    std::vector<SimulationEvent> events;
+    uint64_t droppedEvents = 0;
+    bool fansAuto = true;
+    int webcam = 1;
+    int performanceProfile = 0x02;
+    int modeEnable = 0;
+    int tdp[3] = { 35, 45, 60 };
+    const int tdpMin[3] = { 10, 10, 10 };
+    const int tdpMax[3] = { 45, 60, 80 };
+
+    static void Delay(int64_t us) {
+        if (us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(us));
+        }
+    }
+
+    int MaxFanRaw() {
+        return options.interface == SimulatedInterface::Clevo ? CLEVO_MAX_FAN_RAW : UNIWILL_MAX_FAN_RAW;
+    }
+
+    int RawToPercent(int raw) {
+        return (int) (raw * 100.0 / MaxFanRaw() + 0.5);
+    }
+
+    int ActualRaw(int fanNr) {
+        return (int) std::lround(fanActualRaw[fanNr]);
+    }
+
+    /**
+     * Raw speed the EC drives for a written raw speed
+     */
+    double DrivenRaw(int raw) {
+        if (options.fanMinimumPercent <= 0 && options.fanStepPercent <= 1) { return raw; }
+        double percent = raw * 100.0 / MaxFanRaw();
+        if (percent > 0 && percent < options.fanMinimumPercent) { return 0; }
+        if (options.fanStepPercent > 1) {
+            percent = std::min(100.0, std::round(percent / options.fanStepPercent) * options.fanStepPercent);
+        }
+        return percent * MaxFanRaw() / 100.0;
+    }
+
+    /**
+     * Move the fans towards their driven speed up to now, the lock is held
+     */
+    void AdvanceFans() {
+        auto now = std::chrono::steady_clock::now();
+        for (int i = 0; i < 3; ++i) {
+            double target = DrivenRaw(fanRaw[i]);
+            if (fanActualRaw[i] == target) { continue; }
+            auto reactTime = fanWrittenTime[i] + std::chrono::milliseconds(options.fanDeadTimeMs);
+            if (now < reactTime) { continue; }
+            if (options.fanSlewPercentPerSecond <= 0) {
+                fanActualRaw[i] = target;
+            } else {
+                double seconds = std::chrono::duration<double>(now - std::max(reactTime, fansAdvancedTime)).count();
+                double maxChange = options.fanSlewPercentPerSecond * seconds * MaxFanRaw() / 100.0;
+                double change = std::max(-maxChange, std::min(maxChange, target - fanActualRaw[i]));
+                fanActualRaw[i] += change;
+            }
+            FanChanged(i);
+        }
+        fansAdvancedTime = now;
+    }
+
+    void AddEvent(SimulationEventType type, int fanNr, int value) {
+        if (events.size() >= MAX_EVENTS) {
+            droppedEvents += 1;
+            return;
+        }
+        uint64_t timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+        events.push_back({ timeNs, type, fanNr, value });
+    }
+
+    /**
+     * Start the actuator towards a raw write, rewriting the same value does
+     * not restart it. The lock is held.
+     */
+    void FanWritten(int fanNr, int raw) {
+        if (raw != fanRaw[fanNr]) {
+            fanRaw[fanNr] = raw;
+            fanWrittenTime[fanNr] = std::chrono::steady_clock::now();
+        }
+        AdvanceFans();
+    }
+
+    /**
+     * Log the fan speed as the EC would report it
+     */
+    void FanChanged(int fanNr) {
+        int percent = RawToPercent(ActualRaw(fanNr));
+        if (percent != fanPercent[fanNr]) {
+            fanPercent[fanNr] = percent;
+            AddEvent(SimulationEventType::FanSpeed, fanNr, percent);
+        }
+    }
+
+    bool Belongs(unsigned long request) {
+        int type = _IOC_TYPE(request);
+        if (options.interface == SimulatedInterface::Clevo) {
+            return type == (MAGIC_READ_CL) || type == (MAGIC_WRITE_CL);
+        }
+        return type == (MAGIC_READ_UW) || type == (MAGIC_WRITE_UW);
+    }
+
+    int Batch(struct tuxedo_io_batch *batch, size_t size, int &error) {
+        if (batch == nullptr || size < sizeof(*batch) || batch->count > TUXEDO_IO_BATCH_MAX) {
+            error = EINVAL;
+            return -1;
+        }
+        stats.batchCalls += 1;
+        for (uint32_t i = 0; i < batch->count; ++i) {
+            struct tuxedo_io_batch_entry &entry = batch->entries[i];
+            if (!Belongs(entry.request) || entry.request == RW_CL_BATCH || entry.request == RW_UW_BATCH) {
+                entry.error = EINVAL;
+                continue;
+            }
+            int32_t value = entry.value;
+            entry.error = Register(entry.request, value);
+            if (entry.error == 0 && _IOC_DIR(entry.request) == _IOC_READ) {
+                entry.value = value;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * One scalar register access, the lock is held
+     * @returns errno, 0 on success
+     */
+    int Register(unsigned long request, int32_t &value) {
+        stats.registerAccesses += 1;
+        Delay(options.registerLatencyUs);
+
+        if (request == R_HWCHECK_CL) { value = options.interface == SimulatedInterface::Clevo ? 1 : 0; return 0; }
+        if (request == R_HWCHECK_UW) { value = options.interface == SimulatedInterface::Uniwill ? 1 : 0; return 0; }
+        if (request == R_MOD_CAPABILITIES) {
+            if (!options.batchSupport) { return ENOTTY; }
+            value = MOD_CAP_BATCH;
+            return 0;
+        }
+        if (!Belongs(request)) { return ENOTTY; }
+        return options.interface == SimulatedInterface::Clevo ? ClevoRegister(request, value) : UniwillRegister(request, value);
+    }
+
+    int ClevoRegister(unsigned long request, int32_t &value) {
+        const unsigned long fanInfo[] = { R_CL_FANINFO1, R_CL_FANINFO2, R_CL_FANINFO3 };
+        for (int i = 0; i < 3; ++i) {
+            if (request == fanInfo[i]) {
+                value = (ActualRaw(i) & 0xff) | ((temperatures[i] & 0xff) << 0x08) | ((temperatures[i] & 0xff) << 0x10);
+                return 0;
+            }
+        }
+        if (request == R_CL_WEBCAM_SW) { value = webcam; return 0; }
+        if (request == W_CL_WEBCAM_SW) { webcam = value ? 1 : 0; return 0; }
+        if (request == W_CL_FANSPEED) {
+            for (int i = 0; i < 3; ++i) {
+                FanWritten(i, (value >> (i * 8)) & 0xff);
+            }
+            fansAuto = false;
+            return 0;
+        }
+        if (request == W_CL_FANAUTO) { fansAuto = true; return 0; }
+        if (request == W_CL_PERF_PROFILE) {
+            if (value < 0 || value > 3) { return EINVAL; }
+            performanceProfile = value;
+            return 0;
+        }
+        return ENOTTY;
+    }
+
+    int UniwillRegister(unsigned long request, int32_t &value) {
+        const unsigned long fanSpeedRead[] = { R_UW_FANSPEED, R_UW_FANSPEED2 };
+        const unsigned long fanSpeedWrite[] = { W_UW_FANSPEED, W_UW_FANSPEED2 };
+        const unsigned long fanTemperature[] = { R_UW_FAN_TEMP, R_UW_FAN_TEMP2 };
+        for (int i = 0; i < 2; ++i) {
+            if (request == fanSpeedRead[i]) { value = ActualRaw(i); return 0; }
+            if (request == fanTemperature[i]) { value = temperatures[i]; return 0; }
+            if (request == fanSpeedWrite[i]) {
+                if (value < 0 || value > UNIWILL_MAX_FAN_RAW) { return EINVAL; }
+                FanWritten(i, value);
+                fansAuto = false;
+                return 0;
+            }
+        }
+        const unsigned long tdpRead[] = { R_UW_TDP0, R_UW_TDP1, R_UW_TDP2 };
+        const unsigned long tdpMinRead[] = { R_UW_TDP0_MIN, R_UW_TDP1_MIN, R_UW_TDP2_MIN };
+        const unsigned long tdpMaxRead[] = { R_UW_TDP0_MAX, R_UW_TDP1_MAX, R_UW_TDP2_MAX };
+        const unsigned long tdpWrite[] = { W_UW_TDP0, W_UW_TDP1, W_UW_TDP2 };
+        for (int i = 0; i < 3; ++i) {
+            if (request == tdpRead[i]) { value = tdp[i]; return 0; }
+            if (request == tdpMinRead[i]) { value = tdpMin[i]; return 0; }
+            if (request == tdpMaxRead[i]) { value = tdpMax[i]; return 0; }
+            if (request == tdpWrite[i]) {
+                if (value < tdpMin[i] || value > tdpMax[i]) { return EINVAL; }
+                tdp[i] = value;
+                return 0;
+            }
+        }
+        if (request == R_UW_MODEL_ID) { value = 1; return 0; }
+        if (request == R_UW_FANS_MIN_SPEED) { value = 20; return 0; }
+        if (request == R_UW_FANS_OFF_AVAILABLE) { value = 1; return 0; }
+        if (request == R_UW_PROFS_AVAILABLE) { value = 3; return 0; }
+        if (request == R_UW_MODE_ENABLE) { value = modeEnable; return 0; }
+        if (request == W_UW_MODE_ENABLE) { modeEnable = value; return 0; }
+        if (request == W_UW_FANAUTO) { fansAuto = true; return 0; }
+        if (request == W_UW_PERF_PROF) {
+            if (value < 1 || value > 3) { return EINVAL; }
+            performanceProfile = value;
+            return 0;
+        }
+        return ENOTTY;
+    }
+};
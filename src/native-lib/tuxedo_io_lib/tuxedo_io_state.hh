@@ -0,0 +1,208 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "tuxedo_io_api.hh"
+
+enum class ProfileFanMode {
+    Unchanged,
+    Auto,
+    Manual
+};
+
+/**
+ * Last successfully applied value of every tuxedo-io setter. Used to skip
+ * writes of already active values and to restore the hardware state after
+ * the EC lost it (e.g. on resume).
+ */
+struct DeviceStateRecord {
+    std::string odmProfile;
+    std::map<int, int> tdpValues;
+    bool modeSetKnown = false;
+    bool modeSetEnabled = false;
+    ProfileFanMode fanMode = ProfileFanMode::Unchanged;
+    std::map<int, int> fanSpeeds;
+    bool webcamKnown = false;
+    bool webcamStatus = false;
+
+    void Clear() {
+        *this = DeviceStateRecord();
+    }
+};
+
+struct DeviceStateRestoreStats {
+    bool success = false;
+    int64_t durationUs = 0;
+    // Time from start of restore until fan mode and speeds were written
+    int64_t fanStateUs = -1;
+};
+
+/**
+ * Device decorator recording every successful setter call into a
+ * DeviceStateRecord before forwarding to the wrapped device. The record is
+ * updated under recordMutex, setters of several holders may run at once.
+ */
+class StateRecordingDevice : public DeviceInterface {
+public:
+    StateRecordingDevice(TuxedoIOAPI &device, DeviceStateRecord &record, std::mutex &recordMutex)
+        : DeviceInterface(device.io), device(device), record(record), recordMutex(recordMutex) { }
+
+    virtual bool Identify(bool &identified) { return device.Identify(identified); }
+    virtual bool DeviceInterfaceIdStr(std::string &interfaceIdStr) { return device.DeviceInterfaceIdStr(interfaceIdStr); }
+    virtual bool DeviceModelIdStr(std::string &modelIdStr) { return device.DeviceModelIdStr(modelIdStr); }
+
+    virtual bool SetEnableModeSet(bool enabled) {
+        bool result = device.SetEnableModeSet(enabled);
+        if (result) {
+            std::lock_guard<std::mutex> lock(recordMutex);
+            record.modeSetKnown = true;
+            record.modeSetEnabled = enabled;
+            if (enabled) {
+                record.fanMode = ProfileFanMode::Manual;
+            } else if (record.fanMode == ProfileFanMode::Manual) {
+                record.fanMode = ProfileFanMode::Unchanged;
+            }
+        }
+        return result;
+    }
+
+    virtual bool GetNumberFans(int &nrFans) { return device.GetNumberFans(nrFans); }
+
+    virtual bool SetFansAuto() {
+        bool result = device.SetFansAuto();
+        if (result) {
+            std::lock_guard<std::mutex> lock(recordMutex);
+            record.fanMode = ProfileFanMode::Auto;
+            record.fanSpeeds.clear();
+        }
+        return result;
+    }
+
+    virtual bool SetFanSpeedPercent(const int fanNr, const int fanSpeedPercent) {
+        bool result = device.SetFanSpeedPercent(fanNr, fanSpeedPercent);
+        if (result) {
+            std::lock_guard<std::mutex> lock(recordMutex);
+            record.fanSpeeds[fanNr] = fanSpeedPercent;
+            if (record.fanMode == ProfileFanMode::Auto) {
+                record.fanMode = ProfileFanMode::Unchanged;
+            }
+        }
+        return result;
+    }
+
+    virtual bool GetFanSpeedPercent(const int fanNr, int &fanSpeedPercent) { return device.GetFanSpeedPercent(fanNr, fanSpeedPercent); }
+    virtual bool GetFanTemperature(const int fanNr, int &temperatureCelcius) { return device.GetFanTemperature(fanNr, temperatureCelcius); }
+    virtual bool GetFansMinSpeed(int &minSpeed) { return device.GetFansMinSpeed(minSpeed); }
+    virtual bool GetFansOffAvailable(bool &offAvailable) { return device.GetFansOffAvailable(offAvailable); }
+
+    virtual bool SetWebcam(const bool status) {
+        bool result = device.SetWebcam(status);
+        if (result) {
+            std::lock_guard<std::mutex> lock(recordMutex);
+            record.webcamKnown = true;
+            record.webcamStatus = status;
+        }
+        return result;
+    }
+
+    virtual bool GetWebcam(bool &status) { return device.GetWebcam(status); }
+    virtual bool GetAvailableODMPerformanceProfiles(std::vector<std::string> &profiles) { return device.GetAvailableODMPerformanceProfiles(profiles); }
+
+    virtual bool SetODMPerformanceProfile(std::string performanceProfile) {
+        bool result = device.SetODMPerformanceProfile(performanceProfile);
+        if (result) {
+            std::lock_guard<std::mutex> lock(recordMutex);
+            record.odmProfile = performanceProfile;
+        }
+        return result;
+    }
+
+    virtual bool GetDefaultODMPerformanceProfile(std::string &profileName) { return device.GetDefaultODMPerformanceProfile(profileName); }
+    virtual bool GetNumberTDPs(int &nrTDPs) { return device.GetNumberTDPs(nrTDPs); }
+    virtual bool GetTDPDescriptors(std::vector<std::string> &tdpDescriptors) { return device.GetTDPDescriptors(tdpDescriptors); }
+    virtual bool GetTDPMin(const int tdpIndex, int &minValue) { return device.GetTDPMin(tdpIndex, minValue); }
+    virtual bool GetTDPMax(const int tdpIndex, int &maxValue) { return device.GetTDPMax(tdpIndex, maxValue); }
+
+    virtual bool SetTDP(const int tdpIndex, const int tdpValue) {
+        bool result = device.SetTDP(tdpIndex, tdpValue);
+        if (result) {
+            std::lock_guard<std::mutex> lock(recordMutex);
+            record.tdpValues[tdpIndex] = tdpValue;
+        }
+        return result;
+    }
+
+    virtual bool GetTDP(const int tdpIndex, int &tdpValue) { return device.GetTDP(tdpIndex, tdpValue); }
+    virtual bool GetStatus(DeviceStatus &status) { return device.GetStatus(status); }
+
+    /**
+     * Writes the complete recorded state back to the hardware. Same order
+     * as a profile application: ODM profile, TDPs, fan mode, fan speeds
+     * and last the webcam switch.
+     */
+    bool Restore(DeviceStateRestoreStats &stats) {
+        auto start = std::chrono::steady_clock::now();
+        DeviceStateRecord restore;
+        {
+            std::lock_guard<std::mutex> lock(recordMutex);
+            restore = record;
+        }
+        bool success = true;
+
+        if (!restore.odmProfile.empty()) {
+            success &= device.SetODMPerformanceProfile(restore.odmProfile);
+        }
+
+        for (const auto &tdp : restore.tdpValues) {
+            success &= device.SetTDP(tdp.first, tdp.second);
+        }
+
+        if (restore.fanMode == ProfileFanMode::Auto) {
+            success &= device.SetFansAuto();
+        }
+        if (restore.modeSetKnown) {
+            success &= device.SetEnableModeSet(restore.modeSetEnabled);
+        }
+        if (restore.fanMode != ProfileFanMode::Auto) {
+            for (const auto &fan : restore.fanSpeeds) {
+                success &= device.SetFanSpeedPercent(fan.first, fan.second);
+            }
+        }
+        stats.fanStateUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        if (restore.webcamKnown) {
+            success &= device.SetWebcam(restore.webcamStatus);
+        }
+
+        stats.success = success;
+        stats.durationUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        return success;
+    }
+
+private:
+    TuxedoIOAPI &device;
+    DeviceStateRecord &record;
+    std::mutex &recordMutex;
+};
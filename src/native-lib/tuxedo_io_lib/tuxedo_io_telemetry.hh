@@ -0,0 +1,138 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#define TELEMETRY_MAX_FANS 3
+#define TELEMETRY_MAX_TDPS 3
+
+/**
+ * Latest known hardware values. Plain fixed size layout without pointers
+ * so it can be copied as a whole by readers.
+ */
+struct TelemetrySnapshot {
+    uint64_t updatedNs;
+    char interfaceId[16];
+    char modelId[16];
+    char odmProfile[32];
+    int32_t nrFans;
+    int32_t fansMinSpeed;
+    int32_t fansOffAvailable;
+    int32_t webcamStatus;
+    struct {
+        int32_t temperature;
+        int32_t speedPercent;
+        uint64_t temperatureUpdatedNs;
+        uint64_t speedUpdatedNs;
+    } fans[TELEMETRY_MAX_FANS];
+    int32_t nrTDPs;
+    int32_t reserved;
+    struct {
+        char descriptor[8];
+        int32_t min;
+        int32_t max;
+        int32_t current;
+        int32_t reserved;
+    } tdps[TELEMETRY_MAX_TDPS];
+    uint64_t ioctlCalls;
+    uint64_t ioctlErrors;
+    uint64_t ioctlShortCircuited;
+    uint64_t ioctlDurationNs;
+};
+
+inline uint64_t TelemetryNowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+inline void TelemetrySetString(char *target, size_t size, const std::string &value) {
+    strncpy(target, value.c_str(), size - 1);
+    target[size - 1] = '\0';
+}
+
+/**
+ * Seqlock protected snapshot. Writers are serialized by a mutex, readers
+ * never block and retry if they raced with a writer.
+ */
+class TelemetryStore {
+public:
+    TelemetryStore() {
+        memset(&snapshot, 0, sizeof(snapshot));
+        for (int i = 0; i < TELEMETRY_MAX_FANS; ++i) {
+            snapshot.fans[i].temperature = -1;
+            snapshot.fans[i].speedPercent = -1;
+        }
+        snapshot.webcamStatus = -1;
+    }
+
+    static TelemetryStore &Default() {
+        static TelemetryStore store;
+        return store;
+    }
+
+    template<typename Updater>
+    void Update(Updater updater) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        sequence.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        updater(snapshot);
+        snapshot.updatedNs = TelemetryNowNs();
+        sequence.fetch_add(1, std::memory_order_release);
+        if (onUpdate) {
+            onUpdate(snapshot);
+        }
+    }
+
+    /**
+     * Listener run after every update with the writer lock held, e.g. to
+     * mirror the snapshot into shared memory
+     */
+    void SetUpdateListener(std::function<void(const TelemetrySnapshot &)> listener) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        onUpdate = listener;
+    }
+
+    void Read(TelemetrySnapshot &target) {
+        uint32_t before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            memcpy(&target, &snapshot, sizeof(target));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+    }
+
+    uint32_t Sequence() {
+        return sequence.load(std::memory_order_acquire);
+    }
+
+private:
+    std::mutex writeMutex;
+    std::atomic<uint32_t> sequence { 0 };
+    TelemetrySnapshot snapshot;
+    std::function<void(const TelemetrySnapshot &)> onUpdate;
+};
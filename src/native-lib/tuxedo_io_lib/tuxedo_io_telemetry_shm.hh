@@ -0,0 +1,168 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <string>
+#include "tuxedo_io_api.hh"
+#include "tuxedo_io_telemetry.hh"
+
+#define TELEMETRY_SHM_NAME "/tcc-telemetry"
+#define TELEMETRY_SHM_MAGIC 0x54434354 // "TCCT"
+// Major changes break the layout, minor versions only append fields
+#define TELEMETRY_SHM_VERSION_MAJOR 1
+#define TELEMETRY_SHM_VERSION_MINOR 0
+
+/**
+ * Layout of the shared memory segment. Only fixed width types, the
+ * sequence is a seqlock counter (odd while the writer is active).
+ */
+struct TelemetryShmSegment {
+    uint32_t magic;
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    uint32_t size;
+    std::atomic<uint32_t> sequence;
+    uint64_t publishedNs;
+    TelemetrySnapshot snapshot;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "seqlock counter must be lock free to be shared between processes");
+
+/**
+ * Cross process telemetry segment under /dev/shm. The daemon creates and
+ * publishes, other processes (GUI, tray) map it read only.
+ */
+class TelemetryShm {
+public:
+    ~TelemetryShm() {
+        Close();
+    }
+
+    bool Create(const char *name = TELEMETRY_SHM_NAME) {
+        Close();
+        int fd = shm_open(name, O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+        if (fd < 0) { return false; }
+        // Readable by unprivileged GUI processes regardless of umask
+        fchmod(fd, 0644);
+        if (ftruncate(fd, sizeof(TelemetryShmSegment)) < 0) {
+            close(fd);
+            return false;
+        }
+        void *mapping = mmap(nullptr, sizeof(TelemetryShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) { return false; }
+
+        segment = (TelemetryShmSegment *) mapping;
+        writable = true;
+        shmName = name;
+        segment->sequence.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        segment->magic = TELEMETRY_SHM_MAGIC;
+        segment->versionMajor = TELEMETRY_SHM_VERSION_MAJOR;
+        segment->versionMinor = TELEMETRY_SHM_VERSION_MINOR;
+        segment->size = sizeof(TelemetryShmSegment);
+        segment->publishedNs = 0;
+        memset(&segment->snapshot, 0, sizeof(segment->snapshot));
+        segment->sequence.store(2, std::memory_order_release);
+        return true;
+    }
+
+    bool Open(const char *name = TELEMETRY_SHM_NAME) {
+        Close();
+        int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0) { return false; }
+        struct stat info;
+        if (fstat(fd, &info) < 0 || (size_t) info.st_size < sizeof(TelemetryShmSegment)) {
+            close(fd);
+            return false;
+        }
+        void *mapping = mmap(nullptr, sizeof(TelemetryShmSegment), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) { return false; }
+
+        segment = (TelemetryShmSegment *) mapping;
+        writable = false;
+        if (segment->magic != TELEMETRY_SHM_MAGIC || segment->versionMajor != TELEMETRY_SHM_VERSION_MAJOR) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Close() {
+        if (segment == nullptr) { return; }
+        munmap(segment, sizeof(TelemetryShmSegment));
+        segment = nullptr;
+        if (writable) {
+            shm_unlink(shmName.c_str());
+        }
+    }
+
+    bool IsOpen() {
+        return segment != nullptr;
+    }
+
+    void Publish(const TelemetrySnapshot &snapshot) {
+        if (segment == nullptr || !writable) { return; }
+        IOStatistics &statistics = IOStatistics::Default();
+        uint32_t sequence = segment->sequence.load(std::memory_order_relaxed);
+        segment->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&segment->snapshot, &snapshot, sizeof(snapshot));
+        segment->snapshot.ioctlCalls = statistics.calls.load(std::memory_order_relaxed);
+        segment->snapshot.ioctlErrors = statistics.errors.load(std::memory_order_relaxed);
+        segment->snapshot.ioctlShortCircuited = statistics.shortCircuited.load(std::memory_order_relaxed);
+        segment->snapshot.ioctlDurationNs = statistics.durationNs.load(std::memory_order_relaxed);
+        segment->publishedNs = TelemetryNowNs();
+        segment->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * Consistent copy of the published snapshot. Gives up after a bounded
+     * number of retries in case the publisher died mid-write.
+     */
+    bool Read(TelemetrySnapshot &target, uint32_t &sequence) {
+        if (segment == nullptr) { return false; }
+        for (int attempt = 0; attempt < READ_RETRIES; ++attempt) {
+            uint32_t before = segment->sequence.load(std::memory_order_acquire);
+            if (before & 1) { continue; }
+            memcpy(&target, &segment->snapshot, sizeof(target));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (segment->sequence.load(std::memory_order_relaxed) == before) {
+                sequence = before;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const int READ_RETRIES = 1000;
+
+    TelemetryShmSegment *segment = nullptr;
+    bool writable = false;
+    std::string shmName;
+};
@@ -0,0 +1,311 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tuxedo_io_backend.hh"
+
+#define IOCTL_TRACE_MAGIC "TCCIOTR"
+#define IOCTL_TRACE_VERSION 1
+
+/**
+ * Trace file layout: one file header followed by records, each a record
+ * header and inSize + outSize argument bytes. All values little endian as
+ * written by the recording machine.
+ */
+struct IoctlTraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordHeaderSize;
+    // Wall clock at trace start, only informational
+    uint64_t startRealtimeNs;
+};
+
+struct IoctlTraceRecordHeader {
+    // Monotonic time since trace start
+    uint64_t timestampNs;
+    uint32_t request;
+    int32_t result;
+    int32_t error;
+    uint16_t inSize;
+    uint16_t outSize;
+};
+
+static_assert(sizeof(IoctlTraceRecordHeader) == 24, "trace record header layout must stay fixed");
+
+inline uint64_t IoctlTraceNowNs(clockid_t clock = CLOCK_MONOTONIC) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+/**
+ * Records every ioctl issued through IO to a binary trace file. Records are
+ * buffered in memory and written in blocks, the disabled case costs one
+ * relaxed atomic load per call.
+ */
+class IoctlTraceRecorder {
+public:
+    static IoctlTraceRecorder &Default() {
+        static IoctlTraceRecorder recorder;
+        return recorder;
+    }
+
+    ~IoctlTraceRecorder() {
+        Stop();
+    }
+
+    bool Start(const std::string &path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd >= 0) { return false; }
+        fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) { return false; }
+
+        IoctlTraceFileHeader header = {};
+        memcpy(header.magic, IOCTL_TRACE_MAGIC, sizeof(header.magic));
+        header.version = IOCTL_TRACE_VERSION;
+        header.recordHeaderSize = sizeof(IoctlTraceRecordHeader);
+        header.startRealtimeNs = IoctlTraceNowNs(CLOCK_REALTIME);
+        buffer.clear();
+        Append(&header, sizeof(header));
+        startNs = IoctlTraceNowNs();
+        records = 0;
+        recording.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @returns Number of records written
+     */
+    uint64_t Stop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd < 0) { return 0; }
+        recording.store(false, std::memory_order_release);
+        Flush();
+        close(fd);
+        fd = -1;
+        return records;
+    }
+
+    bool IsRecording() {
+        return recording.load(std::memory_order_relaxed);
+    }
+
+    void Record(unsigned long request, const void *in, size_t inSize, const void *out, size_t outSize, int result, int error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd < 0) { return; }
+        IoctlTraceRecordHeader header;
+        header.timestampNs = IoctlTraceNowNs() - startNs;
+        header.request = (uint32_t) request;
+        header.result = result;
+        header.error = error;
+        header.inSize = (uint16_t) std::min<size_t>(inSize, UINT16_MAX);
+        header.outSize = (uint16_t) std::min<size_t>(outSize, UINT16_MAX);
+        Append(&header, sizeof(header));
+        Append(in, header.inSize);
+        Append(out, header.outSize);
+        records += 1;
+        if (buffer.size() >= FLUSH_SIZE) {
+            Flush();
+        }
+    }
+
+private:
+    static constexpr size_t FLUSH_SIZE = 64 * 1024;
+
+    std::mutex mutex;
+    std::atomic<bool> recording { false };
+    int fd = -1;
+    uint64_t startNs = 0;
+    uint64_t records = 0;
+    std::vector<char> buffer;
+
+    void Append(const void *data, size_t size) {
+        if (size == 0) { return; }
+        buffer.insert(buffer.end(), (const char *) data, (const char *) data + size);
+    }
+
+    void Flush() {
+        size_t written = 0;
+        while (written < buffer.size()) {
+            ssize_t result = write(fd, buffer.data() + written, buffer.size() - written);
+            if (result < 0 && errno == EINTR) { continue; }
+            if (result <= 0) { break; }
+            written += result;
+        }
+        buffer.clear();
+    }
+};
+
+struct IoctlReplayStats {
+    uint64_t records;
+    uint64_t served;
+    // Calls without any record of their request code
+    uint64_t missing;
+    // Writes whose argument differs from the recorded one
+    uint64_t diverged;
+    // Calls served after the records of their request code were used up
+    uint64_t repeated;
+};
+
+/**
+ * Serves a recorded trace back to the device backends. Every request code
+ * has its own cursor, so the n-th call of a request gets the n-th recorded
+ * answer independent of how calls of different requests interleave. After
+ * the last record of a request code its answer is repeated.
+ */
+class IoctlReplay : public IoctlBackend {
+public:
+    /**
+     * @param realtime Delay answers until their recorded time since replay
+     * start instead of serving them as fast as possible
+     */
+    IoctlReplay(bool realtime = false) : realtime(realtime) { }
+
+    bool Load(const std::string &path) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { return false; }
+        std::vector<char> data;
+        char chunk[64 * 1024];
+        ssize_t length;
+        while ((length = read(fd, chunk, sizeof(chunk))) > 0) {
+            data.insert(data.end(), chunk, chunk + length);
+        }
+        close(fd);
+        if (length < 0) { return false; }
+        return Parse(data);
+    }
+
+    bool Parse(const std::vector<char> &data) {
+        IoctlTraceFileHeader header;
+        if (data.size() < sizeof(header)) { return false; }
+        memcpy(&header, data.data(), sizeof(header));
+        if (memcmp(header.magic, IOCTL_TRACE_MAGIC, sizeof(header.magic)) != 0 || header.version != IOCTL_TRACE_VERSION
+            || header.recordHeaderSize < sizeof(IoctlTraceRecordHeader)) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        records.clear();
+        cursors.clear();
+        stats = {};
+        size_t offset = sizeof(header);
+        while (offset + header.recordHeaderSize <= data.size()) {
+            Record record;
+            memcpy(&record.header, data.data() + offset, sizeof(record.header));
+            offset += header.recordHeaderSize;
+            size_t argumentSize = (size_t) record.header.inSize + record.header.outSize;
+            if (offset + argumentSize > data.size()) { break; }
+            record.in.assign(data.data() + offset, data.data() + offset + record.header.inSize);
+            record.out.assign(data.data() + offset + record.header.inSize, data.data() + offset + argumentSize);
+            offset += argumentSize;
+            records[record.header.request].push_back(record);
+            stats.records += 1;
+        }
+        startNs = IoctlTraceNowNs();
+        return stats.records > 0;
+    }
+
+    /**
+     * Answer with the next record of the request, argument is updated with
+     * the recorded output
+     */
+    int Call(unsigned long request, void *argument, size_t argumentSize, int &error) override {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto it = records.find((uint32_t) request);
+        if (it == records.end()) {
+            stats.missing += 1;
+            error = ENOTTY;
+            return -1;
+        }
+
+        size_t &cursor = cursors[it->first];
+        const Record &record = it->second[std::min(cursor, it->second.size() - 1)];
+        if (cursor >= it->second.size()) {
+            stats.repeated += 1;
+        } else {
+            cursor += 1;
+        }
+        if (argument != nullptr && !record.in.empty()
+            && (record.in.size() > argumentSize || memcmp(record.in.data(), argument, record.in.size()) != 0)) {
+            stats.diverged += 1;
+        }
+        stats.served += 1;
+
+        if (realtime) {
+            uint64_t dueNs = startNs + record.header.timestampNs;
+            lock.unlock();
+            uint64_t now = IoctlTraceNowNs();
+            if (dueNs > now) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(dueNs - now));
+            }
+            lock.lock();
+        }
+
+        if (argument != nullptr && !record.out.empty()) {
+            memcpy(argument, record.out.data(), std::min(argumentSize, record.out.size()));
+        }
+        error = record.header.error;
+        return record.header.result;
+    }
+
+    /**
+     * Rewind all cursors and the replay clock
+     */
+    void Rewind() {
+        std::lock_guard<std::mutex> lock(mutex);
+        cursors.clear();
+        startNs = IoctlTraceNowNs();
+        uint64_t total = stats.records;
+        stats = {};
+        stats.records = total;
+    }
+
+    IoctlReplayStats GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+private:
+    struct Record {
+        IoctlTraceRecordHeader header;
+        std::vector<char> in;
+        std::vector<char> out;
+    };
+
+    std::mutex mutex;
+    bool realtime;
+    uint64_t startNs = 0;
+    std::map<uint32_t, std::vector<Record>> records;
+    std::map<uint32_t, size_t> cursors;
+    IoctlReplayStats stats = {};
+};
@@ -0,0 +1,602 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/videodev2.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class V4l2ControlType {
+    Integer,
+    // Integer controls with range 0..1 count as boolean too
+    Boolean,
+    Menu,
+    IntegerMenu,
+    Button
+};
+
+struct V4l2MenuItem {
+    int64_t index;
+    std::string textId;
+    std::string name;
+};
+
+struct V4l2Control {
+    uint32_t id;
+    std::string textId;
+    std::string name;
+    V4l2ControlType type;
+    int64_t minimum;
+    int64_t maximum;
+    int64_t step;
+    int64_t defaultValue;
+    uint32_t flags;
+    std::vector<V4l2MenuItem> menu;
+
+    bool Readable() const {
+        return type != V4l2ControlType::Button && !(flags & V4L2_CTRL_FLAG_WRITE_ONLY);
+    }
+};
+
+struct V4l2ApplyResult {
+    std::vector<std::string> applied;
+    // Not a V4L2 control of the device, e.g. format or vendor specific controls
+    std::vector<std::string> unknown;
+    // Rejected by the driver, invalid value or clamped to another value
+    std::vector<std::string> failed;
+};
+
+/**
+ * ioctl layer of one video device, replaced by a mock in tests
+ */
+class V4l2DeviceIo {
+public:
+    virtual ~V4l2DeviceIo() { }
+
+    /**
+     * @returns -1 and errno set on failure like ioctl()
+     */
+    virtual int Ioctl(unsigned long request, void *argument) = 0;
+};
+
+class V4l2FileIo : public V4l2DeviceIo {
+public:
+    V4l2FileIo(const std::string &path) {
+        // Non blocking, controls never wait for frames
+        fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    }
+
+    ~V4l2FileIo() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool IsOpen() {
+        return fd >= 0;
+    }
+
+    int Ioctl(unsigned long request, void *argument) override {
+        int result;
+        do {
+            result = ioctl(fd, request, argument);
+        } while (result < 0 && errno == EINTR);
+        return result;
+    }
+
+private:
+    int fd = -1;
+};
+
+/**
+ * Identifier of a control or menu name as used by cameractrls.py and the
+ * webcam presets: lower case, spaces and dashes as underscores, punctuation
+ * removed
+ */
+inline std::string V4l2TextId(const char *name) {
+    std::string stripped;
+    for (const char *c = name; *c != '\0'; ++c) {
+        if (*c == ' ' || *c == '-') {
+            stripped += '_';
+        } else if (strchr(",&(./)", *c) == nullptr) {
+            stripped += (*c >= 'A' && *c <= 'Z') ? (char) (*c - 'A' + 'a') : *c;
+        }
+    }
+    std::string textId;
+    for (size_t i = 0; i < stripped.size(); ++i) {
+        if (stripped[i] == '_' && i + 1 < stripped.size() && stripped[i + 1] == '_') {
+            textId += '_';
+            i += 1;
+        } else {
+            textId += stripped[i];
+        }
+    }
+    return textId;
+}
+
+/**
+ * Driver, card and bus info of the device. The device number of a node is
+ * reused once another camera is plugged in, these tell the cameras apart.
+ * @returns Empty if the device does not answer VIDIOC_QUERYCAP
+ */
+inline std::string V4l2DeviceIdentity(V4l2DeviceIo &io) {
+    struct v4l2_capability capability = {};
+    if (io.Ioctl(VIDIOC_QUERYCAP, &capability) < 0) { return std::string(); }
+    auto field = [](const uint8_t *text, size_t size) {
+        return std::string((const char *) text, strnlen((const char *) text, size));
+    };
+    return field(capability.driver, sizeof(capability.driver)) + '\n' + field(capability.card, sizeof(capability.card))
+        + '\n' + field(capability.bus_info, sizeof(capability.bus_info));
+}
+
+inline bool V4l2IsCaptureDevice(V4l2DeviceIo &io) {
+    struct v4l2_capability capability = {};
+    if (io.Ioctl(VIDIOC_QUERYCAP, &capability) < 0) { return false; }
+    uint32_t caps = (capability.capabilities & V4L2_CAP_DEVICE_CAPS) ? capability.device_caps : capability.capabilities;
+    return caps & V4L2_CAP_VIDEO_CAPTURE;
+}
+
+/**
+ * False for IR cameras only offering grey frames
+ */
+inline bool V4l2HasColorFormat(V4l2DeviceIo &io) {
+    for (uint32_t index = 0; ; ++index) {
+        struct v4l2_fmtdesc format = {};
+        format.index = index;
+        format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (io.Ioctl(VIDIOC_ENUM_FMT, &format) < 0) { return false; }
+        if (format.pixelformat != V4L2_PIX_FMT_GREY) { return true; }
+    }
+}
+
+/**
+ * Controls and menus of one device, queried once and kept while the device
+ * stays the same. Values are read and written in batches.
+ */
+class V4l2ControlSet {
+public:
+    /**
+     * Enumerate all integer, boolean, menu and button controls
+     */
+    bool Query(V4l2DeviceIo &io) {
+        controls.clear();
+        struct v4l2_query_ext_ctrl query = {};
+        query.id = V4L2_CTRL_FLAG_NEXT_CTRL | V4L2_CTRL_FLAG_NEXT_COMPOUND;
+        while (io.Ioctl(VIDIOC_QUERY_EXT_CTRL, &query) == 0) {
+            V4l2Control control;
+            if (!(query.flags & V4L2_CTRL_FLAG_DISABLED) && FromQuery(query, control)) {
+                if (control.type == V4l2ControlType::Menu || control.type == V4l2ControlType::IntegerMenu) {
+                    QueryMenu(io, control);
+                }
+                controls.push_back(control);
+            }
+            query.id |= V4L2_CTRL_FLAG_NEXT_CTRL | V4L2_CTRL_FLAG_NEXT_COMPOUND;
+        }
+        return errno == EINVAL || !controls.empty();
+    }
+
+    const std::vector<V4l2Control> &Controls() const {
+        return controls;
+    }
+
+    const V4l2Control *Find(const std::string &textId) const {
+        for (const V4l2Control &control : controls) {
+            if (control.textId == textId) { return &control; }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Current values of all readable controls in one VIDIOC_G_EXT_CTRLS,
+     * controls failing to read are left out
+     */
+    std::map<uint32_t, int64_t> ReadValues(V4l2DeviceIo &io) const {
+        std::vector<struct v4l2_ext_control> values;
+        for (const V4l2Control &control : controls) {
+            if (control.Readable()) {
+                struct v4l2_ext_control value = {};
+                value.id = control.id;
+                values.push_back(value);
+            }
+        }
+        std::map<uint32_t, int64_t> result;
+        if (values.empty()) { return result; }
+        if (ExtControls(io, VIDIOC_G_EXT_CTRLS, values.data(), values.size()) == 0) {
+            for (const struct v4l2_ext_control &value : values) { result[value.id] = value.value; }
+            return result;
+        }
+        for (struct v4l2_ext_control &value : values) {
+            if (ExtControls(io, VIDIOC_G_EXT_CTRLS, &value, 1) == 0) { result[value.id] = value.value; }
+        }
+        return result;
+    }
+
+    /**
+     * Inactive flags change with related controls (e.g. auto exposure), the
+     * rest of the query stays valid
+     */
+    void RefreshFlags(V4l2DeviceIo &io, std::vector<V4l2Control> &refreshed) const {
+        for (V4l2Control &control : refreshed) {
+            struct v4l2_query_ext_ctrl query = {};
+            query.id = control.id;
+            if (io.Ioctl(VIDIOC_QUERY_EXT_CTRL, &query) == 0) {
+                control.flags = query.flags;
+            }
+        }
+    }
+
+    /**
+     * Set controls by text id and value as in the presets, all in one
+     * VIDIOC_S_EXT_CTRLS. If the driver rejects the batch every control is
+     * set on its own, so one bad value does not block the others.
+     */
+    V4l2ApplyResult Apply(V4l2DeviceIo &io, const std::vector<std::pair<std::string, std::string>> &values) const {
+        V4l2ApplyResult result;
+        std::vector<struct v4l2_ext_control> batch;
+        std::vector<std::string> names;
+        for (const auto &entry : values) {
+            const V4l2Control *control = Find(entry.first);
+            struct v4l2_ext_control value = {};
+            int64_t parsed;
+            if (control == nullptr) {
+                result.unknown.push_back(entry.first);
+            } else if (!ParseValue(*control, entry.second, parsed)) {
+                result.failed.push_back(entry.first);
+            } else {
+                value.id = control->id;
+                value.value = (int32_t) parsed;
+                batch.push_back(value);
+                names.push_back(entry.first);
+            }
+        }
+        if (batch.empty()) { return result; }
+
+        std::vector<struct v4l2_ext_control> requested = batch;
+        std::vector<bool> set(batch.size(), true);
+        if (ExtControls(io, VIDIOC_S_EXT_CTRLS, batch.data(), batch.size()) != 0) {
+            batch = requested;
+            for (size_t i = 0; i < batch.size(); ++i) {
+                set[i] = ExtControls(io, VIDIOC_S_EXT_CTRLS, &batch[i], 1) == 0;
+            }
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            // The driver writes back clamped values
+            if (set[i] && batch[i].value == requested[i].value) {
+                result.applied.push_back(names[i]);
+            } else {
+                result.failed.push_back(names[i]);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Value of a preset entry: numbers for integers, yes/no style words for
+     * booleans, the menu text id for menus, anything for buttons
+     */
+    static bool ParseValue(const V4l2Control &control, const std::string &text, int64_t &value) {
+        switch (control.type) {
+        case V4l2ControlType::Integer: {
+            char *end;
+            errno = 0;
+            value = strtoll(text.c_str(), &end, 10);
+            return errno == 0 && !text.empty() && *end == '\0';
+        }
+        case V4l2ControlType::Boolean: {
+            std::string lower = text;
+            for (char &c : lower) { c = tolower((unsigned char) c); }
+            value = (lower == "y" || lower == "yes" || lower == "t" || lower == "true" || lower == "on" || lower == "1") ? 1 : 0;
+            return true;
+        }
+        case V4l2ControlType::Menu:
+        case V4l2ControlType::IntegerMenu:
+            for (const V4l2MenuItem &item : control.menu) {
+                if (item.textId == text) {
+                    value = item.index;
+                    return true;
+                }
+            }
+            return false;
+        case V4l2ControlType::Button:
+            value = 0;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    std::vector<V4l2Control> controls;
+
+    static int ExtControls(V4l2DeviceIo &io, unsigned long request, struct v4l2_ext_control *values, size_t count) {
+        struct v4l2_ext_controls batch = {};
+        batch.which = V4L2_CTRL_WHICH_CUR_VAL;
+        batch.count = count;
+        batch.controls = values;
+        return io.Ioctl(request, &batch);
+    }
+
+    static bool FromQuery(const struct v4l2_query_ext_ctrl &query, V4l2Control &control) {
+        switch (query.type) {
+        case V4L2_CTRL_TYPE_INTEGER:
+            control.type = query.minimum == 0 && query.maximum == 1 && query.step == 1 ? V4l2ControlType::Boolean : V4l2ControlType::Integer;
+            break;
+        case V4L2_CTRL_TYPE_BOOLEAN:
+            control.type = V4l2ControlType::Boolean;
+            break;
+        case V4L2_CTRL_TYPE_MENU:
+            control.type = V4l2ControlType::Menu;
+            break;
+        case V4L2_CTRL_TYPE_INTEGER_MENU:
+            control.type = V4l2ControlType::IntegerMenu;
+            break;
+        case V4L2_CTRL_TYPE_BUTTON:
+            control.type = V4l2ControlType::Button;
+            break;
+        default:
+            return false;
+        }
+        char name[sizeof(query.name) + 1] = {};
+        memcpy(name, query.name, sizeof(query.name));
+        control.id = query.id;
+        control.name = name;
+        control.textId = V4l2TextId(name);
+        control.minimum = query.minimum;
+        control.maximum = query.maximum;
+        control.step = query.step;
+        control.defaultValue = query.default_value;
+        control.flags = query.flags;
+        return true;
+    }
+
+    static void QueryMenu(V4l2DeviceIo &io, V4l2Control &control) {
+        for (int64_t index = control.minimum; index <= control.maximum; ++index) {
+            struct v4l2_querymenu query = {};
+            query.id = control.id;
+            query.index = (uint32_t) index;
+            // Menus may have holes
+            if (io.Ioctl(VIDIOC_QUERYMENU, &query) < 0) { continue; }
+            V4l2MenuItem item;
+            item.index = index;
+            if (control.type == V4l2ControlType::Menu) {
+                char name[sizeof(query.name) + 1] = {};
+                memcpy(name, query.name, sizeof(query.name));
+                item.name = name;
+                item.textId = V4l2TextId(name);
+            } else {
+                item.name = item.textId = std::to_string((long long) query.value);
+            }
+            control.menu.push_back(item);
+        }
+    }
+};
+
+/**
+ * Queried control sets by device path, process wide
+ */
+class V4l2ControlCache {
+public:
+    static V4l2ControlCache &Default() {
+        static V4l2ControlCache cache;
+        return cache;
+    }
+
+    /**
+     * Controls of the opened device, queried on first use and again once a
+     * camera with a different identity shows up at the path
+     * @returns nullptr if the device has no queryable controls
+     */
+    std::shared_ptr<const V4l2ControlSet> Get(const std::string &path, V4l2DeviceIo &io) {
+        std::string identity = V4l2DeviceIdentity(io);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(path);
+        if (it != entries.end() && !identity.empty() && it->second.identity == identity) {
+            return it->second.controls;
+        }
+        std::shared_ptr<V4l2ControlSet> controls = std::make_shared<V4l2ControlSet>();
+        if (!controls->Query(io)) {
+            entries.erase(path);
+            return nullptr;
+        }
+        // Without an identity a replug cannot be told apart, query every time
+        if (identity.empty()) {
+            entries.erase(path);
+        } else {
+            entries[path] = { identity, controls };
+        }
+        return controls;
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+    }
+
+private:
+    struct Entry {
+        std::string identity;
+        std::shared_ptr<const V4l2ControlSet> controls;
+    };
+
+    std::mutex mutex;
+    std::map<std::string, Entry> entries;
+};
+
+/**
+ * Camera answering the capability and control ioctls from memory, stands in
+ * for the device file in tests. Offers brightness, white_balance_automatic,
+ * white_balance_temperature (inactive while automatic) and
+ * power_line_frequency.
+ */
+class V4l2SimulatedCamera : public V4l2DeviceIo {
+public:
+    /**
+     * @param textIds Controls to offer, all if empty
+     */
+    V4l2SimulatedCamera(const std::string &card, const std::string &busInfo, const std::vector<std::string> &textIds = {})
+        : card(card), busInfo(busInfo) {
+        AddControl(textIds, V4L2_CID_BRIGHTNESS, V4L2_CTRL_TYPE_INTEGER, "Brightness", -64, 64, 0);
+        AddControl(textIds, V4L2_CID_AUTO_WHITE_BALANCE, V4L2_CTRL_TYPE_BOOLEAN, "White Balance, Automatic", 0, 1, 1);
+        AddControl(textIds, V4L2_CID_POWER_LINE_FREQUENCY, V4L2_CTRL_TYPE_MENU, "Power Line Frequency", 0, 2, 1,
+                   { "Disabled", "50 Hz", "60 Hz" });
+        AddControl(textIds, V4L2_CID_WHITE_BALANCE_TEMPERATURE, V4L2_CTRL_TYPE_INTEGER, "White Balance Temperature", 2800, 6500, 4600);
+    }
+
+    int Ioctl(unsigned long request, void *argument) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        switch (request) {
+        case VIDIOC_QUERYCAP:
+            return QueryCapability(*(struct v4l2_capability *) argument);
+        case VIDIOC_QUERY_EXT_CTRL:
+            return QueryControl(*(struct v4l2_query_ext_ctrl *) argument);
+        case VIDIOC_QUERYMENU:
+            return QueryMenu(*(struct v4l2_querymenu *) argument);
+        case VIDIOC_G_EXT_CTRLS:
+            return GetControls(*(struct v4l2_ext_controls *) argument);
+        case VIDIOC_S_EXT_CTRLS:
+            return SetControls(*(struct v4l2_ext_controls *) argument);
+        default:
+            return Fail(ENOTTY);
+        }
+    }
+
+    /**
+     * Number of control enumerations from the first control on
+     */
+    uint64_t Enumerations() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return enumerations;
+    }
+
+private:
+    struct Control {
+        struct v4l2_query_ext_ctrl query;
+        std::vector<std::string> menu;
+        int64_t value;
+    };
+
+    std::mutex mutex;
+    std::string card;
+    std::string busInfo;
+    // Ordered by id like the driver enumerates them
+    std::map<uint32_t, Control> controls;
+    uint64_t enumerations = 0;
+
+    static int Fail(int error) {
+        errno = error;
+        return -1;
+    }
+
+    void AddControl(const std::vector<std::string> &textIds, uint32_t id, uint32_t type, const char *name,
+                    int64_t minimum, int64_t maximum, int64_t defaultValue, const std::vector<std::string> &menu = {}) {
+        if (!textIds.empty() && std::find(textIds.begin(), textIds.end(), V4l2TextId(name)) == textIds.end()) { return; }
+        Control control = {};
+        control.query.id = id;
+        control.query.type = type;
+        strncpy(control.query.name, name, sizeof(control.query.name) - 1);
+        control.query.minimum = minimum;
+        control.query.maximum = maximum;
+        control.query.step = type == V4L2_CTRL_TYPE_MENU ? 0 : 1;
+        control.query.default_value = defaultValue;
+        control.menu = menu;
+        control.value = defaultValue;
+        controls[id] = control;
+    }
+
+    int QueryCapability(struct v4l2_capability &capability) {
+        memset(&capability, 0, sizeof(capability));
+        strncpy((char *) capability.driver, "uvcvideo", sizeof(capability.driver) - 1);
+        strncpy((char *) capability.card, card.c_str(), sizeof(capability.card) - 1);
+        strncpy((char *) capability.bus_info, busInfo.c_str(), sizeof(capability.bus_info) - 1);
+        capability.capabilities = V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_DEVICE_CAPS;
+        capability.device_caps = V4L2_CAP_VIDEO_CAPTURE;
+        return 0;
+    }
+
+    int QueryControl(struct v4l2_query_ext_ctrl &query) {
+        uint32_t id = query.id & ~(V4L2_CTRL_FLAG_NEXT_CTRL | V4L2_CTRL_FLAG_NEXT_COMPOUND);
+        auto it = controls.end();
+        if (query.id & V4L2_CTRL_FLAG_NEXT_CTRL) {
+            if (id == 0) { enumerations += 1; }
+            it = controls.upper_bound(id);
+        } else {
+            it = controls.find(id);
+        }
+        if (it == controls.end()) { return Fail(EINVAL); }
+        query = it->second.query;
+        auto automatic = controls.find(V4L2_CID_AUTO_WHITE_BALANCE);
+        if (query.id == V4L2_CID_WHITE_BALANCE_TEMPERATURE && automatic != controls.end() && automatic->second.value != 0) {
+            query.flags |= V4L2_CTRL_FLAG_INACTIVE;
+        }
+        return 0;
+    }
+
+    int QueryMenu(struct v4l2_querymenu &query) {
+        auto it = controls.find(query.id);
+        if (it == controls.end() || query.index >= it->second.menu.size()) { return Fail(EINVAL); }
+        strncpy((char *) query.name, it->second.menu[query.index].c_str(), sizeof(query.name) - 1);
+        return 0;
+    }
+
+    int GetControls(struct v4l2_ext_controls &batch) {
+        for (uint32_t i = 0; i < batch.count; ++i) {
+            auto it = controls.find(batch.controls[i].id);
+            if (it == controls.end()) {
+                batch.error_idx = i;
+                return Fail(EINVAL);
+            }
+            batch.controls[i].value = (int32_t) it->second.value;
+        }
+        return 0;
+    }
+
+    /**
+     * All or nothing like the driver, integers are clamped to their range
+     */
+    int SetControls(struct v4l2_ext_controls &batch) {
+        for (uint32_t i = 0; i < batch.count; ++i) {
+            auto it = controls.find(batch.controls[i].id);
+            const struct v4l2_query_ext_ctrl *query = it != controls.end() ? &it->second.query : nullptr;
+            if (query == nullptr || (query->type == V4L2_CTRL_TYPE_MENU
+                && (batch.controls[i].value < query->minimum || batch.controls[i].value > query->maximum))) {
+                batch.error_idx = i;
+                return Fail(EINVAL);
+            }
+        }
+        for (uint32_t i = 0; i < batch.count; ++i) {
+            Control &control = controls[batch.controls[i].id];
+            int64_t value = std::max<int64_t>(control.query.minimum, std::min<int64_t>(control.query.maximum, batch.controls[i].value));
+            control.value = value;
+            batch.controls[i].value = (int32_t) value;
+        }
+        return 0;
+    }
+};
@@ -21,12 +21,123 @@
 #include <cmath>
 #include <libudev.h>
 #include <vector>
+#include <mutex>
+#include <memory>
+#include <map>
+#include <exception>
 #include "tuxedo_io_lib/tuxedo_io_api.hh"
+#include "tuxedo_io_lib/tuxedo_io_cpupolicy.hh"
+#include "tuxedo_io_lib/tuxedo_io_fancal.hh"
+#include "tuxedo_io_lib/tuxedo_io_gpu.hh"
+#include "tuxedo_io_lib/tuxedo_io_hotplug.hh"
+#include "tuxedo_io_lib/tuxedo_io_journal.hh"
+#include "tuxedo_io_lib/tuxedo_io_latency.hh"
+#include "tuxedo_io_lib/tuxedo_io_leds.hh"
+#include "tuxedo_io_lib/tuxedo_io_logins.hh"
+#include "tuxedo_io_lib/tuxedo_io_probes.hh"
+#include "tuxedo_io_lib/tuxedo_io_profile.hh"
+#include "tuxedo_io_lib/tuxedo_io_resume.hh"
+#include "tuxedo_io_lib/tuxedo_io_sampler.hh"
+#include "tuxedo_io_lib/tuxedo_io_scheduler.hh"
+#include "tuxedo_io_lib/tuxedo_io_session.hh"
+#include "tuxedo_io_lib/tuxedo_io_sim.hh"
+#include "tuxedo_io_lib/tuxedo_io_state.hh"
+#include "tuxedo_io_lib/tuxedo_io_telemetry.hh"
+#include "tuxedo_io_lib/tuxedo_io_v4l2.hh"
+#include "tuxedo_io_lib/tuxedo_io_metrics.hh"
+#include "tuxedo_io_lib/tuxedo_io_telemetry_shm.hh"
 
 using namespace Napi;
 
+/**
+ * State of one addon instance. The main thread and every worker_thread
+ * loading the addon get their own, the device session is shared.
+ */
+struct AddonData {
+    // Keeps the process wide device open while the instance lives
+    std::shared_ptr<DeviceSession> session = DeviceSession::Acquire();
+    // Read only mappings of the daemon's telemetry
+    TelemetryShm telemetryShmReader;
+    TelemetryJournal telemetryJournalReader;
+};
+
+static inline AddonData &Data(Napi::Env env) {
+    return *env.GetInstanceData<AddonData>();
+}
+
+/**
+ * Exclusive access for call sequences that must not interleave with other calls
+ */
+static inline DeviceSession::Access LockDevice(Napi::Env env) {
+    return Data(env).session->Lock();
+}
+
+/**
+ * Shared access for single calls, concurrent callers are ordered by the ioctl queue
+ */
+static inline DeviceSession::Access ShareDevice(Napi::Env env) {
+    return Data(env).session->Share();
+}
+
+/**
+ * Device access of the native service threads. They hold the session of the
+ * starting instance weakly and lock it per read like every other caller.
+ */
+template <typename Read>
+static bool ReadSessionDevice(const std::weak_ptr<DeviceSession> &weakSession, Read read) {
+    std::shared_ptr<DeviceSession> session = weakSession.lock();
+    if (!session) { return false; }
+    DeviceSession::Access access = session->Share();
+    return read(access.Device());
+}
+
+/**
+ * Background services exist once per process. Each is stopped with the
+ * instance that started it, not with whichever instance exits first.
+ */
+enum AddonService {
+    SERVICE_SENSOR_SAMPLER,
+    SERVICE_RESUME_WATCH,
+    SERVICE_METRICS_SERVER,
+    SERVICE_TELEMETRY_PUBLISHER,
+    SERVICE_TELEMETRY_JOURNAL,
+    SERVICE_SCHEDULER,
+    SERVICE_IOCTL_TRACE,
+    SERVICE_GPU_QUERY,
+    SERVICE_KEYBOARD_LEDS,
+    SERVICE_LOOP_MONITOR,
+    SERVICE_DEVICE_WATCH,
+    SERVICE_COUNT
+};
+
+// Serializes starting and stopping services between instances
+static std::mutex serviceMutex;
+static AddonData *serviceOwners[SERVICE_COUNT] = {};
+
+template<typename Updater>
+static inline void UpdateTelemetry(Updater updater) {
+    TelemetryStore::Default().Update(updater);
+}
+
+static inline void UpdateFanTelemetry(int fanNr, int temperature, int speedPercent) {
+    if (fanNr < 0 || fanNr >= TELEMETRY_MAX_FANS) { return; }
+    UpdateTelemetry([&](TelemetrySnapshot &t) {
+        uint64_t now = TelemetryNowNs();
+        if (temperature != -1) {
+            t.fans[fanNr].temperature = temperature;
+            t.fans[fanNr].temperatureUpdatedNs = now;
+        }
+        if (speedPercent != -1) {
+            t.fans[fanNr].speedPercent = speedPercent;
+            t.fans[fanNr].speedUpdatedNs = now;
+        }
+        if (t.nrFans <= fanNr) { t.nrFans = fanNr + 1; }
+    });
+}
+
 Boolean GetModuleInfo(const CallbackInfo &info) {
-    TuxedoIOAPI io;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
     if (info.Length() != 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "GetModuleInfo - invalid argument"); }
 
     Object moduleInfo = info[0].As<Object>();
@@ -46,6 +157,11 @@ Boolean GetModuleInfo(const CallbackInfo &info) {
     io.DeviceModelIdStr(deviceIdStr);
     moduleInfo.Set("model", deviceIdStr);
 
+    UpdateTelemetry([&](TelemetrySnapshot &t) {
+        TelemetrySetString(t.interfaceId, sizeof(t.interfaceId), activeInterface.empty() ? "inactive" : activeInterface);
+        TelemetrySetString(t.modelId, sizeof(t.modelId), deviceIdStr);
+    });
+
     return Boolean::New(info.Env(), result);
 }
 
@@ -66,7 +182,8 @@ static inline bool CheckMinVersionByStrings(std::string version, std::string min
 }
 
 Boolean WmiAvailable(const CallbackInfo &info) {
-    TuxedoIOAPI io;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
 
     std::string modVersion, modAPIMinVersion;
 
@@ -80,92 +197,339 @@ Boolean WmiAvailable(const CallbackInfo &info) {
 
 Boolean SetEnableModeSet(const CallbackInfo &info) {
     if (info.Length() != 1 || !info[0].IsBoolean()) { throw Napi::Error::New(info.Env(), "SetEnableModeSet - invalid argument"); }
-    TuxedoIOAPI io;
     bool enabled = info[0].As<Boolean>();
-    bool result = io.SetEnableModeSet(enabled);
+    DeviceSession::Access access = ShareDevice(info.Env());
+    bool result = access.Recording().SetEnableModeSet(enabled);
     return Boolean::New(info.Env(), result);
 }
 
 Number GetFansMinSpeed(const CallbackInfo &info) {
-    TuxedoIOAPI io;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
     int minSpeed = 0;
     io.GetFansMinSpeed(minSpeed);
+    UpdateTelemetry([&](TelemetrySnapshot &t) { t.fansMinSpeed = minSpeed; });
     return Number::New(info.Env(), minSpeed);
 }
 
 Boolean GetFansOffAvailable(const CallbackInfo &info) {
-    TuxedoIOAPI io;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
     bool offAvailable = true;
     io.GetFansOffAvailable(offAvailable);
+    UpdateTelemetry([&](TelemetrySnapshot &t) { t.fansOffAvailable = offAvailable ? 1 : 0; });
     return Boolean::New(info.Env(), offAvailable);
 }
 
 Number GetNumberFans(const CallbackInfo &info) {
-    TuxedoIOAPI io;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
     int nrFans = 0;
     io.GetNumberFans(nrFans);
+    UpdateTelemetry([&](TelemetrySnapshot &t) { t.nrFans = nrFans; });
     return Number::New(info.Env(), nrFans);
 }
 
 Boolean SetFansAuto(const CallbackInfo &info) {
-    TuxedoIOAPI io;
-    bool result = io.SetFansAuto();
+    LoopMonitor::CallTimer timer;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    bool result = access.Recording().SetFansAuto();
     return Boolean::New(info.Env(), result);
 }
 
 Boolean SetFanSpeedPercent(const CallbackInfo &info) {
+    LoopMonitor::CallTimer timer;
     if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsNumber()) { throw Napi::Error::New(info.Env(), "SetFanSpeedPercent - invalid argument"); }
-    TuxedoIOAPI io;
 
     int fanNumber = info[0].As<Number>();
     int fanSpeedPercent = info[1].As<Number>();
-    bool result = io.SetFanSpeedPercent(fanNumber, fanSpeedPercent);
+    DeviceSession::Access access = ShareDevice(info.Env());
+    bool result = access.Recording().SetFanSpeedPercent(fanNumber, fanSpeedPercent);
     return Boolean::New(info.Env(), result);
 }
 
 Boolean GetFanSpeedPercent(const CallbackInfo &info) {
+    LoopMonitor::CallTimer timer;
     if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsObject()) { throw Napi::Error::New(info.Env(), "GetFanSpeedPercent - invalid argument"); }
-    TuxedoIOAPI io;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
     int fanNumber = info[0].As<Number>();
     int fanSpeedPercent;
     bool result = io.GetFanSpeedPercent(fanNumber, fanSpeedPercent);
+    if (result) { UpdateFanTelemetry(fanNumber, -1, fanSpeedPercent); }
     Object objWrapper = info[1].As<Object>();
     objWrapper.Set("value", fanSpeedPercent);
     return Boolean::New(info.Env(), result);
 }
 
 Boolean GetFanTemperature(const CallbackInfo &info) {
+    LoopMonitor::CallTimer timer;
     if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsObject()) { throw Napi::Error::New(info.Env(), "GetFanTemperature - invalid argument"); }
-    TuxedoIOAPI io;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
     int fanNumber = info[0].As<Number>();
     int temperatureCelcius;
     bool result = io.GetFanTemperature(fanNumber, temperatureCelcius);
+    if (result) { UpdateFanTelemetry(fanNumber, temperatureCelcius, -1); }
     Object objWrapper = info[1].As<Object>();
     objWrapper.Set("value", temperatureCelcius);
     return Boolean::New(info.Env(), result);
 }
 
+Boolean GetDeviceStatus(const CallbackInfo &info) {
+    LoopMonitor::CallTimer timer;
+    if (info.Length() != 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "GetDeviceStatus - invalid argument"); }
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
+    DeviceStatus status;
+    bool result = io.GetStatus(status);
+    Object statusObject = info[0].As<Object>();
+    Array fans = Array::New(info.Env());
+    for (int i = 0; i < status.nrFans && i < DEVICE_STATUS_MAX_FANS; ++i) {
+        Object fan = Object::New(info.Env());
+        fan.Set("speedPercent", status.fanSpeedPercent[i]);
+        fan.Set("temperature", status.fanTemperature[i]);
+        fans[i] = fan;
+        UpdateFanTelemetry(i, status.fanTemperature[i], status.fanSpeedPercent[i]);
+    }
+    statusObject.Set("fans", fans);
+    Array tdps = Array::New(info.Env());
+    for (int i = 0; i < status.nrTDPs && i < DEVICE_STATUS_MAX_TDPS; ++i) {
+        Object tdp = Object::New(info.Env());
+        tdp.Set("min", status.tdpMin[i]);
+        tdp.Set("max", status.tdpMax[i]);
+        tdp.Set("current", status.tdp[i]);
+        tdps[i] = tdp;
+    }
+    statusObject.Set("tdps", tdps);
+    return Boolean::New(info.Env(), result);
+}
+
 Boolean SetWebcamStatus(const CallbackInfo &info) {
-    TuxedoIOAPI io;
     if (info.Length() != 1 || !info[0].IsBoolean()) { throw Napi::Error::New(info.Env(), "SetWebcamStatus - invalid argument"); }
     bool status = info[0].As<Boolean>();
-    bool result = io.SetWebcam(status);
+    DeviceSession::Access access = ShareDevice(info.Env());
+    bool result = access.Recording().SetWebcam(status);
+    if (result) { UpdateTelemetry([&](TelemetrySnapshot &t) { t.webcamStatus = status ? 1 : 0; }); }
     return Boolean::New(info.Env(), result);
 }
 
 Boolean GetWebcamStatus(const CallbackInfo &info) {
     if (info.Length() != 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "GetWebcamStatus - invalid argument"); }
-    TuxedoIOAPI io;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
     bool status = false;
     bool result = io.GetWebcam(status);
+    if (result) { UpdateTelemetry([&](TelemetrySnapshot &t) { t.webcamStatus = status ? 1 : 0; }); }
     Object objWrapper = info[0].As<Object>();
     objWrapper.Set("value", status);
     return Boolean::New(info.Env(), result);
 }
 
+/**
+ * Capture devices as devnode to "vendor:product", one node per camera (the
+ * lowest numbered) like cameractrls.py --info
+ */
+Object GetWebcamDevices(const CallbackInfo &info) {
+    if (info.Length() > 1 || (info.Length() == 1 && !info[0].IsBoolean())) { throw Napi::Error::New(info.Env(), "GetWebcamDevices - invalid argument"); }
+    bool ignoreGrey = info.Length() == 0 || info[0].As<Boolean>();
+    // Camera id to node number and path
+    std::map<std::string, std::pair<int, std::string>> cameras;
+
+    TUXEDO_IO_PROBE1(udev__enumerate__entry, "video4linux");
+    struct udev *udev_context = udev_new();
+    if (udev_context) {
+        struct udev_enumerate *video_devices = udev_enumerate_new(udev_context);
+        if (video_devices) {
+            struct udev_list_entry *video_devices_entry;
+            if (udev_enumerate_add_match_subsystem(video_devices, "video4linux") >= 0
+                    && udev_enumerate_scan_devices(video_devices) >= 0) {
+                udev_list_entry_foreach(video_devices_entry, udev_enumerate_get_list_entry(video_devices)) {
+                    struct udev_device *device = udev_device_new_from_syspath(udev_context, udev_list_entry_get_name(video_devices_entry));
+                    if (!device) { continue; }
+                    const char *devnode = udev_device_get_devnode(device);
+                    const char *vendorId = udev_device_get_property_value(device, "ID_VENDOR_ID");
+                    const char *modelId = udev_device_get_property_value(device, "ID_MODEL_ID");
+                    int number;
+                    if (devnode && vendorId && modelId && sscanf(devnode, "/dev/video%d", &number) == 1) {
+                        V4l2FileIo io(devnode);
+                        std::string cameraId = std::string(vendorId) + ":" + modelId;
+                        auto known = cameras.find(cameraId);
+                        if (io.IsOpen() && V4l2IsCaptureDevice(io) && (!ignoreGrey || V4l2HasColorFormat(io))
+                                && (known == cameras.end() || number < known->second.first)) {
+                            cameras[cameraId] = { number, devnode };
+                        }
+                    }
+                    udev_device_unref(device);
+                }
+            }
+            udev_enumerate_unref(video_devices);
+        }
+        udev_unref(udev_context);
+    }
+    TUXEDO_IO_PROBE2(udev__enumerate__return, "video4linux", (long) cameras.size());
+
+    Object result = Object::New(info.Env());
+    for (const auto &camera : cameras) {
+        result.Set(camera.second.second, camera.first);
+    }
+    return result;
+}
+
+static const char *V4l2ControlTypeName(V4l2ControlType type) {
+    switch (type) {
+    case V4l2ControlType::Integer: return "integer";
+    case V4l2ControlType::Boolean: return "boolean";
+    case V4l2ControlType::Button: return "button";
+    default: return "menu";
+    }
+}
+
+// Simulated cameras by device path, answered instead of the device file
+static std::mutex v4l2SimulationMutex;
+static std::map<std::string, std::shared_ptr<V4l2SimulatedCamera>> v4l2SimulatedCameras;
+
+/**
+ * @returns nullptr if the device file cannot be opened
+ */
+static std::shared_ptr<V4l2DeviceIo> OpenV4l2Device(const std::string &devicePath) {
+    {
+        std::lock_guard<std::mutex> lock(v4l2SimulationMutex);
+        auto it = v4l2SimulatedCameras.find(devicePath);
+        if (it != v4l2SimulatedCameras.end()) { return it->second; }
+    }
+    std::shared_ptr<V4l2FileIo> io = std::make_shared<V4l2FileIo>(devicePath);
+    return io->IsOpen() ? io : nullptr;
+}
+
+Boolean GetV4l2Controls(const CallbackInfo &info) {
+    if (info.Length() != 2 || !info[0].IsString() || !info[1].IsArray()) { throw Napi::Error::New(info.Env(), "GetV4l2Controls - invalid argument"); }
+    std::string devicePath = info[0].As<String>();
+    Array controlArray = info[1].As<Array>();
+    std::shared_ptr<V4l2DeviceIo> io = OpenV4l2Device(devicePath);
+    std::shared_ptr<const V4l2ControlSet> controlSet;
+    if (!io || !(controlSet = V4l2ControlCache::Default().Get(devicePath, *io))) {
+        return Boolean::New(info.Env(), false);
+    }
+
+    std::vector<V4l2Control> controls = controlSet->Controls();
+    controlSet->RefreshFlags(*io, controls);
+    std::map<uint32_t, int64_t> values = controlSet->ReadValues(*io);
+    for (size_t i = 0; i < controls.size(); ++i) {
+        Object control = Object::New(info.Env());
+        control.Set("id", controls[i].id);
+        control.Set("name", controls[i].name);
+        control.Set("textId", controls[i].textId);
+        control.Set("type", V4l2ControlTypeName(controls[i].type));
+        control.Set("minimum", (double) controls[i].minimum);
+        control.Set("maximum", (double) controls[i].maximum);
+        control.Set("step", (double) controls[i].step);
+        control.Set("default", (double) controls[i].defaultValue);
+        auto value = values.find(controls[i].id);
+        if (value != values.end()) {
+            control.Set("value", (double) value->second);
+        }
+        control.Set("inactive", (controls[i].flags & V4L2_CTRL_FLAG_INACTIVE) != 0);
+        Array menu = Array::New(info.Env(), controls[i].menu.size());
+        for (size_t j = 0; j < controls[i].menu.size(); ++j) {
+            Object item = Object::New(info.Env());
+            item.Set("index", (double) controls[i].menu[j].index);
+            item.Set("textId", controls[i].menu[j].textId);
+            item.Set("name", controls[i].menu[j].name);
+            menu[j] = item;
+        }
+        control.Set("menu", menu);
+        controlArray[i] = control;
+    }
+    return Boolean::New(info.Env(), true);
+}
+
+static Array StringsToArray(Napi::Env env, const std::vector<std::string> &strings) {
+    Array result = Array::New(env, strings.size());
+    for (size_t i = 0; i < strings.size(); ++i) {
+        result[i] = String::New(env, strings[i]);
+    }
+    return result;
+}
+
+/**
+ * Set controls by text id in one batch
+ * @returns True if every control was applied
+ */
+Boolean SetV4l2Controls(const CallbackInfo &info) {
+    if (info.Length() < 2 || info.Length() > 3 || !info[0].IsString() || !info[1].IsObject() || (info.Length() == 3 && !info[2].IsObject())) {
+        throw Napi::Error::New(info.Env(), "SetV4l2Controls - invalid argument");
+    }
+    std::string devicePath = info[0].As<String>();
+    Object controlValues = info[1].As<Object>();
+    std::vector<std::pair<std::string, std::string>> values;
+    Array names = controlValues.GetPropertyNames();
+    for (uint32_t i = 0; i < names.Length(); ++i) {
+        std::string name = names.Get(i).As<String>();
+        values.push_back({ name, controlValues.Get(name).ToString() });
+    }
+
+    V4l2ApplyResult result;
+    std::shared_ptr<V4l2DeviceIo> io = OpenV4l2Device(devicePath);
+    std::shared_ptr<const V4l2ControlSet> controlSet;
+    if (io && (controlSet = V4l2ControlCache::Default().Get(devicePath, *io))) {
+        result = controlSet->Apply(*io, values);
+    } else {
+        for (const auto &value : values) { result.failed.push_back(value.first); }
+    }
+    if (info.Length() == 3) {
+        Object resultObject = info[2].As<Object>();
+        resultObject.Set("applied", StringsToArray(info.Env(), result.applied));
+        resultObject.Set("unknown", StringsToArray(info.Env(), result.unknown));
+        resultObject.Set("failed", StringsToArray(info.Env(), result.failed));
+    }
+    return Boolean::New(info.Env(), result.unknown.empty() && result.failed.empty());
+}
+
+/**
+ * Serve a simulated camera at the path to the control functions, replaces
+ * the camera simulated there before like a replug
+ */
+void SimulateV4l2Camera(const CallbackInfo &info) {
+    if (info.Length() < 1 || info.Length() > 2 || !info[0].IsString() || (info.Length() == 2 && !info[1].IsObject())) {
+        throw Napi::Error::New(info.Env(), "SimulateV4l2Camera - invalid argument");
+    }
+    std::string devicePath = info[0].As<String>();
+    std::string card = "Simulated Camera", busInfo = "usb-0000:00:14.0-1";
+    std::vector<std::string> textIds;
+    if (info.Length() == 2) {
+        Object options = info[1].As<Object>();
+        if (options.Has("card")) { card = options.Get("card").As<String>(); }
+        if (options.Has("busInfo")) { busInfo = options.Get("busInfo").As<String>(); }
+        if (options.Has("controls")) {
+            Array controls = options.Get("controls").As<Array>();
+            for (uint32_t i = 0; i < controls.Length(); ++i) {
+                textIds.push_back(controls.Get(i).As<String>());
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lock(v4l2SimulationMutex);
+    v4l2SimulatedCameras[devicePath] = std::make_shared<V4l2SimulatedCamera>(card, busInfo, textIds);
+}
+
+void StopV4l2Simulation(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(v4l2SimulationMutex);
+    v4l2SimulatedCameras.clear();
+    V4l2ControlCache::Default().Clear();
+}
+
+Number GetV4l2SimulationEnumerations(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsString()) { throw Napi::Error::New(info.Env(), "GetV4l2SimulationEnumerations - invalid argument"); }
+    std::lock_guard<std::mutex> lock(v4l2SimulationMutex);
+    auto it = v4l2SimulatedCameras.find(info[0].As<String>());
+    return Number::New(info.Env(), it != v4l2SimulatedCameras.end() ? (double) it->second->Enumerations() : -1);
+}
+
 Array GetOutputPorts(const CallbackInfo &info) {
     Array result;
+    int ports = 0;
 
+    TUXEDO_IO_PROBE1(udev__enumerate__entry, "drm");
     struct udev *udev_context = udev_new();
     if (!udev_context) {
         // Placeholder for error log output
@@ -194,19 +558,23 @@ Array GetOutputPorts(const CallbackInfo &info) {
                         result[card_number] = Array::New(info.Env());
                     }
                     result.Get(card_number).As<Array>()[result.Get(card_number).As<Array>().Length()] = name.substr(name.find("-")+1);
+                    ports += 1;
                 }
             }
             udev_enumerate_unref(drm_devices);
         }
         udev_unref(udev_context);
     }
+    TUXEDO_IO_PROBE2(udev__enumerate__return, "drm", ports);
+    (void) ports;
 
     return result;
 }
 
 Boolean GetAvailableODMPerformanceProfiles(const CallbackInfo &info) {
     if (info.Length() != 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "GetAvailableODMPerformanceProfiles - invalid argument"); }
-    TuxedoIOAPI io;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
     Object objWrapper = info[0].As<Object>();
     std::vector<std::string> profiles;
     bool result = io.GetAvailableODMPerformanceProfiles(profiles);
@@ -221,15 +589,17 @@ Boolean GetAvailableODMPerformanceProfiles(const CallbackInfo &info) {
 Boolean SetODMPerformanceProfile(const CallbackInfo &info) {
     if (info.Length() != 1 || !info[0].IsString()) { throw Napi::Error::New(info.Env(), "SetODMPerformanceProfile - invalid argument"); }
     std::string performanceProfile = info[0].As<String>();
-    TuxedoIOAPI io;
-    bool result = io.SetODMPerformanceProfile(performanceProfile);
+    DeviceSession::Access access = ShareDevice(info.Env());
+    bool result = access.Recording().SetODMPerformanceProfile(performanceProfile);
+    if (result) { UpdateTelemetry([&](TelemetrySnapshot &t) { TelemetrySetString(t.odmProfile, sizeof(t.odmProfile), performanceProfile); }); }
     return Boolean::New(info.Env(), result);
 }
 
 Boolean GetDefaultODMPerformanceProfile(const CallbackInfo &info) {
     if (info.Length() != 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "GetDefaultODMPerformanceProfile - invalid argument"); }
     Object objWrapper = info[0].As<Object>();
-    TuxedoIOAPI io;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
     std::string profileName;
     bool result = io.GetDefaultODMPerformanceProfile(profileName);
     objWrapper.Set("value", profileName);
@@ -239,34 +609,46 @@ Boolean GetDefaultODMPerformanceProfile(const CallbackInfo &info) {
 Boolean GetTDPInfo(const CallbackInfo &info) {
     if (info.Length() != 1 || !info[0].IsArray()) { throw Napi::Error::New(info.Env(), "GetTDPInfo - invalid argument"); }
     Array tdpArray = info[0].As<Array>();
-    TuxedoIOAPI io;
+    DeviceSession::Access access = ShareDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
     bool result;
     int nrTDPs = 0;
     std::vector<std::string> tdpDescriptors;
     io.GetTDPDescriptors(tdpDescriptors);
     result = io.GetNumberTDPs(nrTDPs);
-    for (int i = 0; i < nrTDPs; ++i) {
+    // Min, max and current of all TDPs in one batched read
+    DeviceStatus status;
+    io.GetStatus(status);
+    for (int i = 0; i < nrTDPs && i < DEVICE_STATUS_MAX_TDPS; ++i) {
         Object tdpInfo = Object::New(info.Env());
-        int minValue, maxValue, currentValue;
-        io.GetTDPMin(i, minValue);
-        io.GetTDPMax(i, maxValue);
-        io.GetTDP(i, currentValue);
+        int minValue = status.tdpMin[i], maxValue = status.tdpMax[i], currentValue = status.tdp[i];
         tdpInfo.Set("min", minValue);
         tdpInfo.Set("max", maxValue);
         tdpInfo.Set("current", currentValue);
         tdpInfo.Set("descriptor", tdpDescriptors.at(i));
         tdpArray[i] = tdpInfo;
+        if (i < TELEMETRY_MAX_TDPS) {
+            UpdateTelemetry([&](TelemetrySnapshot &t) {
+                TelemetrySetString(t.tdps[i].descriptor, sizeof(t.tdps[i].descriptor), tdpDescriptors.at(i));
+                t.tdps[i].min = minValue;
+                t.tdps[i].max = maxValue;
+                t.tdps[i].current = currentValue;
+            });
+        }
     }
+    UpdateTelemetry([&](TelemetrySnapshot &t) { t.nrTDPs = nrTDPs; });
     return Boolean::New(info.Env(), result);
 }
 
 Boolean SetTDPValues(const CallbackInfo &info) {
     if (info.Length() != 1 || !info[0].IsArray()) { throw Napi::Error::New(info.Env(), "SetTDP - invalid argument"); }
-    TuxedoIOAPI io;
+    DeviceSession::Access access = LockDevice(info.Env());
+    TuxedoIOAPI &io = access.Device();
     Array tdpValues = info[0].As<Array>();
     int nrInputs = tdpValues.Length();
     bool result;
     int nrTDPs = 0;
+    StateRecordingDevice device = access.Recording();
     result = io.GetNumberTDPs(nrTDPs);
     for (int i = 0; i < nrTDPs && i < nrInputs; ++i) {
         int32_t tdpValue;
@@ -274,40 +656,2067 @@ Boolean SetTDPValues(const CallbackInfo &info) {
         if (apiStatus != napi_ok) {
             throw Napi::Error::New(info.Env(), "SetTDP - invalid array element type");
         }
-        io.SetTDP(i, tdpValue);
+        if (device.SetTDP(i, tdpValue) && i < TELEMETRY_MAX_TDPS) {
+            UpdateTelemetry([&](TelemetrySnapshot &t) { t.tdps[i].current = tdpValue; });
+        }
     }
     return Boolean::New(info.Env(), result);
 }
 
-Object Init(Env env, Object exports) {
-    // General
-    exports.Set(String::New(env, "getModuleInfo"), Function::New(env, GetModuleInfo));
-    exports.Set(String::New(env, "wmiAvailable"), Function::New(env, WmiAvailable));
+class ApplyProfileWorker : public AsyncWorker {
+public:
+    ApplyProfileWorker(Napi::Env env, std::shared_ptr<DeviceSession> session, const ProfileApplyRequest &request)
+        : AsyncWorker(env), deferred(Promise::Deferred::New(env)), session(session), request(request) { }
 
-    exports.Set(String::New(env, "setEnableModeSet"), Function::New(env, SetEnableModeSet));
-    exports.Set(String::New(env, "getOutputPorts"), Function::New(env, GetOutputPorts));
+    Promise GetPromise() { return deferred.Promise(); }
 
-    // Fan control
-    exports.Set(String::New(env, "getFansMinSpeed"), Function::New(env, GetFansMinSpeed));
-    exports.Set(String::New(env, "getFansOffAvailable"), Function::New(env, GetFansOffAvailable));
-    exports.Set(String::New(env, "getNumberFans"), Function::New(env, GetNumberFans));
-    exports.Set(String::New(env, "setFansAuto"), Function::New(env, SetFansAuto));
-    exports.Set(String::New(env, "setFanSpeedPercent"), Function::New(env, SetFanSpeedPercent));
-    exports.Set(String::New(env, "getFanSpeedPercent"), Function::New(env, GetFanSpeedPercent));
-    exports.Set(String::New(env, "getFanTemperature"), Function::New(env, GetFanTemperature));
+    void Execute() override {
+        auto start = std::chrono::steady_clock::now();
+        // Profile reads are part of the switch, not informational
+        IoctlPriorityScope priority(IoctlPriority::High);
+        DeviceSession::Access access = session->Lock();
+        StateRecordingDevice device = access.Recording();
+        ProfileApplier applier(device, access.State());
+        success = applier.Apply(request, steps);
+        UpdateTelemetry([&](TelemetrySnapshot &t) { TelemetrySetString(t.odmProfile, sizeof(t.odmProfile), access.State().odmProfile); });
+        durationUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
 
-    // Webcam
-    exports.Set(String::New(env, "setWebcamStatus"), Function::New(env, SetWebcamStatus));
-    exports.Set(String::New(env, "getWebcamStatus"), Function::New(env, GetWebcamStatus));
+    void OnOK() override {
+        Object result = Object::New(Env());
+        Array stepArray = Array::New(Env(), steps.size());
+        for (std::size_t i = 0; i < steps.size(); ++i) {
+            Object step = Object::New(Env());
+            step.Set("name", steps[i].name);
+            step.Set("skipped", steps[i].skipped);
+            step.Set("success", steps[i].success);
+            step.Set("durationUs", (double) steps[i].durationUs);
+            stepArray[i] = step;
+        }
+        result.Set("success", success);
+        result.Set("durationUs", (double) durationUs);
+        result.Set("steps", stepArray);
+        deferred.Resolve(result);
+    }
 
-    // ODM Profiles
-    exports.Set(String::New(env, "getAvailableODMPerformanceProfiles"), Function::New(env, GetAvailableODMPerformanceProfiles));
-    exports.Set(String::New(env, "setODMPerformanceProfile"), Function::New(env, SetODMPerformanceProfile));
-    exports.Set(String::New(env, "getDefaultODMPerformanceProfile"), Function::New(env, GetDefaultODMPerformanceProfile));
+    void OnError(const Error &e) override {
+        deferred.Reject(e.Value());
+    }
 
-    // TDP Control
-    exports.Set(String::New(env, "getTDPInfo"), Function::New(env, GetTDPInfo));
-    exports.Set(String::New(env, "setTDPValues"), Function::New(env, SetTDPValues));
+private:
+    Promise::Deferred deferred;
+    std::shared_ptr<DeviceSession> session;
+    ProfileApplyRequest request;
+    std::vector<ProfileApplyStep> steps;
+    bool success = false;
+    int64_t durationUs = 0;
+};
+
+static std::vector<FanTableEntry> FanTableFromArray(Napi::Env env, Array entries, const char *errorMessage) {
+    std::vector<FanTableEntry> table;
+    for (uint32_t j = 0; j < entries.Length(); ++j) {
+        if (!entries.Get(j).IsObject()) { throw Napi::Error::New(env, errorMessage); }
+        Object entry = entries.Get(j).As<Object>();
+        table.push_back({ entry.Get("temp").As<Number>().Int32Value(), entry.Get("speed").As<Number>().Int32Value() });
+    }
+    return table;
+}
+
+Value ApplyProfile(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "ApplyProfile - invalid argument"); }
+    Object profile = info[0].As<Object>();
+    ProfileApplyRequest request;
+
+    if (profile.Has("odmProfile") && profile.Get("odmProfile").IsString()) {
+        request.odmProfile = profile.Get("odmProfile").As<String>();
+    }
+
+    if (profile.Has("tdpValues") && profile.Get("tdpValues").IsArray()) {
+        Array tdpValues = profile.Get("tdpValues").As<Array>();
+        for (uint32_t i = 0; i < tdpValues.Length(); ++i) {
+            if (!tdpValues.Get(i).IsNumber()) { throw Napi::Error::New(info.Env(), "ApplyProfile - invalid TDP value"); }
+            request.tdpValues.push_back(tdpValues.Get(i).As<Number>().Int32Value());
+        }
+    }
+
+    if (profile.Has("fanMode") && profile.Get("fanMode").IsString()) {
+        std::string fanMode = profile.Get("fanMode").As<String>();
+        if (fanMode == "auto") {
+            request.fanMode = ProfileFanMode::Auto;
+        } else if (fanMode == "manual") {
+            request.fanMode = ProfileFanMode::Manual;
+        } else {
+            throw Napi::Error::New(info.Env(), "ApplyProfile - invalid fan mode");
+        }
+    }
+
+    if (profile.Has("fanSpeeds") && profile.Get("fanSpeeds").IsArray()) {
+        Array fanSpeeds = profile.Get("fanSpeeds").As<Array>();
+        for (uint32_t i = 0; i < fanSpeeds.Length(); ++i) {
+            if (!fanSpeeds.Get(i).IsNumber()) { throw Napi::Error::New(info.Env(), "ApplyProfile - invalid fan speed"); }
+            request.fanSpeeds.push_back(fanSpeeds.Get(i).As<Number>().Int32Value());
+        }
+    }
+
+    ApplyProfileWorker *worker = new ApplyProfileWorker(info.Env(), Data(info.Env()).session, request);
+    Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+struct ResumeStats {
+    int resumeCount = 0;
+    int64_t suspendedMs = 0;
+    DeviceStateRestoreStats restore;
+};
+
+static ResumeWatcher resumeWatcher;
+static ThreadSafeFunction resumeCallback;
+static bool resumeCallbackSet = false;
+static std::mutex resumeStatsMutex;
+static ResumeStats resumeStats;
+
+static Object ResumeStatsToObject(Env env, const ResumeStats &stats) {
+    Object result = Object::New(env);
+    result.Set("resumeCount", stats.resumeCount);
+    result.Set("suspendedMs", (double) stats.suspendedMs);
+    result.Set("restoreSuccess", stats.restore.success);
+    result.Set("restoreDurationUs", (double) stats.restore.durationUs);
+    result.Set("fanStateUs", (double) stats.restore.fanStateUs);
+    return result;
+}
+
+static void OnResume(int64_t suspendedMs) {
+    DeviceStateRestoreStats restoreStats;
+    {
+        IoctlPriorityScope priority(IoctlPriority::High);
+        // Same session as the instance owning the watch
+        std::shared_ptr<DeviceSession> session = DeviceSession::Acquire();
+        DeviceSession::Access access = session->Lock();
+        access.Recording().Restore(restoreStats);
+    }
+
+    ResumeStats *stats;
+    {
+        std::lock_guard<std::mutex> lock(resumeStatsMutex);
+        resumeStats.resumeCount += 1;
+        resumeStats.suspendedMs = suspendedMs;
+        resumeStats.restore = restoreStats;
+        stats = new ResumeStats(resumeStats);
+    }
+
+    napi_status status = napi_closing;
+    if (resumeCallbackSet) {
+        status = resumeCallback.NonBlockingCall(stats, [](Env env, Function callback, ResumeStats *stats) {
+            callback.Call({ ResumeStatsToObject(env, *stats) });
+            delete stats;
+        });
+    }
+    if (status != napi_ok) {
+        delete stats;
+    }
+}
+
+static void StopResumeWatchInternal() {
+    serviceOwners[SERVICE_RESUME_WATCH] = nullptr;
+    resumeWatcher.Stop();
+    if (resumeCallbackSet) {
+        resumeCallback.Release();
+        resumeCallbackSet = false;
+    }
+}
+
+Boolean StartResumeWatch(const CallbackInfo &info) {
+    if (info.Length() > 1 || (info.Length() == 1 && !info[0].IsFunction())) { throw Napi::Error::New(info.Env(), "StartResumeWatch - invalid argument"); }
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    if (resumeWatcher.IsRunning()) {
+        return Boolean::New(info.Env(), false);
+    }
+    if (info.Length() == 1) {
+        resumeCallback = ThreadSafeFunction::New(info.Env(), info[0].As<Function>(), "TuxedoIOResumeWatch", 0, 1);
+        // Resume watching must not keep the event loop alive on its own
+        resumeCallback.Unref(info.Env());
+        resumeCallbackSet = true;
+    }
+    bool result = resumeWatcher.Start(OnResume);
+    if (!result && resumeCallbackSet) {
+        resumeCallback.Release();
+        resumeCallbackSet = false;
+    }
+    if (result) { serviceOwners[SERVICE_RESUME_WATCH] = &Data(info.Env()); }
+    return Boolean::New(info.Env(), result);
+}
+
+void StopResumeWatch(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    StopResumeWatchInternal();
+}
+
+Object GetResumeStats(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(resumeStatsMutex);
+    return ResumeStatsToObject(info.Env(), resumeStats);
+}
+
+Boolean RestoreDeviceState(const CallbackInfo &info) {
+    DeviceStateRestoreStats restoreStats;
+    DeviceSession::Access access = LockDevice(info.Env());
+    bool result = access.Recording().Restore(restoreStats);
+    return Boolean::New(info.Env(), result);
+}
+
+Number GetLastError(const CallbackInfo &info) {
+    return Number::New(info.Env(), IO::LastError());
+}
+
+Array GetIoctlBreakerState(const CallbackInfo &info) {
+    std::vector<IoctlBreaker::Entry> entries = IoctlBreaker::Default().GetEntries();
+    Array result = Array::New(info.Env(), entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        Object entry = Object::New(info.Env());
+        entry.Set("request", (double) entries[i].request);
+        entry.Set("permanent", entries[i].permanent);
+        entry.Set("errno", entries[i].error);
+        entry.Set("failures", entries[i].failures);
+        entry.Set("retryInMs", (double) entries[i].retryInMs);
+        result[i] = entry;
+    }
+    return result;
+}
+
+void ResetIoctlBreaker(const CallbackInfo &info) {
+    IoctlBreaker::Default().Reset();
+}
+
+Object GetIoctlQueueStats(const CallbackInfo &info) {
+    IoctlQueueStats stats = IoctlQueue::Default().GetStats();
+    Object result = Object::New(info.Env());
+    result.Set("depth", (double) stats.depth);
+    result.Set("maxDepth", (double) stats.maxDepth);
+    result.Set("executed", (double) stats.executed);
+    result.Set("coalesced", (double) stats.coalesced);
+    result.Set("superseded", (double) stats.superseded);
+    const char *classNames[IOCTL_PRIORITY_CLASSES] = { "high", "normal", "low" };
+    Object priorities = Object::New(info.Env());
+    for (int i = 0; i < IOCTL_PRIORITY_CLASSES; ++i) {
+        Object priority = Object::New(info.Env());
+        priority.Set("submitted", (double) stats.submitted[i]);
+        priority.Set("avgWaitUs", stats.submitted[i] > 0 ? stats.totalWaitNs[i] / 1000.0 / stats.submitted[i] : 0);
+        priority.Set("maxWaitUs", stats.maxWaitNs[i] / 1000.0);
+        priorities.Set(classNames[i], priority);
+    }
+    result.Set("priorities", priorities);
+    return result;
+}
+
+static MetricsServer metricsServer;
+
+Boolean StartMetricsServer(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsString()) { throw Napi::Error::New(info.Env(), "StartMetricsServer - invalid argument"); }
+    std::string address = info[0].As<String>();
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    bool result = metricsServer.Start(address);
+    if (result) { serviceOwners[SERVICE_METRICS_SERVER] = &Data(info.Env()); }
+    return Boolean::New(info.Env(), result);
+}
+
+static void StopMetricsServerInternal() {
+    serviceOwners[SERVICE_METRICS_SERVER] = nullptr;
+    metricsServer.Stop();
+}
+
+void StopMetricsServer(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    StopMetricsServerInternal();
+}
+
+// Daemon side writable segment, the GUI side mapping is per instance
+static TelemetryShm telemetryShmPublisher;
+
+static void ClosePublishedTelemetry() {
+    serviceOwners[SERVICE_TELEMETRY_PUBLISHER] = nullptr;
+    TelemetryStore::Default().SetUpdateListener(nullptr);
+    telemetryShmPublisher.Close();
+}
+
+Boolean PublishTelemetry(const CallbackInfo &info) {
+    if (info.Length() > 1 || (info.Length() == 1 && !info[0].IsString())) { throw Napi::Error::New(info.Env(), "PublishTelemetry - invalid argument"); }
+    std::string name = info.Length() == 1 ? info[0].As<String>().Utf8Value() : TELEMETRY_SHM_NAME;
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    if (telemetryShmPublisher.IsOpen()) {
+        return Boolean::New(info.Env(), true);
+    }
+    if (!telemetryShmPublisher.Create(name.c_str())) {
+        return Boolean::New(info.Env(), false);
+    }
+    TelemetrySnapshot snapshot;
+    TelemetryStore::Default().Read(snapshot);
+    telemetryShmPublisher.Publish(snapshot);
+    TelemetryStore::Default().SetUpdateListener([](const TelemetrySnapshot &snapshot) {
+        telemetryShmPublisher.Publish(snapshot);
+    });
+    serviceOwners[SERVICE_TELEMETRY_PUBLISHER] = &Data(info.Env());
+    return Boolean::New(info.Env(), true);
+}
+
+void UnpublishTelemetry(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    ClosePublishedTelemetry();
+}
+
+Boolean OpenTelemetry(const CallbackInfo &info) {
+    if (info.Length() > 1 || (info.Length() == 1 && !info[0].IsString())) { throw Napi::Error::New(info.Env(), "OpenTelemetry - invalid argument"); }
+    std::string name = info.Length() == 1 ? info[0].As<String>().Utf8Value() : TELEMETRY_SHM_NAME;
+    TelemetryShm &reader = Data(info.Env()).telemetryShmReader;
+    return Boolean::New(info.Env(), reader.IsOpen() || reader.Open(name.c_str()));
+}
+
+static void SnapshotToObject(Napi::Env env, const TelemetrySnapshot &snapshot, Object result) {
+    result.Set("updatedNs", (double) snapshot.updatedNs);
+    result.Set("interface", std::string(snapshot.interfaceId));
+    result.Set("model", std::string(snapshot.modelId));
+    result.Set("odmProfile", std::string(snapshot.odmProfile));
+    result.Set("fansMinSpeed", snapshot.fansMinSpeed);
+    result.Set("fansOffAvailable", snapshot.fansOffAvailable == 1);
+    result.Set("webcamStatus", snapshot.webcamStatus);
+    Array fans = Array::New(env);
+    for (int i = 0; i < snapshot.nrFans && i < TELEMETRY_MAX_FANS; ++i) {
+        Object fan = Object::New(env);
+        fan.Set("temperature", snapshot.fans[i].temperature);
+        fan.Set("speedPercent", snapshot.fans[i].speedPercent);
+        fan.Set("temperatureUpdatedNs", (double) snapshot.fans[i].temperatureUpdatedNs);
+        fan.Set("speedUpdatedNs", (double) snapshot.fans[i].speedUpdatedNs);
+        fans[i] = fan;
+    }
+    result.Set("fans", fans);
+    Array tdps = Array::New(env);
+    for (int i = 0; i < snapshot.nrTDPs && i < TELEMETRY_MAX_TDPS; ++i) {
+        Object tdp = Object::New(env);
+        tdp.Set("descriptor", std::string(snapshot.tdps[i].descriptor));
+        tdp.Set("min", snapshot.tdps[i].min);
+        tdp.Set("max", snapshot.tdps[i].max);
+        tdp.Set("current", snapshot.tdps[i].current);
+        tdps[i] = tdp;
+    }
+    result.Set("tdps", tdps);
+    result.Set("ioctlCalls", (double) snapshot.ioctlCalls);
+    result.Set("ioctlErrors", (double) snapshot.ioctlErrors);
+}
+
+Boolean ReadTelemetry(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "ReadTelemetry - invalid argument"); }
+    Object result = info[0].As<Object>();
+    TelemetrySnapshot snapshot;
+    uint32_t sequence;
+    if (!Data(info.Env()).telemetryShmReader.Read(snapshot, sequence)) {
+        return Boolean::New(info.Env(), false);
+    }
+    result.Set("sequence", sequence);
+    SnapshotToObject(info.Env(), snapshot, result);
+    return Boolean::New(info.Env(), true);
+}
+
+void CloseTelemetry(const CallbackInfo &info) {
+    Data(info.Env()).telemetryShmReader.Close();
+}
+
+static AdaptiveSampler sensorSampler;
+
+static void StopSensorSamplerInternal() {
+    serviceOwners[SERVICE_SENSOR_SAMPLER] = nullptr;
+    sensorSampler.Stop();
+}
+
+Boolean StartSensorSampler(const CallbackInfo &info) {
+    if (info.Length() > 2 || (info.Length() >= 1 && !info[0].IsNumber()) || (info.Length() == 2 && !info[1].IsNumber())) {
+        throw Napi::Error::New(info.Env(), "StartSensorSampler - invalid argument");
+    }
+    int64_t minIntervalMs = info.Length() >= 1 ? info[0].As<Number>().Int64Value() : 100;
+    int64_t maxIntervalMs = info.Length() == 2 ? info[1].As<Number>().Int64Value() : 5000;
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    if (sensorSampler.IsRunning()) {
+        return Boolean::New(info.Env(), false);
+    }
+
+    int nrFans = 0;
+    if (!ShareDevice(info.Env()).Device().GetNumberFans(nrFans) || nrFans <= 0) {
+        return Boolean::New(info.Env(), false);
+    }
+    std::weak_ptr<DeviceSession> session = Data(info.Env()).session;
+    auto readTemperature = [session](int fanNr, int &temperature) {
+        return ReadSessionDevice(session, [&](TuxedoIOAPI &device) { return device.GetFanTemperature(fanNr, temperature); });
+    };
+    bool result = sensorSampler.Start(readTemperature, nrFans, minIntervalMs, maxIntervalMs, [](int fanNr, int temperature) {
+        UpdateFanTelemetry(fanNr, temperature, -1);
+    });
+    if (result) {
+        serviceOwners[SERVICE_SENSOR_SAMPLER] = &Data(info.Env());
+    }
+    return Boolean::New(info.Env(), result);
+}
+
+void StopSensorSampler(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    StopSensorSamplerInternal();
+}
+
+void SetSamplerFanTable(const CallbackInfo &info) {
+    if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsArray()) { throw Napi::Error::New(info.Env(), "SetSamplerFanTable - invalid argument"); }
+    int fanNumber = info[0].As<Number>();
+    sensorSampler.SetFanTable(fanNumber, FanTableFromArray(info.Env(), info[1].As<Array>(), "SetSamplerFanTable - invalid fan table entry"));
+}
+
+Boolean GetSampledFanTemperature(const CallbackInfo &info) {
+    if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsObject()) { throw Napi::Error::New(info.Env(), "GetSampledFanTemperature - invalid argument"); }
+    int fanNumber = info[0].As<Number>();
+    int temperatureCelcius = -1;
+    bool result = sensorSampler.GetTemperature(fanNumber, temperatureCelcius);
+    Object objWrapper = info[1].As<Object>();
+    objWrapper.Set("value", temperatureCelcius);
+    return Boolean::New(info.Env(), result);
+}
+
+Object GetSamplerStats(const CallbackInfo &info) {
+    SamplerStats stats = sensorSampler.GetStats();
+    Object result = Object::New(info.Env());
+    result.Set("running", stats.running);
+    result.Set("wakeupsPerMinute", stats.wakeupsPerMinute);
+    Array sensors = Array::New(info.Env());
+    for (size_t i = 0; i < stats.sensors.size(); ++i) {
+        Object sensor = Object::New(info.Env());
+        sensor.Set("fanNumber", stats.sensors[i].fanNr);
+        sensor.Set("temperature", stats.sensors[i].temperature);
+        sensor.Set("slope", stats.sensors[i].slope);
+        sensor.Set("intervalMs", (double) stats.sensors[i].intervalMs);
+        sensor.Set("breakpointDistance", stats.sensors[i].breakpointDistance);
+        sensors[i] = sensor;
+    }
+    result.Set("sensors", sensors);
+    return result;
+}
+
+/**
+ * Fan actuator calibration, the session is only locked for the single fan
+ * accesses so other calls are not held up for the minutes it takes
+ */
+class CalibrateFansWorker : public AsyncWorker {
+public:
+    CalibrateFansWorker(Napi::Env env, std::shared_ptr<DeviceSession> session, const std::vector<int> &fans, const FanCalibrationOptions &options)
+        : AsyncWorker(env), deferred(Promise::Deferred::New(env)), session(session), fans(fans), options(options) { }
+
+    Promise GetPromise() { return deferred.Promise(); }
+
+    void Execute() override {
+        auto start = std::chrono::steady_clock::now();
+        int nrFans = 0;
+        {
+            DeviceSession::Access access = session->Share();
+            access.Device().DeviceInterfaceIdStr(interfaceId);
+            access.Device().DeviceModelIdStr(modelId);
+            if (!access.Device().GetNumberFans(nrFans)) {
+                SetError("CalibrateFans - no fans");
+                return;
+            }
+        }
+        if (fans.empty()) {
+            for (int i = 0; i < nrFans; ++i) { fans.push_back(i); }
+        }
+
+        FanCalibration calibration(
+            [this](int fanNr, int percent) { return session->Share().Recording().SetFanSpeedPercent(fanNr, percent); },
+            [this](int fanNr, int &percent) { return session->Share().Device().GetFanSpeedPercent(fanNr, percent); },
+            [this, nrFans](int &temperature) {
+                DeviceSession::Access access = session->Share();
+                bool found = false;
+                for (int i = 0; i < nrFans; ++i) {
+                    int fanTemperature;
+                    if (access.Device().GetFanTemperature(i, fanTemperature)) {
+                        temperature = found ? std::max(temperature, fanTemperature) : fanTemperature;
+                        found = true;
+                    }
+                }
+                return found;
+            },
+            // Back to the EC, whoever drives the fans takes over again
+            [this]() { session->Share().Recording().SetFansAuto(); },
+            options);
+        for (int fanNr : fans) {
+            FanActuatorCharacteristics characteristics;
+            if (fanNr < 0 || fanNr >= nrFans) {
+                SetError("CalibrateFans - invalid fan");
+                break;
+            }
+            if (!calibration.Calibrate(fanNr, characteristics)) {
+                SetError(calibration.TemperatureExceeded() ? "CalibrateFans - temperature limit reached" : "CalibrateFans - fan access failed");
+                break;
+            }
+            results.push_back(characteristics);
+        }
+        durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void OnOK() override {
+        Array fanArray = Array::New(Env(), results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            const FanActuatorCharacteristics &characteristics = results[i];
+            Array stepArray = Array::New(Env(), characteristics.steps.size());
+            for (size_t j = 0; j < characteristics.steps.size(); ++j) {
+                Object step = Object::New(Env());
+                step.Set("commanded", characteristics.steps[j].commanded);
+                step.Set("readBack", characteristics.steps[j].readBack);
+                step.Set("latencyMs", (double) characteristics.steps[j].latencyMs);
+                step.Set("settlingMs", (double) characteristics.steps[j].settlingMs);
+                step.Set("settled", characteristics.steps[j].settled);
+                stepArray[j] = step;
+            }
+            Object fan = Object::New(Env());
+            fan.Set("fan", characteristics.fanNr);
+            fan.Set("offAvailable", characteristics.offAvailable);
+            fan.Set("minimumPercent", characteristics.minimumPercent);
+            fan.Set("quantizationPercent", characteristics.quantizationPercent);
+            fan.Set("latencyMs", (double) characteristics.latencyMs);
+            fan.Set("settlingMsPerPercent", characteristics.settlingMsPerPercent);
+            fan.Set("steps", stepArray);
+            fanArray[i] = fan;
+        }
+        Object result = Object::New(Env());
+        result.Set("interfaceId", interfaceId);
+        result.Set("modelId", modelId);
+        result.Set("durationMs", (double) durationMs);
+        result.Set("fans", fanArray);
+        deferred.Resolve(result);
+    }
+
+    void OnError(const Error &e) override {
+        deferred.Reject(e.Value());
+    }
+
+private:
+    Promise::Deferred deferred;
+    std::shared_ptr<DeviceSession> session;
+    std::vector<int> fans;
+    FanCalibrationOptions options;
+    std::string interfaceId;
+    std::string modelId;
+    std::vector<FanActuatorCharacteristics> results;
+    int64_t durationMs = 0;
+};
+
+Value CalibrateFans(const CallbackInfo &info) {
+    if (info.Length() > 1 || (info.Length() == 1 && !info[0].IsObject())) { throw Napi::Error::New(info.Env(), "CalibrateFans - invalid argument"); }
+    std::vector<int> fans;
+    FanCalibrationOptions options;
+    if (info.Length() == 1) {
+        Object optionsObject = info[0].As<Object>();
+        if (optionsObject.Has("fans") && optionsObject.Get("fans").IsArray()) {
+            Array fanArray = optionsObject.Get("fans").As<Array>();
+            for (uint32_t i = 0; i < fanArray.Length(); ++i) {
+                if (!fanArray.Get(i).IsNumber()) { throw Napi::Error::New(info.Env(), "CalibrateFans - invalid fan"); }
+                fans.push_back(fanArray.Get(i).As<Number>().Int32Value());
+            }
+        }
+        if (optionsObject.Has("stepPercent")) {
+            options.stepPercent = optionsObject.Get("stepPercent").As<Number>().Int32Value();
+        }
+        if (optionsObject.Has("pollIntervalMs")) {
+            options.pollIntervalMs = optionsObject.Get("pollIntervalMs").As<Number>().Int64Value();
+        }
+        if (optionsObject.Has("stableMs")) {
+            options.stableMs = optionsObject.Get("stableMs").As<Number>().Int64Value();
+        }
+        if (optionsObject.Has("timeoutMs")) {
+            options.timeoutMs = optionsObject.Get("timeoutMs").As<Number>().Int64Value();
+        }
+        if (optionsObject.Has("quantizationWindowPercent")) {
+            options.quantizationWindowPercent = optionsObject.Get("quantizationWindowPercent").As<Number>().Int32Value();
+        }
+        if (optionsObject.Has("maxTemperature")) {
+            options.maxTemperature = optionsObject.Get("maxTemperature").As<Number>().Int32Value();
+        }
+    }
+    CalibrateFansWorker *worker = new CalibrateFansWorker(info.Env(), Data(info.Env()).session, fans, options);
+    Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+void GetTelemetry(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "GetTelemetry - invalid argument"); }
+    Object result = info[0].As<Object>();
+    TelemetrySnapshot snapshot;
+    TelemetryStore::Default().Read(snapshot);
+    result.Set("sequence", TelemetryStore::Default().Sequence());
+    SnapshotToObject(info.Env(), snapshot, result);
+}
+
+// Daemon side journal with its recorder thread, the GUI side mapping is per instance
+static TelemetryJournal telemetryJournal;
+static TelemetryJournalRecorder journalRecorder;
+
+static void StopTelemetryJournalInternal() {
+    serviceOwners[SERVICE_TELEMETRY_JOURNAL] = nullptr;
+    journalRecorder.Stop();
+    telemetryJournal.Close();
+}
+
+Boolean StartTelemetryJournal(const CallbackInfo &info) {
+    if (info.Length() < 1 || info.Length() > 3 || !info[0].IsString()
+        || (info.Length() >= 2 && !info[1].IsNumber()) || (info.Length() == 3 && !info[2].IsNumber())) {
+        throw Napi::Error::New(info.Env(), "StartTelemetryJournal - invalid argument");
+    }
+    std::string path = info[0].As<String>();
+    int64_t intervalMs = info.Length() >= 2 ? info[1].As<Number>().Int64Value() : 5000;
+    int64_t maxBytes = info.Length() == 3 ? info[2].As<Number>().Int64Value() : 8 * 1024 * 1024;
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    if (journalRecorder.IsRunning() || maxBytes <= 0 || !telemetryJournal.Create(path, maxBytes)) {
+        return Boolean::New(info.Env(), false);
+    }
+    std::weak_ptr<DeviceSession> session = Data(info.Env()).session;
+    auto readStatus = [session](DeviceStatus &status) {
+        return ReadSessionDevice(session, [&](TuxedoIOAPI &device) { return device.GetStatus(status); });
+    };
+    bool result = journalRecorder.Start(telemetryJournal, readStatus, intervalMs);
+    if (result) {
+        serviceOwners[SERVICE_TELEMETRY_JOURNAL] = &Data(info.Env());
+    } else {
+        StopTelemetryJournalInternal();
+    }
+    return Boolean::New(info.Env(), result);
+}
+
+void StopTelemetryJournal(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    StopTelemetryJournalInternal();
+}
+
+Boolean OpenTelemetryJournal(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsString()) { throw Napi::Error::New(info.Env(), "OpenTelemetryJournal - invalid argument"); }
+    std::string path = info[0].As<String>();
+    return Boolean::New(info.Env(), Data(info.Env()).telemetryJournalReader.Open(path));
+}
+
+void CloseTelemetryJournal(const CallbackInfo &info) {
+    Data(info.Env()).telemetryJournalReader.Close();
+}
+
+/**
+ * Queries go to the read only mapping if opened, else to the journal this
+ * process records. The latter is locked against being stopped meanwhile.
+ */
+static TelemetryJournal &QueriedJournal(Napi::Env env, std::unique_lock<std::mutex> &lock) {
+    TelemetryJournal &reader = Data(env).telemetryJournalReader;
+    if (reader.IsOpen()) { return reader; }
+    lock = std::unique_lock<std::mutex>(serviceMutex);
+    return telemetryJournal;
+}
+
+Float64Array QueryTelemetryJournal(const CallbackInfo &info) {
+    if (info.Length() != 5 || !info[0].IsString() || !info[1].IsNumber() || !info[2].IsNumber() || !info[3].IsNumber() || !info[4].IsNumber()) {
+        throw Napi::Error::New(info.Env(), "QueryTelemetryJournal - invalid argument");
+    }
+    std::string channelName = info[0].As<String>();
+    TelemetryJournalChannel channel;
+    if (channelName == "temperature") {
+        channel = TelemetryJournalChannel::Temperature;
+    } else if (channelName == "fanSpeed") {
+        channel = TelemetryJournalChannel::FanSpeed;
+    } else if (channelName == "tdp") {
+        channel = TelemetryJournalChannel::TDP;
+    } else {
+        throw Napi::Error::New(info.Env(), "QueryTelemetryJournal - invalid channel");
+    }
+    int index = info[1].As<Number>();
+    int64_t fromMs = info[2].As<Number>().Int64Value();
+    int64_t toMs = info[3].As<Number>().Int64Value();
+    int64_t buckets = info[4].As<Number>().Int64Value();
+    if (buckets < 0 || buckets > 100000) { throw Napi::Error::New(info.Env(), "QueryTelemetryJournal - invalid bucket count"); }
+
+    // Aggregated straight into the array buffer handed to JS
+    Float64Array result = Float64Array::New(info.Env(), buckets * 3);
+    std::unique_lock<std::mutex> lock;
+    QueriedJournal(info.Env(), lock).Query(channel, index, fromMs, toMs, buckets, result.Data());
+    return result;
+}
+
+Array GetTelemetryJournalProfiles(const CallbackInfo &info) {
+    if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsNumber()) { throw Napi::Error::New(info.Env(), "GetTelemetryJournalProfiles - invalid argument"); }
+    std::unique_lock<std::mutex> lock;
+    auto changes = QueriedJournal(info.Env(), lock).ProfileChanges(info[0].As<Number>().Int64Value(), info[1].As<Number>().Int64Value());
+    Array result = Array::New(info.Env());
+    for (size_t i = 0; i < changes.size(); ++i) {
+        Object change = Object::New(info.Env());
+        change.Set("timeMs", (double) changes[i].first);
+        change.Set("profile", changes[i].second);
+        result[i] = change;
+    }
+    return result;
+}
+
+// Session of the instance running the scheduler, used by the batched hardware reads of due jobs
+static std::weak_ptr<DeviceSession> schedulerSession;
+static JobScheduler jobScheduler;
+static ThreadSafeFunction schedulerCallback;
+static bool schedulerCallbackSet = false;
+
+static void ReadSchedulerWebcam() {
+    bool status;
+    bool result = ReadSessionDevice(schedulerSession, [&](TuxedoIOAPI &device) { return device.GetWebcam(status); });
+    UpdateTelemetry([&](TelemetrySnapshot &t) { t.webcamStatus = result ? (status ? 1 : 0) : -1; });
+}
+
+/**
+ * Temperatures, fan speeds and TDPs come from one status read, batched by the module
+ */
+static void ReadSchedulerStatus(bool temperatures, bool fanSpeeds, bool tdps) {
+    DeviceStatus status;
+    if (!ReadSessionDevice(schedulerSession, [&](TuxedoIOAPI &device) { return device.GetStatus(status); })) { return; }
+    for (int fanNr = 0; (temperatures || fanSpeeds) && fanNr < status.nrFans; ++fanNr) {
+        int temperature = temperatures && status.fanTemperature[fanNr] >= 0 ? status.fanTemperature[fanNr] : -1;
+        int speedPercent = fanSpeeds && status.fanSpeedPercent[fanNr] >= 0 ? status.fanSpeedPercent[fanNr] : -1;
+        if (temperature != -1 || speedPercent != -1) {
+            UpdateFanTelemetry(fanNr, temperature, speedPercent);
+        }
+    }
+    for (int i = 0; tdps && i < status.nrTDPs && i < TELEMETRY_MAX_TDPS; ++i) {
+        if (status.tdp[i] >= 0) {
+            UpdateTelemetry([&](TelemetrySnapshot &t) { t.tdps[i].current = status.tdp[i]; });
+        }
+    }
+}
+
+static void StopSchedulerInternal() {
+    serviceOwners[SERVICE_SCHEDULER] = nullptr;
+    jobScheduler.Stop();
+    schedulerSession.reset();
+    if (schedulerCallbackSet) {
+        schedulerCallback.Release();
+        schedulerCallbackSet = false;
+    }
+}
+
+/**
+ * Native work of a job doing the given hardware reads, nullptr if none
+ */
+static std::function<void()> SchedulerHardwareReads(Napi::Env env, Array readNames, const char *function) {
+    bool readWebcam = false, readTemperatures = false, readFanSpeeds = false, readTDPs = false;
+    for (uint32_t i = 0; i < readNames.Length(); ++i) {
+        if (!readNames.Get(i).IsString()) { throw Napi::Error::New(env, std::string(function) + " - invalid hardware read"); }
+        std::string readName = readNames.Get(i).As<String>();
+        if (readName == "webcam") {
+            readWebcam = true;
+        } else if (readName == "temperatures") {
+            readTemperatures = true;
+        } else if (readName == "fanSpeeds") {
+            readFanSpeeds = true;
+        } else if (readName == "tdp") {
+            readTDPs = true;
+        } else {
+            throw Napi::Error::New(env, std::string(function) + " - invalid hardware read");
+        }
+    }
+
+    if (!readWebcam && !readTemperatures && !readFanSpeeds && !readTDPs) { return nullptr; }
+    return [readWebcam, readTemperatures, readFanSpeeds, readTDPs]() {
+        if (readWebcam) { ReadSchedulerWebcam(); }
+        if (readTemperatures || readFanSpeeds || readTDPs) { ReadSchedulerStatus(readTemperatures, readFanSpeeds, readTDPs); }
+    };
+}
+
+Number AddScheduledJob(const CallbackInfo &info) {
+    if (info.Length() < 3 || info.Length() > 4 || !info[0].IsString() || !info[1].IsNumber() || !info[2].IsNumber()
+        || (info.Length() == 4 && !info[3].IsArray())) {
+        throw Napi::Error::New(info.Env(), "AddScheduledJob - invalid argument");
+    }
+    std::string name = info[0].As<String>();
+    int64_t periodMs = info[1].As<Number>().Int64Value();
+    int64_t slackMs = info[2].As<Number>().Int64Value();
+    std::function<void()> nativeWork = info.Length() == 4
+        ? SchedulerHardwareReads(info.Env(), info[3].As<Array>(), "AddScheduledJob")
+        : nullptr;
+    return Number::New(info.Env(), jobScheduler.AddJob(name, periodMs, slackMs, nativeWork));
+}
+
+Boolean SetScheduledJobReads(const CallbackInfo &info) {
+    if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsArray()) {
+        throw Napi::Error::New(info.Env(), "SetScheduledJobReads - invalid argument");
+    }
+    std::function<void()> nativeWork = SchedulerHardwareReads(info.Env(), info[1].As<Array>(), "SetScheduledJobReads");
+    return Boolean::New(info.Env(), jobScheduler.SetJobWork(info[0].As<Number>().Int32Value(), nativeWork));
+}
+
+Boolean RemoveScheduledJob(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsNumber()) { throw Napi::Error::New(info.Env(), "RemoveScheduledJob - invalid argument"); }
+    return Boolean::New(info.Env(), jobScheduler.RemoveJob(info[0].As<Number>().Int32Value()));
+}
+
+void CompleteScheduledJob(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsNumber()) { throw Napi::Error::New(info.Env(), "CompleteScheduledJob - invalid argument"); }
+    int jobId = info[0].As<Number>().Int32Value();
+    std::string name;
+    int64_t slackMs;
+    uint64_t deadlineNs;
+    if (LoopMonitor::Default().IsRunning() && jobScheduler.GetRunInProgress(jobId, name, slackMs, deadlineNs)) {
+        LoopMonitor::Default().EndWork(name);
+    }
+    jobScheduler.CompleteJob(jobId);
+}
+
+Boolean StartScheduler(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsFunction()) { throw Napi::Error::New(info.Env(), "StartScheduler - invalid argument"); }
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    if (jobScheduler.IsRunning()) {
+        return Boolean::New(info.Env(), false);
+    }
+
+    // Stays referenced like the intervals it replaces, keeps the daemon alive
+    schedulerCallback = ThreadSafeFunction::New(info.Env(), info[0].As<Function>(), "TuxedoIOScheduler", 0, 1);
+    schedulerCallbackSet = true;
+    schedulerSession = Data(info.Env()).session;
+    bool result = jobScheduler.Start([](const std::vector<int> &jobIds) {
+        std::vector<int> *ids = new std::vector<int>(jobIds);
+        napi_status status = schedulerCallback.NonBlockingCall(ids, [](Env env, Function callback, std::vector<int> *ids) {
+            Array jobs = Array::New(env, ids->size());
+            for (size_t i = 0; i < ids->size(); ++i) {
+                jobs[i] = Number::New(env, (*ids)[i]);
+                // The runs start now that the event loop got to them
+                std::string name;
+                int64_t slackMs;
+                uint64_t deadlineNs;
+                if (LoopMonitor::Default().IsRunning() && jobScheduler.GetRunInProgress((*ids)[i], name, slackMs, deadlineNs)) {
+                    LoopMonitor::Default().BeginWork(name, deadlineNs, slackMs);
+                }
+            }
+            callback.Call({ jobs });
+            delete ids;
+        });
+        if (status != napi_ok) {
+            for (int id : *ids) { jobScheduler.CompleteJob(id); }
+            delete ids;
+        }
+    });
+    if (result) {
+        serviceOwners[SERVICE_SCHEDULER] = &Data(info.Env());
+    } else {
+        StopSchedulerInternal();
+    }
+    return Boolean::New(info.Env(), result);
+}
+
+void StopScheduler(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    StopSchedulerInternal();
+}
+
+Object GetSchedulerStats(const CallbackInfo &info) {
+    Object result = Object::New(info.Env());
+    result.Set("running", jobScheduler.IsRunning());
+    result.Set("wakeups", (double) jobScheduler.Wakeups());
+    Array jobs = Array::New(info.Env());
+    std::vector<ScheduledJobStats> stats = jobScheduler.GetStats();
+    for (size_t i = 0; i < stats.size(); ++i) {
+        Object job = Object::New(info.Env());
+        job.Set("id", stats[i].id);
+        job.Set("name", stats[i].name);
+        job.Set("periodMs", (double) stats[i].periodMs);
+        job.Set("slackMs", (double) stats[i].slackMs);
+        job.Set("runs", (double) stats[i].runs);
+        job.Set("overruns", (double) stats[i].overruns);
+        job.Set("lastRuntimeMs", stats[i].lastRuntimeMs);
+        job.Set("maxRuntimeMs", stats[i].maxRuntimeMs);
+        job.Set("avgRuntimeMs", stats[i].runs > 0 ? stats[i].totalRuntimeMs / stats[i].runs : 0);
+        job.Set("lastLatenessMs", stats[i].lastLatenessMs);
+        job.Set("maxLatenessMs", stats[i].maxLatenessMs);
+        job.Set("avgLatenessMs", stats[i].runs > 0 ? stats[i].totalLatenessMs / stats[i].runs : 0);
+        jobs[i] = job;
+    }
+    result.Set("jobs", jobs);
+    return result;
+}
+
+Boolean StartIoctlTrace(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsString()) { throw Napi::Error::New(info.Env(), "StartIoctlTrace - invalid argument"); }
+    std::string path = info[0].As<String>();
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    bool result = IoctlTraceRecorder::Default().Start(path);
+    if (result) { serviceOwners[SERVICE_IOCTL_TRACE] = &Data(info.Env()); }
+    return Boolean::New(info.Env(), result);
+}
+
+static uint64_t StopIoctlTraceInternal() {
+    serviceOwners[SERVICE_IOCTL_TRACE] = nullptr;
+    return IoctlTraceRecorder::Default().Stop();
+}
+
+Number StopIoctlTrace(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    return Number::New(info.Env(), (double) StopIoctlTraceInternal());
+}
+
+/**
+ * Devices opened after this call are served from the trace instead of
+ * /dev/tuxedo_io, devices already open keep their backend
+ */
+Boolean StartIoctlReplay(const CallbackInfo &info) {
+    if (info.Length() < 1 || info.Length() > 2 || !info[0].IsString() || (info.Length() == 2 && !info[1].IsBoolean())) {
+        throw Napi::Error::New(info.Env(), "StartIoctlReplay - invalid argument");
+    }
+    std::string path = info[0].As<String>();
+    bool realtime = info.Length() == 2 && info[1].As<Boolean>();
+    auto replay = std::make_shared<IoctlReplay>(realtime);
+    if (!replay->Load(path)) {
+        return Boolean::New(info.Env(), false);
+    }
+    IoctlBackend::SetActive(replay);
+    return Boolean::New(info.Env(), true);
+}
+
+void StopIoctlReplay(const CallbackInfo &info) {
+    if (std::dynamic_pointer_cast<IoctlReplay>(IoctlBackend::Active())) {
+        IoctlBackend::SetActive(nullptr);
+    }
+}
+
+Value GetIoctlReplayStats(const CallbackInfo &info) {
+    std::shared_ptr<IoctlReplay> replay = std::dynamic_pointer_cast<IoctlReplay>(IoctlBackend::Active());
+    if (!replay) { return info.Env().Null(); }
+    IoctlReplayStats stats = replay->GetStats();
+    Object result = Object::New(info.Env());
+    result.Set("records", (double) stats.records);
+    result.Set("served", (double) stats.served);
+    result.Set("missing", (double) stats.missing);
+    result.Set("diverged", (double) stats.diverged);
+    result.Set("repeated", (double) stats.repeated);
+    return result;
+}
+
+/**
+ * Like the replay, devices opened after this call talk to a simulated
+ * module instead of /dev/tuxedo_io
+ */
+Boolean StartIoctlSimulation(const CallbackInfo &info) {
+    if (info.Length() > 1 || (info.Length() == 1 && !info[0].IsObject())) { throw Napi::Error::New(info.Env(), "StartIoctlSimulation - invalid argument"); }
+    IoctlSimulationOptions options;
+    if (info.Length() == 1) {
+        Object optionsObject = info[0].As<Object>();
+        if (optionsObject.Has("interface")) {
+            std::string interface = optionsObject.Get("interface").As<String>();
+            if (interface == "clevo") {
+                options.interface = SimulatedInterface::Clevo;
+            } else if (interface == "uniwill") {
+                options.interface = SimulatedInterface::Uniwill;
+            } else {
+                throw Napi::Error::New(info.Env(), "StartIoctlSimulation - invalid interface");
+            }
+        }
+        if (optionsObject.Has("batchSupport")) {
+            options.batchSupport = optionsObject.Get("batchSupport").As<Boolean>();
+        }
+        if (optionsObject.Has("batchError")) {
+            options.batchError = optionsObject.Get("batchError").As<Number>().Int32Value();
+        }
+        if (optionsObject.Has("moduleVersion")) {
+            options.moduleVersion = optionsObject.Get("moduleVersion").As<String>();
+        }
+        if (optionsObject.Has("transitionLatencyUs")) {
+            options.transitionLatencyUs = optionsObject.Get("transitionLatencyUs").As<Number>().Int64Value();
+        }
+        if (optionsObject.Has("registerLatencyUs")) {
+            options.registerLatencyUs = optionsObject.Get("registerLatencyUs").As<Number>().Int64Value();
+        }
+        if (optionsObject.Has("fanDeadTimeMs")) {
+            options.fanDeadTimeMs = optionsObject.Get("fanDeadTimeMs").As<Number>().Int64Value();
+        }
+        if (optionsObject.Has("fanSlewPercentPerSecond")) {
+            options.fanSlewPercentPerSecond = optionsObject.Get("fanSlewPercentPerSecond").As<Number>().DoubleValue();
+        }
+        if (optionsObject.Has("fanMinimumPercent")) {
+            options.fanMinimumPercent = optionsObject.Get("fanMinimumPercent").As<Number>().Int32Value();
+        }
+        if (optionsObject.Has("fanStepPercent")) {
+            options.fanStepPercent = optionsObject.Get("fanStepPercent").As<Number>().Int32Value();
+        }
+    }
+    IoctlBackend::SetActive(std::make_shared<IoctlSimulation>(options));
+    return Boolean::New(info.Env(), true);
+}
+
+void StopIoctlSimulation(const CallbackInfo &info) {
+    if (std::dynamic_pointer_cast<IoctlSimulation>(IoctlBackend::Active())) {
+        IoctlBackend::SetActive(nullptr);
+    }
+}
+
+void SetSimulatedTemperature(const CallbackInfo &info) {
+    if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsNumber()) { throw Napi::Error::New(info.Env(), "SetSimulatedTemperature - invalid argument"); }
+    std::shared_ptr<IoctlSimulation> simulation = std::dynamic_pointer_cast<IoctlSimulation>(IoctlBackend::Active());
+    if (simulation) {
+        simulation->SetTemperature(info[0].As<Number>(), info[1].As<Number>());
+    }
+}
+
+Value GetIoctlSimulationStats(const CallbackInfo &info) {
+    std::shared_ptr<IoctlSimulation> simulation = std::dynamic_pointer_cast<IoctlSimulation>(IoctlBackend::Active());
+    if (!simulation) { return info.Env().Null(); }
+    IoctlSimulationStats stats = simulation->GetStats();
+    Object result = Object::New(info.Env());
+    result.Set("transitions", (double) stats.transitions);
+    result.Set("batchCalls", (double) stats.batchCalls);
+    result.Set("registerAccesses", (double) stats.registerAccesses);
+    result.Set("fansAuto", stats.fansAuto);
+    return result;
+}
+
+/**
+ * Temperature and fan speed changes of the active simulation since the last
+ * call, null if none is active
+ */
+Value TakeSimulationEvents(const CallbackInfo &info) {
+    std::shared_ptr<IoctlSimulation> simulation = std::dynamic_pointer_cast<IoctlSimulation>(IoctlBackend::Active());
+    if (!simulation) { return info.Env().Null(); }
+    uint64_t dropped = 0;
+    std::vector<SimulationEvent> events = simulation->TakeEvents(dropped);
+    Array eventArray = Array::New(info.Env(), events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        Object event = Object::New(info.Env());
+        event.Set("timeMs", events[i].timeNs / 1e6);
+        event.Set("type", events[i].type == SimulationEventType::Temperature ? "temperature" : "speed");
+        event.Set("fan", events[i].fanNr);
+        event.Set("value", events[i].value);
+        eventArray.Set((uint32_t) i, event);
+    }
+    Object result = Object::New(info.Env());
+    result.Set("events", eventArray);
+    result.Set("dropped", (double) dropped);
+    return result;
+}
+
+struct ConcurrentDeviceCall {
+    enum class Kind { GetFanSpeed, GetFanTemperature, SetFanSpeed } kind;
+    int64_t startMs;
+    IoctlPriority priority;
+    int fanNr;
+    int value;
+    bool result;
+    int64_t finishedUs;
+};
+
+/**
+ * Issues fan calls from one thread each, started at the given offsets, to
+ * exercise the ioctl queue with concurrent holders of the session
+ */
+class ConcurrentDeviceCallsWorker : public AsyncWorker {
+public:
+    ConcurrentDeviceCallsWorker(Napi::Env env, std::shared_ptr<DeviceSession> session, const std::vector<ConcurrentDeviceCall> &calls)
+        : AsyncWorker(env), deferred(Promise::Deferred::New(env)), session(session), calls(calls) { }
+
+    Promise GetPromise() { return deferred.Promise(); }
+
+    void Execute() override {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (ConcurrentDeviceCall &call : calls) {
+            threads.emplace_back([this, &call, start]() {
+                std::this_thread::sleep_until(start + std::chrono::milliseconds(call.startMs));
+                IoctlPriorityScope priority(call.priority);
+                DeviceSession::Access access = session->Share();
+                switch (call.kind) {
+                    case ConcurrentDeviceCall::Kind::GetFanSpeed:
+                        call.result = access.Device().GetFanSpeedPercent(call.fanNr, call.value);
+                        break;
+                    case ConcurrentDeviceCall::Kind::GetFanTemperature:
+                        call.result = access.Device().GetFanTemperature(call.fanNr, call.value);
+                        break;
+                    case ConcurrentDeviceCall::Kind::SetFanSpeed:
+                        call.result = access.Recording().SetFanSpeedPercent(call.fanNr, call.value);
+                        break;
+                }
+                call.finishedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            });
+        }
+        for (std::thread &thread : threads) { thread.join(); }
+    }
+
+    void OnOK() override {
+        Array results = Array::New(Env(), calls.size());
+        for (std::size_t i = 0; i < calls.size(); ++i) {
+            Object result = Object::New(Env());
+            result.Set("result", calls[i].result);
+            result.Set("value", calls[i].value);
+            result.Set("finishedMs", calls[i].finishedUs / 1000.0);
+            results.Set((uint32_t) i, result);
+        }
+        deferred.Resolve(results);
+    }
+
+    void OnError(const Error &e) override {
+        deferred.Reject(e.Value());
+    }
+
+private:
+    Promise::Deferred deferred;
+    std::shared_ptr<DeviceSession> session;
+    std::vector<ConcurrentDeviceCall> calls;
+};
+
+Value RunConcurrentDeviceCalls(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsArray()) { throw Napi::Error::New(info.Env(), "RunConcurrentDeviceCalls - invalid argument"); }
+    Array callArray = info[0].As<Array>();
+    std::vector<ConcurrentDeviceCall> calls;
+    for (uint32_t i = 0; i < callArray.Length(); ++i) {
+        if (!callArray.Get(i).IsObject()) { throw Napi::Error::New(info.Env(), "RunConcurrentDeviceCalls - invalid call"); }
+        Object callObject = callArray.Get(i).As<Object>();
+        if (!callObject.Get("call").IsString() || !callObject.Get("fan").IsNumber()) {
+            throw Napi::Error::New(info.Env(), "RunConcurrentDeviceCalls - invalid call");
+        }
+        ConcurrentDeviceCall call = {};
+        std::string kind = callObject.Get("call").As<String>();
+        if (kind == "getFanSpeed") {
+            call.kind = ConcurrentDeviceCall::Kind::GetFanSpeed;
+        } else if (kind == "getFanTemperature") {
+            call.kind = ConcurrentDeviceCall::Kind::GetFanTemperature;
+        } else if (kind == "setFanSpeed") {
+            call.kind = ConcurrentDeviceCall::Kind::SetFanSpeed;
+        } else {
+            throw Napi::Error::New(info.Env(), "RunConcurrentDeviceCalls - invalid call");
+        }
+        call.fanNr = callObject.Get("fan").As<Number>().Int32Value();
+        call.startMs = callObject.Has("startMs") ? callObject.Get("startMs").As<Number>().Int64Value() : 0;
+        call.value = callObject.Has("value") ? callObject.Get("value").As<Number>().Int32Value() : 0;
+        call.priority = IoctlPriority::Auto;
+        if (callObject.Has("priority")) {
+            std::string priority = callObject.Get("priority").As<String>();
+            if (priority == "high") {
+                call.priority = IoctlPriority::High;
+            } else if (priority == "normal") {
+                call.priority = IoctlPriority::Normal;
+            } else if (priority == "low") {
+                call.priority = IoctlPriority::Low;
+            } else {
+                throw Napi::Error::New(info.Env(), "RunConcurrentDeviceCalls - invalid priority");
+            }
+        }
+        calls.push_back(call);
+    }
+    ConcurrentDeviceCallsWorker *worker = new ConcurrentDeviceCallsWorker(info.Env(), Data(info.Env()).session, calls);
+    Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+// Watch of the device file, the session is held by the watch thread while it runs
+static DeviceNodeWatcher deviceWatcher;
+static std::shared_ptr<DeviceSession> deviceWatchSession;
+static ThreadSafeFunction deviceWatchCallback;
+static bool deviceWatchCallbackSet = false;
+static std::mutex deviceWatchMutex;
+static bool deviceWatchReportedPresent = false;
+static bool deviceWatchReportedAvailable = false;
+static uint64_t deviceAppearances = 0;
+static uint64_t deviceDisappearances = 0;
+
+struct DevicePresenceEvent {
+    bool present;
+    DeviceIdentification identification;
+};
+
+static void OnDevicePresence(bool present) {
+    {
+        // Attribute changes of an already identified device need no reopen
+        std::lock_guard<std::mutex> lock(deviceWatchMutex);
+        if (present && deviceWatchReportedPresent && deviceWatchReportedAvailable) { return; }
+    }
+    DevicePresenceEvent *event = new DevicePresenceEvent { present, deviceWatchSession->DevicePresenceChanged(present) };
+    {
+        // Attribute changes that did not make the device usable are not reported
+        std::lock_guard<std::mutex> lock(deviceWatchMutex);
+        if (present == deviceWatchReportedPresent && event->identification.available == deviceWatchReportedAvailable) {
+            delete event;
+            return;
+        }
+        if (present != deviceWatchReportedPresent) {
+            (present ? deviceAppearances : deviceDisappearances) += 1;
+        }
+        deviceWatchReportedPresent = present;
+        deviceWatchReportedAvailable = event->identification.available;
+    }
+
+    napi_status status = deviceWatchCallback.NonBlockingCall(event, [](Env env, Function callback, DevicePresenceEvent *event) {
+        Object result = Object::New(env);
+        result.Set("present", event->present);
+        result.Set("available", event->identification.available);
+        result.Set("interface", event->identification.interfaceId);
+        result.Set("model", event->identification.modelId);
+        result.Set("identifyUs", (double) event->identification.durationUs);
+        delete event;
+        callback.Call({ result });
+    });
+    if (status != napi_ok) { delete event; }
+}
+
+static void StopDeviceWatchInternal() {
+    serviceOwners[SERVICE_DEVICE_WATCH] = nullptr;
+    deviceWatcher.Stop();
+    if (deviceWatchSession) {
+        deviceWatchSession->ForgetDevicePresence();
+        deviceWatchSession.reset();
+    }
+    if (deviceWatchCallbackSet) {
+        deviceWatchCallback.Release();
+        deviceWatchCallbackSet = false;
+    }
+}
+
+Boolean StartDeviceWatch(const CallbackInfo &info) {
+    if (info.Length() < 1 || info.Length() > 2 || !info[0].IsFunction() || (info.Length() == 2 && !info[1].IsString())) {
+        throw Napi::Error::New(info.Env(), "StartDeviceWatch - invalid argument");
+    }
+    std::string devicePath = info.Length() == 2 ? info[1].As<String>() : std::string(TUXEDO_IO_DEVICE_FILE);
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    if (deviceWatcher.IsRunning()) {
+        return Boolean::New(info.Env(), false);
+    }
+
+    // Unreferenced, a watch alone does not keep the process alive
+    deviceWatchCallback = ThreadSafeFunction::New(info.Env(), info[0].As<Function>(), "TuxedoIODeviceWatch", 0, 1);
+    deviceWatchCallback.Unref(info.Env());
+    deviceWatchCallbackSet = true;
+    deviceWatchSession = Data(info.Env()).session;
+    bool present = access(devicePath.c_str(), F_OK) == 0;
+    DeviceIdentification identification = {};
+    if (present) {
+        identification.available = ShareDevice(info.Env()).Device().WmiAvailable();
+    } else {
+        identification = deviceWatchSession->DevicePresenceChanged(false);
+    }
+    {
+        std::lock_guard<std::mutex> watchLock(deviceWatchMutex);
+        deviceWatchReportedPresent = present;
+        deviceWatchReportedAvailable = identification.available;
+    }
+    bool result = deviceWatcher.Start(devicePath, OnDevicePresence);
+    if (result) {
+        serviceOwners[SERVICE_DEVICE_WATCH] = &Data(info.Env());
+        // Appeared or disappeared before the watch was in place
+        if (deviceWatcher.IsPresent() != present) { OnDevicePresence(deviceWatcher.IsPresent()); }
+    } else {
+        StopDeviceWatchInternal();
+    }
+    return Boolean::New(info.Env(), result);
+}
+
+void StopDeviceWatch(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    StopDeviceWatchInternal();
+}
+
+Object GetDeviceWatchState(const CallbackInfo &info) {
+    Object result = Object::New(info.Env());
+    std::lock_guard<std::mutex> lock(deviceWatchMutex);
+    result.Set("running", deviceWatcher.IsRunning());
+    result.Set("present", deviceWatchReportedPresent);
+    result.Set("available", deviceWatchReportedAvailable);
+    result.Set("appearances", (double) deviceAppearances);
+    result.Set("disappearances", (double) deviceDisappearances);
+    return result;
+}
+
+Object GetDeviceSessionStats(const CallbackInfo &info) {
+    DeviceSessionStats stats = Data(info.Env()).session->GetStats();
+    Object result = Object::New(info.Env());
+    result.Set("users", (double) stats.users);
+    result.Set("opens", (double) stats.opens);
+    result.Set("acquisitions", (double) stats.acquisitions);
+    result.Set("contended", (double) stats.contended);
+    return result;
+}
+
+static GpuQuerySession gpuQuerySession;
+
+Boolean StartGpuQuery(const CallbackInfo &info) {
+    if (info.Length() < 2 || info.Length() > 3 || !info[0].IsArray() || !info[1].IsNumber()
+        || (info.Length() == 3 && !info[2].IsString())) {
+        throw Napi::Error::New(info.Env(), "StartGpuQuery - invalid argument");
+    }
+    GpuQueryOptions options;
+    Array fields = info[0].As<Array>();
+    for (uint32_t i = 0; i < fields.Length(); ++i) {
+        if (!fields.Get(i).IsString()) { throw Napi::Error::New(info.Env(), "StartGpuQuery - invalid field"); }
+        options.fields.push_back(fields.Get(i).As<String>());
+    }
+    options.loopMs = info[1].As<Number>().Int32Value();
+    if (info.Length() == 3) {
+        options.executable = info[2].As<String>();
+    }
+
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    bool result = gpuQuerySession.Start(options);
+    if (result) { serviceOwners[SERVICE_GPU_QUERY] = &Data(info.Env()); }
+    return Boolean::New(info.Env(), result);
+}
+
+static void StopGpuQueryInternal() {
+    serviceOwners[SERVICE_GPU_QUERY] = nullptr;
+    gpuQuerySession.Stop();
+}
+
+void StopGpuQuery(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    StopGpuQueryInternal();
+}
+
+static void GpuQuerySnapshotToObject(Napi::Env env, const GpuQuerySnapshot &snapshot, Object result) {
+    uint64_t now = GpuQueryNowNs();
+    result.Set("sequence", (double) snapshot.sequence);
+    result.Set("restarts", (double) snapshot.restarts);
+    result.Set("childRunning", snapshot.childRunning);
+    Array gpus = Array::New(env, snapshot.gpus.size());
+    for (size_t i = 0; i < snapshot.gpus.size(); ++i) {
+        Object gpu = Object::New(env);
+        gpu.Set("index", snapshot.gpus[i].index);
+        gpu.Set("ageMs", (now - snapshot.gpus[i].updatedNs) / 1000000.0);
+        Object values = Object::New(env);
+        for (size_t j = 0; j < snapshot.fields.size() && j < snapshot.gpus[i].values.size(); ++j) {
+            values.Set(snapshot.fields[j], snapshot.gpus[i].values[j]);
+        }
+        gpu.Set("values", values);
+        gpus[i] = gpu;
+    }
+    result.Set("gpus", gpus);
+}
+
+Boolean GetGpuQuerySnapshot(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "GetGpuQuerySnapshot - invalid argument"); }
+    GpuQuerySnapshotToObject(info.Env(), gpuQuerySession.GetSnapshot(), info[0].As<Object>());
+    return Boolean::New(info.Env(), gpuQuerySession.IsRunning());
+}
+
+class GpuQueryWaitWorker : public AsyncWorker {
+public:
+    GpuQueryWaitWorker(Napi::Env env, uint64_t afterSequence, int64_t timeoutMs)
+        : AsyncWorker(env), deferred(Promise::Deferred::New(env)), afterSequence(afterSequence), timeoutMs(timeoutMs) { }
+
+    Promise GetPromise() { return deferred.Promise(); }
+
+    void Execute() override {
+        sampled = gpuQuerySession.WaitForSample(afterSequence, timeoutMs);
+    }
+
+    void OnOK() override {
+        deferred.Resolve(Boolean::New(Env(), sampled));
+    }
+
+    void OnError(const Error &e) override {
+        deferred.Reject(e.Value());
+    }
+
+private:
+    Promise::Deferred deferred;
+    uint64_t afterSequence;
+    int64_t timeoutMs;
+    bool sampled = false;
+};
+
+Value WaitGpuQuerySample(const CallbackInfo &info) {
+    if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+        throw Napi::Error::New(info.Env(), "WaitGpuQuerySample - invalid argument");
+    }
+    GpuQueryWaitWorker *worker = new GpuQueryWaitWorker(info.Env(), info[0].As<Number>().Int64Value(), info[1].As<Number>().Int64Value());
+    Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+/**
+ * Single nvidia-smi query on the thread pool, independent of the streaming session
+ */
+class GpuQueryOnceWorker : public AsyncWorker {
+public:
+    GpuQueryOnceWorker(Napi::Env env, const GpuQueryOptions &options, int64_t timeoutMs)
+        : AsyncWorker(env), deferred(Promise::Deferred::New(env)), options(options), timeoutMs(timeoutMs) { }
+
+    Promise GetPromise() { return deferred.Promise(); }
+
+    void Execute() override {
+        GpuQuerySession session;
+        if (!session.Start(options)) { return; }
+        sampled = session.WaitForSample(0, timeoutMs);
+        snapshot = session.GetSnapshot();
+        session.Stop();
+    }
+
+    void OnOK() override {
+        if (!sampled) {
+            deferred.Resolve(Env().Null());
+            return;
+        }
+        Object result = Object::New(Env());
+        GpuQuerySnapshotToObject(Env(), snapshot, result);
+        deferred.Resolve(result);
+    }
+
+    void OnError(const Error &e) override {
+        deferred.Reject(e.Value());
+    }
+
+private:
+    Promise::Deferred deferred;
+    GpuQueryOptions options;
+    int64_t timeoutMs;
+    bool sampled = false;
+    GpuQuerySnapshot snapshot = {};
+};
+
+Value QueryGpuOnce(const CallbackInfo &info) {
+    if (info.Length() < 2 || info.Length() > 3 || !info[0].IsArray() || !info[1].IsNumber()
+        || (info.Length() == 3 && !info[2].IsString())) {
+        throw Napi::Error::New(info.Env(), "QueryGpuOnce - invalid argument");
+    }
+    GpuQueryOptions options;
+    Array fields = info[0].As<Array>();
+    for (uint32_t i = 0; i < fields.Length(); ++i) {
+        if (!fields.Get(i).IsString()) { throw Napi::Error::New(info.Env(), "QueryGpuOnce - invalid field"); }
+        options.fields.push_back(fields.Get(i).As<String>());
+    }
+    options.loopMs = 0;
+    if (info.Length() == 3) {
+        options.executable = info[2].As<String>();
+    }
+    GpuQueryOnceWorker *worker = new GpuQueryOnceWorker(info.Env(), options, info[1].As<Number>().Int64Value());
+    Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+static LedFrameWriter keyboardLeds;
+static LedAnimator keyboardAnimator;
+
+Boolean OpenKeyboardLeds(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsArray()) { throw Napi::Error::New(info.Env(), "OpenKeyboardLeds - invalid argument"); }
+    std::vector<std::string> paths;
+    Array pathArray = info[0].As<Array>();
+    for (uint32_t i = 0; i < pathArray.Length(); ++i) {
+        if (!pathArray.Get(i).IsString()) { throw Napi::Error::New(info.Env(), "OpenKeyboardLeds - invalid path"); }
+        paths.push_back(pathArray.Get(i).As<String>());
+    }
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    keyboardAnimator.Stop();
+    bool result = keyboardLeds.Open(paths);
+    serviceOwners[SERVICE_KEYBOARD_LEDS] = result ? &Data(info.Env()) : nullptr;
+    return Boolean::New(info.Env(), result);
+}
+
+static void CloseKeyboardLedsInternal() {
+    serviceOwners[SERVICE_KEYBOARD_LEDS] = nullptr;
+    keyboardAnimator.Stop();
+    keyboardLeds.Close();
+}
+
+void CloseKeyboardLeds(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    CloseKeyboardLedsInternal();
+}
+
+Number WriteKeyboardFrame(const CallbackInfo &info) {
+    if (info.Length() < 1 || info.Length() > 2 || !info[0].IsTypedArray() || info[0].As<TypedArray>().TypedArrayType() != napi_uint8_array
+        || (info.Length() == 2 && !info[1].IsNumber())) {
+        throw Napi::Error::New(info.Env(), "WriteKeyboardFrame - invalid argument");
+    }
+    Uint8Array frame = info[0].As<Uint8Array>();
+    int brightness = info.Length() == 2 ? info[1].As<Number>().Int32Value() : -1;
+    {
+        // A frame set from JS replaces the running effect
+        std::lock_guard<std::mutex> lock(serviceMutex);
+        keyboardAnimator.Stop();
+    }
+    return Number::New(info.Env(), keyboardLeds.Write(frame.Data(), frame.ElementLength(), brightness));
+}
+
+void InvalidateKeyboardFrame(const CallbackInfo &info) {
+    keyboardLeds.Invalidate();
+}
+
+Boolean StartKeyboardAnimation(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "StartKeyboardAnimation - invalid argument"); }
+    Object options = info[0].As<Object>();
+    LedAnimationOptions animation;
+    std::string effect = options.Get("effect").IsString() ? options.Get("effect").As<String>() : std::string();
+    if (effect == "breathe") {
+        animation.effect = LedEffect::Breathe;
+    } else if (effect == "wave") {
+        animation.effect = LedEffect::Wave;
+    } else if (effect == "temperature") {
+        animation.effect = LedEffect::Temperature;
+    } else {
+        throw Napi::Error::New(info.Env(), "StartKeyboardAnimation - invalid effect");
+    }
+    if (options.Get("fps").IsNumber()) { animation.fps = options.Get("fps").As<Number>().Int32Value(); }
+    if (options.Get("periodMs").IsNumber()) { animation.periodMs = options.Get("periodMs").As<Number>().Int64Value(); }
+    if (options.Get("minTemperature").IsNumber()) { animation.minTemperature = options.Get("minTemperature").As<Number>().Int32Value(); }
+    if (options.Get("maxTemperature").IsNumber()) { animation.maxTemperature = options.Get("maxTemperature").As<Number>().Int32Value(); }
+    if (options.Get("colors").IsArray()) {
+        Array colors = options.Get("colors").As<Array>();
+        for (uint32_t i = 0; i < colors.Length(); ++i) {
+            if (!colors.Get(i).IsNumber()) { throw Napi::Error::New(info.Env(), "StartKeyboardAnimation - invalid color"); }
+            animation.colors.push_back((uint8_t) std::min(255, std::max(0, colors.Get(i).As<Number>().Int32Value())));
+        }
+    }
+    int fanNr = options.Get("fanNumber").IsNumber() ? options.Get("fanNumber").As<Number>().Int32Value() : 0;
+    if (fanNr < 0 || fanNr >= TELEMETRY_MAX_FANS) { throw Napi::Error::New(info.Env(), "StartKeyboardAnimation - invalid fan number"); }
+
+    // Temperatures as last read by the sampler or fan control, no extra device access
+    LedAnimator::TemperatureSource temperature = [fanNr]() {
+        TelemetrySnapshot snapshot;
+        TelemetryStore::Default().Read(snapshot);
+        return snapshot.fans[fanNr].temperatureUpdatedNs != 0 ? snapshot.fans[fanNr].temperature : -1;
+    };
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    if (!keyboardLeds.IsOpen()) {
+        return Boolean::New(info.Env(), false);
+    }
+    keyboardAnimator.Stop();
+    return Boolean::New(info.Env(), keyboardAnimator.Start(keyboardLeds, animation, temperature));
+}
+
+void StopKeyboardAnimation(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    keyboardAnimator.Stop();
+}
+
+Object GetKeyboardLedStats(const CallbackInfo &info) {
+    LedWriterStats stats = keyboardLeds.GetStats();
+    Object result = Object::New(info.Env());
+    result.Set("leds", (double) keyboardLeds.Size());
+    result.Set("animating", keyboardAnimator.IsRunning());
+    result.Set("animationFrames", (double) keyboardAnimator.Frames());
+    result.Set("frames", (double) stats.frames);
+    result.Set("ledWrites", (double) stats.ledWrites);
+    result.Set("ledsSkipped", (double) stats.ledsSkipped);
+    result.Set("errors", (double) stats.errors);
+    return result;
+}
+
+// One cache per pair of sources, tests read fixture files next to the system ones
+static std::mutex loginCachesMutex;
+static std::map<std::pair<std::string, std::string>, std::unique_ptr<LoginSessionCache>> loginCaches;
+
+Boolean GetLoginSessions(const CallbackInfo &info) {
+    if (info.Length() < 1 || info.Length() > 2 || !info[0].IsObject() || (info.Length() == 2 && !info[1].IsObject())) {
+        throw Napi::Error::New(info.Env(), "GetLoginSessions - invalid argument");
+    }
+    std::pair<std::string, std::string> sources(_PATH_UTMP, LoginSessionCache::DEFAULT_SESSIONS_DIR);
+    if (info.Length() == 2) {
+        Object options = info[1].As<Object>();
+        if (options.Has("utmpPath") && options.Get("utmpPath").IsString()) { sources.first = options.Get("utmpPath").As<String>(); }
+        if (options.Has("sessionsDir") && options.Get("sessionsDir").IsString()) { sources.second = options.Get("sessionsDir").As<String>(); }
+    }
+
+    LoginSnapshot snapshot;
+    {
+        std::lock_guard<std::mutex> lock(loginCachesMutex);
+        std::unique_ptr<LoginSessionCache> &cache = loginCaches[sources];
+        if (!cache) { cache.reset(new LoginSessionCache(sources.first, sources.second)); }
+        cache->Get(snapshot);
+    }
+
+    Napi::Env env = info.Env();
+    Object result = info[0].As<Object>();
+    result.Set("watching", snapshot.watching);
+    result.Set("reloads", (double) snapshot.reloads);
+    result.Set("lastReloadUs", (double) snapshot.lastReloadUs);
+    Array sessions = Array::New(env, snapshot.sessions.size());
+    for (size_t i = 0; i < snapshot.sessions.size(); ++i) {
+        const LoginSession &session = snapshot.sessions[i];
+        Object entry = Object::New(env);
+        entry.Set("id", session.id);
+        entry.Set("user", session.user);
+        entry.Set("uid", (double) session.uid);
+        entry.Set("seat", session.seat);
+        entry.Set("tty", session.tty);
+        entry.Set("display", session.display);
+        entry.Set("type", session.type);
+        entry.Set("class", session.sessionClass);
+        entry.Set("state", session.state);
+        entry.Set("service", session.service);
+        entry.Set("desktop", session.desktop);
+        entry.Set("remoteHost", session.remoteHost);
+        entry.Set("active", session.active);
+        entry.Set("remote", session.remote);
+        entry.Set("vtnr", session.vtnr);
+        entry.Set("leader", (double) session.leader);
+        sessions[i] = entry;
+    }
+    result.Set("sessions", sessions);
+    Array logins = Array::New(env, snapshot.logins.size());
+    for (size_t i = 0; i < snapshot.logins.size(); ++i) {
+        const LoginRecord &login = snapshot.logins[i];
+        Object entry = Object::New(env);
+        entry.Set("user", login.user);
+        entry.Set("line", login.line);
+        entry.Set("host", login.host);
+        entry.Set("pid", (double) login.pid);
+        entry.Set("loginTimeMs", (double) login.loginTimeMs);
+        logins[i] = entry;
+    }
+    result.Set("logins", logins);
+    return Boolean::New(env, snapshot.available);
+}
+
+// One engine per sysfs root, tests use fixture trees
+static std::mutex cpuPolicyEnginesMutex;
+static std::map<std::string, std::shared_ptr<CpuPolicyEngine>> cpuPolicyEngines;
+
+static std::shared_ptr<CpuPolicyEngine> GetCpuPolicyEngine(const CallbackInfo &info, size_t rootArgument, const char *errorMessage) {
+    if (info.Length() > rootArgument + 1 || (info.Length() == rootArgument + 1 && !info[rootArgument].IsString() && !info[rootArgument].IsUndefined())) {
+        throw Napi::Error::New(info.Env(), errorMessage);
+    }
+    std::string root = CPU_SYSFS_ROOT;
+    if (info.Length() == rootArgument + 1 && info[rootArgument].IsString()) {
+        root = info[rootArgument].As<String>();
+    }
+    std::lock_guard<std::mutex> lock(cpuPolicyEnginesMutex);
+    std::shared_ptr<CpuPolicyEngine> &engine = cpuPolicyEngines[root];
+    if (!engine) { engine = std::make_shared<CpuPolicyEngine>(root); }
+    return engine;
+}
+
+static Array CpuPolicyDeviationsToArray(Napi::Env env, const std::vector<CpuPolicyDeviation> &deviations) {
+    Array result = Array::New(env, deviations.size());
+    for (size_t i = 0; i < deviations.size(); ++i) {
+        Object entry = Object::New(env);
+        entry.Set("path", deviations[i].path);
+        entry.Set("expected", deviations[i].expected);
+        entry.Set("actual", deviations[i].actual);
+        entry.Set("error", deviations[i].error);
+        result[i] = entry;
+    }
+    return result;
+}
+
+static Array CpuListToArray(Napi::Env env, const std::vector<int> &cpus) {
+    Array result = Array::New(env, cpus.size());
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        result[i] = Number::New(env, cpus[i]);
+    }
+    return result;
+}
+
+Boolean GetCpuPolicyState(const CallbackInfo &info) {
+    if (info.Length() < 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "GetCpuPolicyState - invalid argument"); }
+    std::shared_ptr<CpuPolicyEngine> engine = GetCpuPolicyEngine(info, 1, "GetCpuPolicyState - invalid argument");
+    CpuSystemState state;
+    bool available = engine->GetState(state);
+
+    Napi::Env env = info.Env();
+    Object result = info[0].As<Object>();
+    result.Set("present", CpuListToArray(env, state.present));
+    result.Set("online", CpuListToArray(env, state.online));
+    result.Set("boost", state.boost >= 0 ? (Value) Boolean::New(env, state.boost > 0) : env.Null());
+    result.Set("noTurbo", state.noTurbo >= 0 ? (Value) Boolean::New(env, state.noTurbo > 0) : env.Null());
+    Array policies = Array::New(env, state.policies.size());
+    for (size_t i = 0; i < state.policies.size(); ++i) {
+        const CpuPolicyState &policy = state.policies[i];
+        Object entry = Object::New(env);
+        entry.Set("id", policy.id);
+        entry.Set("cpus", CpuListToArray(env, policy.cpus));
+        entry.Set("driver", policy.driver);
+        Array governors = Array::New(env, policy.availableGovernors.size());
+        for (size_t j = 0; j < policy.availableGovernors.size(); ++j) { governors[j] = String::New(env, policy.availableGovernors[j]); }
+        entry.Set("availableGovernors", governors);
+        Array preferences = Array::New(env, policy.availablePreferences.size());
+        for (size_t j = 0; j < policy.availablePreferences.size(); ++j) { preferences[j] = String::New(env, policy.availablePreferences[j]); }
+        entry.Set("availableEnergyPerformancePreferences", preferences);
+        Array frequencies = Array::New(env, policy.availableFrequencies.size());
+        for (size_t j = 0; j < policy.availableFrequencies.size(); ++j) { frequencies[j] = Number::New(env, (double) policy.availableFrequencies[j]); }
+        entry.Set("availableFrequencies", frequencies);
+        entry.Set("cpuinfoMinFrequency", (double) policy.cpuinfoMinFreq);
+        entry.Set("cpuinfoMaxFrequency", (double) policy.cpuinfoMaxFreq);
+        entry.Set("active", policy.active);
+        entry.Set("governor", policy.governor);
+        entry.Set("energyPerformancePreference", policy.preference);
+        entry.Set("scalingMinFrequency", (double) policy.minFreq);
+        entry.Set("scalingMaxFrequency", (double) policy.maxFreq);
+        policies[i] = entry;
+    }
+    result.Set("policies", policies);
+    return Boolean::New(env, available);
+}
+
+class ApplyCpuPolicyWorker : public AsyncWorker {
+public:
+    ApplyCpuPolicyWorker(Napi::Env env, std::shared_ptr<CpuPolicyEngine> engine, const CpuPolicyTarget &target)
+        : AsyncWorker(env), deferred(Promise::Deferred::New(env)), engine(engine), target(target) { }
+
+    Promise GetPromise() { return deferred.Promise(); }
+
+    void Execute() override {
+        result = engine->Apply(target);
+    }
+
+    void OnOK() override {
+        Object resultObject = Object::New(Env());
+        resultObject.Set("writes", result.writes);
+        resultObject.Set("unchanged", result.unchanged);
+        resultObject.Set("reads", (double) result.reads);
+        resultObject.Set("failed", CpuPolicyDeviationsToArray(Env(), result.failed));
+        resultObject.Set("durationUs", (double) result.durationUs);
+        deferred.Resolve(resultObject);
+    }
+
+    void OnError(const Error &e) override {
+        deferred.Reject(e.Value());
+    }
+
+private:
+    Promise::Deferred deferred;
+    std::shared_ptr<CpuPolicyEngine> engine;
+    CpuPolicyTarget target;
+    CpuPolicyApplyResult result;
+};
+
+static int64_t OptionalInt64(Object object, const char *name) {
+    return object.Has(name) && object.Get(name).IsNumber() ? object.Get(name).As<Number>().Int64Value() : -1;
+}
+
+static int OptionalFlag(Object object, const char *name) {
+    return object.Has(name) && object.Get(name).IsBoolean() ? (object.Get(name).As<Boolean>() ? 1 : 0) : -1;
+}
+
+static std::string OptionalString(Object object, const char *name) {
+    return object.Has(name) && object.Get(name).IsString() ? object.Get(name).As<String>().Utf8Value() : "";
+}
+
+Value ApplyCpuPolicy(const CallbackInfo &info) {
+    if (info.Length() < 1 || !info[0].IsObject()) { throw Napi::Error::New(info.Env(), "ApplyCpuPolicy - invalid argument"); }
+    std::shared_ptr<CpuPolicyEngine> engine = GetCpuPolicyEngine(info, 1, "ApplyCpuPolicy - invalid argument");
+    Object targetObject = info[0].As<Object>();
+    CpuPolicyTarget target;
+    target.boost = OptionalFlag(targetObject, "boost");
+    target.noTurbo = OptionalFlag(targetObject, "noTurbo");
+    if (targetObject.Has("cores") && targetObject.Get("cores").IsArray()) {
+        Array cores = targetObject.Get("cores").As<Array>();
+        for (uint32_t i = 0; i < cores.Length(); ++i) {
+            if (!cores.Get(i).IsObject()) { throw Napi::Error::New(info.Env(), "ApplyCpuPolicy - invalid core"); }
+            Object coreObject = cores.Get(i).As<Object>();
+            CpuCoreTarget core;
+            core.cpu = (int) OptionalInt64(coreObject, "cpu");
+            if (core.cpu < 0) { throw Napi::Error::New(info.Env(), "ApplyCpuPolicy - invalid core"); }
+            core.online = OptionalFlag(coreObject, "online");
+            core.governor = OptionalString(coreObject, "governor");
+            core.preference = OptionalString(coreObject, "energyPerformancePreference");
+            core.minFreq = OptionalInt64(coreObject, "scalingMinFrequency");
+            core.maxFreq = OptionalInt64(coreObject, "scalingMaxFrequency");
+            target.cores.push_back(core);
+        }
+    }
+
+    ApplyCpuPolicyWorker *worker = new ApplyCpuPolicyWorker(info.Env(), engine, target);
+    Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+Value CheckCpuPolicy(const CallbackInfo &info) {
+    std::shared_ptr<CpuPolicyEngine> engine = GetCpuPolicyEngine(info, 0, "CheckCpuPolicy - invalid argument");
+    CpuPolicyCheckResult check = engine->Check();
+    Object result = Object::New(info.Env());
+    result.Set("drift", CpuPolicyDeviationsToArray(info.Env(), check.drift));
+    result.Set("reads", (double) check.reads);
+    result.Set("durationUs", (double) check.durationUs);
+    return result;
+}
+
+// Answers the monitor's pings on the event loop, unreferenced so it never keeps the loop alive
+static ThreadSafeFunction loopMonitorPing;
+static bool loopMonitorPingSet = false;
+
+static void StopLoopMonitorInternal() {
+    serviceOwners[SERVICE_LOOP_MONITOR] = nullptr;
+    LoopMonitor::Default().Stop();
+    if (loopMonitorPingSet) {
+        loopMonitorPing.Release();
+        loopMonitorPingSet = false;
+    }
+}
+
+Boolean StartLoopMonitor(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsNumber()) { throw Napi::Error::New(info.Env(), "StartLoopMonitor - invalid argument"); }
+    int64_t intervalMs = info[0].As<Number>().Int64Value();
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    if (LoopMonitor::Default().IsRunning() || intervalMs <= 0) {
+        return Boolean::New(info.Env(), false);
+    }
+
+    loopMonitorPing = ThreadSafeFunction::New(info.Env(), Function::New(info.Env(), [](const CallbackInfo &) { }), "TuxedoIOLoopMonitor", 1, 1);
+    loopMonitorPing.Unref(info.Env());
+    loopMonitorPingSet = true;
+    bool result = LoopMonitor::Default().Start(intervalMs, []() {
+        return loopMonitorPing.NonBlockingCall([](Env env, Function callback) { LoopMonitor::Default().Pong(); }) == napi_ok;
+    });
+    if (result) {
+        serviceOwners[SERVICE_LOOP_MONITOR] = &Data(info.Env());
+    } else {
+        StopLoopMonitorInternal();
+    }
+    return Boolean::New(info.Env(), result);
+}
+
+void StopLoopMonitor(const CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    StopLoopMonitorInternal();
+}
+
+void RecordGcPause(const CallbackInfo &info) {
+    if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsNumber()) { throw Napi::Error::New(info.Env(), "RecordGcPause - invalid argument"); }
+    // Flags of perf_hooks' PerformanceEntry.detail.kind
+    int kindFlags = info[0].As<Number>().Int32Value();
+    GcKind kind = GcKind::Major;
+    if (kindFlags & 1) { kind = GcKind::Minor; }
+    else if (kindFlags & 8) { kind = GcKind::Incremental; }
+    else if (kindFlags & 16) { kind = GcKind::WeakCallbacks; }
+    LoopMonitor::Default().RecordGcPause(kind, info[1].As<Number>().DoubleValue());
+}
+
+void BeginWorkerRun(const CallbackInfo &info) {
+    if (info.Length() != 3 || !info[0].IsString() || !info[1].IsNumber() || !info[2].IsNumber()) {
+        throw Napi::Error::New(info.Env(), "BeginWorkerRun - invalid argument");
+    }
+    double latenessMs = std::max(0.0, info[1].As<Number>().DoubleValue());
+    LoopMonitor::Default().BeginWork(info[0].As<String>(), LatencyNowNs() - (uint64_t) (latenessMs * 1e6), info[2].As<Number>().DoubleValue());
+}
+
+void EndWorkerRun(const CallbackInfo &info) {
+    if (info.Length() != 1 || !info[0].IsString()) { throw Napi::Error::New(info.Env(), "EndWorkerRun - invalid argument"); }
+    LoopMonitor::Default().EndWork(info[0].As<String>());
+}
+
+static Object HistogramToObject(Napi::Env env, const LatencyHistogram &histogram) {
+    Object result = Object::New(env);
+    result.Set("count", (double) histogram.count);
+    result.Set("avgMs", histogram.count > 0 ? histogram.sumMs / histogram.count : 0);
+    result.Set("p50Ms", histogram.Quantile(0.5));
+    result.Set("p99Ms", histogram.Quantile(0.99));
+    result.Set("maxMs", histogram.maxMs);
+    Array buckets = Array::New(env, LATENCY_BUCKETS);
+    for (int i = 0; i < LATENCY_BUCKETS; ++i) {
+        buckets[i] = Number::New(env, (double) histogram.counts[i]);
+    }
+    result.Set("buckets", buckets);
+    return result;
+}
+
+Object GetLoopMonitorStats(const CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    LoopMonitorStats stats = LoopMonitor::Default().GetStats();
+    Object result = Object::New(env);
+    result.Set("running", stats.running);
+    result.Set("intervalMs", (double) stats.intervalMs);
+    Array bounds = Array::New(env, LATENCY_BUCKETS - 1);
+    for (int i = 0; i < LATENCY_BUCKETS - 1; ++i) {
+        bounds[i] = Number::New(env, LATENCY_BUCKET_BOUNDS_MS[i]);
+    }
+    result.Set("bucketBoundsMs", bounds);
+    result.Set("skippedPings", (double) stats.skippedPings);
+    result.Set("loopLag", HistogramToObject(env, stats.loopLag));
+    result.Set("gcPause", HistogramToObject(env, stats.gcPause));
+    Object gcPauses = Object::New(env);
+    gcPauses.Set("minor", (double) stats.gcPauses[(int) GcKind::Minor]);
+    gcPauses.Set("major", (double) stats.gcPauses[(int) GcKind::Major]);
+    gcPauses.Set("incremental", (double) stats.gcPauses[(int) GcKind::Incremental]);
+    gcPauses.Set("weakCallbacks", (double) stats.gcPauses[(int) GcKind::WeakCallbacks]);
+    result.Set("gcPauses", gcPauses);
+    result.Set("fanCalls", HistogramToObject(env, stats.fanCalls));
+    Array workers = Array::New(env, stats.workers.size());
+    for (size_t i = 0; i < stats.workers.size(); ++i) {
+        Object worker = Object::New(env);
+        worker.Set("name", stats.workers[i].name);
+        worker.Set("runs", (double) stats.workers[i].runs);
+        worker.Set("missed", (double) stats.workers[i].missed);
+        worker.Set("inProgress", stats.workers[i].inProgress);
+        worker.Set("lateness", HistogramToObject(env, stats.workers[i].lateness));
+        worker.Set("runtime", HistogramToObject(env, stats.workers[i].runtime));
+        worker.Set("fanCallLateness", HistogramToObject(env, stats.workers[i].fanCallLateness));
+        workers[i] = worker;
+    }
+    result.Set("workers", workers);
+    return result;
+}
+
+void ResetLoopMonitor(const CallbackInfo &info) {
+    LoopMonitor::Default().Reset();
+}
+
+/**
+ * Export with napi__entry/napi__return probes around the call, the return
+ * probe also fires when the call throws
+ */
+template<typename Callback>
+static Function ProbedFunction(Napi::Env env, const char *name, Callback callback) {
+    return Function::New(env, [name, callback](const CallbackInfo &info) {
+        struct ReturnProbe {
+            const char *name;
+            int exceptions = std::uncaught_exceptions();
+            ~ReturnProbe() {
+                TUXEDO_IO_PROBE2(napi__return, name, std::uncaught_exceptions() > exceptions ? 1 : 0);
+            }
+        } returnProbe { name };
+        TUXEDO_IO_PROBE1(napi__entry, name);
+        return callback(info);
+    }, name);
+}
+
+/**
+ * Stop the services an exiting instance started, its instance data is freed
+ * by the environment afterwards
+ */
+static void StopOwnedServices(AddonData *data) {
+    std::lock_guard<std::mutex> lock(serviceMutex);
+    if (serviceOwners[SERVICE_SENSOR_SAMPLER] == data) { StopSensorSamplerInternal(); }
+    if (serviceOwners[SERVICE_RESUME_WATCH] == data) { StopResumeWatchInternal(); }
+    if (serviceOwners[SERVICE_METRICS_SERVER] == data) { StopMetricsServerInternal(); }
+    if (serviceOwners[SERVICE_TELEMETRY_PUBLISHER] == data) { ClosePublishedTelemetry(); }
+    if (serviceOwners[SERVICE_TELEMETRY_JOURNAL] == data) { StopTelemetryJournalInternal(); }
+    if (serviceOwners[SERVICE_SCHEDULER] == data) { StopSchedulerInternal(); }
+    if (serviceOwners[SERVICE_IOCTL_TRACE] == data) { StopIoctlTraceInternal(); }
+    if (serviceOwners[SERVICE_GPU_QUERY] == data) { StopGpuQueryInternal(); }
+    if (serviceOwners[SERVICE_KEYBOARD_LEDS] == data) { CloseKeyboardLedsInternal(); }
+    if (serviceOwners[SERVICE_LOOP_MONITOR] == data) { StopLoopMonitorInternal(); }
+    if (serviceOwners[SERVICE_DEVICE_WATCH] == data) { StopDeviceWatchInternal(); }
+}
+
+Object Init(Env env, Object exports) {
+    // One instance per environment, loading in worker_threads is supported
+    AddonData *data = new AddonData();
+    env.SetInstanceData(data);
+    napi_add_env_cleanup_hook(env, [](void *data) { StopOwnedServices((AddonData *) data); }, data);
+
+    // General
+    exports.Set(String::New(env, "getModuleInfo"), ProbedFunction(env, "getModuleInfo", GetModuleInfo));
+    exports.Set(String::New(env, "wmiAvailable"), ProbedFunction(env, "wmiAvailable", WmiAvailable));
+
+    exports.Set(String::New(env, "setEnableModeSet"), ProbedFunction(env, "setEnableModeSet", SetEnableModeSet));
+    exports.Set(String::New(env, "getOutputPorts"), ProbedFunction(env, "getOutputPorts", GetOutputPorts));
+    exports.Set(String::New(env, "getLastError"), ProbedFunction(env, "getLastError", GetLastError));
+    exports.Set(String::New(env, "getIoctlBreakerState"), ProbedFunction(env, "getIoctlBreakerState", GetIoctlBreakerState));
+    exports.Set(String::New(env, "resetIoctlBreaker"), ProbedFunction(env, "resetIoctlBreaker", ResetIoctlBreaker));
+    exports.Set(String::New(env, "getIoctlQueueStats"), ProbedFunction(env, "getIoctlQueueStats", GetIoctlQueueStats));
+    exports.Set(String::New(env, "getDeviceSessionStats"), ProbedFunction(env, "getDeviceSessionStats", GetDeviceSessionStats));
+    exports.Set(String::New(env, "startDeviceWatch"), ProbedFunction(env, "startDeviceWatch", StartDeviceWatch));
+    exports.Set(String::New(env, "stopDeviceWatch"), ProbedFunction(env, "stopDeviceWatch", StopDeviceWatch));
+    exports.Set(String::New(env, "getDeviceWatchState"), ProbedFunction(env, "getDeviceWatchState", GetDeviceWatchState));
+
+    // Fan control
+    exports.Set(String::New(env, "getFansMinSpeed"), ProbedFunction(env, "getFansMinSpeed", GetFansMinSpeed));
+    exports.Set(String::New(env, "getFansOffAvailable"), ProbedFunction(env, "getFansOffAvailable", GetFansOffAvailable));
+    exports.Set(String::New(env, "getNumberFans"), ProbedFunction(env, "getNumberFans", GetNumberFans));
+    exports.Set(String::New(env, "setFansAuto"), ProbedFunction(env, "setFansAuto", SetFansAuto));
+    exports.Set(String::New(env, "setFanSpeedPercent"), ProbedFunction(env, "setFanSpeedPercent", SetFanSpeedPercent));
+    exports.Set(String::New(env, "getFanSpeedPercent"), ProbedFunction(env, "getFanSpeedPercent", GetFanSpeedPercent));
+    exports.Set(String::New(env, "getFanTemperature"), ProbedFunction(env, "getFanTemperature", GetFanTemperature));
+    exports.Set(String::New(env, "getDeviceStatus"), ProbedFunction(env, "getDeviceStatus", GetDeviceStatus));
+    exports.Set(String::New(env, "startSensorSampler"), ProbedFunction(env, "startSensorSampler", StartSensorSampler));
+    exports.Set(String::New(env, "stopSensorSampler"), ProbedFunction(env, "stopSensorSampler", StopSensorSampler));
+    exports.Set(String::New(env, "setSamplerFanTable"), ProbedFunction(env, "setSamplerFanTable", SetSamplerFanTable));
+    exports.Set(String::New(env, "getSampledFanTemperature"), ProbedFunction(env, "getSampledFanTemperature", GetSampledFanTemperature));
+    exports.Set(String::New(env, "getSamplerStats"), ProbedFunction(env, "getSamplerStats", GetSamplerStats));
+    exports.Set(String::New(env, "calibrateFans"), ProbedFunction(env, "calibrateFans", CalibrateFans));
+
+    // GPU query
+    exports.Set(String::New(env, "startGpuQuery"), ProbedFunction(env, "startGpuQuery", StartGpuQuery));
+    exports.Set(String::New(env, "stopGpuQuery"), ProbedFunction(env, "stopGpuQuery", StopGpuQuery));
+    exports.Set(String::New(env, "getGpuQuerySnapshot"), ProbedFunction(env, "getGpuQuerySnapshot", GetGpuQuerySnapshot));
+    exports.Set(String::New(env, "waitGpuQuerySample"), ProbedFunction(env, "waitGpuQuerySample", WaitGpuQuerySample));
+    exports.Set(String::New(env, "queryGpuOnce"), ProbedFunction(env, "queryGpuOnce", QueryGpuOnce));
+
+    // Webcam
+    exports.Set(String::New(env, "setWebcamStatus"), ProbedFunction(env, "setWebcamStatus", SetWebcamStatus));
+    exports.Set(String::New(env, "getWebcamStatus"), ProbedFunction(env, "getWebcamStatus", GetWebcamStatus));
+    exports.Set(String::New(env, "getWebcamDevices"), ProbedFunction(env, "getWebcamDevices", GetWebcamDevices));
+    exports.Set(String::New(env, "getV4l2Controls"), ProbedFunction(env, "getV4l2Controls", GetV4l2Controls));
+    exports.Set(String::New(env, "setV4l2Controls"), ProbedFunction(env, "setV4l2Controls", SetV4l2Controls));
+    exports.Set(String::New(env, "simulateV4l2Camera"), ProbedFunction(env, "simulateV4l2Camera", SimulateV4l2Camera));
+    exports.Set(String::New(env, "stopV4l2Simulation"), ProbedFunction(env, "stopV4l2Simulation", StopV4l2Simulation));
+    exports.Set(String::New(env, "getV4l2SimulationEnumerations"), ProbedFunction(env, "getV4l2SimulationEnumerations", GetV4l2SimulationEnumerations));
+
+    // Keyboard backlight
+    exports.Set(String::New(env, "openKeyboardLeds"), ProbedFunction(env, "openKeyboardLeds", OpenKeyboardLeds));
+    exports.Set(String::New(env, "closeKeyboardLeds"), ProbedFunction(env, "closeKeyboardLeds", CloseKeyboardLeds));
+    exports.Set(String::New(env, "writeKeyboardFrame"), ProbedFunction(env, "writeKeyboardFrame", WriteKeyboardFrame));
+    exports.Set(String::New(env, "invalidateKeyboardFrame"), ProbedFunction(env, "invalidateKeyboardFrame", InvalidateKeyboardFrame));
+    exports.Set(String::New(env, "startKeyboardAnimation"), ProbedFunction(env, "startKeyboardAnimation", StartKeyboardAnimation));
+    exports.Set(String::New(env, "stopKeyboardAnimation"), ProbedFunction(env, "stopKeyboardAnimation", StopKeyboardAnimation));
+    exports.Set(String::New(env, "getKeyboardLedStats"), ProbedFunction(env, "getKeyboardLedStats", GetKeyboardLedStats));
+
+    // Login sessions
+    exports.Set(String::New(env, "getLoginSessions"), ProbedFunction(env, "getLoginSessions", GetLoginSessions));
+
+    // CPU frequency policies
+    exports.Set(String::New(env, "getCpuPolicyState"), ProbedFunction(env, "getCpuPolicyState", GetCpuPolicyState));
+    exports.Set(String::New(env, "applyCpuPolicy"), ProbedFunction(env, "applyCpuPolicy", ApplyCpuPolicy));
+    exports.Set(String::New(env, "checkCpuPolicy"), ProbedFunction(env, "checkCpuPolicy", CheckCpuPolicy));
+
+    // ODM Profiles
+    exports.Set(String::New(env, "getAvailableODMPerformanceProfiles"), ProbedFunction(env, "getAvailableODMPerformanceProfiles", GetAvailableODMPerformanceProfiles));
+    exports.Set(String::New(env, "setODMPerformanceProfile"), ProbedFunction(env, "setODMPerformanceProfile", SetODMPerformanceProfile));
+    exports.Set(String::New(env, "getDefaultODMPerformanceProfile"), ProbedFunction(env, "getDefaultODMPerformanceProfile", GetDefaultODMPerformanceProfile));
+
+    // TDP Control
+    exports.Set(String::New(env, "getTDPInfo"), ProbedFunction(env, "getTDPInfo", GetTDPInfo));
+    exports.Set(String::New(env, "setTDPValues"), ProbedFunction(env, "setTDPValues", SetTDPValues));
+
+    // Profile transaction
+    exports.Set(String::New(env, "applyProfile"), ProbedFunction(env, "applyProfile", ApplyProfile));
+
+    // Suspend/resume state restore
+    exports.Set(String::New(env, "startResumeWatch"), ProbedFunction(env, "startResumeWatch", StartResumeWatch));
+    exports.Set(String::New(env, "stopResumeWatch"), ProbedFunction(env, "stopResumeWatch", StopResumeWatch));
+    exports.Set(String::New(env, "getResumeStats"), ProbedFunction(env, "getResumeStats", GetResumeStats));
+    exports.Set(String::New(env, "restoreDeviceState"), ProbedFunction(env, "restoreDeviceState", RestoreDeviceState));
+
+    // Telemetry
+    exports.Set(String::New(env, "startMetricsServer"), ProbedFunction(env, "startMetricsServer", StartMetricsServer));
+    exports.Set(String::New(env, "stopMetricsServer"), ProbedFunction(env, "stopMetricsServer", StopMetricsServer));
+    exports.Set(String::New(env, "publishTelemetry"), ProbedFunction(env, "publishTelemetry", PublishTelemetry));
+    exports.Set(String::New(env, "unpublishTelemetry"), ProbedFunction(env, "unpublishTelemetry", UnpublishTelemetry));
+    exports.Set(String::New(env, "openTelemetry"), ProbedFunction(env, "openTelemetry", OpenTelemetry));
+    exports.Set(String::New(env, "readTelemetry"), ProbedFunction(env, "readTelemetry", ReadTelemetry));
+    exports.Set(String::New(env, "closeTelemetry"), ProbedFunction(env, "closeTelemetry", CloseTelemetry));
+    exports.Set(String::New(env, "getTelemetry"), ProbedFunction(env, "getTelemetry", GetTelemetry));
+    exports.Set(String::New(env, "startTelemetryJournal"), ProbedFunction(env, "startTelemetryJournal", StartTelemetryJournal));
+    exports.Set(String::New(env, "stopTelemetryJournal"), ProbedFunction(env, "stopTelemetryJournal", StopTelemetryJournal));
+    exports.Set(String::New(env, "openTelemetryJournal"), ProbedFunction(env, "openTelemetryJournal", OpenTelemetryJournal));
+    exports.Set(String::New(env, "closeTelemetryJournal"), ProbedFunction(env, "closeTelemetryJournal", CloseTelemetryJournal));
+    exports.Set(String::New(env, "queryTelemetryJournal"), ProbedFunction(env, "queryTelemetryJournal", QueryTelemetryJournal));
+    exports.Set(String::New(env, "getTelemetryJournalProfiles"), ProbedFunction(env, "getTelemetryJournalProfiles", GetTelemetryJournalProfiles));
+
+    // Periodic work scheduling
+    exports.Set(String::New(env, "addScheduledJob"), ProbedFunction(env, "addScheduledJob", AddScheduledJob));
+    exports.Set(String::New(env, "setScheduledJobReads"), ProbedFunction(env, "setScheduledJobReads", SetScheduledJobReads));
+    exports.Set(String::New(env, "removeScheduledJob"), ProbedFunction(env, "removeScheduledJob", RemoveScheduledJob));
+    exports.Set(String::New(env, "completeScheduledJob"), ProbedFunction(env, "completeScheduledJob", CompleteScheduledJob));
+    exports.Set(String::New(env, "startScheduler"), ProbedFunction(env, "startScheduler", StartScheduler));
+    exports.Set(String::New(env, "stopScheduler"), ProbedFunction(env, "stopScheduler", StopScheduler));
+    exports.Set(String::New(env, "getSchedulerStats"), ProbedFunction(env, "getSchedulerStats", GetSchedulerStats));
+
+    // Event loop and deadline monitoring
+    exports.Set(String::New(env, "startLoopMonitor"), ProbedFunction(env, "startLoopMonitor", StartLoopMonitor));
+    exports.Set(String::New(env, "stopLoopMonitor"), ProbedFunction(env, "stopLoopMonitor", StopLoopMonitor));
+    exports.Set(String::New(env, "recordGcPause"), ProbedFunction(env, "recordGcPause", RecordGcPause));
+    exports.Set(String::New(env, "beginWorkerRun"), ProbedFunction(env, "beginWorkerRun", BeginWorkerRun));
+    exports.Set(String::New(env, "endWorkerRun"), ProbedFunction(env, "endWorkerRun", EndWorkerRun));
+    exports.Set(String::New(env, "getLoopMonitorStats"), ProbedFunction(env, "getLoopMonitorStats", GetLoopMonitorStats));
+    exports.Set(String::New(env, "resetLoopMonitor"), ProbedFunction(env, "resetLoopMonitor", ResetLoopMonitor));
+
+    // ioctl trace, replay and simulation
+    exports.Set(String::New(env, "startIoctlTrace"), ProbedFunction(env, "startIoctlTrace", StartIoctlTrace));
+    exports.Set(String::New(env, "stopIoctlTrace"), ProbedFunction(env, "stopIoctlTrace", StopIoctlTrace));
+    exports.Set(String::New(env, "startIoctlReplay"), ProbedFunction(env, "startIoctlReplay", StartIoctlReplay));
+    exports.Set(String::New(env, "stopIoctlReplay"), ProbedFunction(env, "stopIoctlReplay", StopIoctlReplay));
+    exports.Set(String::New(env, "getIoctlReplayStats"), ProbedFunction(env, "getIoctlReplayStats", GetIoctlReplayStats));
+    exports.Set(String::New(env, "startIoctlSimulation"), ProbedFunction(env, "startIoctlSimulation", StartIoctlSimulation));
+    exports.Set(String::New(env, "stopIoctlSimulation"), ProbedFunction(env, "stopIoctlSimulation", StopIoctlSimulation));
+    exports.Set(String::New(env, "setSimulatedTemperature"), ProbedFunction(env, "setSimulatedTemperature", SetSimulatedTemperature));
+    exports.Set(String::New(env, "getIoctlSimulationStats"), ProbedFunction(env, "getIoctlSimulationStats", GetIoctlSimulationStats));
+    exports.Set(String::New(env, "takeSimulationEvents"), ProbedFunction(env, "takeSimulationEvents", TakeSimulationEvents));
+    exports.Set(String::New(env, "runConcurrentDeviceCalls"), ProbedFunction(env, "runConcurrentDeviceCalls", RunConcurrentDeviceCalls));
 
     return exports;
 }
@@ -19,8 +19,17 @@
 
 import { CpuController } from '../../common/classes/CpuController';
 import { ScalingDriver } from '../../common/classes/LogicalCpuController';
+import { findClosestValue } from '../../common/classes/Utils';
 import { TUXEDODevice } from '../../common/models/DefaultProfiles';
 import { FrequencyConfig, type ITccProfile } from '../../common/models/TccProfile';
+import {
+    type CpuPolicyApplyResult,
+    type CpuPolicyCheckResult,
+    type CpuPolicyDeviation,
+    CpuPolicyState,
+    type CpuPolicyTarget,
+    TuxedoIOAPI,
+} from '../../native-lib/TuxedoIOAPI';
 import { DaemonWorker } from './DaemonWorker';
 import type { TuxedoControlCenterDaemon } from './TuxedoControlCenterDaemon';
 
@@ -38,6 +47,14 @@ export class CpuWorker extends DaemonWorker {
     private hasEPPPerformanceQuirk: boolean;
     private device: TUXEDODevice;
 
+    /**
+     * Profiles are applied and verified by the native cpufreq policy engine,
+     * which only writes and reports values that differ
+     */
+    private nativePolicy: boolean = false;
+    // intel_pstate does not keep scaling_max_freq, see validateCpuFreq
+    private ignoreFrequencyDrift: boolean = false;
+
     constructor(tccd: TuxedoControlCenterDaemon) {
         super(10000, 'CpuWorker', tccd);
         this.cpuCtrl = new CpuController(this.basePath);
@@ -59,8 +76,13 @@ export class CpuWorker extends DaemonWorker {
     }
 
     public async onStart(): Promise<void> {
+        this.nativePolicy = TuxedoIOAPI.getCpuPolicyState(new CpuPolicyState(), this.basePath);
         if (this.tccd.settings.cpuSettingsEnabled) {
-            this.applyCpuProfile(this.activeProfile);
+            if (this.nativePolicy) {
+                await this.applyNativeCpuProfile(this.activeProfile);
+            } else {
+                this.applyCpuProfile(this.activeProfile);
+            }
         }
     }
 
@@ -69,7 +91,9 @@ export class CpuWorker extends DaemonWorker {
         // apply profile again
 
         try {
-            if (this.tccd.settings.cpuSettingsEnabled && !this.validateCpuFreq()) {
+            if (this.tccd.settings.cpuSettingsEnabled && this.nativePolicy) {
+                await this.checkNativeCpuProfile();
+            } else if (this.tccd.settings.cpuSettingsEnabled && !this.validateCpuFreq()) {
                 this.tccd.logLine('CpuWorker: Incorrect settings, reapplying profile');
                 this.applyCpuProfile(this.activeProfile);
             }
@@ -213,6 +237,152 @@ export class CpuWorker extends DaemonWorker {
         }
     }
 
+    /**
+     * Native counterpart of applyCpuProfile, the resulting values follow the
+     * same rules but are computed from the cached policy state and written
+     * without resetting to defaults first
+     */
+    private async applyNativeCpuProfile(profile: ITccProfile): Promise<void> {
+        try {
+            const state: CpuPolicyState = new CpuPolicyState();
+            if (!TuxedoIOAPI.getCpuPolicyState(state, this.basePath)) {
+                return;
+            }
+            const result: CpuPolicyApplyResult = await TuxedoIOAPI.applyCpuPolicy(
+                this.getCpuPolicyTarget(profile, state),
+                this.basePath,
+            );
+            for (const failed of result.failed) {
+                console.error(
+                    `CpuWorker: Failed writing '${failed.expected}' to ${failed.path} => errno ${failed.error}`,
+                );
+            }
+            if (result.writes > 0) {
+                this.tccd.logLine(
+                    `CpuWorker: Applied ${result.writes} cpu values (${result.unchanged} unchanged) in ${(result.durationUs / 1000).toFixed(1)} ms`,
+                );
+            }
+        } catch (err: unknown) {
+            console.error(`CpuWorker: applyNativeCpuProfile failed => ${err}`);
+        }
+    }
+
+    /**
+     * Reapply when a value changed outside of tccd, only the drifted values are written again
+     */
+    private async checkNativeCpuProfile(): Promise<void> {
+        const check: CpuPolicyCheckResult = TuxedoIOAPI.checkCpuPolicy(this.basePath);
+        const drift: CpuPolicyDeviation[] = check.drift.filter(
+            (deviation: CpuPolicyDeviation): boolean =>
+                !(this.ignoreFrequencyDrift && deviation.path.endsWith('_freq')),
+        );
+        if (drift.length === 0) {
+            return;
+        }
+        for (const deviation of drift) {
+            this.tccd.logLine(
+                `CpuWorker: Unexpected value ${deviation.path} => '${deviation.actual}' instead of '${deviation.expected}'`,
+            );
+        }
+        this.tccd.logLine('CpuWorker: Incorrect settings, reapplying profile');
+        await this.applyNativeCpuProfile(this.activeProfile);
+    }
+
+    /**
+     * Per core values of a profile, the rules of applyCpuProfile and CpuController
+     * on top of the defaults of setCpuDefaultConfig
+     */
+    private getCpuPolicyTarget(profile: ITccProfile, state: CpuPolicyState): CpuPolicyTarget {
+        const useMaxPerfGov: boolean = profile.cpu.useMaxPerfGov === true;
+        profile.cpu.governor = useMaxPerfGov ? this.findPerformanceGovernor() : this.findDefaultGovernor();
+
+        let preference: string;
+        if (!this.noEPPWriteQuirk) {
+            preference =
+                useMaxPerfGov || this.hasEPPPerformanceQuirk
+                    ? 'performance'
+                    : (profile.cpu.energyPerformancePreference ?? 'default');
+        }
+
+        const scalingDriver: string = state.policies[0]?.driver;
+        const boostControl: boolean = state.boost !== null && scalingDriver === ScalingDriver.acpi_cpufreq;
+        this.ignoreFrequencyDrift = scalingDriver === ScalingDriver.intel_pstate && profile.cpu.noTurbo !== true;
+
+        const setMinFrequency: number = useMaxPerfGov ? -2 : profile.cpu.scalingMinFrequency;
+        const setMaxFrequency: number = useMaxPerfGov ? undefined : profile.cpu.scalingMaxFrequency;
+        // Like useCores, 0 leaves all cores online
+        const onlineCores: number = profile.cpu.onlineCores || state.present.length;
+        const target: CpuPolicyTarget = { cores: [] };
+
+        const governor: string = profile.cpu.governor;
+        for (const policy of state.policies) {
+            const availableFrequencies: number[] =
+                policy.availableFrequencies.length > 0 ? policy.availableFrequencies : undefined;
+            let minFrequency: number;
+            let maxFrequency: number;
+            if (policy.cpuinfoMinFrequency >= 0 && policy.cpuinfoMaxFrequency >= 0) {
+                if (setMinFrequency === undefined) {
+                    minFrequency = policy.cpuinfoMinFrequency;
+                } else if (setMinFrequency === -2) {
+                    minFrequency = policy.cpuinfoMaxFrequency;
+                } else {
+                    minFrequency = Math.max(
+                        policy.cpuinfoMinFrequency,
+                        Math.min(policy.cpuinfoMaxFrequency, setMinFrequency),
+                    );
+                }
+                minFrequency = findClosestValue(minFrequency, availableFrequencies);
+
+                if (setMaxFrequency === undefined) {
+                    maxFrequency = policy.cpuinfoMaxFrequency;
+                } else if (setMaxFrequency === FrequencyConfig.ReducedFrequency) {
+                    if (boostControl) {
+                        maxFrequency = policy.cpuinfoMaxFrequency;
+                    } else if (availableFrequencies !== undefined) {
+                        maxFrequency = availableFrequencies[Math.floor(availableFrequencies.length / 2.0)];
+                    } else {
+                        maxFrequency = Math.round(policy.cpuinfoMaxFrequency / 2);
+                    }
+                } else {
+                    maxFrequency = setMaxFrequency;
+                }
+                maxFrequency = Math.max(minFrequency, Math.min(policy.cpuinfoMaxFrequency, maxFrequency));
+                maxFrequency = findClosestValue(
+                    maxFrequency,
+                    availableFrequencies?.filter((frequency: number): boolean => frequency >= minFrequency),
+                );
+            }
+
+            for (const cpu of policy.cpus) {
+                target.cores.push({
+                    cpu,
+                    governor: policy.availableGovernors.includes(governor) ? governor : undefined,
+                    energyPerformancePreference: policy.availableEnergyPerformancePreferences.includes(preference)
+                        ? preference
+                        : undefined,
+                    scalingMinFrequency: minFrequency,
+                    scalingMaxFrequency: maxFrequency,
+                });
+            }
+        }
+
+        // Same order as CpuController.useCores, cpu0 always stays online
+        const presentCpus: number[] = [...state.present].sort((a: number, b: number): number => a - b);
+        presentCpus.forEach((cpu: number, index: number): void => {
+            target.cores.push({ cpu, online: index === 0 || index < onlineCores });
+        });
+
+        if (boostControl) {
+            const maximumAvailableFrequency: number =
+                state.policies[0].availableFrequencies[0] ?? state.policies[0].cpuinfoMaxFrequency;
+            target.boost = setMaxFrequency === undefined || setMaxFrequency > maximumAvailableFrequency;
+        }
+        if (state.noTurbo !== null) {
+            target.noTurbo = profile.cpu.noTurbo ?? false;
+        }
+        return target;
+    }
+
     private setCpuDefaultConfig(): void {
         try {
             this.cpuCtrl.useCores();
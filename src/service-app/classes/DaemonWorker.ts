@@ -29,6 +29,10 @@ export abstract class DaemonWorker {
     ) {}
 
     public timer: NodeJS.Timeout;
+    // Delay the scheduler may add to share wakeups with other workers
+    public slack: number = this.timeout / 10;
+    // Hardware reads done natively in the scheduler wakeup before onWork
+    public hardwareReads: string[] = [];
 
     protected previousProfile: ITccProfile;
     protected activeProfile: ITccProfile;
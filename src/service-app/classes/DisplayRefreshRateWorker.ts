@@ -22,6 +22,7 @@ import { execCommandAsync } from '../../common/classes/Utils';
 import { XDisplayRefreshRateController } from '../../common/classes/XDisplayRefreshRateController';
 import type { IDisplayFreqRes, IDisplayMode } from '../../common/models/DisplayFreqRes';
 import type { ITccProfile } from '../../common/models/TccProfile';
+import { LoginSessions, TuxedoIOAPI } from '../../native-lib/TuxedoIOAPI';
 import { DaemonWorker } from './DaemonWorker';
 import type { TuxedoControlCenterDaemon } from './TuxedoControlCenterDaemon';
 
@@ -31,6 +32,7 @@ export class DisplayRefreshRateWorker extends DaemonWorker {
     private displayInfoFound: boolean = false;
     private previousUsers: string[] = [];
     private wAvailable: boolean = undefined;
+    private nativeSessions: boolean = false;
     private disallowedUserNames: string[] = ['sddm', 'gdm', 'gdm-gree', 'root'];
 
     constructor(tccd: TuxedoControlCenterDaemon) {
@@ -39,6 +41,16 @@ export class DisplayRefreshRateWorker extends DaemonWorker {
     }
 
     public async onStart(): Promise<void> {
+        try {
+            this.nativeSessions = TuxedoIOAPI.getLoginSessions(new LoginSessions());
+        } catch (err: unknown) {
+            console.error(`DisplayRefreshrateWorker: native login sessions failed => ${err}`);
+            this.nativeSessions = false;
+        }
+        if (this.nativeSessions) {
+            return;
+        }
+
         try {
             this.wAvailable = !!(await execCommandAsync('which w')).toString().trim();
             if (!this.wAvailable) {
@@ -53,6 +65,37 @@ export class DisplayRefreshRateWorker extends DaemonWorker {
     // user is able to switch XDG_SESSION_TYPE in login screen and thus a new check needs to be done
     // not checking XDG_SESSION_TYPE during login screen, checking again on user change
     private checkUsers(): boolean[] {
+        const loggedInUsers: string[] = this.nativeSessions ? this.getSessionUsers() : this.getWUsers();
+
+        const usersAvailable: boolean = loggedInUsers.length > 0;
+        const usersChanged: boolean = JSON.stringify(loggedInUsers) !== JSON.stringify(this.previousUsers);
+
+        this.previousUsers = loggedInUsers;
+
+        return [usersAvailable, usersChanged];
+    }
+
+    // Cached by the addon and only reread after utmp or the logind sessions change
+    private getSessionUsers(): string[] {
+        const snapshot: LoginSessions = new LoginSessions();
+        if (!TuxedoIOAPI.getLoginSessions(snapshot)) {
+            return [];
+        }
+
+        // Prefer logind, its greeter sessions are told apart by class, utmp is the fallback without logind
+        const userNames: string[] =
+            snapshot.sessions.length > 0
+                ? snapshot.sessions
+                      .filter((session): boolean => session.class === 'user' && session.state !== 'closing')
+                      .map((session): string => session.user)
+                : snapshot.logins.map((login): string => login.user);
+
+        return userNames.filter(
+            (userName: string): boolean => !!userName && !this.disallowedUserNames.includes(userName),
+        );
+    }
+
+    private getWUsers(): string[] {
         const userInformation: string[] = child_process.execSync('w --no-header').toString().split('\n');
 
         const loggedInUsers: string[] = [];
@@ -69,12 +112,7 @@ export class DisplayRefreshRateWorker extends DaemonWorker {
             }
         }
 
-        const usersAvailable: boolean = loggedInUsers.length > 0;
-        const usersChanged: boolean = JSON.stringify(loggedInUsers) !== JSON.stringify(this.previousUsers);
-
-        this.previousUsers = loggedInUsers;
-
-        return [usersAvailable, usersChanged];
+        return loggedInUsers;
     }
 
     private resetToDefault(): void {
@@ -84,7 +122,7 @@ export class DisplayRefreshRateWorker extends DaemonWorker {
     }
 
     public async onWork(): Promise<void> {
-        if (!this.wAvailable) {
+        if (!this.nativeSessions && !this.wAvailable) {
             return;
         }
 
@@ -0,0 +1,158 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import * as fs from 'node:fs';
+import * as os from 'node:os';
+import * as path from 'node:path';
+
+import type {
+    FanActuatorCharacteristics,
+    FanCalibrationResult,
+    ITuxedoIOAPI,
+} from '../../native-lib/TuxedoIOAPI';
+import {
+    compensateFanSpeed,
+    fanActuatorModelKey,
+    loadFanActuatorProfile,
+    storeFanActuatorProfile,
+} from './FanActuatorProfiles';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+const actuator: FanActuatorCharacteristics = {
+    fan: 0,
+    offAvailable: true,
+    minimumPercent: 25,
+    quantizationPercent: 5,
+    latencyMs: 500,
+    settlingMsPerPercent: 50,
+    steps: [],
+};
+
+describe('compensateFanSpeed', (): void => {
+    it('passes speeds through without calibration', (): void => {
+        expect(compensateFanSpeed(undefined, 42, 30, 30, 1000)).toBe(42);
+    });
+
+    it('leads rising speeds by the latency', (): void => {
+        // Half an interval of latency, half of the last rise on top
+        expect(compensateFanSpeed(actuator, 60, 50, 50, 1000)).toBe(65);
+        expect(compensateFanSpeed(actuator, 98, 80, 80, 1000)).toBe(100);
+        // No lead on falling speeds
+        expect(compensateFanSpeed(actuator, 50, 60, 60, 1000)).toBe(50);
+    });
+
+    it('raises speeds below the minimum, keeps off', (): void => {
+        expect(compensateFanSpeed(actuator, 15, 15, 0, 1000)).toBe(25);
+        expect(compensateFanSpeed(actuator, 0, 15, 25, 1000)).toBe(0);
+    });
+
+    it('keeps the written speed for changes within the quantization', (): void => {
+        expect(compensateFanSpeed(actuator, 52, 52, 50, 1000)).toBe(50);
+        expect(compensateFanSpeed(actuator, 47, 47, 50, 1000)).toBe(50);
+        expect(compensateFanSpeed(actuator, 55, 55, 50, 1000)).toBe(55);
+        expect(compensateFanSpeed(actuator, 100, 100, 98, 1000)).toBe(100);
+    });
+});
+
+describe('Fan actuator profiles', (): void => {
+    let directory: string;
+
+    beforeEach((): void => {
+        directory = fs.mkdtempSync(path.join(os.tmpdir(), 'tcc-fanactuators-'));
+    });
+
+    afterEach((): void => {
+        fs.rmSync(directory, { recursive: true, force: true });
+    });
+
+    it('are stored per model', (): void => {
+        const filePath: string = path.join(directory, 'tcc', 'fanactuators');
+        const result: FanCalibrationResult = {
+            interfaceId: 'uniwill',
+            modelId: '1',
+            durationMs: 1000,
+            fans: [actuator],
+        };
+        expect(storeFanActuatorProfile(filePath, result)).toBe('uniwill:1');
+        expect(storeFanActuatorProfile(filePath, { ...result, interfaceId: 'clevo', modelId: '' })).toBe('clevo');
+
+        expect(loadFanActuatorProfile(filePath, 'uniwill', '1').fans).toEqual([actuator]);
+        expect(loadFanActuatorProfile(filePath, 'uniwill', '2')).toBeUndefined();
+        expect(loadFanActuatorProfile(path.join(directory, 'missing'), 'uniwill', '1')).toBeUndefined();
+        expect(fanActuatorModelKey('clevo', '')).toBe('clevo');
+    });
+});
+
+describe('TuxedoIOAPI fan calibration on a simulated module', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopIoctlSimulation();
+    });
+
+    for (const interfaceName of ['uniwill', 'clevo'] as const) {
+        it(`${interfaceName}: measures the simulated actuator`, async (): Promise<void> => {
+            nativeLib.startIoctlSimulation({
+                interface: interfaceName,
+                fanDeadTimeMs: 20,
+                fanSlewPercentPerSecond: 1000,
+                fanMinimumPercent: 25,
+                fanStepPercent: 5,
+            });
+            const result: FanCalibrationResult = await nativeLib.calibrateFans({
+                fans: [0],
+                pollIntervalMs: 5,
+                stableMs: 60,
+            });
+
+            expect(result.interfaceId).toBe(interfaceName === 'uniwill' ? 'uniwill' : 'clevo_acpi');
+            expect(result.modelId).toBe(interfaceName === 'uniwill' ? '1' : '');
+            expect(result.fans.length).toBe(1);
+            const fan: FanActuatorCharacteristics = result.fans[0];
+            expect(fan.offAvailable).toBe(true);
+            expect(fan.minimumPercent).toBe(25);
+            expect(fan.quantizationPercent).toBe(5);
+            expect(fan.latencyMs).toBeGreaterThanOrEqual(20);
+            expect(fan.latencyMs).toBeLessThan(60);
+            expect(fan.settlingMsPerPercent).toBeLessThan(5);
+            // Up from standstill in 10 percent steps and down again
+            expect(fan.steps.map((step): number => step.commanded)).toEqual([
+                10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 90, 80, 70, 60, 50, 40, 30, 20, 10, 0,
+            ]);
+            expect(fan.steps.every((step): boolean => step.settled)).toBe(true);
+            expect(fan.steps[1].readBack).toBe(0);
+            expect(fan.steps[2].readBack).toBe(30);
+            expect(nativeLib.getIoctlSimulationStats().fansAuto).toBe(true);
+        }, 30000);
+    }
+
+    it('stops at the temperature limit and hands the fans back to the EC', async (): Promise<void> => {
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+        nativeLib.setSimulatedTemperature(1, 95);
+
+        await expectAsync(nativeLib.calibrateFans({ fans: [0], pollIntervalMs: 5, stableMs: 60 }))
+            .toBeRejectedWithError(/temperature limit/);
+        expect(nativeLib.getIoctlSimulationStats().fansAuto).toBe(true);
+    });
+});
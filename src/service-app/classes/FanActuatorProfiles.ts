@@ -0,0 +1,127 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import * as fs from 'node:fs';
+import * as path from 'node:path';
+import type {
+    FanActuatorCharacteristics,
+    FanCalibrationResult,
+    IoctlSimulationOptions,
+} from '../../native-lib/TuxedoIOAPI';
+
+/**
+ * Calibration result of one device model
+ */
+export interface FanActuatorProfile extends FanCalibrationResult {
+    calibratedAt: string;
+}
+
+export type FanActuatorProfiles = { [modelKey: string]: FanActuatorProfile };
+
+// Slow, stepped actuator for calibration runs on a simulated device
+export const SIMULATED_FAN_ACTUATOR: IoctlSimulationOptions = {
+    fanDeadTimeMs: 300,
+    fanSlewPercentPerSecond: 20,
+    fanMinimumPercent: 25,
+    fanStepPercent: 5,
+};
+
+/**
+ * Profiles are keyed by the model id of the device. Clevo devices report
+ * none, they share one profile per interface.
+ */
+export function fanActuatorModelKey(interfaceId: string, modelId: string): string {
+    return modelId !== '' ? `${interfaceId}:${modelId}` : interfaceId;
+}
+
+export function readFanActuatorProfiles(filePath: string): FanActuatorProfiles {
+    try {
+        if (fs.existsSync(filePath)) {
+            return JSON.parse(fs.readFileSync(filePath, 'utf-8'));
+        }
+    } catch (err: unknown) {
+        console.error(`FanActuatorProfiles: readFanActuatorProfiles failed => ${err}`);
+    }
+    return {};
+}
+
+/**
+ * @returns Profile of the model, undefined if it was never calibrated
+ */
+export function loadFanActuatorProfile(
+    filePath: string,
+    interfaceId: string,
+    modelId: string,
+): FanActuatorProfile | undefined {
+    return readFanActuatorProfiles(filePath)[fanActuatorModelKey(interfaceId, modelId)];
+}
+
+/**
+ * Store a calibration result as the profile of its model, replacing an
+ * earlier one
+ *
+ * @returns Key of the stored profile
+ */
+export function storeFanActuatorProfile(filePath: string, result: FanCalibrationResult): string {
+    const profiles: FanActuatorProfiles = readFanActuatorProfiles(filePath);
+    const modelKey: string = fanActuatorModelKey(result.interfaceId, result.modelId);
+    profiles[modelKey] = { ...result, calibratedAt: new Date().toISOString() };
+    fs.mkdirSync(path.dirname(filePath), { recursive: true });
+    fs.writeFileSync(filePath, `${JSON.stringify(profiles, null, 4)}\n`);
+    return modelKey;
+}
+
+/**
+ * Speed to command for a speed calculated by the fan logic, given the
+ * measured actuator of the fan
+ *
+ * - Rising speeds lead by the actuator latency, in worker intervals times
+ *   the rise of the last interval, so the fan gets there when it is needed
+ * - Speeds between off and the minimum are raised to the minimum, the fan
+ *   would stand still otherwise
+ * - Changes smaller than the quantization keep the written speed, the fan
+ *   would not follow them
+ *
+ * @param previousSpeed Calculated speed of the previous interval, -1 if none
+ * @param writtenSpeed Last commanded speed, -1 if none
+ */
+export function compensateFanSpeed(
+    actuator: FanActuatorCharacteristics | undefined,
+    speed: number,
+    previousSpeed: number,
+    writtenSpeed: number,
+    intervalMs: number,
+): number {
+    if (actuator === undefined || speed < 0) {
+        return speed;
+    }
+
+    let compensated: number = speed;
+    if (previousSpeed >= 0 && speed > previousSpeed && actuator.latencyMs > 0) {
+        compensated = Math.min(100, Math.round(speed + ((speed - previousSpeed) * actuator.latencyMs) / intervalMs));
+    }
+    if (compensated > 0 && compensated < actuator.minimumPercent) {
+        compensated = actuator.minimumPercent;
+    }
+    const boundary: boolean = compensated === 0 || compensated === 100 || compensated === actuator.minimumPercent;
+    if (writtenSpeed >= 0 && !boundary && Math.abs(compensated - writtenSpeed) < actuator.quantizationPercent) {
+        return writtenSpeed;
+    }
+    return compensated;
+}
@@ -0,0 +1,209 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import { performance } from 'node:perf_hooks';
+import { delay } from '../../common/classes/Utils';
+import type { ITccProfile } from '../../common/models/TccProfile';
+import { type IoctlSimulationStats, type SimulationEvents, TuxedoIOAPI } from '../../native-lib/TuxedoIOAPI';
+import { FanControlWorker } from './FanControlWorker';
+import { analyzeStepResponse, type FanSpeedSample, type FanStepResponse } from './FanControlStepResponse';
+import type { TuxedoControlCenterDaemon } from './TuxedoControlCenterDaemon';
+
+/**
+ * Temperature change applied to all sensors of the simulated device
+ */
+export interface FanBenchmarkScenario {
+    name: string;
+    fromCelsius: number;
+    toCelsius: number;
+    // 0 for a step
+    rampMs: number;
+    // Observed time from the start of the change
+    durationMs: number;
+}
+
+export const FAN_BENCHMARK_SCENARIOS: FanBenchmarkScenario[] = [
+    { name: 'step-up', fromCelsius: 50, toCelsius: 85, rampMs: 0, durationMs: 30000 },
+    // Falling speeds are rate limited, the settling takes longer
+    { name: 'step-down', fromCelsius: 85, toCelsius: 50, rampMs: 0, durationMs: 60000 },
+    { name: 'ramp-up', fromCelsius: 50, toCelsius: 90, rampMs: 20000, durationMs: 45000 },
+];
+
+export const FAN_BENCHMARK_INTERFACES: ('clevo' | 'uniwill')[] = ['clevo', 'uniwill'];
+
+// Ramps are applied in steps of this period
+const RAMP_STEP_MS: number = 250;
+// Worker intervals at the start temperature before a change, fills the 13 sample temperature filter
+const WARMUP_INTERVALS: number = 15;
+
+export class FanBenchmarkResult {
+    interface: string;
+    scenario: string;
+    fanProfile: string;
+    workerIntervalMs: number;
+    durationMs: number;
+    ioctls: number;
+    ioctlsPerSecond: number;
+    registerAccessesPerSecond: number;
+    // Simulation log overflows, results are incomplete when not 0
+    droppedEvents: number;
+    fans: FanStepResponse[];
+}
+
+/**
+ * Runs the daemon fan control stack (FanControlWorker, temperature sampler,
+ * FanControlLogic and the tuxedo-io fan writes) against a simulated device
+ * and measures how the fans follow temperature changes
+ */
+export class FanControlBenchmark {
+    // Last fan speed per fan as seen in the simulation log
+    private fanSpeeds: Map<number, number> = new Map();
+    private droppedEvents: number = 0;
+
+    constructor(
+        private tccd: TuxedoControlCenterDaemon,
+        private profile: ITccProfile,
+    ) {}
+
+    public async run(
+        interfaces: ('clevo' | 'uniwill')[] = FAN_BENCHMARK_INTERFACES,
+        scenarios: FanBenchmarkScenario[] = FAN_BENCHMARK_SCENARIOS,
+    ): Promise<FanBenchmarkResult[]> {
+        const results: FanBenchmarkResult[] = [];
+        for (const interfaceName of interfaces) {
+            TuxedoIOAPI.startIoctlSimulation({ interface: interfaceName });
+            this.fanSpeeds.clear();
+            this.takeSpeedChanges();
+
+            const worker: FanControlWorker = new FanControlWorker(this.tccd, this.tccd.identifyDevice(), 'tuxedo-io');
+            worker.updateProfile(this.profile);
+            await worker.start();
+            const timer: NodeJS.Timeout = setInterval((): void => {
+                worker
+                    .work()
+                    .catch((err: unknown): void => console.error(`FanControlBenchmark: onWork failed => ${err}`));
+            }, worker.timeout);
+
+            try {
+                for (const scenario of scenarios) {
+                    results.push(await this.runScenario(interfaceName, scenario, worker.timeout));
+                }
+            } finally {
+                clearInterval(timer);
+                await worker.exit();
+                TuxedoIOAPI.stopIoctlSimulation();
+            }
+        }
+        return results;
+    }
+
+    private async runScenario(
+        interfaceName: string,
+        scenario: FanBenchmarkScenario,
+        workerIntervalMs: number,
+    ): Promise<FanBenchmarkResult> {
+        this.setTemperature(scenario.fromCelsius);
+        await delay(WARMUP_INTERVALS * workerIntervalMs);
+        this.takeSpeedChanges();
+        const initialSpeeds: Map<number, number> = new Map(this.fanSpeeds);
+        const statsBefore: IoctlSimulationStats = TuxedoIOAPI.getIoctlSimulationStats();
+        this.droppedEvents = 0;
+
+        // The change is timed by the simulation log, the same clock as the fan speed changes
+        const startMs: number = performance.now();
+        let changeMs: number;
+        const speedChanges: Map<number, FanSpeedSample[]> = new Map();
+        const collect = (): void => {
+            const [changes, firstTemperatureMs] = this.takeSpeedChanges(scenario.fromCelsius);
+            if (changeMs === undefined) {
+                changeMs = firstTemperatureMs;
+            }
+            for (const [fan, samples] of changes) {
+                speedChanges.set(fan, (speedChanges.get(fan) ?? []).concat(samples));
+            }
+        };
+
+        if (scenario.rampMs > 0) {
+            for (let elapsedMs: number = 0; elapsedMs < scenario.rampMs; elapsedMs = performance.now() - startMs) {
+                const progress: number = elapsedMs / scenario.rampMs;
+                this.setTemperature(scenario.fromCelsius + (scenario.toCelsius - scenario.fromCelsius) * progress);
+                await delay(RAMP_STEP_MS);
+                collect();
+            }
+        }
+        this.setTemperature(scenario.toCelsius);
+        await delay(scenario.durationMs - (performance.now() - startMs));
+        collect();
+
+        const statsAfter: IoctlSimulationStats = TuxedoIOAPI.getIoctlSimulationStats();
+        const durationMs: number = performance.now() - startMs;
+        const ioctls: number = statsAfter.transitions - statsBefore.transitions;
+        const registerAccesses: number = statsAfter.registerAccesses - statsBefore.registerAccesses;
+        return {
+            interface: interfaceName,
+            scenario: scenario.name,
+            fanProfile: this.profile.fan?.fanProfile,
+            workerIntervalMs,
+            durationMs: Math.round(durationMs),
+            ioctls,
+            ioctlsPerSecond: ioctls / (durationMs / 1000),
+            registerAccessesPerSecond: registerAccesses / (durationMs / 1000),
+            droppedEvents: this.droppedEvents,
+            fans: Array.from(initialSpeeds.entries()).map(
+                ([fan, initialSpeed]: [number, number]): FanStepResponse =>
+                    analyzeStepResponse(fan, initialSpeed, speedChanges.get(fan) ?? [], changeMs),
+            ),
+        };
+    }
+
+    private setTemperature(temperatureCelsius: number): void {
+        for (let fan: number = 0; fan < 3; fan++) {
+            TuxedoIOAPI.setSimulatedTemperature(fan, Math.round(temperatureCelsius));
+        }
+    }
+
+    /**
+     * Consume the simulation log and keep track of the current fan speeds
+     *
+     * @param baseCelsius Temperature before the change, to find the time of the change
+     * @returns Fan speed changes per fan and the time of the first temperature change away from baseCelsius
+     */
+    private takeSpeedChanges(baseCelsius?: number): [Map<number, FanSpeedSample[]>, number] {
+        const changes: Map<number, FanSpeedSample[]> = new Map();
+        let firstTemperatureMs: number;
+        const log: SimulationEvents = TuxedoIOAPI.takeSimulationEvents();
+        if (log === null) {
+            return [changes, firstTemperatureMs];
+        }
+        this.droppedEvents += log.dropped;
+
+        for (const event of log.events) {
+            if (event.type === 'temperature') {
+                if (firstTemperatureMs === undefined && baseCelsius !== undefined && event.value !== baseCelsius) {
+                    firstTemperatureMs = event.timeMs;
+                }
+                continue;
+            }
+            this.fanSpeeds.set(event.fan, event.value);
+            const sample: FanSpeedSample = { timeMs: event.timeMs, speed: event.value };
+            changes.set(event.fan, (changes.get(event.fan) ?? []).concat([sample]));
+        }
+        return [changes, firstTemperatureMs];
+    }
+}
@@ -217,6 +217,23 @@ export class FanControlLogic {
         }
     }
 
+    /**
+     * Decide the speed again for the reported temperatures, e.g. after the
+     * fan profile values changed
+     *
+     * @returns Speed in percent, -1 before the first reported temperature
+     */
+    public recalculateSpeedPercent(): number {
+        if (this.tempBuffer.getBufferCopy().length === 0) {
+            return -1;
+        }
+        const nextSpeedPercent: number = this.calculateSpeedPercent();
+        if (nextSpeedPercent > -1) {
+            this.latestSpeedPercent = nextSpeedPercent;
+        }
+        return nextSpeedPercent;
+    }
+
     /**
      * Get the speed in percent decided by the logic handler
      */
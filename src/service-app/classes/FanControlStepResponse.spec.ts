@@ -0,0 +1,71 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import { analyzeStepResponse, type FanSpeedSample, type FanStepResponse } from './FanControlStepResponse';
+
+function samples(...points: [number, number][]): FanSpeedSample[] {
+    return points.map(([timeMs, speed]: [number, number]): FanSpeedSample => ({ timeMs, speed }));
+}
+
+describe('Fan step response analysis', (): void => {
+    it('measures latency and settling of a monotonic rise', (): void => {
+        const response: FanStepResponse = analyzeStepResponse(
+            0,
+            20,
+            samples([8000, 35], [9000, 50], [10000, 59], [11000, 60]),
+            1000,
+        );
+        expect(response.initialSpeed).toBe(20);
+        expect(response.finalSpeed).toBe(60);
+        expect(response.latencyMs).toBe(7000);
+        // 59 is within the 2 percent point band around 60
+        expect(response.settlingTimeMs).toBe(9000);
+        expect(response.overshootPercent).toBe(0);
+        expect(response.speedChanges).toBe(4);
+    });
+
+    it('reports overshoot relative to the speed change and settles after it', (): void => {
+        const response: FanStepResponse = analyzeStepResponse(1, 20, samples([3000, 70], [5000, 60]), 0);
+        expect(response.latencyMs).toBe(3000);
+        expect(response.overshootPercent).toBe(25);
+        expect(response.settlingTimeMs).toBe(5000);
+    });
+
+    it('handles falling speeds', (): void => {
+        const response: FanStepResponse = analyzeStepResponse(0, 80, samples([2000, 78], [3000, 76], [4000, 40]), 0);
+        expect(response.latencyMs).toBe(2000);
+        expect(response.finalSpeed).toBe(40);
+        expect(response.overshootPercent).toBe(0);
+        expect(response.settlingTimeMs).toBe(4000);
+    });
+
+    it('ignores changes before the temperature change', (): void => {
+        const response: FanStepResponse = analyzeStepResponse(0, 30, samples([500, 40], [2500, 50]), 1000);
+        expect(response.latencyMs).toBe(1500);
+        expect(response.speedChanges).toBe(1);
+    });
+
+    it('reports no latency when the fan never changes', (): void => {
+        const response: FanStepResponse = analyzeStepResponse(2, 45, [], 1000);
+        expect(response.latencyMs).toBeNull();
+        expect(response.settlingTimeMs).toBe(0);
+        expect(response.finalSpeed).toBe(45);
+    });
+});
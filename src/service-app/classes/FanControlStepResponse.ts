@@ -0,0 +1,91 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Settled means within this many percent points of the final speed ...
+const SETTLING_BAND_MIN_PERCENT: number = 2;
+// ... or within this fraction of the speed change, whichever is wider
+const SETTLING_BAND_FRACTION: number = 0.05;
+
+/**
+ * Fan speed change as seen on the actuator, time since simulation start
+ */
+export interface FanSpeedSample {
+    timeMs: number;
+    speed: number;
+}
+
+export class FanStepResponse {
+    fan: number;
+    initialSpeed: number;
+    finalSpeed: number;
+    // From the temperature change to the first fan speed change, null if the speed never changed
+    latencyMs: number | null;
+    // From the temperature change until the speed stays within the settling band of the final speed
+    settlingTimeMs: number;
+    // Largest excursion beyond the final speed, in percent of the speed change
+    overshootPercent: number;
+    speedChanges: number;
+}
+
+/**
+ * Step response metrics of one fan for a temperature change at changeMs
+ *
+ * @param initialSpeed Fan speed at changeMs
+ * @param samples Fan speed changes after changeMs in order, the last one is the final speed
+ */
+export function analyzeStepResponse(
+    fan: number,
+    initialSpeed: number,
+    samples: FanSpeedSample[],
+    changeMs: number,
+): FanStepResponse {
+    const changes: FanSpeedSample[] = samples.filter((sample: FanSpeedSample): boolean => sample.timeMs >= changeMs);
+    const finalSpeed: number = changes.length > 0 ? changes[changes.length - 1].speed : initialSpeed;
+    const step: number = finalSpeed - initialSpeed;
+    const band: number = Math.max(SETTLING_BAND_MIN_PERCENT, Math.abs(step) * SETTLING_BAND_FRACTION);
+
+    const firstChange: FanSpeedSample = changes.find(
+        (sample: FanSpeedSample): boolean => sample.speed !== initialSpeed,
+    );
+
+    let settledMs: number = Math.abs(initialSpeed - finalSpeed) <= band ? changeMs : undefined;
+    let peak: number = 0;
+    for (const sample of changes) {
+        if (Math.abs(sample.speed - finalSpeed) <= band) {
+            if (settledMs === undefined) {
+                settledMs = sample.timeMs;
+            }
+        } else {
+            settledMs = undefined;
+        }
+        if (step !== 0) {
+            peak = Math.max(peak, (sample.speed - finalSpeed) * Math.sign(step));
+        }
+    }
+
+    return {
+        fan,
+        initialSpeed,
+        finalSpeed,
+        latencyMs: firstChange !== undefined ? firstChange.timeMs - changeMs : null,
+        settlingTimeMs: (settledMs ?? changeMs) - changeMs,
+        overshootPercent: step !== 0 ? (peak / Math.abs(step)) * 100 : 0,
+        speedChanges: changes.length,
+    };
+}
@@ -17,11 +17,19 @@
  * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+import type { ITccFanProfile } from '../../common/models/TccFanTable';
+import type { ITccProfile } from '../../common/models/TccProfile';
 import type { ObjWrapper } from '../../native-lib/TuxedoIOAPI';
-import { TuxedoIOAPI as ioAPI } from '../../native-lib/TuxedoIOAPI';
+import { TelemetrySnapshot, TuxedoIOAPI as ioAPI } from '../../native-lib/TuxedoIOAPI';
 import { FanControlBaseClass } from './FanControlBaseClass';
 import { FAN_LOGIC } from './FanControlLogic';
 
+// Values of the scheduler wakeup older than one FanControlWorker period are not used
+const SCHEDULED_READ_MAX_AGE_NS: number = 1000 * 1000 * 1000;
+// Sensors are sampled at least once per FanControlWorker period, older samples are not used
+const SAMPLER_MIN_INTERVAL_MS: number = 100;
+const SAMPLER_MAX_INTERVAL_MS: number = 1000;
+
 export class FanControlTuxedoIO extends FanControlBaseClass {
     public async initFanControl(fanWriteAvailable: boolean, fanControlEnabled: boolean): Promise<void> {
         if (fanWriteAvailable) {
@@ -35,6 +43,11 @@ export class FanControlTuxedoIO extends FanControlBaseClass {
                 console.log('FanControlTuxedoIO: Enabling automatic mode');
             }
 
+            // Temperatures are read on the sampler thread, the worker only picks up the latest sample
+            if (!ioAPI.getSamplerStats().running && !ioAPI.startSensorSampler(SAMPLER_MIN_INTERVAL_MS, SAMPLER_MAX_INTERVAL_MS)) {
+                console.log('FanControlTuxedoIO: Temperature sampler not available');
+            }
+
             this.tccd.dbusData.fansOffAvailable = ioAPI.getFansOffAvailable();
             this.tccd.dbusData.fansMinSpeed = ioAPI.getFansMinSpeed();
         } else {
@@ -92,7 +105,9 @@ export class FanControlTuxedoIO extends FanControlBaseClass {
 
     public async getFanSpeedPercent(fanIndex: number): Promise<number> {
         const currentSpeedPercent: ObjWrapper<number> = { value: -1 };
-        const speedReadSuccess: boolean = ioAPI.getFanSpeedPercent(fanIndex, currentSpeedPercent);
+        const speedReadSuccess: boolean =
+            this.getScheduledRead(fanIndex, 'speedPercent', currentSpeedPercent) ||
+            ioAPI.getFanSpeedPercent(fanIndex, currentSpeedPercent);
 
         if (!speedReadSuccess) {
             console.log(`FanControlTuxedoIO: Fan speed read with IO API index ${fanIndex} failed`);
@@ -103,7 +118,10 @@ export class FanControlTuxedoIO extends FanControlBaseClass {
 
     public async getFanTemperature(fanIndex: number, logging?: boolean): Promise<number> {
         const currentTemperatureCelcius: ObjWrapper<number> = { value: -1 };
-        const tempReadSuccess: boolean = ioAPI.getFanTemperature(fanIndex, currentTemperatureCelcius);
+        const tempReadSuccess: boolean =
+            ioAPI.getSampledFanTemperature(fanIndex, currentTemperatureCelcius) ||
+            this.getScheduledRead(fanIndex, 'temperature', currentTemperatureCelcius) ||
+            ioAPI.getFanTemperature(fanIndex, currentTemperatureCelcius);
 
         if (!tempReadSuccess && (logging ?? true)) {
             console.log(`FanControlTuxedoIO: Fan temperature read with IO API index ${fanIndex} failed`);
@@ -112,6 +130,33 @@ export class FanControlTuxedoIO extends FanControlBaseClass {
         return currentTemperatureCelcius.value;
     }
 
+    /**
+     * Value read natively in the scheduler wakeup of the current run
+     *
+     * @returns False without native scheduling or if the read is not recent
+     */
+    private getScheduledRead(
+        fanIndex: number,
+        value: 'temperature' | 'speedPercent',
+        result: ObjWrapper<number>,
+    ): boolean {
+        if (!this.tccd?.nativeScheduling) {
+            return false;
+        }
+        const telemetry: TelemetrySnapshot = new TelemetrySnapshot();
+        ioAPI.getTelemetry(telemetry);
+        const fan: TelemetrySnapshot['fans'][number] = telemetry.fans?.[fanIndex];
+        if (fan === undefined) {
+            return false;
+        }
+        const updatedNs: number = value === 'temperature' ? fan.temperatureUpdatedNs : fan.speedUpdatedNs;
+        if (!(updatedNs > 0) || Number(process.hrtime.bigint()) - updatedNs > SCHEDULED_READ_MAX_AGE_NS) {
+            return false;
+        }
+        result.value = fan[value];
+        return true;
+    }
+
     public async writeFanSpeed(fanIndex: number, calculatedSpeed: number): Promise<void> {
         const speedWriteSuccess: boolean = ioAPI.setFanSpeedPercent(fanIndex, calculatedSpeed);
 
@@ -135,7 +180,16 @@ export class FanControlTuxedoIO extends FanControlBaseClass {
         return [wmiStatus, wmiStatus];
     }
 
+    public async setFanProfileValues(activeProfile: ITccProfile, currentFanProfile: ITccFanProfile): Promise<void> {
+        await super.setFanProfileValues(activeProfile, currentFanProfile);
+        // Same logic mapping as mapLogicToFans: first fan CPU, others GPU
+        ioAPI.setSamplerFanTable(0, currentFanProfile.tableCPU ?? []);
+        ioAPI.setSamplerFanTable(1, currentFanProfile.tableGPU ?? []);
+        ioAPI.setSamplerFanTable(2, currentFanProfile.tableGPU ?? []);
+    }
+
     public async exit(): Promise<void> {
+        ioAPI.stopSensorSampler();
         ioAPI.setFansAuto(); // required to avoid high fan speed on wakeup for certain devices
         ioAPI.setEnableModeSet(false);
         console.log('FanControlTuxedoIO: Enabling automatic mode');
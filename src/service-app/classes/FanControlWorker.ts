@@ -17,11 +17,19 @@
  * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+import { TccPaths } from '../../common/classes/TccPaths';
 import type { TUXEDODevice } from '../../common/models/DefaultProfiles';
 import { FanData } from '../../common/models/IFanData';
 import type { ITccFanProfile, ITccFanTableEntry } from '../../common/models/TccFanTable';
-import { ModuleInfo, TuxedoIOAPI } from '../../native-lib/TuxedoIOAPI';
+import type { ITccProfile } from '../../common/models/TccProfile';
+import {
+    type FanActuatorCharacteristics,
+    ModuleInfo,
+    type ProfileApplyRequest,
+    TuxedoIOAPI,
+} from '../../native-lib/TuxedoIOAPI';
 import { DaemonWorker } from './DaemonWorker';
+import { compensateFanSpeed, type FanActuatorProfile, loadFanActuatorProfile } from './FanActuatorProfiles';
 import type { FanControlBaseClass } from './FanControlBaseClass';
 import type { FanControlLogic } from './FanControlLogic';
 import { FanControlPwm } from './FanControlPwm';
@@ -45,6 +53,10 @@ export class FanControlWorker extends DaemonWorker {
         tableGPU: [],
     };
     private previousTempValues: Map<number, number> = new Map();
+    // Speeds calculated by the fan logic, before the actuator compensation
+    private previousCalculatedSpeeds: Map<number, number> = new Map();
+    // Calibration of this model from tccd --calibrate-fans, if any
+    private actuatorProfile: FanActuatorProfile;
     private retryFanInitCounter: number = 5;
     private dbusData: {
         fans: {
@@ -75,7 +87,15 @@ export class FanControlWorker extends DaemonWorker {
 
     private nrTempsAvailable: number;
 
-    constructor(tccd: TuxedoControlCenterDaemon, tuxedoDevice: TUXEDODevice) {
+    /**
+     * @param fanApiName Only try this fan API, e.g. to stay on a simulated
+     * tuxedo-io device in the fan benchmark
+     */
+    constructor(
+        tccd: TuxedoControlCenterDaemon,
+        tuxedoDevice: TUXEDODevice,
+        private fanApiName?: 'tuxi' | 'pwm' | 'tuxedo-io',
+    ) {
         super(1000, 'FanControlWorker', tccd);
         this.tuxedoDevice = tuxedoDevice;
         this.updateDbusData();
@@ -99,10 +119,15 @@ export class FanControlWorker extends DaemonWorker {
             ];
 
             for (const { class: fanClass, name } of fanControlClasses) {
+                if (this.fanApiName !== undefined && name !== this.fanApiName) {
+                    continue;
+                }
                 this.fanApi = fanClass;
                 if (await this.initializeFanControl(this.fanApi, name)) {
                     if (name === 'tuxedo-io') {
                         this.setActiveInterface();
+                        // Picked up from the telemetry by FanControlTuxedoIO under native scheduling
+                        this.hardwareReads = ['temperatures', 'fanSpeeds'];
                     }
                     return;
                 }
@@ -113,6 +138,17 @@ export class FanControlWorker extends DaemonWorker {
         }
     }
 
+    /**
+     * tuxedo-io became available after start, e.g. the module loaded late
+     */
+    public async onTuxedoIOAvailable(): Promise<void> {
+        if (this.fanApi instanceof FanControlTuxedoIO) {
+            this.setActiveInterface();
+        } else if (!this.fanApi) {
+            await this.onStart();
+        }
+    }
+
     private setActiveInterface() {
         // todo: tuxedo-drivers currently has 2 issues
         // - ec does set a different fan speed after one or more hours
@@ -131,6 +167,16 @@ export class FanControlWorker extends DaemonWorker {
             }
 
             this.isUniwill = modInfo.activeInterface === 'uniwill';
+            this.actuatorProfile = loadFanActuatorProfile(
+                TccPaths.FAN_ACTUATORS_FILE,
+                modInfo.activeInterface,
+                modInfo.model,
+            );
+            if (this.actuatorProfile !== undefined) {
+                console.log(
+                    `FanControlWorker: setActiveInterface: Using fan calibration of ${this.actuatorProfile.calibratedAt}`,
+                );
+            }
         } else {
             console.error('FanControlWorker: setActiveInterface: wmi not available');
         }
@@ -195,11 +241,47 @@ export class FanControlWorker extends DaemonWorker {
         return false;
     }
 
+    /**
+     * Fan part of a native profile application, only defined when the fans
+     * are driven through tuxedo-io. The speeds are decided by the fan logic
+     * with the values of the new profile, all fans get the highest speed
+     * like in the regular work interval.
+     */
+    public async getProfileApplyRequest(profile: ITccProfile): Promise<ProfileApplyRequest> {
+        if (!(this.fanApi instanceof FanControlTuxedoIO) || !this.fanWriteAvailable) {
+            return {};
+        }
+        if (!this.tccd.settings.fanControlEnabled) {
+            return { fanMode: 'auto' };
+        }
+
+        const fanProfile: ITccFanProfile =
+            profile.fan.fanProfile === 'Custom'
+                ? await getCurrentCustomProfile(profile)
+                : this.tccd.getCurrentFanProfile(profile);
+        await this.fanApi.setFanProfileValues(profile, fanProfile);
+
+        const fans: Map<number, FanControlLogic> = await this.fanApi.getFans();
+        const speeds: number[] = Array.from(fans.values()).map((fanLogic: FanControlLogic): number =>
+            fanLogic.recalculateSpeedPercent(),
+        );
+        const maxSpeed: number = Math.max(-1, ...speeds);
+        if (maxSpeed < 0) {
+            return { fanMode: 'manual' };
+        }
+        const fanSpeeds: number[] = [];
+        for (const fanNumber of fans.keys()) {
+            fanSpeeds[fanNumber - 1] = maxSpeed;
+        }
+        return { fanMode: 'manual', fanSpeeds: Array.from(fanSpeeds, (speed: number): number => speed ?? -1) };
+    }
+
     private async setPreviousFans(): Promise<void> {
         const numberInterfaces: number = await this.fanApi.getNumberFanInterfaces();
 
         for (let i: number = 0; i <= numberInterfaces; i++) {
             this.previousTempValues.set(i, -1);
+            this.previousCalculatedSpeeds.set(i, -1);
         }
     }
 
@@ -323,12 +405,24 @@ export class FanControlWorker extends DaemonWorker {
         if (!fanLogic) return;
 
         if (this.tccd.settings.fanControlEnabled) {
-            if (
-                (this.isUniwill && calculatedSpeed > -1) ||
-                (this.previousTempValues.get(fanIndex) !== calculatedSpeed && calculatedSpeed > -1)
-            ) {
-                await this.fanApi.writeFanSpeed(fanIndex, calculatedSpeed);
-                this.previousTempValues.set(fanIndex, calculatedSpeed);
+            // Calibrations only exist for tuxedo-io
+            const speed: number =
+                this.fanApi instanceof FanControlTuxedoIO
+                    ? compensateFanSpeed(
+                          this.actuatorProfile?.fans.find(
+                              (fan: FanActuatorCharacteristics): boolean => fan.fan === fanIndex,
+                          ),
+                          calculatedSpeed,
+                          this.previousCalculatedSpeeds.get(fanIndex) ?? -1,
+                          this.previousTempValues.get(fanIndex) ?? -1,
+                          this.timeout,
+                      )
+                    : calculatedSpeed;
+            this.previousCalculatedSpeeds.set(fanIndex, calculatedSpeed);
+
+            if ((this.isUniwill && speed > -1) || (this.previousTempValues.get(fanIndex) !== speed && speed > -1)) {
+                await this.fanApi.writeFanSpeed(fanIndex, speed);
+                this.previousTempValues.set(fanIndex, speed);
             }
         }
     }
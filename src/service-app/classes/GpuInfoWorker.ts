@@ -26,12 +26,21 @@ import { PowerController } from '../../common/classes/PowerController';
 import { SysFsPropertyInteger, SysFsPropertyString } from '../../common/classes/SysFsProperties';
 import { countLines, execCommandAsync } from '../../common/classes/Utils';
 import type { IdGpuInfo, IiGpuInfo } from '../../common/models/TccGpuValues';
+import { GpuQuerySnapshot, TuxedoIOAPI } from '../../native-lib/TuxedoIOAPI';
 import { DaemonWorker } from './DaemonWorker';
 import type { TuxedoControlCenterDaemon } from './TuxedoControlCenterDaemon';
 
-export class GpuInfoWorker extends DaemonWorker {
-    private isNvidiaSmiInstalled: boolean = undefined;
+// Fields of the streaming nvidia-smi query, it only runs while dGPU metrics are used
+const NVIDIA_GPU_QUERY_FIELDS: string[] = [
+    'power.draw',
+    'power.max_limit',
+    'enforced.power.limit',
+    'clocks.gr',
+    'clocks.max.gr',
+];
+const NVIDIA_GPU_QUERY_INTERVAL_MS: number = 2000;
 
+export class GpuInfoWorker extends DaemonWorker {
     private amdIGpuHwmonPath: string;
     private amdDGpuHwmonPath: string;
 
@@ -44,6 +53,8 @@ export class GpuInfoWorker extends DaemonWorker {
     private hwmonIGpuRetryCount: number = 3;
     private hwmonDGpuRetryCount: number = 3;
 
+    private nvidiaGpuQueryUnavailable: boolean = false;
+
     constructor(
         public tccd: TuxedoControlCenterDaemon,
         private availability: AvailabilityService,
@@ -59,11 +70,7 @@ export class GpuInfoWorker extends DaemonWorker {
             this.intelIGpuDrmPath = await this.getIntelIGpuDrmPath();
         }
 
-        if (this.availability.getNvidiaDGpuCount() === 1) {
-            if (this.isNvidiaSmiInstalled === undefined) {
-                this.isNvidiaSmiInstalled = await this.checkNvidiaSmiInstalled();
-            }
-        } else if (this.availability.getAmdDGpuCount() === 1) {
+        if (this.availability.getNvidiaDGpuCount() !== 1 && this.availability.getAmdDGpuCount() === 1) {
             this.amdDGpuHwmonPath = await this.getAmdDGpuHwmonPath();
         }
 
@@ -74,6 +81,8 @@ export class GpuInfoWorker extends DaemonWorker {
     }
 
     public async onWork(): Promise<void> {
+        this.updateNvidiaGpuQuery(this.tccd.dbusData.sensorDataCollectionStatus && this.tccd.dbusData.d0MetricsUsage);
+
         if (this.tccd.dbusData.sensorDataCollectionStatus) {
             await Promise.all([this.getIGPUValues(), this.getDGPUValues()]);
         } else {
@@ -82,7 +91,29 @@ export class GpuInfoWorker extends DaemonWorker {
         }
     }
 
-    public async onExit(): Promise<void> {}
+    public async onExit(): Promise<void> {
+        TuxedoIOAPI.stopGpuQuery();
+    }
+
+    /**
+     * Polling nvidia-smi keeps the dGPU out of D3cold, the query is started and
+     * stopped together with the dGPU metrics usage
+     */
+    private updateNvidiaGpuQuery(enabled: boolean): void {
+        if (this.availability.getNvidiaDGpuCount() !== 1 || this.nvidiaGpuQueryUnavailable) {
+            return;
+        }
+
+        const running: boolean = TuxedoIOAPI.getGpuQuerySnapshot(new GpuQuerySnapshot());
+        if (enabled && !running) {
+            if (!TuxedoIOAPI.startGpuQuery(NVIDIA_GPU_QUERY_FIELDS, NVIDIA_GPU_QUERY_INTERVAL_MS)) {
+                this.nvidiaGpuQueryUnavailable = true;
+                console.log('GpuInfoWorker: nvidia-smi not available, no NVIDIA GPU values');
+            }
+        } else if (!enabled && running) {
+            TuxedoIOAPI.stopGpuQuery();
+        }
+    }
 
     private async getIntelIGpuDrmPath(): Promise<string | undefined> {
         const intelIGpuDevices: string = await execCommandAsync(
@@ -192,7 +223,7 @@ export class GpuInfoWorker extends DaemonWorker {
         const metricsUsage: boolean = this.tccd.dbusData.d0MetricsUsage;
 
         if (nvidiaDevices === 1 && metricsUsage) {
-            dGpuValues = await this.getNvidiaDGPUValues();
+            dGpuValues = this.getNvidiaDGpuPowerValues();
         } else if (amdDGpuDevices === 1 && metricsUsage) {
             if (this.amdDGpuHwmonPath || this.checkAmdDGpuHwmonPath()) {
                 dGpuValues = await this.getAmdDGpuValues(dGpuValues);
@@ -204,57 +235,31 @@ export class GpuInfoWorker extends DaemonWorker {
         this.tccd.dbusData.dGpuInfoValuesJSON = JSON.stringify(dGpuValues);
     }
 
-    private async getNvidiaDGPUValues(): Promise<IdGpuInfo> {
-        return await this.getNvidiaDGpuPowerValues();
-    }
-
-    private async checkNvidiaSmiInstalled(): Promise<boolean> {
-        try {
-            const stdout: string = await execCommandAsync('which nvidia-smi');
-            return stdout?.trim()?.length > 0;
-        } catch (err: unknown) {
-            console.error(`GpuInfoWorker: checkNvidiaSmiInstalled: ${err}`);
-            return false;
+    /**
+     * Latest values of the streaming nvidia-smi query, the first sample arrives
+     * one interval after the query was started
+     */
+    private getNvidiaDGpuPowerValues(): IdGpuInfo {
+        const snapshot: GpuQuerySnapshot = new GpuQuerySnapshot();
+        if (!TuxedoIOAPI.getGpuQuerySnapshot(snapshot) || snapshot.gpus.length === 0) {
+            return this.getDefaultValuesDGpu();
         }
-    }
-
-    private async getNvidiaDGpuPowerValues(): Promise<IdGpuInfo> {
-        const command =
-            'nvidia-smi --query-gpu=power.draw,power.max_limit,enforced.power.limit,clocks.gr,clocks.max.gr --format=csv,noheader';
 
-        try {
-            const stdout: string = await execCommandAsync(command);
-            const gpuInfo: IdGpuInfo = this.parseOutput(stdout);
-            return gpuInfo;
-        } catch (err: unknown) {
-            console.error(`GpuInfoWorker: getNvidiaDGpuPowerValues failed => ${err}`);
+        // Older values mean the child hangs or is being restarted
+        const gpu: GpuQuerySnapshot['gpus'][number] = snapshot.gpus[0];
+        if (gpu.ageMs > 3 * NVIDIA_GPU_QUERY_INTERVAL_MS) {
             return this.getDefaultValuesDGpu();
         }
-    }
-
-    private parseOutput(output: string): IdGpuInfo {
-        const [powerDraw, maxPowerLimit, enforcedPowerLimit, coreFrequency, maxCoreFrequency] = output
-            .split(',')
-            .map((value: string): number => this.parseNumberWithMetric(value.trim()));
 
         return {
-            powerDraw,
-            maxPowerLimit,
-            enforcedPowerLimit,
-            coreFrequency,
-            maxCoreFrequency,
+            powerDraw: gpu.values['power.draw'],
+            maxPowerLimit: gpu.values['power.max_limit'],
+            enforcedPowerLimit: gpu.values['enforced.power.limit'],
+            coreFrequency: gpu.values['clocks.gr'],
+            maxCoreFrequency: gpu.values['clocks.max.gr'],
         };
     }
 
-    private parseNumberWithMetric(value: string): number {
-        const numberRegex = /(\d+(\.\d+)?)/;
-        const match: RegExpExecArray = numberRegex.exec(value);
-        if (match !== null) {
-            return Number(match[0]);
-        }
-        return -1;
-    }
-
     private async getAmdDGpuValues(dGpuValues: IdGpuInfo): Promise<IdGpuInfo> {
         const amdDGpuHwmonPath: string = this.amdDGpuHwmonPath;
 
@@ -25,6 +25,7 @@ import {
     KeyboardBacklightColorModes,
     type KeyboardBacklightStateInterface,
 } from '../../common/models/TccSettings';
+import { TuxedoIOAPI } from '../../native-lib/TuxedoIOAPI';
 import type { TuxedoControlCenterDaemon } from './TuxedoControlCenterDaemon';
 
 export class KeyboardBacklightListener {
@@ -41,6 +42,9 @@ export class KeyboardBacklightListener {
     protected sysDBusUPowerProps: dbus.ClientInterface = {} as dbus.ClientInterface;
     protected sysDBusUPowerKbdBacklightInterface: dbus.ClientInterface = {} as dbus.ClientInterface;
     protected onStartRetryCount: number = 5;
+    // RGB LEDs written through the addon's frame writer instead of fs
+    protected nativeLeds: boolean = false;
+    protected animating: boolean = false;
 
     constructor(private tccd: TuxedoControlCenterDaemon) {
         this.init();
@@ -59,6 +63,12 @@ export class KeyboardBacklightListener {
         }
 
         if (this.keyboardBacklightCapabilities?.zones !== undefined) {
+            if (this.keyboardBacklightCapabilities.maxRed !== undefined) {
+                this.nativeLeds = TuxedoIOAPI.openKeyboardLeds(
+                    this.ledsRGBZones.slice(0, this.keyboardBacklightCapabilities.zones),
+                );
+            }
+
             // Init state in settings if not yet done or anything is wonky
             if (this.keyboardBacklightCapabilities.zones !== this.tccd.settings.keyboardBacklightStates?.length) {
                 this.tccd.settings.keyboardBacklightStates = [];
@@ -171,6 +181,13 @@ export class KeyboardBacklightListener {
                             fs.watch(
                                 `${this.ledsRGBZones[i]}/multi_intensity`,
                                 async function (): Promise<void> {
+                                    // Own animation frames, not a change from outside
+                                    if (this.animating) {
+                                        return;
+                                    }
+                                    if (this.nativeLeds) {
+                                        TuxedoIOAPI.invalidateKeyboardFrame();
+                                    }
                                     if (
                                         !(await this.sysDBusUPowerProps.Get('org.freedesktop.UPower', 'LidIsClosed'))
                                             .value
@@ -353,27 +370,10 @@ export class KeyboardBacklightListener {
                 }
             }
 
-            if (this.ledsRGBZones?.length > 0) {
-                this.setBufferInput(this.ledsRGBZones[0], true);
-            }
-            for (let i: number = 0; i < this.ledsRGBZones?.length; ++i) {
-                if (this.ledsRGBZones[i]) {
-                    if (await fileOKAsync(`${this.ledsRGBZones[i]}/multi_intensity`)) {
-                        if (keyboardBacklightStatesNew?.[i]) {
-                            const red: string = keyboardBacklightStatesNew[i].red.toString();
-                            const green: string = keyboardBacklightStatesNew[i].green.toString();
-                            const blue: string = keyboardBacklightStatesNew[i].blue.toString();
-
-                            await fs.promises.appendFile(
-                                `${this.ledsRGBZones[i]}/multi_intensity`,
-                                `${red} ${green} ${blue}`,
-                            );
-                        }
-                    }
-                }
-            }
-            if (this.ledsRGBZones?.length > 0) {
-                this.setBufferInput(this.ledsRGBZones[0], false);
+            if (this.nativeLeds) {
+                this.writeNativeKeyboardLeds(keyboardBacklightStatesNew);
+            } else {
+                await this.writeKeyboardLeds(keyboardBacklightStatesNew);
             }
         }
 
@@ -386,4 +386,51 @@ export class KeyboardBacklightListener {
             this.tccd.dbusData.keyboardBacklightStatesJSON = JSON.stringify(keyboardBacklightStatesNew);
         }
     }
+
+    /**
+     * One frame with the color of every zone or key, only changed LEDs are
+     * written. The breathing mode runs as native animation.
+     */
+    private writeNativeKeyboardLeds(keyboardBacklightStatesNew: Array<KeyboardBacklightStateInterface>): void {
+        const colors: number[] = [];
+        for (let i: number = 0; i < this.keyboardBacklightCapabilities.zones && keyboardBacklightStatesNew?.[i]; ++i) {
+            colors.push(
+                keyboardBacklightStatesNew[i].red,
+                keyboardBacklightStatesNew[i].green,
+                keyboardBacklightStatesNew[i].blue,
+            );
+        }
+
+        this.animating =
+            keyboardBacklightStatesNew?.[0]?.mode === KeyboardBacklightColorModes.breathing &&
+            TuxedoIOAPI.startKeyboardAnimation({ effect: 'breathe', colors });
+        if (!this.animating) {
+            TuxedoIOAPI.writeKeyboardFrame(Uint8Array.from(colors));
+        }
+    }
+
+    private async writeKeyboardLeds(keyboardBacklightStatesNew: Array<KeyboardBacklightStateInterface>): Promise<void> {
+        if (this.ledsRGBZones?.length > 0) {
+            this.setBufferInput(this.ledsRGBZones[0], true);
+        }
+        for (let i: number = 0; i < this.ledsRGBZones?.length; ++i) {
+            if (this.ledsRGBZones[i]) {
+                if (await fileOKAsync(`${this.ledsRGBZones[i]}/multi_intensity`)) {
+                    if (keyboardBacklightStatesNew?.[i]) {
+                        const red: string = keyboardBacklightStatesNew[i].red.toString();
+                        const green: string = keyboardBacklightStatesNew[i].green.toString();
+                        const blue: string = keyboardBacklightStatesNew[i].blue.toString();
+
+                        await fs.promises.appendFile(
+                            `${this.ledsRGBZones[i]}/multi_intensity`,
+                            `${red} ${green} ${blue}`,
+                        );
+                    }
+                }
+            }
+        }
+        if (this.ledsRGBZones?.length > 0) {
+            this.setBufferInput(this.ledsRGBZones[0], false);
+        }
+    }
 }
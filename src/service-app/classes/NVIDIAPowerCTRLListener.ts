@@ -18,19 +18,24 @@
  */
 
 import { SysFsPropertyInteger } from '../../common/classes/SysFsProperties';
-import { execCommandSync } from '../../common/classes/Utils';
+import { type GpuQuerySnapshot, TuxedoIOAPI } from '../../native-lib/TuxedoIOAPI';
 import { DaemonListener } from './DaemonListener';
 import type { TuxedoControlCenterDaemon } from './TuxedoControlCenterDaemon';
 
+const NVIDIA_POWER_LIMIT_QUERY_TIMEOUT_MS: number = 10000;
+
 export class NVIDIAPowerCTRLListener extends DaemonListener {
     private ctgpOffsetPath: string = '/sys/devices/platform/tuxedo_nvidia_power_ctrl/ctgp_offset';
     private ctgpOffsetSysfsProp: SysFsPropertyInteger = new SysFsPropertyInteger(this.ctgpOffsetPath);
-    private ctgpAvailable: boolean = this.ctgpOffsetSysfsProp.isAvailable() && this.checkNvidiaSmiInstalled();
+    // Set once nvidia-smi answered the power limit query
+    private ctgpAvailable: boolean = false;
 
     constructor(tccd: TuxedoControlCenterDaemon) {
         super(tccd);
 
-        this.init();
+        this.init().catch((err: unknown): void => {
+            console.error(`NVIDIAPowerCTRLListener: init failed => ${err}`);
+        });
     }
 
     public onActiveProfileChanged(): void {
@@ -41,10 +46,24 @@ export class NVIDIAPowerCTRLListener extends DaemonListener {
         this.applyActiveProfile();
     }
 
-    private init(): void {
-        if (!this.ctgpAvailable) {
+    /**
+     * Power limits come from a single nvidia-smi query on the thread pool, a
+     * failing query also means nvidia-smi is not installed
+     */
+    private async init(): Promise<void> {
+        if (!this.ctgpOffsetSysfsProp.isAvailable()) {
+            return;
+        }
+
+        const snapshot: GpuQuerySnapshot = await TuxedoIOAPI.queryGpuOnce(
+            ['power.default_limit', 'power.max_limit'],
+            NVIDIA_POWER_LIMIT_QUERY_TIMEOUT_MS,
+        );
+        if (snapshot === null) {
+            console.log('NVIDIAPowerCTRLListener: nvidia-smi not available');
             return;
         }
+        this.ctgpAvailable = true;
 
         this.ctgpOffsetSysfsProp.setFSWatchListener(
             function (event: 'rename' | 'change', _filename: string): void {
@@ -61,68 +80,28 @@ export class NVIDIAPowerCTRLListener extends DaemonListener {
 
         this.applyActiveProfile();
 
-        try {
-            const defaultPowerLimit: number = this.getDefaultPowerLimit();
-            const maxPowerLimit: number = this.getMaxPowerLimit();
-
-            if (defaultPowerLimit && maxPowerLimit) {
-                this.tccd.dbusData.nvidiaPowerCTRLAvailable = true;
-                this.tccd.dbusData.nvidiaPowerCTRLDefaultPowerLimit = defaultPowerLimit;
-                this.tccd.dbusData.nvidiaPowerCTRLMaxPowerLimit = maxPowerLimit;
-            } else {
-                this.tccd.dbusData.nvidiaPowerCTRLAvailable = false;
-                this.tccd.dbusData.nvidiaPowerCTRLDefaultPowerLimit = -1;
-                this.tccd.dbusData.nvidiaPowerCTRLMaxPowerLimit = -1;
-            }
-        } catch (err: unknown) {
-            console.error(`NVIDIAPowerCTRLListener: init failed => ${err}`);
-        }
-    }
-
-    public getDefaultPowerLimit(): number {
-        try {
-            const defaultPowerLimit: string = execCommandSync(
-                'nvidia-smi --format=csv,noheader,nounits --query-gpu=power.default_limit',
-            );
-
-            if (defaultPowerLimit) {
-                return Number(defaultPowerLimit);
-            }
-
-            console.log('NVIDIAPowerCTRLListener: Default nvidia power limit not available');
-            return undefined;
-        } catch (err: unknown) {
-            console.log(`NVIDIAPowerCTRLListener: getDefaultPowerLimit failed => ${err}`);
-            return undefined;
+        const defaultPowerLimit: number = this.getPowerLimit(snapshot, 'power.default_limit');
+        const maxPowerLimit: number = this.getPowerLimit(snapshot, 'power.max_limit');
+
+        if (defaultPowerLimit && maxPowerLimit) {
+            this.tccd.dbusData.nvidiaPowerCTRLAvailable = true;
+            this.tccd.dbusData.nvidiaPowerCTRLDefaultPowerLimit = defaultPowerLimit;
+            this.tccd.dbusData.nvidiaPowerCTRLMaxPowerLimit = maxPowerLimit;
+        } else {
+            this.tccd.dbusData.nvidiaPowerCTRLAvailable = false;
+            this.tccd.dbusData.nvidiaPowerCTRLDefaultPowerLimit = -1;
+            this.tccd.dbusData.nvidiaPowerCTRLMaxPowerLimit = -1;
         }
     }
 
-    public getMaxPowerLimit(): number {
-        try {
-            const maxPowerLimit: string = execCommandSync(
-                'nvidia-smi --format=csv,noheader,nounits --query-gpu=power.max_limit',
-            );
-
-            if (maxPowerLimit) {
-                return Number(maxPowerLimit);
-            }
-
-            console.log('NVIDIAPowerCTRLListener: Maximum nvidia power limit not available');
-            return undefined;
-        } catch (err: unknown) {
-            console.log(`NVIDIAPowerCTRLListener: getMaxPowerLimit failed => ${err}`);
-            return undefined;
+    private getPowerLimit(snapshot: GpuQuerySnapshot, field: string): number {
+        const powerLimit: number = snapshot.gpus[0]?.values[field];
+        if (powerLimit !== undefined && powerLimit > 0) {
+            return powerLimit;
         }
-    }
 
-    private checkNvidiaSmiInstalled(): boolean {
-        try {
-            const stdout: string = execCommandSync('which nvidia-smi');
-            return stdout?.trim()?.length > 0;
-        } catch (err: unknown) {
-            console.error(`NVIDIAPowerCTRLListener: checkNvidiaSmiInstalled failed => ${err}`);
-            return false;
-        }
+        console.log(`NVIDIAPowerCTRLListener: nvidia ${field} not available`);
+        return undefined;
     }
 
     private applyActiveProfile(): void {
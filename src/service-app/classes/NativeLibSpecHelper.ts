@@ -0,0 +1,70 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import * as fs from 'node:fs';
+import * as path from 'node:path';
+
+import type { ITuxedoIOAPI, TelemetrySnapshot } from '../../native-lib/TuxedoIOAPI';
+
+/**
+ * Path of the addon as built by build-native-*, undefined if it is not built
+ */
+export function findNativeLib(): string | undefined {
+    for (const buildType of ['Release', 'Debug']) {
+        const addonPath: string = path.resolve(__dirname, '../../../build', buildType, 'TuxedoIOAPI.node');
+        if (fs.existsSync(addonPath)) {
+            return addonPath;
+        }
+    }
+    return undefined;
+}
+
+export function loadNativeLib(): ITuxedoIOAPI | undefined {
+    const addonPath: string | undefined = findNativeLib();
+    return addonPath !== undefined ? require(addonPath) : undefined;
+}
+
+/**
+ * Fails the current spec when the addon is not built, test-service-app
+ * builds it first
+ */
+export function requireNativeLib(nativeLib: ITuxedoIOAPI | undefined): void {
+    if (nativeLib === undefined) {
+        throw new Error('native addon not built, run npm run build-native-debug');
+    }
+}
+
+/**
+ * Empty snapshot for getTelemetry and readTelemetry to fill in
+ */
+export class TelemetrySnapshotStub implements TelemetrySnapshot {
+    sequence = 0;
+    updatedNs = 0;
+    interface = '';
+    model = '';
+    odmProfile = '';
+    fansMinSpeed = 0;
+    fansOffAvailable = false;
+    webcamStatus = -1;
+    fans: TelemetrySnapshot['fans'] = [];
+    tdps: TelemetrySnapshot['tdps'] = [];
+    ioctlCalls = 0;
+    ioctlErrors = 0;
+}
@@ -17,7 +17,7 @@
  * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-import type { ITccODMPowerLimits } from '../../common/models/TccProfile';
+import type { ITccODMPowerLimits, ITccProfile } from '../../common/models/TccProfile';
 import { TuxedoIOAPI as ioAPI, type TDPInfo } from '../../native-lib/TuxedoIOAPI';
 import { DaemonWorker } from './DaemonWorker';
 import type { TuxedoControlCenterDaemon } from './TuxedoControlCenterDaemon';
@@ -28,22 +28,18 @@ export class ODMPowerLimitWorker extends DaemonWorker {
     }
 
     public async onStart(): Promise<void> {
-        let odmPowerLimitSettings: ITccODMPowerLimits = this.activeProfile.odmPowerLimits;
-        if (odmPowerLimitSettings === undefined) {
-            odmPowerLimitSettings = { tdpValues: [] };
-        }
-
         const tdpInfo: TDPInfo[] = [];
         if (ioAPI.getTDPInfo(tdpInfo) && tdpInfo?.length > 0) {
-            let newTDPValues: number[] = [];
-            // If set in profile use these
-            if (odmPowerLimitSettings.tdpValues && odmPowerLimitSettings.tdpValues?.length > 0) {
-                newTDPValues = odmPowerLimitSettings.tdpValues;
-            }
+            const newTDPValues: number[] = ODMPowerLimitWorker.resolveTDPValues(this.activeProfile, tdpInfo);
 
-            if (newTDPValues?.length === 0) {
-                // Default to max values
-                newTDPValues = tdpInfo.map((tdpEntry: TDPInfo): number => tdpEntry.max);
+            if (JSON.stringify(this.tccd.appliedHardwareProfile?.tdpValues) === JSON.stringify(newTDPValues)) {
+                // Set by the profile transaction of this switch
+                this.tccd.logLine('ODMPowerLimitWorker: ODM TDPs already applied');
+                for (let i: number = 0; i < tdpInfo?.length && i < newTDPValues?.length; ++i) {
+                    tdpInfo[i].current = newTDPValues[i];
+                }
+                this.tccd.dbusData.odmPowerLimitsJSON = JSON.stringify(tdpInfo);
+                return;
             }
 
             this.tccd.logLine(
@@ -61,6 +57,23 @@ export class ODMPowerLimitWorker extends DaemonWorker {
         this.tccd.dbusData.odmPowerLimitsJSON = JSON.stringify(tdpInfo);
     }
 
+    /**
+     * TDP values of a profile, the maximum values if the profile sets none
+     */
+    public static resolveTDPValues(profile: ITccProfile, tdpInfo: TDPInfo[]): number[] {
+        let odmPowerLimitSettings: ITccODMPowerLimits = profile.odmPowerLimits;
+        if (odmPowerLimitSettings === undefined) {
+            odmPowerLimitSettings = { tdpValues: [] };
+        }
+
+        // If set in profile use these
+        if (odmPowerLimitSettings.tdpValues && odmPowerLimitSettings.tdpValues?.length > 0) {
+            return odmPowerLimitSettings.tdpValues;
+        }
+        // Default to max values
+        return tdpInfo.map((tdpEntry: TDPInfo): number => tdpEntry.max);
+    }
+
     public async onWork(): Promise<void> {}
 
     public async onExit(): Promise<void> {}
@@ -19,7 +19,7 @@
 
 import { SysFsPropertyString, SysFsPropertyStringList } from '../../common/classes/SysFsProperties';
 import { TUXEDODevice } from '../../common/models/DefaultProfiles';
-import type { ITccODMProfile } from '../../common/models/TccProfile';
+import type { ITccODMProfile, ITccProfile } from '../../common/models/TccProfile';
 import { TuxedoIOAPI as ioAPI, type ObjWrapper } from '../../native-lib/TuxedoIOAPI';
 import { DaemonWorker } from './DaemonWorker';
 import type { TuxedoControlCenterDaemon } from './TuxedoControlCenterDaemon';
@@ -83,18 +83,16 @@ export class ODMProfileWorker extends DaemonWorker {
         const availableProfiles: ObjWrapper<string[]> = { value: [] };
         const odmProfilesAvailable: boolean = ioAPI.getAvailableODMPerformanceProfiles(availableProfiles);
         if (odmProfilesAvailable) {
-            let chosenODMProfileName: string = this.getODMProfileName();
-
-            // If saved profile name does not match available ones
-            // attempt to get the default profile name
-            if (!availableProfiles.value.includes(chosenODMProfileName)) {
-                const defaultProfileName: ObjWrapper<string> = { value: '' };
-                ioAPI.getDefaultODMPerformanceProfile(defaultProfileName);
-                chosenODMProfileName = defaultProfileName.value;
-            }
-
-            // Make sure a valid one could be found before proceeding, otherwise abort
-            if (availableProfiles.value.includes(chosenODMProfileName)) {
+            const chosenODMProfileName: string = ODMProfileWorker.resolveTuxedoIOProfileName(
+                this.activeProfile,
+                availableProfiles.value,
+            );
+
+            if (this.tccd.appliedHardwareProfile?.odmProfile === chosenODMProfileName) {
+                // Set by the profile transaction of this switch
+                this.tccd.logLine(`ODMProfileWorker: ODM profile '${chosenODMProfileName}' already applied`);
+            } else if (availableProfiles.value.includes(chosenODMProfileName)) {
+                // Make sure a valid one could be found before proceeding, otherwise abort
                 this.tccd.logLine(`ODMProfileWorker: Setting ODM profile '${chosenODMProfileName}'`);
                 if (!ioAPI.setODMPerformanceProfile(chosenODMProfileName)) {
                     this.tccd.logLine('ODMProfileWorker: Failed to apply profile');
@@ -118,6 +116,39 @@ export class ODMProfileWorker extends DaemonWorker {
         return chosenODMProfileName;
     }
 
+    /**
+     * ODM profile to set through tuxedo-io for a profile. If the saved
+     * profile name does not match the available ones the default profile
+     * name is used.
+     */
+    public static resolveTuxedoIOProfileName(profile: ITccProfile, availableProfiles: string[]): string {
+        const chosenODMProfileName: string = profile.odmProfile?.name;
+        if (availableProfiles.includes(chosenODMProfileName)) {
+            return chosenODMProfileName;
+        }
+        const defaultProfileName: ObjWrapper<string> = { value: '' };
+        ioAPI.getDefaultODMPerformanceProfile(defaultProfileName);
+        return defaultProfileName.value;
+    }
+
+    /**
+     * True if ODM profiles are not handled by a platform profile sysfs
+     * interface and thus set through tuxedo-io
+     */
+    public static usesTuxedoIO(dev: TUXEDODevice): boolean {
+        if (
+            ODMProfileWorker.tuxedoPlatformProfile.isAvailable() &&
+            ODMProfileWorker.tuxedoPlatformProfileChoices.isAvailable()
+        ) {
+            return false;
+        }
+        return !(
+            !ODMProfileWorker.hasQuirkNoPlatformProfile(dev) &&
+            ODMProfileWorker.platformProfile.isAvailable() &&
+            ODMProfileWorker.platformProfileChoices.isAvailable()
+        );
+    }
+
     private static hasQuirkNoPlatformProfile(dev: TUXEDODevice): boolean {
         // prettier-ignore
         const noPlatformProfileDevices = [
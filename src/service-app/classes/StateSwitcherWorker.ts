@@ -120,6 +120,7 @@ export class StateSwitcherWorker extends DaemonWorker {
         if (oldActiveProfileId !== this.tccd.activeProfile.id || this.refreshProfile) {
             this.refreshProfile = false;
             this.tccd.updateDBusActiveProfileData();
+            await this.tccd.applyHardwareProfile(this.tccd.getCurrentProfile());
             this.tccd.startWorkers();
         }
     }
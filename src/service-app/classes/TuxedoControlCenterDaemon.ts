@@ -18,7 +18,9 @@
  */
 
 import { SIGTERM } from 'node:constants';
+import * as fs from 'node:fs';
 import * as os from 'node:os';
+import { type PerformanceEntry, PerformanceObserver, performance } from 'node:perf_hooks';
 import { AvailabilityService } from '../../common/classes/availability.service';
 import { ConfigHandler } from '../../common/classes/ConfigHandler';
 import { CpuController } from '../../common/classes/CpuController';
@@ -28,15 +30,28 @@ import { TccPaths } from '../../common/classes/TccPaths';
 import { defaultCustomProfile, TUXEDODevice } from '../../common/models/DefaultProfiles';
 import { customFanPreset, type ITccFanProfile } from '../../common/models/TccFanTable';
 import { FrequencyConfig, generateProfileId, type ITccProfile } from '../../common/models/TccProfile';
-import { type ITccSettings, ProfileStates } from '../../common/models/TccSettings';
+import { defaultSettings, type ITccSettings, ProfileStates } from '../../common/models/TccSettings';
 import type { WebcamPreset } from '../../common/models/TccWebcamSettings';
-import { ModuleInfo, type TDPInfo, TuxedoIOAPI } from '../../native-lib/TuxedoIOAPI';
+import {
+    type DevicePresenceEvent,
+    type FanCalibrationResult,
+    ModuleInfo,
+    type ObjWrapper,
+    type ProfileApplyRequest,
+    type ProfileApplyResult,
+    type ProfileApplyStep,
+    type ResumeStats,
+    type TDPInfo,
+    TuxedoIOAPI,
+} from '../../native-lib/TuxedoIOAPI';
 import { ChargingWorker } from './ChargingWorker';
 import { CpuPowerWorker } from './CpuPowerWorker';
 import { CpuWorker } from './CpuWorker';
 import type { DaemonWorker } from './DaemonWorker';
 import { DisplayBacklightWorker } from './DisplayBacklightWorker';
 import { DisplayRefreshRateWorker } from './DisplayRefreshRateWorker';
+import { SIMULATED_FAN_ACTUATOR, storeFanActuatorProfile } from './FanActuatorProfiles';
+import { FAN_BENCHMARK_INTERFACES, type FanBenchmarkResult, FanControlBenchmark } from './FanControlBenchmark';
 import { FanControlWorker } from './FanControlWorker';
 import { GpuInfoWorker } from './GpuInfoWorker';
 import { KeyboardBacklightListener } from './KeyboardBacklightListener';
@@ -53,6 +68,9 @@ import { YCbCr420WorkaroundWorker } from './YCbCr420WorkaroundWorker';
 
 const tccPackage: any = require('../../package.json');
 
+// Event loop ping period of the native loop monitor
+const LOOP_MONITOR_INTERVAL_MS: number = 500;
+
 export class TuxedoControlCenterDaemon extends SingleProcess {
     static readonly CMD_RESTART_SERVICE: string = 'systemctl restart tccd.service';
     static readonly CMD_START_SERVICE: string = 'systemctl start tccd.service';
@@ -67,15 +85,25 @@ export class TuxedoControlCenterDaemon extends SingleProcess {
     public dbusData: TccDBusData = new TccDBusData();
 
     public activeProfile: ITccProfile;
+    // What the profile transaction applied, the workers starting afterwards do not write it again
+    public appliedHardwareProfile: { odmProfile?: string; tdpValues?: number[] };
 
     private workers: DaemonWorker[] = [];
     private listeners: (KeyboardBacklightListener | NVIDIAPowerCTRLListener)[] = [];
 
     protected started: boolean = false;
+    // Worker intervals run from the native scheduler instead of setInterval
+    public nativeScheduling: boolean = false;
+    private scheduledJobs: Map<number, DaemonWorker> = new Map();
+    private telemetryJournalStarted: boolean = false;
+
+    // Feeds GC pauses to the native loop monitor
+    private gcObserver: PerformanceObserver;
 
     private stateWorker: StateSwitcherWorker;
     private chargingWorker: ChargingWorker;
     private displayWorker: DisplayRefreshRateWorker;
+    private fanControlWorker: FanControlWorker;
     constructor() {
         super(TccPaths.PID_FILE);
         this.config = new ConfigHandler(
@@ -93,17 +121,41 @@ export class TuxedoControlCenterDaemon extends SingleProcess {
             process.exit();
         }
 
+        // Runs on a simulated device, needs neither root nor a running daemon
+        if (process.argv.some((argument: string): boolean => argument.split('=')[0] === '--benchmark-fan')) {
+            await this.runFanBenchmark().catch(
+                async (err: unknown): Promise<void> => await this.catchError(err as Error),
+            );
+            process.exit();
+        }
+        if (this.optionValue('--calibrate-fans-simulation') !== undefined) {
+            await this.runFanCalibration().catch(
+                async (err: unknown): Promise<void> => await this.catchError(err as Error),
+            );
+            process.exit();
+        }
+
         // Only allow to continue if root
         if (process.geteuid() !== 0) {
             throw Error('Not root, bye');
         }
 
+        if (process.argv.some((argument: string): boolean => argument.split('=')[0] === '--calibrate-fans')) {
+            await this.runFanCalibration().catch(
+                async (err: unknown): Promise<void> => await this.catchError(err as Error),
+            );
+            process.exit();
+        }
+
         // Check arguments, start, stop, restart config files etc..
         // todo: do error handling inside catchError
         await this.handleArgumentProgramFlow().catch(
             async (err: unknown): Promise<void> => await this.catchError(err as Error),
         );
 
+        // Before any worker touches the device, a replay replaces it entirely
+        this.startIoctlTracing();
+
         this.displayWorker = new DisplayRefreshRateWorker(this);
         this.loadConfigsAndProfiles();
         await this.setupSignalHandling();
@@ -116,7 +168,8 @@ export class TuxedoControlCenterDaemon extends SingleProcess {
         this.workers.push(new DisplayBacklightWorker(this));
         this.workers.push(new CpuWorker(this));
         this.workers.push(new WebcamWorker(this));
-        this.workers.push(new FanControlWorker(this, this.identifyDevice()));
+        this.fanControlWorker = new FanControlWorker(this, this.identifyDevice());
+        this.workers.push(this.fanControlWorker);
         this.workers.push(new YCbCr420WorkaroundWorker(this));
         this.workers.push(new GpuInfoWorker(this, new AvailabilityService()));
         this.workers.push(new CpuPowerWorker(this));
@@ -131,21 +184,107 @@ export class TuxedoControlCenterDaemon extends SingleProcess {
 
         await this.startWorkers();
 
+        if (TuxedoIOAPI.wmiAvailable()) {
+            this.startResumeWatch();
+        }
+        this.startDeviceWatch();
+
+        this.startMetricsServer();
+        this.startLoopMonitor();
+        if (!TuxedoIOAPI.publishTelemetry()) {
+            this.logLine('TuxedoControlCenterDaemon: Failed to publish telemetry to shared memory');
+        }
+        this.startTelemetryJournal();
+
         this.started = true;
         this.logLine('TuxedoControlCenterDaemon: Daemon started');
 
         // Start continuous work for each worker with individual interval
+        if (this.startScheduledWork()) {
+            return;
+        }
         for (const worker of this.workers) {
+            let dueMs: number = performance.now() + worker.timeout;
             worker.timer = setInterval(async (): Promise<void> => {
+                // Intervals are rescheduled from their last start, so is the deadline
+                const startMs: number = performance.now();
+                TuxedoIOAPI.beginWorkerRun(worker.name, startMs - dueMs, worker.slack);
+                dueMs = startMs + worker.timeout;
                 try {
                     await worker.work();
                 } catch (err: unknown) {
                     console.error(`TuxedoControlCenterDaemon: Failed executing onWork() of ${worker.name} => ${err}`);
+                } finally {
+                    TuxedoIOAPI.endWorkerRun(worker.name);
                 }
             }, worker.timeout);
         }
     }
 
+    /**
+     * Runs the worker intervals from the native scheduler, one wakeup for all
+     * workers due at the same time
+     *
+     * @returns False if the scheduler is not available and plain intervals are needed
+     */
+    private startScheduledWork(): boolean {
+        const jobs: Map<number, DaemonWorker> = this.scheduledJobs;
+        for (const worker of this.workers) {
+            const jobId: number = TuxedoIOAPI.addScheduledJob(
+                worker.name,
+                worker.timeout,
+                worker.slack,
+                TuxedoIOAPI.wmiAvailable() ? worker.hardwareReads : [],
+            );
+            jobs.set(jobId, worker);
+        }
+
+        this.nativeScheduling = TuxedoIOAPI.startScheduler((jobIds: number[]): void => {
+            for (const jobId of jobIds) {
+                const worker: DaemonWorker = jobs.get(jobId);
+                if (worker === undefined) {
+                    continue;
+                }
+                worker
+                    .work()
+                    .catch((err: unknown): void => {
+                        console.error(`TuxedoControlCenterDaemon: Failed executing onWork() of ${worker.name} => ${err}`);
+                    })
+                    .finally((): void => TuxedoIOAPI.completeScheduledJob(jobId));
+            }
+        });
+
+        if (!this.nativeScheduling) {
+            for (const jobId of jobs.keys()) {
+                TuxedoIOAPI.removeScheduledJob(jobId);
+            }
+            jobs.clear();
+            this.logLine('TuxedoControlCenterDaemon: Native scheduler not available, using intervals');
+        }
+        return this.nativeScheduling;
+    }
+
+    /**
+     * Hardware reads are batched into the scheduler wakeups only while tuxedo-io
+     * is available, the fan worker knows its reads once it chose tuxedo-io
+     */
+    private updateScheduledHardwareReads(): void {
+        const available: boolean = TuxedoIOAPI.wmiAvailable();
+        for (const [jobId, worker] of this.scheduledJobs) {
+            TuxedoIOAPI.setScheduledJobReads(jobId, available ? worker.hardwareReads : []);
+        }
+    }
+
+    private startTelemetryJournal(): void {
+        if (this.telemetryJournalStarted || !TuxedoIOAPI.wmiAvailable()) {
+            return;
+        }
+        this.telemetryJournalStarted = TuxedoIOAPI.startTelemetryJournal(TccPaths.TELEMETRY_JOURNAL_FILE);
+        if (!this.telemetryJournalStarted) {
+            this.logLine(`TuxedoControlCenterDaemon: Failed to record telemetry journal ${TccPaths.TELEMETRY_JOURNAL_FILE}`);
+        }
+    }
+
     public async startWorkers(): Promise<void> {
         for (const worker of this.workers) {
             try {
@@ -155,6 +294,259 @@ export class TuxedoControlCenterDaemon extends SingleProcess {
                 console.error(`TuxedoControlCenterDaemon: Failed executing onStart => ${err}`);
             }
         }
+        this.appliedHardwareProfile = undefined;
+    }
+
+    /**
+     * Apply the tuxedo-io controlled parts of a profile (ODM profile, TDPs, fan mode and
+     * fan speeds) in one native transaction instead of waiting for the individual workers.
+     * The values are resolved like the workers do, which skip what was applied on their next start.
+     */
+    public async applyHardwareProfile(profile: ITccProfile): Promise<void> {
+        this.appliedHardwareProfile = undefined;
+        if (!TuxedoIOAPI.wmiAvailable()) {
+            return;
+        }
+
+        const request: ProfileApplyRequest = {};
+        const availableODMProfiles: ObjWrapper<string[]> = { value: [] };
+        if (
+            ODMProfileWorker.usesTuxedoIO(this.identifyDevice()) &&
+            TuxedoIOAPI.getAvailableODMPerformanceProfiles(availableODMProfiles)
+        ) {
+            const odmProfile: string = ODMProfileWorker.resolveTuxedoIOProfileName(profile, availableODMProfiles.value);
+            if (availableODMProfiles.value.includes(odmProfile)) {
+                request.odmProfile = odmProfile;
+            }
+        }
+        const tdpInfo: TDPInfo[] = [];
+        if (TuxedoIOAPI.getTDPInfo(tdpInfo) && tdpInfo.length > 0) {
+            request.tdpValues = ODMPowerLimitWorker.resolveTDPValues(profile, tdpInfo);
+        }
+        if (this.fanControlWorker !== undefined) {
+            Object.assign(request, await this.fanControlWorker.getProfileApplyRequest(profile));
+        }
+
+        try {
+            const result: ProfileApplyResult = await TuxedoIOAPI.applyProfile(request);
+            const succeeded = (prefix: string): boolean => {
+                const steps: ProfileApplyStep[] = result.steps.filter((step: ProfileApplyStep): boolean =>
+                    step.name.startsWith(prefix),
+                );
+                return steps.length > 0 && steps.every((step: ProfileApplyStep): boolean => step.success);
+            };
+            this.appliedHardwareProfile = {
+                odmProfile: succeeded('odmProfile') ? request.odmProfile : undefined,
+                tdpValues: succeeded('tdp') ? request.tdpValues : undefined,
+            };
+            const steps: string = result.steps
+                .map(
+                    (step: ProfileApplyStep): string =>
+                        `${step.name}:${step.skipped ? 'skipped' : step.success ? 'ok' : 'failed'}`,
+                )
+                .join(', ');
+            this.logLine(
+                `TuxedoControlCenterDaemon: Applied hardware profile in ${(result.durationUs / 1000).toFixed(1)} ms [ ${steps} ]`,
+            );
+        } catch (err: unknown) {
+            console.error(`TuxedoControlCenterDaemon: Failed applying hardware profile => ${err}`);
+        }
+    }
+
+    /**
+     * Optional OpenMetrics endpoint, enabled with --metrics (default socket) or
+     * --metrics=<socket path|localhost port>
+     */
+    private startMetricsServer(): void {
+        const metricsArgument: string = process.argv.find(
+            (argument: string): boolean => argument === '--metrics' || argument.startsWith('--metrics='),
+        );
+        if (metricsArgument === undefined) {
+            return;
+        }
+
+        const address: string = metricsArgument.includes('=')
+            ? metricsArgument.substring(metricsArgument.indexOf('=') + 1)
+            : TccPaths.TCCD_METRICS_SOCKET;
+        if (TuxedoIOAPI.startMetricsServer(address)) {
+            this.logLine(`TuxedoControlCenterDaemon: Serving metrics on ${address}`);
+        } else {
+            this.logLine(`TuxedoControlCenterDaemon: Failed to serve metrics on ${address}`);
+        }
+    }
+
+    /**
+     * Normally tccd is restarted around sleep by tccd-sleep.service, the watch covers
+     * setups where it keeps running so the EC state is restored right away on resume
+     */
+    private startResumeWatch(): void {
+        TuxedoIOAPI.startResumeWatch((stats: ResumeStats): void => {
+            this.logLine(
+                `TuxedoControlCenterDaemon: Resumed after ${stats.suspendedMs} ms, restored device state ${stats.restoreSuccess ? '' : 'with errors '}in ${(stats.restoreDurationUs / 1000).toFixed(1)} ms (fans after ${(stats.fanStateUs / 1000).toFixed(1)} ms)`,
+            );
+        });
+    }
+
+    /**
+     * Takes over hardware control as soon as tuxedo-io shows up, e.g. when the
+     * DKMS module loads after tccd started
+     */
+    private startDeviceWatch(): void {
+        const started: boolean = TuxedoIOAPI.startDeviceWatch((event: DevicePresenceEvent): void => {
+            this.onDevicePresenceChanged(event).catch((err: unknown): void => {
+                console.error(`TuxedoControlCenterDaemon: Failed to take over tuxedo-io => ${err}`);
+            });
+        });
+        if (!started) {
+            this.logLine('TuxedoControlCenterDaemon: Failed to watch for tuxedo-io');
+        }
+    }
+
+    private async onDevicePresenceChanged(event: DevicePresenceEvent): Promise<void> {
+        this.dbusData.tuxedoWmiAvailable = event.available;
+        if (!event.present) {
+            this.logLine('TuxedoControlCenterDaemon: tuxedo-io removed');
+            this.updateScheduledHardwareReads();
+            return;
+        }
+        if (!event.available) {
+            this.logLine('TuxedoControlCenterDaemon: tuxedo-io appeared but no interface was identified');
+            return;
+        }
+
+        this.logLine(
+            `TuxedoControlCenterDaemon: tuxedo-io appeared [ interface: ${event.interface} ], identified in ${event.identifyUs} µs`,
+        );
+        this.startResumeWatch();
+        this.startTelemetryJournal();
+        await this.fanControlWorker?.onTuxedoIOAvailable();
+        this.updateScheduledHardwareReads();
+        await this.applyHardwareProfile(this.getCurrentProfile());
+    }
+
+    /**
+     * Event loop lag, GC pauses and worker deadlines, read with
+     * getLoopMonitorStats() or from the metrics endpoint
+     */
+    private startLoopMonitor(): void {
+        if (!TuxedoIOAPI.startLoopMonitor(LOOP_MONITOR_INTERVAL_MS)) {
+            this.logLine('TuxedoControlCenterDaemon: Failed to start loop monitor');
+            return;
+        }
+        this.gcObserver = new PerformanceObserver((list): void => {
+            for (const entry of list.getEntries() as (PerformanceEntry & { detail?: { kind: number } })[]) {
+                TuxedoIOAPI.recordGcPause(entry.detail?.kind ?? 0, entry.duration);
+            }
+        });
+        this.gcObserver.observe({ entryTypes: ['gc'] });
+    }
+
+    /**
+     * Optional ioctl trace recording with --trace-ioctl=<file> for field bug
+     * reports, and replay of such a trace instead of the device with
+     * --replay-ioctl=<file> (--replay-ioctl-realtime to keep recorded timing)
+     */
+    private startIoctlTracing(): void {
+        const replayPath: string = this.optionValue('--replay-ioctl');
+        if (replayPath !== undefined) {
+            if (TuxedoIOAPI.startIoctlReplay(replayPath, process.argv.includes('--replay-ioctl-realtime'))) {
+                this.logLine(`TuxedoControlCenterDaemon: Replaying ioctl trace ${replayPath}`);
+            } else {
+                this.logLine(`TuxedoControlCenterDaemon: Failed to load ioctl trace ${replayPath}`);
+            }
+        }
+
+        const tracePath: string = this.optionValue('--trace-ioctl');
+        if (tracePath !== undefined) {
+            if (TuxedoIOAPI.startIoctlTrace(tracePath)) {
+                this.logLine(`TuxedoControlCenterDaemon: Recording ioctl trace to ${tracePath}`);
+            } else {
+                this.logLine(`TuxedoControlCenterDaemon: Failed to record ioctl trace to ${tracePath}`);
+            }
+        }
+    }
+
+    /**
+     * Value of a command line option given as <option>=<value>
+     */
+    private optionValue(option: string): string {
+        return process.argv
+            .find((argument: string): boolean => argument.startsWith(`${option}=`))
+            ?.substring(option.length + 1);
+    }
+
+    /**
+     * Fan control step response benchmark on a simulated device with
+     * --benchmark-fan[=<result file>], limited to one register layout with
+     * --benchmark-fan-interface=clevo|uniwill. The result is printed as JSON
+     * when no file is given.
+     */
+    private async runFanBenchmark(): Promise<void> {
+        const interfaceName: string = this.optionValue('--benchmark-fan-interface');
+        if (interfaceName !== undefined && !FAN_BENCHMARK_INTERFACES.includes(interfaceName as 'clevo' | 'uniwill')) {
+            throw Error(`Unknown fan benchmark interface ${interfaceName}`);
+        }
+
+        // Default settings and profile, the configuration of this machine does not influence the result
+        this.settings = JSON.parse(JSON.stringify(defaultSettings));
+        this.settings.fanControlEnabled = true;
+        this.activeProfile = JSON.parse(JSON.stringify(defaultCustomProfile));
+
+        const benchmark: FanControlBenchmark = new FanControlBenchmark(this, this.activeProfile);
+        const results: FanBenchmarkResult[] = await benchmark.run(
+            interfaceName !== undefined ? [interfaceName as 'clevo' | 'uniwill'] : FAN_BENCHMARK_INTERFACES,
+        );
+        const output: string = JSON.stringify({ version: tccPackage.version, results }, null, 4);
+
+        const outputPath: string = this.optionValue('--benchmark-fan');
+        if (outputPath !== undefined) {
+            fs.writeFileSync(outputPath, `${output}\n`);
+            this.logLine(`TuxedoControlCenterDaemon: Fan benchmark result written to ${outputPath}`);
+        } else {
+            console.log(output);
+        }
+    }
+
+    /**
+     * Fan actuator calibration with --calibrate-fans[=<result file>]. The
+     * daemon must not run meanwhile, the result becomes the profile of the
+     * device model for the fan control. With
+     * --calibrate-fans-simulation=clevo|uniwill it runs on a simulated device
+     * with a slow, stepped actuator instead and nothing is stored. The result
+     * is printed as JSON when no file is given.
+     */
+    private async runFanCalibration(): Promise<void> {
+        const interfaceName: string = this.optionValue('--calibrate-fans-simulation');
+        if (interfaceName !== undefined) {
+            if (!FAN_BENCHMARK_INTERFACES.includes(interfaceName as 'clevo' | 'uniwill')) {
+                throw Error(`Unknown fan calibration interface ${interfaceName}`);
+            }
+            TuxedoIOAPI.startIoctlSimulation({
+                interface: interfaceName as 'clevo' | 'uniwill',
+                ...SIMULATED_FAN_ACTUATOR,
+            });
+        } else if (!(await this.start())) {
+            throw Error('Stop the daemon before calibrating the fans');
+        }
+        if (!TuxedoIOAPI.wmiAvailable()) {
+            throw Error('Fan calibration needs tuxedo-io');
+        }
+
+        this.logLine('TuxedoControlCenterDaemon: Calibrating fans, this takes a few minutes');
+        const result: FanCalibrationResult = await TuxedoIOAPI.calibrateFans();
+        if (interfaceName === undefined) {
+            const modelKey: string = storeFanActuatorProfile(TccPaths.FAN_ACTUATORS_FILE, result);
+            this.logLine(`TuxedoControlCenterDaemon: Fan calibration stored for ${modelKey}`);
+        }
+        const output: string = JSON.stringify({ version: tccPackage.version, ...result }, null, 4);
+
+        const outputPath: string = this.optionValue('--calibrate-fans');
+        if (outputPath !== undefined) {
+            fs.writeFileSync(outputPath, `${output}\n`);
+            this.logLine(`TuxedoControlCenterDaemon: Fan calibration result written to ${outputPath}`);
+        } else {
+            console.log(output);
+        }
     }
 
     public triggerStateCheck(reset?: boolean): void {
@@ -190,6 +582,17 @@ export class TuxedoControlCenterDaemon extends SingleProcess {
         for (const worker of this.workers) {
             clearInterval(worker.timer);
         }
+        TuxedoIOAPI.stopScheduler();
+        TuxedoIOAPI.stopResumeWatch();
+        TuxedoIOAPI.stopDeviceWatch();
+        TuxedoIOAPI.stopMetricsServer();
+        TuxedoIOAPI.unpublishTelemetry();
+        TuxedoIOAPI.stopTelemetryJournal();
+        TuxedoIOAPI.stopIoctlTrace();
+        TuxedoIOAPI.stopGpuQuery();
+        TuxedoIOAPI.closeKeyboardLeds();
+        this.gcObserver?.disconnect();
+        TuxedoIOAPI.stopLoopMonitor();
 
         for (const worker of this.workers) {
             try {
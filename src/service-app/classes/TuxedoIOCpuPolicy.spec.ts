@@ -0,0 +1,175 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import * as fs from 'node:fs';
+import * as os from 'node:os';
+import * as path from 'node:path';
+
+import type {
+    ITuxedoIOAPI,
+    CpuPolicyApplyResult,
+    CpuPolicyCheckResult,
+    CpuPolicyState,
+    CpuPolicyTarget,
+} from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+const NR_CPUS: number = 4;
+
+// Fixture of /sys/devices/system/cpu with one cpufreq policy per cpu
+function createCpuTree(root: string): void {
+    const write = (file: string, value: string): void => {
+        fs.mkdirSync(path.dirname(path.join(root, file)), { recursive: true });
+        fs.writeFileSync(path.join(root, file), `${value}\n`);
+    };
+    write('present', `0-${NR_CPUS - 1}`);
+    write('online', `0-${NR_CPUS - 1}`);
+    write('cpufreq/boost', '1');
+    for (let cpu: number = 0; cpu < NR_CPUS; cpu++) {
+        if (cpu > 0) {
+            write(`cpu${cpu}/online`, '1');
+        }
+        const policy: string = `cpufreq/policy${cpu}`;
+        write(`${policy}/related_cpus`, `${cpu}`);
+        write(`${policy}/scaling_driver`, 'acpi-cpufreq');
+        write(`${policy}/scaling_available_governors`, 'ondemand powersave performance schedutil');
+        write(`${policy}/scaling_available_frequencies`, '3000000 2400000 1800000 1200000');
+        write(`${policy}/cpuinfo_min_freq`, '1200000');
+        write(`${policy}/cpuinfo_max_freq`, '3000000');
+        write(`${policy}/scaling_governor`, 'schedutil');
+        write(`${policy}/scaling_min_freq`, '1200000');
+        write(`${policy}/scaling_max_freq`, '3000000');
+    }
+}
+
+class CpuPolicyStateStub implements CpuPolicyState {
+    present: number[] = [];
+    online: number[] = [];
+    boost: boolean | null = null;
+    noTurbo: boolean | null = null;
+    policies: CpuPolicyState['policies'] = [];
+}
+
+describe('TuxedoIOAPI cpufreq policies on a fixture tree', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+    let root: string;
+
+    const read = (file: string): string => fs.readFileSync(path.join(root, file), 'utf-8').trim();
+
+    function allCores(values: Omit<CpuPolicyTarget['cores'][number], 'cpu'>): CpuPolicyTarget['cores'] {
+        return Array.from({ length: NR_CPUS }, (_: unknown, cpu: number) => ({ cpu, ...values }));
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        // A fresh root per test, engines are cached per root
+        root = fs.mkdtempSync(path.join(os.tmpdir(), 'tcc-cpu-'));
+        createCpuTree(root);
+    });
+
+    afterEach((): void => {
+        if (root !== undefined) {
+            fs.rmSync(root, { recursive: true, force: true });
+        }
+    });
+
+    it('reads the policies of the tree', (): void => {
+        const state: CpuPolicyState = new CpuPolicyStateStub();
+        expect(nativeLib.getCpuPolicyState(state, root)).toBe(true);
+        expect(state.present).toEqual([0, 1, 2, 3]);
+        expect(state.boost).toBe(true);
+        expect(state.noTurbo).toBeNull();
+        expect(state.policies.length).toBe(NR_CPUS);
+        expect(state.policies[2].cpus).toEqual([2]);
+        expect(state.policies[2].governor).toBe('schedutil');
+        expect(state.policies[2].availableFrequencies).toEqual([3000000, 2400000, 1800000, 1200000]);
+        expect(state.policies[2].energyPerformancePreference).toBe('');
+    });
+
+    it('is not available without cpufreq policies', (): void => {
+        fs.rmSync(path.join(root, 'cpufreq'), { recursive: true });
+        expect(nativeLib.getCpuPolicyState(new CpuPolicyStateStub(), root)).toBe(false);
+    });
+
+    it('writes only values that differ', async (): Promise<void> => {
+        const target: CpuPolicyTarget = {
+            cores: allCores({ governor: 'schedutil', scalingMinFrequency: 1200000, scalingMaxFrequency: 2400000 }),
+            boost: false,
+        };
+        const first: CpuPolicyApplyResult = await nativeLib.applyCpuPolicy(target, root);
+        expect(first.failed).toEqual([]);
+        // Maximum frequency per policy and boost
+        expect(first.writes).toBe(NR_CPUS + 1);
+        expect(read('cpufreq/policy1/scaling_max_freq')).toBe('2400000');
+        expect(read('cpufreq/boost')).toBe('0');
+
+        const second: CpuPolicyApplyResult = await nativeLib.applyCpuPolicy(target, root);
+        expect(second.writes).toBe(0);
+        expect(second.unchanged).toBe(first.writes + first.unchanged);
+    });
+
+    it('raises the maximum before a minimum above the current maximum', async (): Promise<void> => {
+        fs.writeFileSync(path.join(root, 'cpufreq/policy0/scaling_max_freq'), '1800000\n');
+        const result: CpuPolicyApplyResult = await nativeLib.applyCpuPolicy(
+            { cores: [{ cpu: 0, scalingMinFrequency: 2400000, scalingMaxFrequency: 3000000 }] },
+            root,
+        );
+        expect(result.failed).toEqual([]);
+        expect(read('cpufreq/policy0/scaling_min_freq')).toBe('2400000');
+        expect(read('cpufreq/policy0/scaling_max_freq')).toBe('3000000');
+    });
+
+    it('takes cores offline and leaves their policies alone', async (): Promise<void> => {
+        const cores: CpuPolicyTarget['cores'] = allCores({ governor: 'performance' }).map(
+            (core: CpuPolicyTarget['cores'][number]) => ({ ...core, online: core.cpu < 2 }),
+        );
+        await nativeLib.applyCpuPolicy({ cores }, root);
+        expect(read('cpu2/online')).toBe('0');
+        expect(read('cpu3/online')).toBe('0');
+        expect(read('cpufreq/policy1/scaling_governor')).toBe('performance');
+
+        // The fixture online list is not maintained by a kernel
+        fs.writeFileSync(path.join(root, 'online'), '0-1\n');
+        const state: CpuPolicyState = new CpuPolicyStateStub();
+        nativeLib.getCpuPolicyState(state, root);
+        expect(state.policies[3].active).toBe(false);
+        expect(state.policies[3].governor).toBe('');
+    });
+
+    it('reports values changed by someone else as drift', async (): Promise<void> => {
+        await nativeLib.applyCpuPolicy({ cores: allCores({ governor: 'powersave' }) }, root);
+        expect(nativeLib.checkCpuPolicy(root).drift).toEqual([]);
+
+        fs.writeFileSync(path.join(root, 'cpufreq/policy3/scaling_governor'), 'performance\n');
+        const check: CpuPolicyCheckResult = nativeLib.checkCpuPolicy(root);
+        expect(check.drift).toEqual([
+            { path: 'cpufreq/policy3/scaling_governor', expected: 'powersave', actual: 'performance', error: 0 },
+        ]);
+        // One online list, three scaling files per policy without preferences and boost
+        expect(check.reads).toBe(1 + 3 * NR_CPUS + 1);
+
+        const reapplied: CpuPolicyApplyResult = await nativeLib.applyCpuPolicy(
+            { cores: allCores({ governor: 'powersave' }) },
+            root,
+        );
+        expect(reapplied.writes).toBe(1);
+        expect(nativeLib.checkCpuPolicy(root).drift).toEqual([]);
+    });
+});
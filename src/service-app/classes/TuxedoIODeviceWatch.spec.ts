@@ -0,0 +1,108 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import * as fs from 'node:fs';
+import * as os from 'node:os';
+import * as path from 'node:path';
+
+import type { DevicePresenceEvent, DeviceWatchState, ITuxedoIOAPI } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+describe('TuxedoIOAPI device watch', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+    let devDir: string;
+    let devicePath: string;
+    let events: DevicePresenceEvent[];
+    let onEvent: () => void;
+
+    function nextEvent(): Promise<DevicePresenceEvent> {
+        const count: number = events.length;
+        return new Promise((resolve, reject): void => {
+            const timeout: NodeJS.Timeout = setTimeout((): void => reject(new Error('no device event')), 2000);
+            onEvent = (): void => {
+                if (events.length > count) {
+                    clearTimeout(timeout);
+                    resolve(events[count]);
+                }
+            };
+        });
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        devDir = fs.mkdtempSync(path.join(os.tmpdir(), 'tcc-dev-'));
+        devicePath = path.join(devDir, 'tuxedo_io');
+        events = [];
+        onEvent = (): void => {};
+        // Identification runs against the simulated module, the fixture file only signals presence
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopDeviceWatch();
+        nativeLib?.stopIoctlSimulation();
+        if (devDir !== undefined) {
+            fs.rmSync(devDir, { recursive: true, force: true });
+        }
+    });
+
+    it('identifies the device once when the node appears and reports its removal', async (): Promise<void> => {
+        const started: boolean = nativeLib.startDeviceWatch((event: DevicePresenceEvent): void => {
+            events.push(event);
+            onEvent();
+        }, devicePath);
+        expect(started).toBe(true);
+        expect(nativeLib.getDeviceWatchState().present).toBe(false);
+
+        const appeared: Promise<DevicePresenceEvent> = nextEvent();
+        fs.writeFileSync(devicePath, '');
+        fs.chmodSync(devicePath, 0o660);
+        expect(await appeared).toEqual(
+            jasmine.objectContaining({ present: true, available: true, interface: 'uniwill' }),
+        );
+
+        const removed: Promise<DevicePresenceEvent> = nextEvent();
+        fs.rmSync(devicePath);
+        expect((await removed).present).toBe(false);
+
+        // The attribute change of the identified node was not reported again
+        expect(events.length).toBe(2);
+        const state: DeviceWatchState = nativeLib.getDeviceWatchState();
+        expect(state.running).toBe(true);
+        expect(state.appearances).toBe(1);
+        expect(state.disappearances).toBe(1);
+    });
+
+    it('keeps the device closed while the node is missing', (): void => {
+        // Without backend the session uses the device file
+        nativeLib.stopIoctlSimulation();
+        expect(nativeLib.startDeviceWatch((): void => {}, devicePath)).toBe(true);
+        const opens: number = nativeLib.getDeviceSessionStats().opens;
+
+        expect(nativeLib.wmiAvailable()).toBe(false);
+        expect(nativeLib.wmiAvailable()).toBe(false);
+        expect(nativeLib.getDeviceSessionStats().opens).toBe(opens);
+    });
+
+    it('does not start twice', (): void => {
+        expect(nativeLib.startDeviceWatch((): void => {}, devicePath)).toBe(true);
+        expect(nativeLib.startDeviceWatch((): void => {}, devicePath)).toBe(false);
+    });
+});
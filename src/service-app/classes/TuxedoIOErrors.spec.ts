@@ -0,0 +1,87 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import { constants } from 'node:os';
+
+import type { ITuxedoIOAPI, ObjWrapper, TDPInfo } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+describe('TuxedoIOAPI errno propagation', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopIoctlSimulation();
+    });
+
+    it('reports EINVAL for unknown ODM profiles', (): void => {
+        expect(nativeLib.setODMPerformanceProfile('no-such-profile')).toBe(false);
+        expect(nativeLib.getLastError()).toBe(constants.errno.EINVAL);
+    });
+
+    it('reports EOPNOTSUPP for operations the interface does not implement', (): void => {
+        // Uniwill devices have no webcam switch
+        expect(nativeLib.setWebcamStatus(true)).toBe(false);
+        expect(nativeLib.getLastError()).toBe(constants.errno.EOPNOTSUPP);
+    });
+
+    it('clears the error on success', (): void => {
+        const fanSpeed: ObjWrapper<number> = { value: -1 };
+        expect(nativeLib.setODMPerformanceProfile('no-such-profile')).toBe(false);
+        expect(nativeLib.getFanSpeedPercent(0, fanSpeed)).toBe(true);
+        expect(nativeLib.getLastError()).toBe(0);
+    });
+
+    it('does not short-circuit writes rejected for their value', (): void => {
+        const tdpInfo: TDPInfo[] = [];
+        expect(nativeLib.getTDPInfo(tdpInfo)).toBe(true);
+
+        nativeLib.setTDPValues([tdpInfo[0].max + 1]);
+        expect(nativeLib.getLastError()).toBe(constants.errno.EINVAL);
+
+        expect(nativeLib.setTDPValues([tdpInfo[0].min])).toBe(true);
+        expect(nativeLib.getLastError()).toBe(0);
+        tdpInfo.length = 0;
+        expect(nativeLib.getTDPInfo(tdpInfo)).toBe(true);
+        expect(tdpInfo[0].current).toBe(tdpInfo[0].min);
+    });
+
+    it('reports EINVAL for fans the interface does not have', (): void => {
+        const value: ObjWrapper<number> = { value: -1 };
+        expect(nativeLib.setFanSpeedPercent(2, 50)).toBe(false);
+        expect(nativeLib.getLastError()).toBe(constants.errno.EINVAL);
+        expect(nativeLib.getFanSpeedPercent(2, value)).toBe(false);
+        expect(nativeLib.getLastError()).toBe(constants.errno.EINVAL);
+        expect(nativeLib.getFanTemperature(2, value)).toBe(false);
+        expect(nativeLib.getLastError()).toBe(constants.errno.EINVAL);
+    });
+
+    it('does not hold back the next fan write after a failed one', (): void => {
+        expect(nativeLib.setFanSpeedPercent(0, 150)).toBe(false);
+        expect(nativeLib.getLastError()).toBe(constants.errno.EINVAL);
+
+        expect(nativeLib.setFanSpeedPercent(0, 50)).toBe(true);
+        expect(nativeLib.getLastError()).toBe(0);
+    });
+});
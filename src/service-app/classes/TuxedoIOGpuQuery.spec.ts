@@ -0,0 +1,117 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import * as fs from 'node:fs';
+import * as os from 'node:os';
+import * as path from 'node:path';
+
+import type { GpuQuerySnapshot, ITuxedoIOAPI } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+// Stands in for nvidia-smi: two samples split across writes, one line to ignore, then exits
+const STUB_SCRIPT: string = `#!/bin/sh
+echo "$@" > "$0.args"
+printf '0, 25.50, [N/A],'
+sleep 0.05
+printf ' 2100\\n'
+echo 'No devices were found'
+echo '0, 26.00, 80.00, 1800'
+sleep 0.2
+exit 1
+`;
+
+class GpuQuerySnapshotStub implements GpuQuerySnapshot {
+    sequence: number;
+    restarts: number;
+    childRunning: boolean;
+    gpus: GpuQuerySnapshot['gpus'] = [];
+}
+
+describe('TuxedoIOAPI GPU query', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+    const fields: string[] = ['power.draw', 'power.max_limit', 'clocks.gr'];
+    let stubDir: string;
+    let stubPath: string;
+
+    function readSnapshot(): GpuQuerySnapshot {
+        const snapshot: GpuQuerySnapshot = new GpuQuerySnapshotStub();
+        expect(nativeLib.getGpuQuerySnapshot(snapshot)).toBe(true);
+        return snapshot;
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        stubDir = fs.mkdtempSync(path.join(os.tmpdir(), 'tcc-gpu-query-'));
+        stubPath = path.join(stubDir, 'nvidia-smi');
+        fs.writeFileSync(stubPath, STUB_SCRIPT, { mode: 0o755 });
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopGpuQuery();
+        if (stubDir !== undefined) {
+            fs.rmSync(stubDir, { recursive: true, force: true });
+        }
+    });
+
+    it('streams values from one child', async (): Promise<void> => {
+        expect(nativeLib.startGpuQuery(fields, 100, stubPath)).toBe(true);
+        expect(nativeLib.startGpuQuery(fields, 100, stubPath)).toBe(false);
+        expect(await nativeLib.waitGpuQuerySample(0, 5000)).toBe(true);
+
+        const snapshot: GpuQuerySnapshot = readSnapshot();
+        expect(snapshot.sequence).toBe(1);
+        expect(snapshot.gpus.length).toBe(1);
+        expect(snapshot.gpus[0].index).toBe(0);
+        expect(snapshot.gpus[0].values).toEqual({ 'power.draw': 25.5, 'power.max_limit': -1, 'clocks.gr': 2100 });
+        expect(fs.readFileSync(`${stubPath}.args`, 'utf-8').trim()).toBe(
+            '--query-gpu=index,power.draw,power.max_limit,clocks.gr --format=csv,noheader,nounits --loop-ms=100',
+        );
+
+        expect(await nativeLib.waitGpuQuerySample(1, 5000)).toBe(true);
+        expect(readSnapshot().gpus[0].values['power.max_limit']).toBe(80);
+    });
+
+    it('restarts the child when it exits', async (): Promise<void> => {
+        expect(nativeLib.startGpuQuery(fields, 100, stubPath)).toBe(true);
+        expect(await nativeLib.waitGpuQuerySample(2, 10000)).toBe(true);
+
+        const snapshot: GpuQuerySnapshot = readSnapshot();
+        expect(snapshot.restarts).toBeGreaterThanOrEqual(1);
+        expect(snapshot.gpus[0].ageMs).toBeLessThan(10000);
+    });
+
+    it('fails to start without executable', async (): Promise<void> => {
+        expect(nativeLib.startGpuQuery(fields, 100, path.join(stubDir, 'missing'))).toBe(false);
+        expect(nativeLib.getGpuQuerySnapshot(new GpuQuerySnapshotStub())).toBe(false);
+        expect(await nativeLib.waitGpuQuerySample(0, 10)).toBe(false);
+    });
+
+    it('queries once without a loop', async (): Promise<void> => {
+        const snapshot: GpuQuerySnapshot = await nativeLib.queryGpuOnce(fields, 5000, stubPath);
+        expect(snapshot).not.toBeNull();
+        expect(snapshot.gpus[0].values['power.draw']).toBe(25.5);
+        expect(fs.readFileSync(`${stubPath}.args`, 'utf-8').trim()).toBe(
+            '--query-gpu=index,power.draw,power.max_limit,clocks.gr --format=csv,noheader,nounits',
+        );
+        expect(nativeLib.getGpuQuerySnapshot(new GpuQuerySnapshotStub())).toBe(false);
+
+        expect(await nativeLib.queryGpuOnce(fields, 10, path.join(stubDir, 'missing'))).toBeNull();
+    });
+});
@@ -0,0 +1,149 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import * as fs from 'node:fs';
+import * as os from 'node:os';
+import * as path from 'node:path';
+
+import type { ITuxedoIOAPI, ObjWrapper } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+// Layout of tuxedo_io_journal.hh
+const HEADER_SIZE: number = 4096;
+const RECORD_SIZE: number = 64;
+const NEXT_SEQUENCE_OFFSET: number = 24;
+const TEMPERATURE_OFFSET: number = 16;
+
+const INTERVAL_MS: number = 5;
+
+function delay(ms: number): Promise<void> {
+    return new Promise((resolve): NodeJS.Timeout => setTimeout(resolve, ms));
+}
+
+describe('TuxedoIOAPI telemetry journal', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+    let tmpDir: string;
+    let journalPath: string;
+
+    async function record(durationMs: number, maxBytes: number): Promise<[number, number]> {
+        const fromMs: number = Date.now() - 1;
+        expect(nativeLib.startTelemetryJournal(journalPath, INTERVAL_MS, maxBytes)).toBe(true);
+        await delay(durationMs);
+        nativeLib.stopTelemetryJournal();
+        return [fromMs, Date.now() + 1];
+    }
+
+    // Records of the queried journal in [fromMs, toMs), one bucket per millisecond
+    function countRecords(fromMs: number, toMs: number): number {
+        const result: Float64Array = nativeLib.queryTelemetryJournal('temperature', 0, fromMs, toMs, toMs - fromMs);
+        let count: number = 0;
+        for (let i: number = 0; i < result.length; i += 3) {
+            if (!isNaN(result[i])) {
+                count += 1;
+            }
+        }
+        return count;
+    }
+
+    function patchJournal(offset: number, patch: (file: Buffer) => void): void {
+        const file: Buffer = fs.readFileSync(journalPath);
+        patch(file.subarray(offset));
+        fs.writeFileSync(journalPath, file);
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'tcc-journal-'));
+        journalPath = path.join(tmpDir, 'telemetry.journal');
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+        nativeLib.setSimulatedTemperature(0, 60);
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopTelemetryJournal();
+        nativeLib?.closeTelemetryJournal();
+        nativeLib?.stopIoctlSimulation();
+        if (tmpDir !== undefined) {
+            fs.rmSync(tmpDir, { recursive: true, force: true });
+        }
+    });
+
+    it('records sampled values and the active profile', async (): Promise<void> => {
+        const profiles: ObjWrapper<string[]> = { value: [] };
+        expect(nativeLib.getAvailableODMPerformanceProfiles(profiles)).toBe(true);
+        expect(nativeLib.setODMPerformanceProfile(profiles.value[0])).toBe(true);
+
+        const [fromMs, toMs] = await record(50, HEADER_SIZE + 100 * RECORD_SIZE);
+        expect(nativeLib.openTelemetryJournal(journalPath)).toBe(true);
+
+        const [min, max] = nativeLib.queryTelemetryJournal('temperature', 0, fromMs, toMs, 1);
+        expect(min).toBe(60);
+        expect(max).toBe(60);
+        expect(nativeLib.getTelemetryJournalProfiles(fromMs, toMs).map((change): string => change.profile))
+            .toEqual([profiles.value[0]]);
+    });
+
+    it('overwrites the oldest records once the ring is full', async (): Promise<void> => {
+        const capacity: number = 4;
+        const [fromMs, toMs] = await record(100, HEADER_SIZE + capacity * RECORD_SIZE);
+        expect(fs.statSync(journalPath).size).toBe(HEADER_SIZE + capacity * RECORD_SIZE);
+
+        expect(nativeLib.openTelemetryJournal(journalPath)).toBe(true);
+        // The slot written next is left out
+        expect(countRecords(fromMs, toMs)).toBe(capacity - 1);
+    });
+
+    it('skips records whose checksum does not match', async (): Promise<void> => {
+        const [fromMs, toMs] = await record(50, HEADER_SIZE + 100 * RECORD_SIZE);
+        expect(nativeLib.openTelemetryJournal(journalPath)).toBe(true);
+        const recorded: number = countRecords(fromMs, toMs);
+        expect(recorded).toBeGreaterThan(1);
+        nativeLib.closeTelemetryJournal();
+
+        patchJournal(HEADER_SIZE + TEMPERATURE_OFFSET, (recordData: Buffer): void => {
+            recordData.writeInt16LE(99);
+        });
+        expect(nativeLib.openTelemetryJournal(journalPath)).toBe(true);
+        expect(countRecords(fromMs, toMs)).toBe(recorded - 1);
+        const [, max] = nativeLib.queryTelemetryJournal('temperature', 0, fromMs, toMs, 1);
+        expect(max).toBe(60);
+    });
+
+    it('continues after the newest valid record when the header lags behind', async (): Promise<void> => {
+        const maxBytes: number = HEADER_SIZE + 100 * RECORD_SIZE;
+        const [fromMs] = await record(50, maxBytes);
+        patchJournal(NEXT_SEQUENCE_OFFSET, (header: Buffer): void => {
+            header.writeBigUInt64LE(1n);
+        });
+
+        nativeLib.setSimulatedTemperature(0, 70);
+        const [, toMs] = await record(50, maxBytes);
+        expect(nativeLib.openTelemetryJournal(journalPath)).toBe(true);
+        const [min, max] = nativeLib.queryTelemetryJournal('temperature', 0, fromMs, toMs, 1);
+        expect(min).toBe(60);
+        expect(max).toBe(70);
+    });
+
+    it('rejects files that are no journal', (): void => {
+        fs.writeFileSync(journalPath, Buffer.alloc(HEADER_SIZE + RECORD_SIZE));
+        expect(nativeLib.openTelemetryJournal(journalPath)).toBe(false);
+        expect(nativeLib.openTelemetryJournal(path.join(tmpDir, 'missing.journal'))).toBe(false);
+    });
+});
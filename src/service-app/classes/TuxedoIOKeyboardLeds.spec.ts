@@ -0,0 +1,112 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import * as fs from 'node:fs';
+import * as os from 'node:os';
+import * as path from 'node:path';
+
+import type { ITuxedoIOAPI, KeyboardLedStats } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+describe('TuxedoIOAPI keyboard LEDs on a fake sysfs tree', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+    const nrLeds: number = 4;
+    let treeDir: string;
+    let ledPaths: string[];
+
+    function readColor(led: number): number[] {
+        // Values are written from offset 0 without truncating, the first line is the latest
+        return fs
+            .readFileSync(path.join(ledPaths[led], 'multi_intensity'), 'utf-8')
+            .split('\n')[0]
+            .split(' ')
+            .slice(0, 3)
+            .map((value: string): number => Number.parseInt(value, 10));
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        treeDir = fs.mkdtempSync(path.join(os.tmpdir(), 'tcc-leds-'));
+        fs.mkdirSync(path.join(treeDir, 'device', 'controls'), { recursive: true });
+        fs.writeFileSync(path.join(treeDir, 'device', 'controls', 'buffer_input'), '0');
+        ledPaths = [];
+        for (let i: number = 0; i < nrLeds; ++i) {
+            const ledPath: string = path.join(treeDir, i === 0 ? 'rgb:kbd_backlight' : `rgb:kbd_backlight_${i}`);
+            fs.mkdirSync(ledPath);
+            fs.writeFileSync(path.join(ledPath, 'multi_intensity'), '000 000 000');
+            fs.writeFileSync(path.join(ledPath, 'brightness'), '0');
+            fs.symlinkSync(path.join(treeDir, 'device'), path.join(ledPath, 'device'));
+            ledPaths.push(ledPath);
+        }
+    });
+
+    afterEach((): void => {
+        nativeLib?.closeKeyboardLeds();
+        if (treeDir !== undefined) {
+            fs.rmSync(treeDir, { recursive: true, force: true });
+        }
+    });
+
+    it('writes only changed LEDs', (): void => {
+        expect(nativeLib.openKeyboardLeds(ledPaths)).toBe(true);
+        const frame: Uint8Array = Uint8Array.from([255, 0, 0, 0, 255, 0, 0, 0, 255, 10, 20, 30]);
+
+        expect(nativeLib.writeKeyboardFrame(frame)).toBe(nrLeds);
+        expect(readColor(3)).toEqual([10, 20, 30]);
+        expect(nativeLib.writeKeyboardFrame(frame)).toBe(0);
+
+        frame[4] = 128;
+        expect(nativeLib.writeKeyboardFrame(frame)).toBe(1);
+        expect(readColor(1)).toEqual([0, 128, 0]);
+
+        nativeLib.invalidateKeyboardFrame();
+        expect(nativeLib.writeKeyboardFrame(frame)).toBe(nrLeds);
+
+        const stats: KeyboardLedStats = nativeLib.getKeyboardLedStats();
+        expect(stats.leds).toBe(nrLeds);
+        expect(stats.frames).toBe(4);
+        expect(stats.ledWrites).toBe(9);
+        expect(stats.ledsSkipped).toBe(7);
+        expect(stats.errors).toBe(0);
+    });
+
+    it('fails to open missing LEDs', (): void => {
+        expect(nativeLib.openKeyboardLeds([path.join(treeDir, 'missing')])).toBe(false);
+        expect(nativeLib.writeKeyboardFrame(new Uint8Array(3))).toBe(-1);
+        expect(nativeLib.startKeyboardAnimation({ effect: 'wave' })).toBe(false);
+    });
+
+    it('animates on a native timer', async (): Promise<void> => {
+        expect(nativeLib.openKeyboardLeds(ledPaths)).toBe(true);
+        expect(nativeLib.startKeyboardAnimation({ effect: 'breathe' })).toBe(false);
+        expect(nativeLib.startKeyboardAnimation({ effect: 'wave', fps: 60, periodMs: 500 })).toBe(true);
+        await new Promise((resolve: (value: unknown) => void): NodeJS.Timeout => setTimeout(resolve, 300));
+
+        const stats: KeyboardLedStats = nativeLib.getKeyboardLedStats();
+        expect(stats.animating).toBe(true);
+        expect(stats.animationFrames).toBeGreaterThan(5);
+        expect(stats.ledWrites).toBeGreaterThan(nrLeds);
+
+        // A frame from JS replaces the animation
+        expect(nativeLib.writeKeyboardFrame(new Uint8Array(nrLeds * 3))).toBeGreaterThanOrEqual(0);
+        expect(nativeLib.getKeyboardLedStats().animating).toBe(false);
+        expect(readColor(0)).toEqual([0, 0, 0]);
+    });
+});
@@ -0,0 +1,139 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import * as fs from 'node:fs';
+import * as os from 'node:os';
+import * as path from 'node:path';
+
+import type { ITuxedoIOAPI, LoginSessionSources, LoginSessions } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+// struct utmpx as laid out by glibc on x86_64 and aarch64
+const UTMP_RECORD_SIZE: number = 384;
+const USER_PROCESS: number = 7;
+
+function utmpRecord(user: string, line: string, host: string, pid: number, loginTimeSec: number): Buffer {
+    const record: Buffer = Buffer.alloc(UTMP_RECORD_SIZE);
+    record.writeInt16LE(USER_PROCESS, 0);
+    record.writeInt32LE(pid, 4);
+    record.write(line, 8, 32, 'utf-8');
+    record.write(user, 44, 32, 'utf-8');
+    record.write(host, 76, 256, 'utf-8');
+    record.writeInt32LE(loginTimeSec, 340);
+    return record;
+}
+
+class LoginSessionsStub implements LoginSessions {
+    watching: boolean;
+    reloads: number;
+    lastReloadUs: number;
+    sessions: LoginSessions['sessions'] = [];
+    logins: LoginSessions['logins'] = [];
+}
+
+describe('TuxedoIOAPI login sessions from fixture files', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+    let fixtureDir: string;
+    let utmpPath: string;
+    let sessionsDir: string;
+
+    function readSessions(): LoginSessions {
+        const snapshot: LoginSessions = new LoginSessionsStub();
+        expect(nativeLib.getLoginSessions(snapshot, { utmpPath, sessionsDir })).toBe(true);
+        return snapshot;
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        fixtureDir = fs.mkdtempSync(path.join(os.tmpdir(), 'tcc-logins-'));
+        utmpPath = path.join(fixtureDir, 'utmp');
+        sessionsDir = path.join(fixtureDir, 'sessions');
+        fs.mkdirSync(sessionsDir);
+        fs.writeFileSync(utmpPath, utmpRecord('alice', 'tty2', ':0', 1234, 1700000000));
+        fs.writeFileSync(
+            path.join(sessionsDir, '2'),
+            '# This is private data. Do not parse.\nUID=1000\nUSER=alice\nACTIVE=1\nSTATE=active\nREMOTE=0\n' +
+                'TYPE=x11\nCLASS=user\nSEAT=seat0\nTTY=tty2\nDISPLAY=:0\nSERVICE=sddm\nDESKTOP=KDE\n' +
+                'VTNR=2\nLEADER=1234\n',
+        );
+        fs.writeFileSync(path.join(sessionsDir, 'c1'), 'UID=973\nUSER=sddm\nSTATE=online\nTYPE=x11\nCLASS=greeter\n');
+        fs.writeFileSync(path.join(sessionsDir, '2.ref'), '');
+    });
+
+    afterEach((): void => {
+        if (fixtureDir !== undefined) {
+            fs.rmSync(fixtureDir, { recursive: true, force: true });
+        }
+    });
+
+    it('reads logind sessions and utmp logins', (): void => {
+        const snapshot: LoginSessions = readSessions();
+        expect(snapshot.sessions.map((session): string => session.id)).toEqual(['2', 'c1']);
+        expect(snapshot.sessions[0]).toEqual(
+            jasmine.objectContaining({
+                user: 'alice',
+                uid: 1000,
+                seat: 'seat0',
+                display: ':0',
+                type: 'x11',
+                class: 'user',
+                state: 'active',
+                active: true,
+                remote: false,
+                vtnr: 2,
+                leader: 1234,
+            }),
+        );
+        expect(snapshot.sessions[1].class).toBe('greeter');
+        expect(snapshot.logins).toEqual([
+            { user: 'alice', line: 'tty2', host: ':0', pid: 1234, loginTimeMs: 1700000000000 },
+        ]);
+    });
+
+    it('rereads only after a source changed', (): void => {
+        const first: LoginSessions = readSessions();
+        expect(first.watching).toBe(true);
+        expect(readSessions().reloads).toBe(first.reloads);
+
+        fs.appendFileSync(utmpPath, utmpRecord('bob', 'pts/0', '10.0.0.2', 4321, 1700000100));
+        const appended: LoginSessions = readSessions();
+        expect(appended.reloads).toBe(first.reloads + 1);
+        expect(appended.logins.map((login): string => login.user)).toEqual(['alice', 'bob']);
+
+        fs.rmSync(path.join(sessionsDir, 'c1'));
+        const removed: LoginSessions = readSessions();
+        expect(removed.reloads).toBe(appended.reloads + 1);
+        expect(removed.sessions.map((session): string => session.id)).toEqual(['2']);
+
+        fs.writeFileSync(path.join(fixtureDir, 'unrelated'), '');
+        expect(readSessions().reloads).toBe(removed.reloads);
+    });
+
+    it('reports missing sources', (): void => {
+        const snapshot: LoginSessions = new LoginSessionsStub();
+        const sources: LoginSessionSources = {
+            utmpPath: path.join(fixtureDir, 'missing'),
+            sessionsDir: path.join(fixtureDir, 'missing.d'),
+        };
+        expect(nativeLib.getLoginSessions(snapshot, sources)).toBe(false);
+        expect(snapshot.sessions).toEqual([]);
+        expect(snapshot.logins).toEqual([]);
+    });
+});
@@ -0,0 +1,90 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+
+import type { ITuxedoIOAPI, LoopMonitorStats, ObjWrapper } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+function blockEventLoop(durationMs: number): void {
+    const endMs: number = Date.now() + durationMs;
+    while (Date.now() < endMs) {
+        // Busy wait like a synchronous execSync would
+    }
+}
+
+function delay(ms: number): Promise<void> {
+    return new Promise((resolve): NodeJS.Timeout => setTimeout(resolve, ms));
+}
+
+describe('TuxedoIOAPI loop monitor', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        nativeLib.resetLoopMonitor();
+        expect(nativeLib.startLoopMonitor(10)).toBe(true);
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopLoopMonitor();
+        nativeLib?.stopIoctlSimulation();
+    });
+
+    it('measures a blocked event loop', async (): Promise<void> => {
+        await delay(30);
+        blockEventLoop(80);
+        await delay(30);
+
+        const stats: LoopMonitorStats = nativeLib.getLoopMonitorStats();
+        expect(stats.running).toBe(true);
+        expect(stats.loopLag.count).toBeGreaterThan(1);
+        expect(stats.loopLag.maxMs).toBeGreaterThanOrEqual(50);
+        expect(stats.loopLag.buckets.length).toBe(stats.bucketBoundsMs.length + 1);
+        expect(stats.loopLag.buckets.reduce((sum: number, count: number): number => sum + count, 0)).toBe(
+            stats.loopLag.count,
+        );
+    });
+
+    it('counts missed deadlines and attributes fan calls to the running worker', (): void => {
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+        const temperature: ObjWrapper<number> = { value: 0 };
+
+        nativeLib.beginWorkerRun('FanControlWorker', 20, 100);
+        nativeLib.endWorkerRun('FanControlWorker');
+        nativeLib.beginWorkerRun('FanControlWorker', 150, 100);
+        expect(nativeLib.getFanTemperature(0, temperature)).toBe(true);
+        nativeLib.endWorkerRun('FanControlWorker');
+        nativeLib.recordGcPause(4, 12);
+
+        const stats: LoopMonitorStats = nativeLib.getLoopMonitorStats();
+        const worker: LoopMonitorStats['workers'][number] = stats.workers.find(
+            (entry): boolean => entry.name === 'FanControlWorker',
+        );
+        expect(worker.runs).toBe(2);
+        expect(worker.missed).toBe(1);
+        expect(worker.inProgress).toBe(false);
+        expect(worker.lateness.maxMs).toBeGreaterThanOrEqual(150);
+        expect(worker.fanCallLateness.count).toBe(1);
+        expect(worker.fanCallLateness.maxMs).toBeGreaterThanOrEqual(150);
+        expect(stats.fanCalls.count).toBe(1);
+        expect(stats.gcPauses.major).toBe(1);
+        expect(stats.gcPause.maxMs).toBe(12);
+    });
+});
@@ -0,0 +1,117 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import * as fs from 'node:fs';
+import * as http from 'node:http';
+import * as os from 'node:os';
+import * as path from 'node:path';
+
+import type { ITuxedoIOAPI, ObjWrapper } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+interface MetricsResponse {
+    status: number;
+    contentType: string;
+    body: string;
+}
+
+function request(socketPath: string, method: string, headers: http.OutgoingHttpHeaders = {}): Promise<MetricsResponse> {
+    return new Promise((resolve: (response: MetricsResponse) => void, reject: (err: Error) => void): void => {
+        const clientRequest: http.ClientRequest = http.request(
+            { socketPath, path: '/metrics', method, headers },
+            (response: http.IncomingMessage): void => {
+                let body: string = '';
+                response.setEncoding('utf8');
+                response.on('data', (chunk: string): void => {
+                    body += chunk;
+                });
+                response.on('end', (): void => {
+                    resolve({ status: response.statusCode, contentType: response.headers['content-type'], body });
+                });
+            },
+        );
+        clientRequest.on('error', reject);
+        clientRequest.end();
+    });
+}
+
+describe('TuxedoIOAPI metrics endpoint', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+    let tmpDir: string;
+    let socketPath: string;
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'tcc-metrics-'));
+        socketPath = path.join(tmpDir, 'metrics.sock');
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+        expect(nativeLib.startMetricsServer(socketPath)).toBe(true);
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopMetricsServer();
+        nativeLib?.stopIoctlSimulation();
+        if (tmpDir !== undefined) {
+            fs.rmSync(tmpDir, { recursive: true, force: true });
+        }
+    });
+
+    it('serves the Prometheus text format by default', async (): Promise<void> => {
+        const profiles: ObjWrapper<string[]> = { value: [] };
+        expect(nativeLib.getAvailableODMPerformanceProfiles(profiles)).toBe(true);
+        expect(nativeLib.setODMPerformanceProfile(profiles.value[0])).toBe(true);
+
+        const response: MetricsResponse = await request(socketPath, 'GET');
+        expect(response.status).toBe(200);
+        expect(response.contentType).toContain('text/plain; version=0.0.4');
+        expect(response.body).toContain('# TYPE tuxedo_io_info gauge\n');
+        expect(response.body).toContain(`tuxedo_io_odm_profile{profile="${profiles.value[0]}"} 1\n`);
+        expect(response.body).toContain('# TYPE tuxedo_io_ioctl_calls_total counter\n');
+        expect(response.body).not.toContain('# EOF');
+    });
+
+    it('serves OpenMetrics if requested', async (): Promise<void> => {
+        const response: MetricsResponse = await request(socketPath, 'GET', {
+            Accept: 'application/openmetrics-text; version=1.0.0',
+        });
+        expect(response.status).toBe(200);
+        expect(response.contentType).toContain('application/openmetrics-text');
+        expect(response.body).toContain('# TYPE tuxedo_io info\n');
+        // Counter families are named without the _total suffix
+        expect(response.body).toContain('# TYPE tuxedo_io_ioctl_calls counter\n');
+        expect(response.body.endsWith('# EOF\n')).toBe(true);
+    });
+
+    it('rejects other methods', async (): Promise<void> => {
+        const response: MetricsResponse = await request(socketPath, 'POST');
+        expect(response.status).toBe(405);
+    });
+
+    it('serves a single server at a time', (): void => {
+        expect(nativeLib.startMetricsServer(path.join(tmpDir, 'second.sock'))).toBe(false);
+    });
+
+    it('rejects ports out of range', (): void => {
+        nativeLib.stopMetricsServer();
+        for (const port of ['0', '65536', '99999999999999999999']) {
+            expect(nativeLib.startMetricsServer(port)).toBe(false);
+        }
+    });
+});
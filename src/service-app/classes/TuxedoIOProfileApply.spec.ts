@@ -0,0 +1,111 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+
+import type {
+    ITuxedoIOAPI,
+    ObjWrapper,
+    ProfileApplyRequest,
+    ProfileApplyResult,
+    ProfileApplyStep,
+    TDPInfo,
+} from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+describe('TuxedoIOAPI profile transaction', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+
+    function stepNames(result: ProfileApplyResult): string[] {
+        return result.steps.map((step: ProfileApplyStep): string => step.name);
+    }
+
+    function profileRequest(): ProfileApplyRequest {
+        const profiles: ObjWrapper<string[]> = { value: [] };
+        expect(nativeLib.getAvailableODMPerformanceProfiles(profiles)).toBe(true);
+        const tdpInfo: TDPInfo[] = [];
+        expect(nativeLib.getTDPInfo(tdpInfo)).toBe(true);
+        return {
+            odmProfile: profiles.value[profiles.value.length - 1],
+            tdpValues: tdpInfo.map((tdp: TDPInfo): number => tdp.min),
+            fanMode: 'manual',
+            fanSpeeds: [60, -1],
+        };
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopIoctlSimulation();
+    });
+
+    it('applies ODM profile, TDPs, fan mode and fan speeds in order', async (): Promise<void> => {
+        const request: ProfileApplyRequest = profileRequest();
+        const result: ProfileApplyResult = await nativeLib.applyProfile(request);
+
+        expect(result.success).toBe(true);
+        // Fan 1 is left alone
+        expect(stepNames(result)).toEqual(['odmProfile', 'tdp0', 'tdp1', 'tdp2', 'fanMode', 'fan0']);
+
+        const fanSpeed: ObjWrapper<number> = { value: -1 };
+        expect(nativeLib.getFanSpeedPercent(0, fanSpeed)).toBe(true);
+        expect(fanSpeed.value).toBe(60);
+        const tdpInfo: TDPInfo[] = [];
+        expect(nativeLib.getTDPInfo(tdpInfo)).toBe(true);
+        expect(tdpInfo.map((tdp: TDPInfo): number => tdp.current)).toEqual(request.tdpValues);
+    });
+
+    it('skips steps whose target is already active', async (): Promise<void> => {
+        const request: ProfileApplyRequest = profileRequest();
+        await nativeLib.applyProfile(request);
+        const result: ProfileApplyResult = await nativeLib.applyProfile(request);
+
+        expect(result.success).toBe(true);
+        expect(result.steps.length).toBe(6);
+        expect(result.steps.every((step: ProfileApplyStep): boolean => step.skipped && step.success)).toBe(true);
+    });
+
+    it('continues after a failed step and reports it', async (): Promise<void> => {
+        const request: ProfileApplyRequest = { ...profileRequest(), odmProfile: 'no-such-profile' };
+        const result: ProfileApplyResult = await nativeLib.applyProfile(request);
+
+        expect(result.success).toBe(false);
+        expect(result.steps[0]).toEqual(jasmine.objectContaining({ name: 'odmProfile', success: false }));
+        expect(result.steps.slice(1).every((step: ProfileApplyStep): boolean => step.success)).toBe(true);
+    });
+
+    it('does not write fan speeds in auto mode', async (): Promise<void> => {
+        const result: ProfileApplyResult = await nativeLib.applyProfile({ fanMode: 'auto', fanSpeeds: [60, 60] });
+
+        expect(result.success).toBe(true);
+        expect(stepNames(result)).toEqual(['fanMode']);
+    });
+
+    it('rejects invalid requests', (): void => {
+        expect((): Promise<ProfileApplyResult> => nativeLib.applyProfile({ fanMode: 'off' as 'auto' })).toThrowError(
+            /invalid fan mode/,
+        );
+        expect((): Promise<ProfileApplyResult> =>
+            nativeLib.applyProfile({ fanSpeeds: ['fast' as unknown as number] }),
+        ).toThrowError(/invalid fan speed/);
+    });
+});
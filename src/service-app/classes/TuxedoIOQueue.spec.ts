@@ -0,0 +1,157 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+
+import type {
+    ConcurrentDeviceCallResult, IoctlQueueStats, IoctlSimulationStats, ITuxedoIOAPI, ObjWrapper,
+} from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+type PriorityClass = 'high' | 'normal' | 'low';
+
+function delay(ms: number): Promise<void> {
+    return new Promise((resolve: () => void): NodeJS.Timeout => setTimeout(resolve, ms));
+}
+
+describe('TuxedoIOAPI ioctl submission queue', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+
+    // Calls submitted per priority class while running action
+    async function submittedDuring(action: () => void | Promise<unknown>): Promise<Record<PriorityClass, number>> {
+        const before: IoctlQueueStats = nativeLib.getIoctlQueueStats();
+        await action();
+        const after: IoctlQueueStats = nativeLib.getIoctlQueueStats();
+        const submitted = (priority: PriorityClass): number =>
+            after.priorities[priority].submitted - before.priorities[priority].submitted;
+        return { high: submitted('high'), normal: submitted('normal'), low: submitted('low') };
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+        // Open and identify the simulated device outside of the measurements
+        nativeLib.wmiAvailable();
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopSensorSampler();
+        nativeLib?.stopIoctlSimulation();
+    });
+
+    it('submits informational reads with low priority', async (): Promise<void> => {
+        const fanSpeed: ObjWrapper<number> = { value: -1 };
+        const submitted: Record<PriorityClass, number> = await submittedDuring((): void => {
+            expect(nativeLib.getFanSpeedPercent(0, fanSpeed)).toBe(true);
+        });
+        expect(submitted).toEqual({ high: 0, normal: 0, low: 1 });
+    });
+
+    it('submits writes with high priority', async (): Promise<void> => {
+        const submitted: Record<PriorityClass, number> = await submittedDuring((): void => {
+            expect(nativeLib.setFanSpeedPercent(0, 50)).toBe(true);
+        });
+        expect(submitted).toEqual({ high: 1, normal: 0, low: 0 });
+    });
+
+    it('submits all calls of a profile switch with high priority', async (): Promise<void> => {
+        const submitted: Record<PriorityClass, number> = await submittedDuring(
+            (): Promise<unknown> => nativeLib.applyProfile({ tdpValues: [20, 30, 40] }),
+        );
+        expect(submitted.high).toBeGreaterThan(3);
+        expect(submitted.normal).toBe(0);
+        expect(submitted.low).toBe(0);
+    });
+
+    it('submits sensor sampling with normal priority', async (): Promise<void> => {
+        const submitted: Record<PriorityClass, number> = await submittedDuring(async (): Promise<void> => {
+            expect(nativeLib.startSensorSampler(50, 50)).toBe(true);
+            await delay(300);
+            nativeLib.stopSensorSampler();
+        });
+        expect(submitted.normal).toBeGreaterThan(0);
+        expect(submitted.high).toBe(0);
+    });
+
+    it('drains the queue after every call', (): void => {
+        nativeLib.setFanSpeedPercent(1, 60);
+        const stats: IoctlQueueStats = nativeLib.getIoctlQueueStats();
+        expect(stats.depth).toBe(0);
+        expect(stats.maxDepth).toBeGreaterThan(0);
+    });
+
+    describe('with concurrent callers', (): void => {
+        beforeEach((): void => {
+            // Slow enough for later callers to queue behind the call in flight
+            nativeLib.startIoctlSimulation({ interface: 'uniwill', transitionLatencyUs: 50000 });
+            nativeLib.wmiAvailable();
+        });
+
+        function transitions(): number {
+            const stats: IoctlSimulationStats = nativeLib.getIoctlSimulationStats();
+            return stats.transitions;
+        }
+
+        it('lets a fan write overtake queued informational reads', async (): Promise<void> => {
+            const results: ConcurrentDeviceCallResult[] = await nativeLib.runConcurrentDeviceCalls([
+                { call: 'getFanSpeed', fan: 0, startMs: 0, priority: 'low' },
+                { call: 'getFanSpeed', fan: 1, startMs: 10, priority: 'low' },
+                { call: 'getFanTemperature', fan: 0, startMs: 10, priority: 'low' },
+                { call: 'getFanTemperature', fan: 1, startMs: 10, priority: 'low' },
+                { call: 'setFanSpeed', fan: 0, value: 40, startMs: 20 },
+            ]);
+            expect(results.every((result: ConcurrentDeviceCallResult): boolean => result.result)).toBe(true);
+            const write: ConcurrentDeviceCallResult = results[4];
+            for (const queuedRead of results.slice(1, 4)) {
+                expect(write.finishedMs).toBeLessThan(queuedRead.finishedMs);
+            }
+        });
+
+        it('answers identical queued reads with one ioctl', async (): Promise<void> => {
+            const transitionsBefore: number = transitions();
+            const coalescedBefore: number = nativeLib.getIoctlQueueStats().coalesced;
+            const results: ConcurrentDeviceCallResult[] = await nativeLib.runConcurrentDeviceCalls([
+                { call: 'getFanTemperature', fan: 0, startMs: 0 },
+                { call: 'getFanSpeed', fan: 1, startMs: 10 },
+                { call: 'getFanSpeed', fan: 1, startMs: 10 },
+            ]);
+            expect(results.every((result: ConcurrentDeviceCallResult): boolean => result.result)).toBe(true);
+            expect(results[1].value).toBe(results[2].value);
+            expect(transitions() - transitionsBefore).toBe(2);
+            expect(nativeLib.getIoctlQueueStats().coalesced - coalescedBefore).toBe(1);
+        });
+
+        it('replaces a queued write by a newer one to the same fan', async (): Promise<void> => {
+            const transitionsBefore: number = transitions();
+            const supersededBefore: number = nativeLib.getIoctlQueueStats().superseded;
+            const results: ConcurrentDeviceCallResult[] = await nativeLib.runConcurrentDeviceCalls([
+                { call: 'getFanTemperature', fan: 0, startMs: 0 },
+                { call: 'setFanSpeed', fan: 0, value: 30, startMs: 10 },
+                { call: 'setFanSpeed', fan: 0, value: 60, startMs: 20 },
+            ]);
+            expect(results.every((result: ConcurrentDeviceCallResult): boolean => result.result)).toBe(true);
+            expect(transitions() - transitionsBefore).toBe(2);
+            expect(nativeLib.getIoctlQueueStats().superseded - supersededBefore).toBe(1);
+
+            const fanSpeed: ObjWrapper<number> = { value: -1 };
+            expect(nativeLib.getFanSpeedPercent(0, fanSpeed)).toBe(true);
+            expect(fanSpeed.value).toBe(60);
+        });
+    });
+});
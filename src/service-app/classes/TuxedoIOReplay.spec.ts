@@ -0,0 +1,185 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import * as fs from 'node:fs';
+import * as os from 'node:os';
+import * as path from 'node:path';
+
+import type { IoctlReplayStats, ITuxedoIOAPI, ModuleInfo } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+const TRACE_HEADER_SIZE: number = 24;
+const RECORD_HEADER_SIZE: number = 24;
+
+// _IOR(IOCTL_MAGIC, nr, pointer) of tuxedo_io_ioctl.h on 64 bit
+function ioctlRead(nr: number): number {
+    return ((2 << 30) | (8 << 16) | (0xec << 8) | nr) >>> 0;
+}
+
+const R_MOD_VERSION: number = ioctlRead(0x00);
+const R_HWCHECK_CL: number = ioctlRead(0x05);
+const R_HWCHECK_UW: number = ioctlRead(0x06);
+
+interface TraceRecord {
+    request: number;
+    result?: number;
+    error?: number;
+    in?: Buffer;
+    out?: Buffer;
+}
+
+function traceHeader(magic: string = 'TCCIOTR', version: number = 1, recordHeaderSize: number = RECORD_HEADER_SIZE): Buffer {
+    const header: Buffer = Buffer.alloc(TRACE_HEADER_SIZE);
+    header.write(magic, 0, 8, 'latin1');
+    header.writeUInt32LE(version, 8);
+    header.writeUInt32LE(recordHeaderSize, 12);
+    return header;
+}
+
+function traceRecord(record: TraceRecord, recordHeaderSize: number = RECORD_HEADER_SIZE): Buffer {
+    const argumentIn: Buffer = record.in ?? Buffer.alloc(0);
+    const argumentOut: Buffer = record.out ?? Buffer.alloc(0);
+    const header: Buffer = Buffer.alloc(recordHeaderSize);
+    header.writeUInt32LE(record.request, 8);
+    header.writeInt32LE(record.result ?? 0, 12);
+    header.writeInt32LE(record.error ?? 0, 16);
+    header.writeUInt16LE(argumentIn.length, 20);
+    header.writeUInt16LE(argumentOut.length, 22);
+    return Buffer.concat([header, argumentIn, argumentOut]);
+}
+
+function int32(value: number): Buffer {
+    const buffer: Buffer = Buffer.alloc(4);
+    buffer.writeInt32LE(value);
+    return buffer;
+}
+
+// Records identifying a uniwill module when the replayed device is opened
+const IDENTIFY_UNIWILL: TraceRecord[] = [
+    { request: R_HWCHECK_CL, out: int32(0) },
+    { request: R_HWCHECK_UW, out: int32(1) },
+];
+
+function moduleVersion(version: string): TraceRecord {
+    return { request: R_MOD_VERSION, out: Buffer.from(version + '\0', 'latin1') };
+}
+
+describe('TuxedoIOAPI ioctl replay', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+    let tmpDir: string;
+
+    function writeTrace(name: string, ...parts: Buffer[]): string {
+        const tracePath: string = path.join(tmpDir, name);
+        fs.writeFileSync(tracePath, Buffer.concat(parts));
+        return tracePath;
+    }
+
+    function readModuleInfo(): [boolean, ModuleInfo] {
+        const moduleInfo: ModuleInfo = { version: '', activeInterface: '', model: '' };
+        const result: boolean = nativeLib.getModuleInfo(moduleInfo);
+        return [result, moduleInfo];
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'tcc-replay-'));
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopIoctlReplay();
+        if (tmpDir !== undefined) {
+            fs.rmSync(tmpDir, { recursive: true, force: true });
+        }
+    });
+
+    it('rejects traces with an invalid header', (): void => {
+        const record: Buffer = traceRecord(moduleVersion('0.3.0'));
+        expect(nativeLib.startIoctlReplay(writeTrace('magic.trace', traceHeader('TCCIOTX'), record))).toBe(false);
+        expect(nativeLib.startIoctlReplay(writeTrace('version.trace', traceHeader('TCCIOTR', 2), record))).toBe(false);
+        expect(nativeLib.startIoctlReplay(writeTrace('small.trace', traceHeader('TCCIOTR', 1, 16), record))).toBe(false);
+        expect(nativeLib.startIoctlReplay(writeTrace('short.trace', traceHeader().subarray(0, 12)))).toBe(false);
+        expect(nativeLib.startIoctlReplay(writeTrace('empty.trace', traceHeader()))).toBe(false);
+        expect(nativeLib.startIoctlReplay(path.join(tmpDir, 'missing.trace'))).toBe(false);
+        expect(nativeLib.getIoctlReplayStats()).toBeNull();
+    });
+
+    it('drops a truncated record at the end of the trace', (): void => {
+        const truncated: Buffer = traceRecord(moduleVersion('0.3.2'));
+        const tracePath: string = writeTrace('truncated.trace', traceHeader(),
+            traceRecord(moduleVersion('0.3.0')), traceRecord(moduleVersion('0.3.1')),
+            truncated.subarray(0, truncated.length - 2));
+        expect(nativeLib.startIoctlReplay(tracePath)).toBe(true);
+        expect(nativeLib.getIoctlReplayStats().records).toBe(2);
+    });
+
+    it('skips unknown record header fields of newer writers', (): void => {
+        const recordHeaderSize: number = RECORD_HEADER_SIZE + 8;
+        const tracePath: string = writeTrace('padded.trace', traceHeader('TCCIOTR', 1, recordHeaderSize),
+            ...[...IDENTIFY_UNIWILL, moduleVersion('0.3.0')].map((record: TraceRecord): Buffer => traceRecord(record, recordHeaderSize)));
+        expect(nativeLib.startIoctlReplay(tracePath)).toBe(true);
+        expect(nativeLib.getIoctlReplayStats().records).toBe(3);
+
+        const [result, moduleInfo] = readModuleInfo();
+        expect(result).toBe(true);
+        expect(moduleInfo.version).toBe('0.3.0');
+        expect(moduleInfo.activeInterface).toBe('uniwill');
+    });
+
+    it('serves the records of a request in order and repeats the last one', (): void => {
+        const tracePath: string = writeTrace('ordered.trace', traceHeader(),
+            ...[...IDENTIFY_UNIWILL, moduleVersion('0.3.0'), moduleVersion('0.3.1')].map((record: TraceRecord): Buffer => traceRecord(record)));
+        expect(nativeLib.startIoctlReplay(tracePath)).toBe(true);
+
+        const versions: string[] = [];
+        for (let i: number = 0; i < 3; ++i) {
+            const [result, moduleInfo] = readModuleInfo();
+            expect(result).toBe(true);
+            versions.push(moduleInfo.version);
+        }
+        expect(versions).toEqual(['0.3.0', '0.3.1', '0.3.1']);
+
+        const stats: IoctlReplayStats = nativeLib.getIoctlReplayStats();
+        expect(stats.records).toBe(4);
+        expect(stats.repeated).toBeGreaterThanOrEqual(1);
+        expect(stats.diverged).toBe(0);
+    });
+
+    it('answers requests missing from the trace with ENOTTY', (): void => {
+        const tracePath: string = writeTrace('partial.trace', traceHeader(),
+            ...[...IDENTIFY_UNIWILL, moduleVersion('0.3.0')].map((record: TraceRecord): Buffer => traceRecord(record)));
+        expect(nativeLib.startIoctlReplay(tracePath)).toBe(true);
+
+        // The uniwill model id is not part of the trace
+        const [, moduleInfo] = readModuleInfo();
+        expect(moduleInfo.model).toBe('');
+        expect(nativeLib.getIoctlReplayStats().missing).toBeGreaterThan(0);
+    });
+
+    it('replays recorded errors and counts diverged inputs', (): void => {
+        const tracePath: string = writeTrace('errors.trace', traceHeader(),
+            ...IDENTIFY_UNIWILL.map((record: TraceRecord): Buffer => traceRecord(record)),
+            traceRecord({ request: R_MOD_VERSION, result: -1, error: 5, in: Buffer.from('x', 'latin1') }));
+        expect(nativeLib.startIoctlReplay(tracePath)).toBe(true);
+
+        const [result] = readModuleInfo();
+        expect(result).toBe(false);
+        expect(nativeLib.getIoctlReplayStats().diverged).toBe(1);
+    });
+});
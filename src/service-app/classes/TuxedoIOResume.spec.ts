@@ -0,0 +1,88 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+
+import type { ITuxedoIOAPI, ObjWrapper, ResumeStats, TDPInfo } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+describe('TuxedoIOAPI resume restore', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+
+    function readTDPs(): number[] {
+        const tdpInfo: TDPInfo[] = [];
+        expect(nativeLib.getTDPInfo(tdpInfo)).toBe(true);
+        return tdpInfo.map((tdp: TDPInfo): number => tdp.current);
+    }
+
+    function readFanSpeed(fanNumber: number): number {
+        const fanSpeed: ObjWrapper<number> = { value: -1 };
+        expect(nativeLib.getFanSpeedPercent(fanNumber, fanSpeed)).toBe(true);
+        return fanSpeed.value;
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopResumeWatch();
+        nativeLib?.stopIoctlSimulation();
+    });
+
+    it('writes the recorded state back to a module that lost it', (): void => {
+        const profiles: ObjWrapper<string[]> = { value: [] };
+        expect(nativeLib.getAvailableODMPerformanceProfiles(profiles)).toBe(true);
+        // Overwrite everything earlier specs recorded on this session, uniwill has no webcam switch
+        expect(nativeLib.setODMPerformanceProfile(profiles.value[0])).toBe(true);
+        expect(nativeLib.setTDPValues([20, 30, 40])).toBe(true);
+        expect(nativeLib.setFansAuto()).toBe(true);
+        expect(nativeLib.setEnableModeSet(true)).toBe(true);
+        expect(nativeLib.setFanSpeedPercent(0, 40)).toBe(true);
+        expect(nativeLib.setFanSpeedPercent(1, 70)).toBe(true);
+
+        // Like the EC after resume, a fresh module starts with its defaults
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+        expect(readTDPs()).not.toEqual([20, 30, 40]);
+        expect(readFanSpeed(1)).not.toBe(70);
+
+        expect(nativeLib.restoreDeviceState()).toBe(true);
+        expect(readTDPs()).toEqual([20, 30, 40]);
+        expect(readFanSpeed(0)).toBe(40);
+        expect(readFanSpeed(1)).toBe(70);
+    });
+
+    it('runs a single resume watch', (): void => {
+        const resumes: ResumeStats[] = [];
+        expect(
+            nativeLib.startResumeWatch((stats: ResumeStats): void => {
+                resumes.push(stats);
+            }),
+        ).toBe(true);
+        expect(nativeLib.startResumeWatch()).toBe(false);
+        nativeLib.stopResumeWatch();
+        expect(nativeLib.startResumeWatch()).toBe(true);
+
+        // Nothing was suspended meanwhile
+        const stats: ResumeStats = nativeLib.getResumeStats();
+        expect(stats.resumeCount).toBe(0);
+        expect(resumes.length).toBe(0);
+    });
+});
@@ -0,0 +1,113 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+
+import type { DeviceSessionStats, ITuxedoIOAPI, ObjWrapper, SamplerStats } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+function delay(ms: number): Promise<void> {
+    return new Promise((resolve: () => void): NodeJS.Timeout => setTimeout(resolve, ms));
+}
+
+describe('TuxedoIOAPI adaptive sensor sampler', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+        nativeLib.setSimulatedTemperature(0, 50);
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopSensorSampler();
+        nativeLib?.stopIoctlSimulation();
+    });
+
+    it('samples a steady sensor at the slowest interval', async (): Promise<void> => {
+        expect(nativeLib.startSensorSampler(20, 200)).toBe(true);
+        await delay(700);
+
+        const temperature: ObjWrapper<number> = { value: -1 };
+        expect(nativeLib.getSampledFanTemperature(0, temperature)).toBe(true);
+        expect(temperature.value).toBe(50);
+        const stats: SamplerStats = nativeLib.getSamplerStats();
+        expect(stats.running).toBe(true);
+        expect(stats.sensors[0].slope).toBe(0);
+        expect(stats.sensors[0].intervalMs).toBe(200);
+        expect(stats.wakeupsPerMinute).toBeGreaterThan(2);
+    });
+
+    it('samples faster while the temperature moves towards a breakpoint', async (): Promise<void> => {
+        expect(nativeLib.startSensorSampler(20, 1000)).toBe(true);
+        nativeLib.setSamplerFanTable(0, [
+            { temp: 50, speed: 20 },
+            { temp: 60, speed: 40 },
+            { temp: 70, speed: 60 },
+            { temp: 80, speed: 80 },
+        ]);
+        // About 20 °C/s, the second sample follows the first after a second
+        for (let temperature: number = 51; temperature <= 75; ++temperature) {
+            await delay(50);
+            nativeLib.setSimulatedTemperature(0, temperature);
+        }
+
+        const stats: SamplerStats = nativeLib.getSamplerStats();
+        expect(stats.sensors[0].slope).toBeGreaterThan(0);
+        expect(stats.sensors[0].breakpointDistance).toBeLessThanOrEqual(10);
+        expect(stats.sensors[0].intervalMs).toBeLessThan(1000);
+    });
+
+    it('drops the sample once a read fails', async (): Promise<void> => {
+        expect(nativeLib.startSensorSampler(20, 200)).toBe(true);
+        await delay(100);
+        const temperature: ObjWrapper<number> = { value: -1 };
+        expect(nativeLib.getSampledFanTemperature(0, temperature)).toBe(true);
+
+        // Reads as no sensor
+        nativeLib.setSimulatedTemperature(0, 0);
+        await delay(300);
+        expect(nativeLib.getSampledFanTemperature(0, temperature)).toBe(false);
+        expect(nativeLib.getSamplerStats().sensors[0].temperature).toBe(-1);
+    });
+
+    it('reads through the shared device session', async (): Promise<void> => {
+        // Opens the simulated device in the session
+        expect(nativeLib.wmiAvailable()).toBe(true);
+        const before: DeviceSessionStats = nativeLib.getDeviceSessionStats();
+        expect(nativeLib.startSensorSampler(20, 200)).toBe(true);
+        await delay(100);
+        nativeLib.stopSensorSampler();
+
+        const after: DeviceSessionStats = nativeLib.getDeviceSessionStats();
+        expect(after.opens).toBe(before.opens);
+        expect(after.acquisitions).toBeGreaterThan(before.acquisitions + 1);
+    });
+
+    it('rejects invalid intervals and a second start', (): void => {
+        expect(nativeLib.startSensorSampler(200, 20)).toBe(false);
+        expect(nativeLib.startSensorSampler(20, 200)).toBe(true);
+        expect(nativeLib.startSensorSampler(20, 200)).toBe(false);
+
+        nativeLib.stopSensorSampler();
+        const stats: SamplerStats = nativeLib.getSamplerStats();
+        expect(stats.running).toBe(false);
+        expect(stats.sensors).toEqual([]);
+    });
+});
@@ -0,0 +1,147 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+
+import type { ITuxedoIOAPI, SchedulerStats, TelemetrySnapshot } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib, TelemetrySnapshotStub } from './NativeLibSpecHelper';
+
+type JobStats = SchedulerStats['jobs'][number];
+
+function delay(ms: number): Promise<void> {
+    return new Promise((resolve: () => void): NodeJS.Timeout => setTimeout(resolve, ms));
+}
+
+describe('TuxedoIOAPI job scheduler', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+    let jobIds: number[];
+    let dispatched: number[][];
+
+    function addJob(name: string, periodMs: number, slackMs: number, hardwareReads?: string[]): number {
+        const jobId: number = nativeLib.addScheduledJob(name, periodMs, slackMs, hardwareReads);
+        expect(jobId).toBeGreaterThanOrEqual(0);
+        jobIds.push(jobId);
+        return jobId;
+    }
+
+    function jobStats(jobId: number): JobStats {
+        return nativeLib.getSchedulerStats().jobs.find((job: JobStats): boolean => job.id === jobId);
+    }
+
+    // Completes every dispatched job except the ones given
+    function startScheduler(keepRunning: number[] = []): void {
+        const started: boolean = nativeLib.startScheduler((ids: number[]): void => {
+            dispatched.push(ids);
+            for (const id of ids) {
+                if (!keepRunning.includes(id)) {
+                    nativeLib.completeScheduledJob(id);
+                }
+            }
+        });
+        expect(started).toBe(true);
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        jobIds = [];
+        dispatched = [];
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopScheduler();
+        for (const jobId of jobIds ?? []) {
+            nativeLib.removeScheduledJob(jobId);
+        }
+        nativeLib?.stopIoctlSimulation();
+    });
+
+    it('dispatches jobs sharing a deadline in one wakeup', async (): Promise<void> => {
+        const first: number = addJob('first', 100, 50);
+        const second: number = addJob('second', 100, 50);
+        startScheduler();
+        await delay(550);
+
+        const firstStats: JobStats = jobStats(first);
+        const secondStats: JobStats = jobStats(second);
+        expect(firstStats.runs).toBeGreaterThan(2);
+        expect(secondStats.runs).toBeGreaterThan(2);
+        expect(nativeLib.getSchedulerStats().wakeups).toBeLessThan(firstStats.runs + secondStats.runs);
+        expect(dispatched.some((ids: number[]): boolean => ids.includes(first) && ids.includes(second))).toBe(true);
+    });
+
+    it('counts deadlines of unfinished runs as overruns', async (): Promise<void> => {
+        const jobId: number = addJob('stuck', 50, 0);
+        startScheduler([jobId]);
+        await delay(300);
+
+        const stats: JobStats = jobStats(jobId);
+        expect(stats.runs).toBe(1);
+        expect(stats.overruns).toBeGreaterThan(0);
+
+        nativeLib.completeScheduledJob(jobId);
+        await delay(150);
+        expect(jobStats(jobId).runs).toBeGreaterThan(1);
+    });
+
+    it('reads the hardware of due jobs into the telemetry', async (): Promise<void> => {
+        expect(nativeLib.setFanSpeedPercent(1, 70)).toBe(true);
+        addJob('fans', 50, 0, ['fanSpeeds']);
+        startScheduler();
+        await delay(200);
+
+        const snapshot: TelemetrySnapshot = new TelemetrySnapshotStub();
+        nativeLib.getTelemetry(snapshot);
+        expect(snapshot.fans[1].speedPercent).toBe(70);
+    });
+
+    it('reads temperatures and fan speeds with one status read', async (): Promise<void> => {
+        nativeLib.setSimulatedTemperature(0, 64);
+        expect(nativeLib.setFanSpeedPercent(0, 40)).toBe(true);
+        addJob('fans', 50, 0, ['temperatures', 'fanSpeeds']);
+        startScheduler();
+        await delay(200);
+
+        const snapshot: TelemetrySnapshot = new TelemetrySnapshotStub();
+        nativeLib.getTelemetry(snapshot);
+        expect(snapshot.fans[0].temperature).toBe(64);
+        expect(snapshot.fans[0].speedPercent).toBe(40);
+        expect(snapshot.fans[0].temperatureUpdatedNs).toBeGreaterThan(0);
+    });
+
+    it('reads the hardware registered after the job was added', async (): Promise<void> => {
+        nativeLib.setSimulatedTemperature(1, 57);
+        const jobId: number = addJob('fans', 50, 0, []);
+        startScheduler();
+        expect(nativeLib.setScheduledJobReads(jobId, ['temperatures'])).toBe(true);
+        await delay(200);
+
+        const snapshot: TelemetrySnapshot = new TelemetrySnapshotStub();
+        nativeLib.getTelemetry(snapshot);
+        expect(snapshot.fans[1].temperature).toBe(57);
+        expect(nativeLib.setScheduledJobReads(-1, [])).toBe(false);
+    });
+
+    it('rejects invalid jobs', (): void => {
+        expect(nativeLib.addScheduledJob('invalid', 0, 0)).toBe(-1);
+        expect((): number => nativeLib.addScheduledJob('invalid', 100, 0, ['keyboard'])).toThrowError(
+            /invalid hardware read/,
+        );
+    });
+});
@@ -0,0 +1,106 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import * as os from 'node:os';
+
+import type { DeviceStatus, IoctlSimulationStats, ITuxedoIOAPI, TDPInfo } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+class DeviceStatusStub implements DeviceStatus {
+    fans: Array<{ speedPercent: number; temperature: number }> = [];
+    tdps: Array<{ min: number; max: number; current: number }> = [];
+}
+
+describe('TuxedoIOAPI on a simulated module', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+
+    function readStatus(): [DeviceStatus, IoctlSimulationStats] {
+        const status: DeviceStatus = new DeviceStatusStub();
+        expect(nativeLib.getDeviceStatus(status)).toBe(true);
+        return [status, nativeLib.getIoctlSimulationStats()];
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopIoctlSimulation();
+    });
+
+    for (const interfaceName of ['uniwill', 'clevo'] as const) {
+        it(`${interfaceName}: batched and per register status reads agree`, (): void => {
+            nativeLib.startIoctlSimulation({ interface: interfaceName, batchSupport: true });
+            const [batchedStatus, batchedStats] = readStatus();
+
+            nativeLib.startIoctlSimulation({ interface: interfaceName, batchSupport: false });
+            const [singleStatus, singleStats] = readStatus();
+
+            expect(batchedStatus).toEqual(singleStatus);
+            expect(batchedStats.batchCalls).toBe(1);
+            expect(singleStats.batchCalls).toBe(0);
+            expect(batchedStats.registerAccesses).toBe(singleStats.registerAccesses);
+            expect(batchedStats.transitions).toBeLessThan(singleStats.transitions);
+        });
+    }
+
+    it('uniwill: status reads reflect writes in both modes', (): void => {
+        for (const batchSupport of [true, false]) {
+            nativeLib.startIoctlSimulation({ interface: 'uniwill', batchSupport });
+            nativeLib.setSimulatedTemperature(0, 72);
+            expect(nativeLib.setTDPValues([20, 30, 40])).toBe(true);
+            expect(nativeLib.setFanSpeedPercent(1, 80)).toBe(true);
+
+            const [status] = readStatus();
+            expect(status.fans[0].temperature).toBe(72);
+            expect(status.fans[1].speedPercent).toBe(80);
+            expect(status.tdps.map((tdp): number => tdp.current)).toEqual([20, 30, 40]);
+
+            const tdpInfo: TDPInfo[] = [];
+            expect(nativeLib.getTDPInfo(tdpInfo)).toBe(true);
+            expect(tdpInfo.map((tdp): number => tdp.current)).toEqual([20, 30, 40]);
+            expect(tdpInfo.map((tdp): string => tdp.descriptor)).toEqual(['pl1', 'pl2', 'pl4']);
+        }
+    });
+
+    it('falls back to per register calls on modules without batch support', (): void => {
+        nativeLib.startIoctlSimulation({ interface: 'uniwill', batchSupport: false, moduleVersion: '0.2.6' });
+        const [status, stats] = readStatus();
+        expect(status.fans.length).toBe(2);
+        expect(status.tdps.length).toBe(3);
+        expect(stats.batchCalls).toBe(0);
+        expect(nativeLib.wmiAvailable()).toBe(true);
+    });
+
+    it('falls back to per register calls for good when the batch ioctl is rejected', (): void => {
+        nativeLib.startIoctlSimulation({ interface: 'uniwill', batchSupport: false });
+        readStatus();
+        const [singleStatus, singleStats] = readStatus();
+
+        nativeLib.startIoctlSimulation({ interface: 'uniwill', batchError: os.constants.errno.EOPNOTSUPP });
+        readStatus();
+        const [status, stats] = readStatus();
+
+        expect(status).toEqual(singleStatus);
+        expect(stats.batchCalls).toBe(0);
+        // Only the first read tried the batch ioctl
+        expect(stats.transitions).toBe(singleStats.transitions + 1);
+    });
+});
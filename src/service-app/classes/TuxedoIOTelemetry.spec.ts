@@ -0,0 +1,82 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+
+import type { ITuxedoIOAPI, TDPInfo, TelemetrySnapshot } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib, TelemetrySnapshotStub } from './NativeLibSpecHelper';
+
+describe('TuxedoIOAPI telemetry', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+    // Never the segment of a running tccd
+    const segmentName: string = `/tcc-telemetry-spec-${process.pid}`;
+
+    function tdpCurrents(snapshot: TelemetrySnapshot): number[] {
+        return snapshot.tdps.map((tdp: { current: number }): number => tdp.current);
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+        // Fills in the TDP count and ranges
+        expect(nativeLib.getTDPInfo([])).toBe(true);
+    });
+
+    afterEach((): void => {
+        nativeLib?.closeTelemetry();
+        nativeLib?.unpublishTelemetry();
+        nativeLib?.stopIoctlSimulation();
+    });
+
+    it('keeps the values of the setters in the local store', (): void => {
+        const before: TelemetrySnapshot = new TelemetrySnapshotStub();
+        nativeLib.getTelemetry(before);
+        expect(nativeLib.setTDPValues([20, 30, 40])).toBe(true);
+
+        const after: TelemetrySnapshot = new TelemetrySnapshotStub();
+        nativeLib.getTelemetry(after);
+        expect(after.sequence).toBeGreaterThan(before.sequence);
+        expect(tdpCurrents(after)).toEqual([20, 30, 40]);
+    });
+
+    it('mirrors updates into the shared memory segment', (): void => {
+        expect(nativeLib.publishTelemetry(segmentName)).toBe(true);
+        expect(nativeLib.openTelemetry(segmentName)).toBe(true);
+
+        const published: TelemetrySnapshot = new TelemetrySnapshotStub();
+        expect(nativeLib.readTelemetry(published)).toBe(true);
+        // Even, no write in progress
+        expect(published.sequence % 2).toBe(0);
+
+        const tdpInfo: TDPInfo[] = [];
+        expect(nativeLib.getTDPInfo(tdpInfo)).toBe(true);
+        const tdpValues: number[] = tdpInfo.map((tdp: TDPInfo): number => tdp.min);
+        expect(nativeLib.setTDPValues(tdpValues)).toBe(true);
+
+        const updated: TelemetrySnapshot = new TelemetrySnapshotStub();
+        expect(nativeLib.readTelemetry(updated)).toBe(true);
+        expect(updated.sequence).toBeGreaterThan(published.sequence);
+        expect(tdpCurrents(updated)).toEqual(tdpValues);
+    });
+
+    it('does not map a segment that is not published', (): void => {
+        expect(nativeLib.openTelemetry(`${segmentName}-missing`)).toBe(false);
+        expect(nativeLib.readTelemetry(new TelemetrySnapshotStub())).toBe(false);
+    });
+});
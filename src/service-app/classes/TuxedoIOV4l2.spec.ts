@@ -0,0 +1,106 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+
+import type { ITuxedoIOAPI, V4l2ApplyResult, V4l2Control } from '../../native-lib/TuxedoIOAPI';
+import { loadNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+const DEVICE_PATH: string = '/dev/video-simulated';
+
+describe('TuxedoIOAPI V4L2 controls', (): void => {
+    const nativeLib: ITuxedoIOAPI | undefined = loadNativeLib();
+
+    function readControls(): V4l2Control[] {
+        const controls: V4l2Control[] = [];
+        expect(nativeLib.getV4l2Controls(DEVICE_PATH, controls)).toBe(true);
+        return controls;
+    }
+
+    function findControl(controls: V4l2Control[], textId: string): V4l2Control {
+        return controls.find((control: V4l2Control): boolean => control.textId === textId);
+    }
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        nativeLib.simulateV4l2Camera(DEVICE_PATH);
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopV4l2Simulation();
+    });
+
+    it('queries controls and menus with their current values', (): void => {
+        const controls: V4l2Control[] = readControls();
+        expect(controls.map((control: V4l2Control): string => control.textId)).toEqual([
+            'brightness',
+            'white_balance_automatic',
+            'power_line_frequency',
+            'white_balance_temperature',
+        ]);
+        expect(findControl(controls, 'white_balance_automatic').type).toBe('boolean');
+        expect(findControl(controls, 'white_balance_temperature').inactive).toBe(true);
+
+        const powerLineFrequency: V4l2Control = findControl(controls, 'power_line_frequency');
+        expect(powerLineFrequency.type).toBe('menu');
+        expect(powerLineFrequency.value).toBe(1);
+        expect(powerLineFrequency.menu.map((item): string => item.textId)).toEqual(['disabled', '50_hz', '60_hz']);
+    });
+
+    it('applies a batch and reports unknown and clamped controls', (): void => {
+        const result: V4l2ApplyResult = { applied: [], unknown: [], failed: [] };
+        const values: Record<string, string | number | boolean> = {
+            brightness: 100,
+            white_balance_automatic: false,
+            power_line_frequency: '60_hz',
+            zoom_absolute: 1,
+        };
+        expect(nativeLib.setV4l2Controls(DEVICE_PATH, values, result)).toBe(false);
+        expect(result.applied.sort()).toEqual(['power_line_frequency', 'white_balance_automatic']);
+        expect(result.unknown).toEqual(['zoom_absolute']);
+        expect(result.failed).toEqual(['brightness']);
+
+        const controls: V4l2Control[] = readControls();
+        expect(findControl(controls, 'brightness').value).toBe(64);
+        expect(findControl(controls, 'power_line_frequency').value).toBe(2);
+        expect(findControl(controls, 'white_balance_temperature').inactive).toBe(false);
+    });
+
+    it('enumerates the controls once while the camera stays the same', (): void => {
+        readControls();
+        readControls();
+        expect(nativeLib.setV4l2Controls(DEVICE_PATH, { brightness: 10 })).toBe(true);
+        expect(nativeLib.getV4l2SimulationEnumerations(DEVICE_PATH)).toBe(1);
+    });
+
+    it('queries again once another camera is plugged in at the same path', (): void => {
+        nativeLib.simulateV4l2Camera(DEVICE_PATH, { card: 'Camera A', controls: ['brightness'] });
+        expect(readControls().length).toBe(1);
+
+        nativeLib.simulateV4l2Camera(DEVICE_PATH, { card: 'Camera B' });
+        expect(readControls().length).toBe(4);
+        expect(nativeLib.getV4l2SimulationEnumerations(DEVICE_PATH)).toBe(1);
+    });
+
+    it('fails for device files that cannot be opened', (): void => {
+        const controls: V4l2Control[] = [];
+        expect(nativeLib.getV4l2Controls('/dev/video-missing', controls)).toBe(false);
+        expect(nativeLib.getV4l2SimulationEnumerations('/dev/video-missing')).toBe(-1);
+    });
+});
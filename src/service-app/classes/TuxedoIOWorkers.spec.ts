@@ -0,0 +1,79 @@
+/*!
+ * Copyright (c) 2026 TUXEDO Computers GmbH <tux@tuxedocomputers.com>
+ *
+ * This file is part of TUXEDO Control Center.
+ *
+ * TUXEDO Control Center is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TUXEDO Control Center is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with TUXEDO Control Center.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import 'jasmine';
+import { Worker } from 'node:worker_threads';
+
+import type { ITuxedoIOAPI, ObjWrapper } from '../../native-lib/TuxedoIOAPI';
+import { findNativeLib, requireNativeLib } from './NativeLibSpecHelper';
+
+// Loads the addon in its own environment, sets a fan speed and reports the session users
+const workerSource: string = `
+    const { parentPort, workerData } = require('node:worker_threads');
+    const nativeLib = require(workerData.addonPath);
+    const written = nativeLib.setFanSpeedPercent(0, workerData.fanSpeedPercent);
+    parentPort.postMessage({ written, users: nativeLib.getDeviceSessionStats().users });
+`;
+
+interface WorkerResult {
+    written: boolean;
+    users: number;
+}
+
+function runWorker(addonPath: string, fanSpeedPercent: number): Promise<WorkerResult> {
+    return new Promise<WorkerResult>((resolve, reject): void => {
+        const worker: Worker = new Worker(workerSource, { eval: true, workerData: { addonPath, fanSpeedPercent } });
+        let result: WorkerResult;
+        worker.on('message', (message: WorkerResult): void => { result = message; });
+        worker.on('error', reject);
+        worker.on('exit', (): void => resolve(result));
+    });
+}
+
+describe('TuxedoIOAPI in worker_threads', (): void => {
+    const addonPath: string | undefined = findNativeLib();
+    const nativeLib: ITuxedoIOAPI | undefined = addonPath !== undefined ? require(addonPath) : undefined;
+
+    beforeEach((): void => {
+        requireNativeLib(nativeLib);
+        nativeLib.startIoctlSimulation({ interface: 'uniwill' });
+    });
+
+    afterEach((): void => {
+        nativeLib?.stopSensorSampler();
+        nativeLib?.stopIoctlSimulation();
+    });
+
+    it('shares one device session between environments', async (): Promise<void> => {
+        const usersBefore: number = nativeLib.getDeviceSessionStats().users;
+        const result: WorkerResult = await runWorker(addonPath, 60);
+        expect(result.written).toBe(true);
+        expect(result.users).toBe(usersBefore + 1);
+
+        const fanSpeed: ObjWrapper<number> = { value: -1 };
+        expect(nativeLib.getFanSpeedPercent(0, fanSpeed)).toBe(true);
+        expect(fanSpeed.value).toBe(60);
+    });
+
+    it('keeps services of the main thread running when a worker exits', async (): Promise<void> => {
+        expect(nativeLib.startSensorSampler(100, 1000)).toBe(true);
+        await runWorker(addonPath, 40);
+        expect(nativeLib.getSamplerStats().running).toBe(true);
+    });
+});
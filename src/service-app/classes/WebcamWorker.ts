@@ -18,13 +18,14 @@
  */
 
 import type { ITccProfile } from '../../common/models/TccProfile';
-import { type ObjWrapper, TuxedoIOAPI } from '../../native-lib/TuxedoIOAPI';
+import { type ObjWrapper, TelemetrySnapshot, TuxedoIOAPI } from '../../native-lib/TuxedoIOAPI';
 import { DaemonWorker } from './DaemonWorker';
 import type { TuxedoControlCenterDaemon } from './TuxedoControlCenterDaemon';
 
 export class WebcamWorker extends DaemonWorker {
     constructor(tccd: TuxedoControlCenterDaemon) {
         super(2000, 'WebCamWorker', tccd);
+        this.hardwareReads = ['webcam'];
     }
 
     public async onStart(): Promise<void> {
@@ -60,6 +61,14 @@ export class WebcamWorker extends DaemonWorker {
     }
 
     public async onWork(): Promise<void> {
+        if (this.tccd.nativeScheduling) {
+            // Already read in the scheduler wakeup batch
+            const telemetry: TelemetrySnapshot = new TelemetrySnapshot();
+            TuxedoIOAPI.getTelemetry(telemetry);
+            this.tccd.dbusData.webcamSwitchAvailable = telemetry.webcamStatus !== -1;
+            this.tccd.dbusData.webcamSwitchStatus = telemetry.webcamStatus === -1 ? undefined : telemetry.webcamStatus === 1;
+            return;
+        }
         this.updateWebcamStatus();
     }
 